@@ -3,6 +3,7 @@ include(CMakeDependentOption)
 # Components to build
 option(BUILD_TESTS "Build with unittests" ON)
 option(BUILD_STRESS_TESTS "Build with stress tests" OFF)
+option(BUILD_BENCHMARKS "Build micro-benchmarks" OFF)
 option(BUILD_RPC "Build RPC framework" ON)
 option(BUILD_DOC "Build documentation" OFF)
 option(BUILD_EXAMPLES "Build examples" ON)
@@ -16,6 +17,7 @@ message(STATUS "  Build RPC Framework:                    ${BUILD_RPC}")
 message(STATUS "    Build python client libraries:        ${WITH_PY_CLIENT}")
 message(STATUS "    Build java client libraries:          ${WITH_JAVA_CLIENT}")
 message(STATUS "  Build with unit tests:                  ${BUILD_TESTS}")
+message(STATUS "  Build micro-benchmarks:                 ${BUILD_BENCHMARKS}")
 message(STATUS "  Build documentation:                    ${BUILD_DOC}")
 message(STATUS "  Build examples:                         ${BUILD_EXAMPLES}")
 message(STATUS "----------------------------------------------------------")
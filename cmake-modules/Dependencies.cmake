@@ -85,6 +85,18 @@ message(STATUS "Jemalloc library: ${JEMALLOC_LIBRARIES}")
 install(FILES ${JEMALLOC_LIBRARIES} DESTINATION lib)
 
 if (BUILD_RPC)
+  # The nonblocking server needs libevent; without it, only the thread-pool
+  # server is built
+  find_package(Libevent)
+  if (LIBEVENT_FOUND)
+    message(STATUS "Libevent library: ${LIBEVENT_LIBRARIES}")
+    add_definitions(-DCONFLUO_NONBLOCKING_SERVER)
+    set(THRIFT_WITH_LIBEVENT ON)
+  else ()
+    message(STATUS "Libevent not found; building without the nonblocking rpc server")
+    set(THRIFT_WITH_LIBEVENT OFF)
+  endif ()
+
   set(THRIFT_CXX_FLAGS "${EXTERNAL_CXX_FLAGS}")
   set(THRIFT_C_FLAGS "${EXTERNAL_C_FLAGS}")
   set(THRIFT_PREFIX "${PROJECT_BINARY_DIR}/external/thrift")
@@ -104,7 +116,7 @@ if (BUILD_RPC)
                         "-DWITH_HASKELL=OFF"
                         "-DWITH_ZLIB=OFF" # For now
                         "-DWITH_OPENSSL=OFF" # For now
-                        "-DWITH_LIBEVENT=OFF" # For now
+                        "-DWITH_LIBEVENT=${THRIFT_WITH_LIBEVENT}"
                         "-DWITH_JAVA=OFF"
                         "-DWITH_PYTHON=OFF"
                         "-DWITH_CPP=ON"
@@ -115,11 +127,14 @@ if (BUILD_RPC)
 
   if (CMAKE_BUILD_TYPE MATCHES DEBUG)
     set(THRIFT_STATIC_LIB_NAME "${CMAKE_STATIC_LIBRARY_PREFIX}thriftd")
+    set(THRIFTNB_STATIC_LIB_NAME "${CMAKE_STATIC_LIBRARY_PREFIX}thriftnbd")
   else ()
     set(THRIFT_STATIC_LIB_NAME "${CMAKE_STATIC_LIBRARY_PREFIX}thrift")
+    set(THRIFTNB_STATIC_LIB_NAME "${CMAKE_STATIC_LIBRARY_PREFIX}thriftnb")
   endif ()
 
   set(THRIFT_STATIC_LIB "${THRIFT_PREFIX}/lib/${THRIFT_STATIC_LIB_NAME}${CMAKE_STATIC_LIBRARY_SUFFIX}")
+  set(THRIFTNB_STATIC_LIB "${THRIFT_PREFIX}/lib/${THRIFTNB_STATIC_LIB_NAME}${CMAKE_STATIC_LIBRARY_SUFFIX}")
   ExternalProject_Add(thrift
       URL "http://archive.apache.org/dist/thrift/${THRIFT_VERSION}/thrift-${THRIFT_VERSION}.tar.gz"
       CMAKE_ARGS ${THRIFT_CMAKE_ARGS})
@@ -129,8 +144,17 @@ if (BUILD_RPC)
   message(STATUS "Thrift static library: ${THRIFT_STATIC_LIB}")
   add_library(thriftstatic STATIC IMPORTED GLOBAL)
   set_target_properties(thriftstatic PROPERTIES IMPORTED_LOCATION ${THRIFT_STATIC_LIB})
-  
   install(FILES ${THRIFT_STATIC_LIB} DESTINATION lib)
+
+  if (LIBEVENT_FOUND)
+    message(STATUS "Thrift nonblocking static library: ${THRIFTNB_STATIC_LIB}")
+    add_library(thriftnbstatic STATIC IMPORTED GLOBAL)
+    set_target_properties(thriftnbstatic PROPERTIES IMPORTED_LOCATION ${THRIFTNB_STATIC_LIB})
+    set(THRIFT_LIBRARIES thriftnbstatic thriftstatic ${LIBEVENT_LIBRARIES})
+    install(FILES ${THRIFTNB_STATIC_LIB} DESTINATION lib)
+  else ()
+    set(THRIFT_LIBRARIES thriftstatic)
+  endif ()
   install(DIRECTORY ${THRIFT_INCLUDE_DIR}/thrift DESTINATION include)
 endif()
 
@@ -0,0 +1,42 @@
+# FindLibevent
+# ------------
+#
+# This module looks for the libevent event notification library, which the
+# nonblocking Thrift server depends on.
+#
+# This modules defines the following variables:
+#
+# ::
+#
+#    LIBEVENT_INCLUDE_DIRS = The libevent include directories.
+#    LIBEVENT_LIBRARIES    = The libevent libraries to link against.
+#    LIBEVENT_FOUND        = Was libevent found or not?
+#
+
+#
+# Find libevent...
+#
+
+find_path(LIBEVENT_INCLUDE_DIR
+  NAMES event.h
+  PATHS
+    /usr/local/include
+    /opt/local/include
+  DOC "libevent include directory"
+)
+
+find_library(LIBEVENT_LIBRARY
+  NAMES event
+  PATHS
+    /usr/local/lib
+    /opt/local/lib
+  DOC "libevent library"
+)
+
+set(LIBEVENT_INCLUDE_DIRS ${LIBEVENT_INCLUDE_DIR})
+set(LIBEVENT_LIBRARIES ${LIBEVENT_LIBRARY})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Libevent DEFAULT_MSG LIBEVENT_LIBRARY LIBEVENT_INCLUDE_DIR)
+
+mark_as_advanced(LIBEVENT_INCLUDE_DIR LIBEVENT_LIBRARY)
@@ -5,7 +5,7 @@ curdir="`cd "$curdir"; pwd`"
 
 sudo yum -y update
 sudo yum -y groupinstall "Development Tools"
-sudo yum -y install gcc-c++ boost-devel java-1.7.0-openjdk* ant
+sudo yum -y install gcc-c++ boost-devel libevent-devel java-1.7.0-openjdk* ant
 
 wget https://cmake.org/files/v3.9/cmake-3.9.2.tar.gz
 tar xvzf cmake-3.9.2.tar.gz
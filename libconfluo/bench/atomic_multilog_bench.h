@@ -0,0 +1,232 @@
+#ifndef CONFLUO_BENCH_ATOMIC_MULTILOG_BENCH_H_
+#define CONFLUO_BENCH_ATOMIC_MULTILOG_BENCH_H_
+
+#include <memory>
+#include <thread>
+
+#include "atomic_multilog.h"
+#include "benchmark.h"
+
+using namespace ::confluo;
+
+/**
+ * Shared setup for the multilog benchmarks
+ */
+class multilog_bench {
+ public:
+  /** Records per batch in the append_batch benchmark */
+  static const size_t BATCH_SIZE = 64;
+
+  struct rec {
+    int64_t ts;
+    bool a;
+    int8_t b;
+    int16_t c;
+    int32_t d;
+    int64_t e;
+    float f;
+    double g;
+    char h[16];
+  }__attribute__((packed));
+
+  static task_pool &mgmt_pool() {
+    static task_pool pool;
+    return pool;
+  }
+
+  static std::vector<column_t> schema() {
+    schema_builder builder;
+    builder.add_column(primitive_types::BOOL_TYPE(), "a");
+    builder.add_column(primitive_types::CHAR_TYPE(), "b");
+    builder.add_column(primitive_types::SHORT_TYPE(), "c");
+    builder.add_column(primitive_types::INT_TYPE(), "d");
+    builder.add_column(primitive_types::LONG_TYPE(), "e");
+    builder.add_column(primitive_types::FLOAT_TYPE(), "f");
+    builder.add_column(primitive_types::DOUBLE_TYPE(), "g");
+    builder.add_column(primitive_types::STRING_TYPE(16), "h");
+    return builder.get_columns();
+  }
+
+  static rec make_record(uint64_t i, int64_t ts) {
+    rec r = {ts, i % 2 == 0, static_cast<int8_t>(i % 128), static_cast<int16_t>(i % 10000),
+             static_cast<int32_t>(i % 1000), static_cast<int64_t>(i % 4096), static_cast<float>(i % 100) / 10,
+             static_cast<double>(i % 1000) / 100, {}};
+    snprintf(r.h, sizeof(r.h), "key%llu", static_cast<unsigned long long>(i % 100));
+    return r;
+  }
+
+  static std::unique_ptr<atomic_multilog> create() {
+    return std::unique_ptr<atomic_multilog>(
+        new atomic_multilog("bench_table", schema(), "/tmp", storage::IN_MEMORY, archival_mode::OFF, mgmt_pool()));
+  }
+
+  /**
+   * Adds the i-th filter; filters cycle over the integer fields with a
+   * spread of selectivities
+   */
+  static void add_filter(atomic_multilog &mlog, size_t i) {
+    static const char *fields[] = {"c", "d", "e", "g"};
+    std::string expr = std::string(fields[i % 4]) + " > " + std::to_string((i / 4 + 1) * 10);
+    mlog.add_filter("filter" + std::to_string(i), expr);
+  }
+
+  /**
+   * Adds an index on the i-th field
+   */
+  static void add_index(atomic_multilog &mlog, size_t i) {
+    static const char *fields[] = {"a", "b", "c", "d", "e", "f", "g", "h"};
+    mlog.add_index(fields[i % 8]);
+  }
+
+  /**
+   * Appends n records, optionally in batches, split across nthreads
+   * registered writer threads
+   */
+  static void append(atomic_multilog &mlog, uint64_t n, size_t nthreads, bool batched, bench::bench_timer &timer) {
+    std::vector<std::thread> writers;
+    timer.start();
+    for (size_t t = 0; t < nthreads; t++) {
+      writers.push_back(std::thread([&mlog, n, nthreads, batched, t] {
+        thread_manager::register_thread();
+        int64_t ts = static_cast<int64_t>(utils::time_utils::cur_ns());
+        if (batched) {
+          for (uint64_t i = t * BATCH_SIZE; i < n; i += nthreads * BATCH_SIZE) {
+            record_batch_builder builder = mlog.get_batch_builder();
+            for (uint64_t j = i; j < std::min(i + BATCH_SIZE, n); j++) {
+              rec r = make_record(j, ts);
+              builder.add_record(&r);
+            }
+            record_batch batch = builder.get_batch();
+            mlog.append_batch(batch);
+          }
+        } else {
+          for (uint64_t i = t; i < n; i += nthreads) {
+            rec r = make_record(i, ts);
+            mlog.append(&r);
+          }
+        }
+        thread_manager::deregister_thread();
+      }));
+    }
+    for (auto &w : writers)
+      w.join();
+    timer.stop();
+  }
+
+  /**
+   * Sweeps writer threads over several filter and index configurations of a
+   * single multilog; data log buckets are only released with the process, so
+   * the multilog is reconfigured in place rather than re-created per run
+   */
+  static void append_sweep(bench::bench_context &ctx, bool batched) {
+    const uint64_t n = ctx.scaled(1ULL << 14);
+    auto mlog = create();
+    size_t nfilters = 0;
+    for (size_t target : {0, 4, 16}) {
+      for (; nfilters < target; nfilters++)
+        add_filter(*mlog, nfilters);
+      sweep_threads(ctx, *mlog, "filters=" + std::to_string(nfilters), n, batched);
+    }
+    for (size_t i = 0; i < nfilters; i++)
+      mlog->remove_filter("filter" + std::to_string(i));
+
+    size_t nindexes = 0;
+    for (size_t target : {4, 8}) {
+      for (; nindexes < target; nindexes++)
+        add_index(*mlog, nindexes);
+      sweep_threads(ctx, *mlog, "indexes=" + std::to_string(nindexes), n, batched);
+    }
+  }
+
+ private:
+  static void sweep_threads(bench::bench_context &ctx, atomic_multilog &mlog, const std::string &params, uint64_t n,
+                            bool batched) {
+    for (size_t nthreads : ctx.thread_counts()) {
+      ctx.run_timed("threads=" + std::to_string(nthreads) + "/" + params, n, [&](bench::bench_timer &timer) {
+        append(mlog, n, nthreads, batched, timer);
+      });
+    }
+  }
+};
+
+const size_t multilog_bench::BATCH_SIZE;
+
+/**
+ * Appends single records with varying numbers of writer threads, filters
+ * and indexes
+ */
+CONFLUO_BENCHMARK(atomic_multilog_append) {
+  multilog_bench::append_sweep(ctx, false);
+}
+
+/**
+ * Appends record batches with varying numbers of writer threads, filters
+ * and indexes
+ */
+CONFLUO_BENCHMARK(atomic_multilog_append_batch) {
+  multilog_bench::append_sweep(ctx, true);
+}
+
+/**
+ * Runs ad-hoc filters of varying selectivity, once with a full scan and
+ * once through an index
+ */
+CONFLUO_BENCHMARK(atomic_multilog_execute_filter) {
+  const uint64_t n = ctx.scaled(1ULL << 17);
+  bench::bench_timer untimed;
+  auto scan_mlog = multilog_bench::create();
+  multilog_bench::append(*scan_mlog, n, 1, true, untimed);
+  auto index_mlog = multilog_bench::create();
+  index_mlog->add_index("d", 1);
+  multilog_bench::append(*index_mlog, n, 1, true, untimed);
+
+  // d cycles through [0, 1000)
+  std::vector<std::pair<std::string, std::string>> exprs = {
+      {"1%", "d < 10"}, {"10%", "d < 100"}, {"50%", "d < 500"}
+  };
+  for (const auto &e : exprs) {
+    for (int use_index = 0; use_index < 2; use_index++) {
+      atomic_multilog &mlog = use_index ? *index_mlog : *scan_mlog;
+      ctx.run(std::string("plan=") + (use_index ? "index" : "full_scan") + "/selectivity=" + e.first, n, [&] {
+        uint64_t count = 0;
+        for (auto c = mlog.execute_filter(e.second); c->has_more(); c->advance())
+          count++;
+        bench::do_not_optimize(count);
+      });
+    }
+  }
+}
+
+/**
+ * Reads a filter aggregate over time ranges of increasing width
+ */
+CONFLUO_BENCHMARK(atomic_multilog_get_aggregate) {
+  const uint64_t n = ctx.scaled(1ULL << 17);
+  const uint64_t span_ms = 10000;
+  const uint64_t nqueries = 1000;
+  auto mlog = multilog_bench::create();
+  mlog->add_filter("all", "d >= 0");
+  mlog->add_aggregate("sum_d", "all", "SUM(d)");
+
+  // Spread the records evenly over span_ms milliseconds
+  thread_manager::register_thread();
+  const uint64_t base_ms = 1000000000;
+  for (uint64_t i = 0; i < n; i++) {
+    uint64_t ms = base_ms + i * span_ms / n;
+    multilog_bench::rec r = multilog_bench::make_record(i, static_cast<int64_t>(ms * 1000000));
+    mlog->append(&r);
+  }
+  thread_manager::deregister_thread();
+
+  for (uint64_t width_ms : {UINT64_C(1), UINT64_C(100), UINT64_C(1000), span_ms}) {
+    ctx.run("range_ms=" + std::to_string(width_ms), nqueries, [&] {
+      for (uint64_t q = 0; q < nqueries; q++) {
+        uint64_t begin = base_ms + (q * UINT64_C(2654435761)) % (span_ms - width_ms + 1);
+        numeric agg = mlog->get_aggregate("sum_d", begin, begin + width_ms - 1);
+        bench::do_not_optimize(agg);
+      }
+    });
+  }
+}
+
+#endif /* CONFLUO_BENCH_ATOMIC_MULTILOG_BENCH_H_ */
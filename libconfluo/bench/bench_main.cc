@@ -0,0 +1,103 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "error_handling.h"
+#include "cmd_parse.h"
+#include "threads/thread_manager.h"
+#include "benchmark.h"
+#include "container/monolog_bench.h"
+#include "container/radix_tree_bench.h"
+#include "atomic_multilog_bench.h"
+#include "compression/encode_bench.h"
+#include "read_tail_bench.h"
+#include "filter_bench.h"
+
+using namespace ::confluo;
+using namespace ::confluo::bench;
+
+static bool matches(const std::string &name, const std::string &filters) {
+  if (filters == "*")
+    return true;
+  std::stringstream ss(filters);
+  std::string filter;
+  while (std::getline(ss, filter, ',')) {
+    if (!filter.empty() && name.find(filter) != std::string::npos)
+      return true;
+  }
+  return false;
+}
+
+int main(int argc, char **argv) {
+  utils::error_handling::install_signal_handler(argv[0], SIGSEGV, SIGKILL, SIGSTOP);
+
+  cmd_options opts;
+  opts.add(cmd_option("filter", 'f', false).set_default("*")
+               .set_description("Comma-separated substrings of the benchmarks to run, * for all"));
+  opts.add(cmd_option("format", 't', false).set_default("console").set_description("Output format: console, csv or json"));
+  opts.add(cmd_option("output", 'o', false).set_default("-").set_description("Output file, - for stdout"));
+  opts.add(cmd_option("repetitions", 'r', false).set_default("5").set_description("Timed repetitions per run"));
+  opts.add(cmd_option("scale", 's', false).set_default("1.0").set_description("Data set size multiplier"));
+  opts.add(cmd_option("max-threads", 'n', false).set_default("0")
+               .set_description("Largest writer thread count, 0 for the maximum concurrency"));
+  opts.add(cmd_option("list", 'l', true).set_description("List benchmarks and exit"));
+
+  cmd_parser parser(argc, argv, opts);
+  if (parser.get_flag("help")) {
+    fprintf(stderr, "%s\n", parser.help_msg().c_str());
+    return 0;
+  }
+
+  std::string filter, format, output;
+  int repetitions, max_threads;
+  double scale;
+  try {
+    filter = parser.get("filter");
+    format = parser.get("format");
+    output = parser.get("output");
+    repetitions = parser.get_int("repetitions");
+    scale = parser.get_double("scale");
+    max_threads = parser.get_int("max-threads");
+  } catch (std::exception &e) {
+    fprintf(stderr, "could not parse cmdline args: %s\n", e.what());
+    fprintf(stderr, "%s\n", parser.help_msg().c_str());
+    return 1;
+  }
+  if (format != "console" && format != "csv" && format != "json") {
+    fprintf(stderr, "unknown format: %s\n", format.c_str());
+    return 1;
+  }
+
+  if (parser.get_flag("list")) {
+    for (const auto &b : bench_registry::benchmarks())
+      std::cout << b.first << "\n";
+    return 0;
+  }
+
+  // Writer threads register with the thread manager, which caps their number
+  int concurrency = thread_manager::get_max_concurrency();
+  if (max_threads <= 0 || max_threads > concurrency)
+    max_threads = concurrency;
+
+  std::vector<bench_result> results;
+  for (const auto &b : bench_registry::benchmarks()) {
+    if (!matches(b.first, filter))
+      continue;
+    fprintf(stderr, "Running %s...\n", b.first.c_str());
+    bench_context ctx(b.first, static_cast<size_t>(repetitions), scale, static_cast<size_t>(max_threads));
+    b.second(ctx);
+    results.insert(results.end(), ctx.results().begin(), ctx.results().end());
+  }
+
+  std::ofstream file;
+  if (output != "-")
+    file.open(output);
+  std::ostream &out = output == "-" ? std::cout : file;
+  if (format == "csv")
+    bench_reporter::write_csv(out, results);
+  else if (format == "json")
+    bench_reporter::write_json(out, results, static_cast<size_t>(repetitions), scale);
+  else
+    bench_reporter::write_console(out, results);
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <thread>
+
+namespace confluo {
+namespace bench {
+
+double bench_result::ns_per_op() const {
+  return ops == 0 ? median_ns : median_ns / static_cast<double>(ops);
+}
+
+double bench_result::ops_per_sec() const {
+  return median_ns == 0 ? 0 : static_cast<double>(ops) * 1e9 / median_ns;
+}
+
+double bench_result::bytes_per_op() const {
+  return ops == 0 ? static_cast<double>(bytes) : static_cast<double>(bytes) / static_cast<double>(ops);
+}
+
+bench_timer::bench_timer()
+    : start_ns_(0),
+      elapsed_ns_(0),
+      running_(false) {
+}
+
+void bench_timer::start() {
+  if (!running_) {
+    running_ = true;
+    start_ns_ = utils::time_utils::cur_ns();
+  }
+}
+
+void bench_timer::stop() {
+  if (running_) {
+    elapsed_ns_ += utils::time_utils::cur_ns() - start_ns_;
+    running_ = false;
+  }
+}
+
+uint64_t bench_timer::elapsed_ns() const {
+  return elapsed_ns_;
+}
+
+bench_context::bench_context(const std::string &name, size_t repetitions, double scale, size_t max_threads)
+    : name_(name),
+      repetitions_(std::max(repetitions, static_cast<size_t>(1))),
+      scale_(scale),
+      max_threads_(std::max(max_threads, static_cast<size_t>(1))) {
+}
+
+uint64_t bench_context::scaled(uint64_t n) const {
+  return std::max(static_cast<uint64_t>(static_cast<double>(n) * scale_), static_cast<uint64_t>(1));
+}
+
+std::vector<size_t> bench_context::thread_counts() const {
+  std::vector<size_t> counts;
+  for (size_t n = 1; n < max_threads_; n *= 2)
+    counts.push_back(n);
+  counts.push_back(max_threads_);
+  return counts;
+}
+
+void bench_context::set_bytes(uint64_t bytes) {
+  if (!results_.empty())
+    results_.back().bytes = bytes;
+}
+
+const std::vector<bench_result> &bench_context::results() const {
+  return results_;
+}
+
+void bench_context::add_result(const std::string &params, uint64_t ops, std::vector<uint64_t> &samples) {
+  std::sort(samples.begin(), samples.end());
+  bench_result res;
+  res.name = name_;
+  res.params = params;
+  res.ops = ops;
+  res.repetitions = samples.size();
+  res.min_ns = static_cast<double>(samples.front());
+  res.max_ns = static_cast<double>(samples.back());
+  size_t mid = samples.size() / 2;
+  res.median_ns = samples.size() % 2 ? static_cast<double>(samples[mid])
+                                     : (static_cast<double>(samples[mid - 1]) + static_cast<double>(samples[mid])) / 2;
+  double sum = 0;
+  for (uint64_t s : samples)
+    sum += static_cast<double>(s);
+  res.mean_ns = sum / static_cast<double>(samples.size());
+  res.bytes = 0;
+  results_.push_back(res);
+}
+
+bool bench_registry::add(const std::string &name, bench_fn fn) {
+  benchmarks().push_back(std::make_pair(name, fn));
+  return true;
+}
+
+std::vector<std::pair<std::string, bench_fn>> &bench_registry::benchmarks() {
+  static std::vector<std::pair<std::string, bench_fn>> benchmarks;
+  return benchmarks;
+}
+
+void bench_reporter::write_console(std::ostream &out, const std::vector<bench_result> &results) {
+  out << std::left << std::setw(32) << "benchmark" << std::setw(36) << "params" << std::right << std::setw(12)
+      << "ops" << std::setw(16) << "median(ms)" << std::setw(14) << "ns/op" << std::setw(18) << "ops/s"
+      << std::setw(14) << "bytes/op" << "\n";
+  out << std::fixed;
+  for (const auto &r : results) {
+    out << std::left << std::setw(32) << r.name << std::setw(36) << r.params << std::right << std::setw(12) << r.ops
+        << std::setw(16) << std::setprecision(3) << r.median_ns / 1e6 << std::setw(14) << std::setprecision(1)
+        << r.ns_per_op() << std::setw(18) << std::setprecision(0) << r.ops_per_sec() << std::setw(14);
+    if (r.bytes == 0)
+      out << "-";
+    else
+      out << std::setprecision(1) << r.bytes_per_op();
+    out << "\n";
+  }
+  out.flush();
+}
+
+void bench_reporter::write_csv(std::ostream &out, const std::vector<bench_result> &results) {
+  out << "name,params,ops,repetitions,min_ns,median_ns,mean_ns,max_ns,ns_per_op,ops_per_sec,bytes\n";
+  out << std::fixed << std::setprecision(2);
+  for (const auto &r : results) {
+    out << r.name << "," << r.params << "," << r.ops << "," << r.repetitions << "," << r.min_ns << ","
+        << r.median_ns << "," << r.mean_ns << "," << r.max_ns << "," << r.ns_per_op() << "," << r.ops_per_sec()
+        << "," << r.bytes << "\n";
+  }
+  out.flush();
+}
+
+void bench_reporter::write_json(std::ostream &out, const std::vector<bench_result> &results, size_t repetitions,
+                                double scale) {
+  char date[32];
+  time_t now = time(nullptr);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+  out << std::fixed << std::setprecision(2);
+  out << "{\n";
+  out << "  \"context\": {\n";
+  out << "    \"date\": \"" << date << "\",\n";
+  out << "    \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+  out << "    \"repetitions\": " << repetitions << ",\n";
+  out << "    \"scale\": " << scale << "\n";
+  out << "  },\n";
+  out << "  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const bench_result &r = results[i];
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"name\": \"" << r.name << "\", \"params\": \"" << r.params << "\", \"ops\": " << r.ops
+        << ", \"repetitions\": " << r.repetitions << ", \"min_ns\": " << r.min_ns << ", \"median_ns\": "
+        << r.median_ns << ", \"mean_ns\": " << r.mean_ns << ", \"max_ns\": " << r.max_ns << ", \"ns_per_op\": "
+        << r.ns_per_op() << ", \"ops_per_sec\": " << r.ops_per_sec() << ", \"bytes\": " << r.bytes << "}";
+  }
+  out << "\n  ]\n}\n";
+  out.flush();
+}
+
+}
+}
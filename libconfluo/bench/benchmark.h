@@ -0,0 +1,254 @@
+#ifndef CONFLUO_BENCH_BENCHMARK_H_
+#define CONFLUO_BENCH_BENCHMARK_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "time_utils.h"
+
+namespace confluo {
+namespace bench {
+
+/**
+ * Timing results for one parameterization of a benchmark
+ */
+struct bench_result {
+  /** The name of the benchmark */
+  std::string name;
+  /** The parameters of the run, e.g. "threads=4/filters=16" */
+  std::string params;
+  /** The number of operations performed per repetition */
+  uint64_t ops;
+  /** The number of timed repetitions */
+  size_t repetitions;
+  /** Minimum time per repetition, in nanoseconds */
+  double min_ns;
+  /** Median time per repetition, in nanoseconds */
+  double median_ns;
+  /** Mean time per repetition, in nanoseconds */
+  double mean_ns;
+  /** Maximum time per repetition, in nanoseconds */
+  double max_ns;
+  /** Memory used by the run, in bytes; 0 if not measured */
+  uint64_t bytes;
+
+  /**
+   * @return The median time per operation, in nanoseconds
+   */
+  double ns_per_op() const;
+
+  /**
+   * @return The operation throughput at the median time
+   */
+  double ops_per_sec() const;
+
+  /**
+   * @return The memory used per operation, in bytes
+   */
+  double bytes_per_op() const;
+};
+
+/**
+ * Times sections of a single repetition
+ */
+class bench_timer {
+ public:
+  /**
+   * Constructs a stopped timer
+   */
+  bench_timer();
+
+  /**
+   * Starts (or resumes) timing
+   */
+  void start();
+
+  /**
+   * Pauses timing; the time since the last start is accumulated
+   */
+  void stop();
+
+  /**
+   * @return The accumulated time in nanoseconds
+   */
+  uint64_t elapsed_ns() const;
+
+ private:
+  uint64_t start_ns_;
+  uint64_t elapsed_ns_;
+  bool running_;
+};
+
+/**
+ * Passed to each benchmark; runs its timed sections and collects results
+ */
+class bench_context {
+ public:
+  /**
+   * Constructs a context for a benchmark
+   *
+   * @param name The name of the benchmark
+   * @param repetitions The number of timed repetitions per run
+   * @param scale Multiplier applied to the benchmark's data set sizes
+   * @param max_threads The largest number of threads to benchmark with
+   */
+  bench_context(const std::string &name, size_t repetitions, double scale, size_t max_threads);
+
+  /**
+   * Scales a data set size by the configured scale factor
+   *
+   * @param n The default size
+   * @return The scaled size, at least 1
+   */
+  uint64_t scaled(uint64_t n) const;
+
+  /**
+   * @return The thread counts to benchmark with: powers of two up to, and
+   * including, the maximum
+   */
+  std::vector<size_t> thread_counts() const;
+
+  /**
+   * Runs fn once untimed as a warm-up, then times it for each repetition
+   *
+   * @param params The parameters of the run
+   * @param ops The number of operations fn performs
+   * @param fn The operation to time
+   */
+  template<typename F>
+  void run(const std::string &params, uint64_t ops, F &&fn) {
+    run_timed(params, ops, [&fn](bench_timer &timer) {
+      timer.start();
+      fn();
+      timer.stop();
+    });
+  }
+
+  /**
+   * Like run(), but fn times its own sections using the timer it is
+   * passed, so that per-repetition setup can be excluded
+   *
+   * @param params The parameters of the run
+   * @param ops The number of operations timed by fn
+   * @param fn The operation, taking a bench_timer &
+   */
+  template<typename F>
+  void run_timed(const std::string &params, uint64_t ops, F &&fn) {
+    {
+      bench_timer warmup;
+      fn(warmup);
+    }
+    std::vector<uint64_t> samples;
+    for (size_t i = 0; i < repetitions_; i++) {
+      bench_timer timer;
+      fn(timer);
+      samples.push_back(timer.elapsed_ns());
+    }
+    add_result(params, ops, samples);
+  }
+
+  /**
+   * Records the memory used by the last run, e.g. by the data structure it
+   * built
+   *
+   * @param bytes The memory used, in bytes
+   */
+  void set_bytes(uint64_t bytes);
+
+  /**
+   * @return The results collected so far
+   */
+  const std::vector<bench_result> &results() const;
+
+ private:
+  void add_result(const std::string &params, uint64_t ops, std::vector<uint64_t> &samples);
+
+  std::string name_;
+  size_t repetitions_;
+  double scale_;
+  size_t max_threads_;
+  std::vector<bench_result> results_;
+};
+
+/** A benchmark function */
+typedef void (*bench_fn)(bench_context &);
+
+/**
+ * Registry of all benchmarks linked into the binary
+ */
+class bench_registry {
+ public:
+  /**
+   * Registers a benchmark
+   *
+   * @param name The name of the benchmark
+   * @param fn The benchmark function
+   * @return True
+   */
+  static bool add(const std::string &name, bench_fn fn);
+
+  /**
+   * @return All registered benchmarks, in registration order
+   */
+  static std::vector<std::pair<std::string, bench_fn>> &benchmarks();
+};
+
+/**
+ * Output formats for benchmark results
+ */
+class bench_reporter {
+ public:
+  /**
+   * Writes results as a human readable table
+   *
+   * @param out The output stream
+   * @param results The results
+   */
+  static void write_console(std::ostream &out, const std::vector<bench_result> &results);
+
+  /**
+   * Writes results as CSV, one row per run
+   *
+   * @param out The output stream
+   * @param results The results
+   */
+  static void write_csv(std::ostream &out, const std::vector<bench_result> &results);
+
+  /**
+   * Writes results as a JSON document, along with the context they were
+   * obtained in
+   *
+   * @param out The output stream
+   * @param results The results
+   * @param repetitions The number of repetitions per run
+   * @param scale The data set scale factor
+   */
+  static void write_json(std::ostream &out, const std::vector<bench_result> &results, size_t repetitions,
+                         double scale);
+};
+
+/**
+ * Prevents the compiler from optimizing away the computation of a value
+ *
+ * @param value The value
+ */
+template<typename T>
+inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}
+}
+
+/**
+ * Defines and registers a benchmark; the body receives a bench_context &ctx
+ */
+#define CONFLUO_BENCHMARK(name) \
+  static void name##_bench(::confluo::bench::bench_context &ctx); \
+  static const bool name##_registered = ::confluo::bench::bench_registry::add(#name, name##_bench); \
+  static void name##_bench(::confluo::bench::bench_context &ctx)
+
+#endif /* CONFLUO_BENCH_BENCHMARK_H_ */
@@ -0,0 +1,58 @@
+#ifndef CONFLUO_BENCH_ENCODE_BENCH_H_
+#define CONFLUO_BENCH_ENCODE_BENCH_H_
+
+#include "compression/delta_decoder.h"
+#include "compression/delta_encoder.h"
+#include "compression/lz4_decoder.h"
+#include "compression/lz4_encoder.h"
+#include "benchmark.h"
+
+using namespace ::confluo;
+using namespace ::confluo::compression;
+
+/**
+ * LZ4-encodes and decodes a buffer of records with repeating fields
+ */
+CONFLUO_BENCHMARK(lz4_encode_decode) {
+  const size_t size = ctx.scaled(16ULL << 20);
+  std::vector<uint8_t> source(size);
+  for (size_t i = 0; i < size; i++)
+    source[i] = static_cast<uint8_t>((i / 64) % 256 + (i % 8));
+
+  ctx.run("op=encode", size, [&] {
+    auto encoded = lz4_encoder<>::encode(source.data(), size);
+    bench::do_not_optimize(encoded.get());
+  });
+
+  auto encoded = lz4_encoder<>::encode(source.data(), size);
+  std::vector<uint8_t> dest(size);
+  ctx.run("op=decode", size, [&] {
+    lz4_decoder<>::decode(encoded.get(), dest.data());
+    bench::do_not_optimize(dest[size - 1]);
+  });
+}
+
+/**
+ * Delta-encodes (with Elias-gamma coded deltas) and decodes a sorted array
+ * of offsets, as stored in reflog buckets
+ */
+CONFLUO_BENCHMARK(elias_gamma_encode_decode) {
+  const size_t n = ctx.scaled(1ULL << 20);
+  std::vector<uint64_t> source(n);
+  for (size_t i = 0; i < n; i++)
+    source[i] = i * 64 + (i % 7) * 8;
+
+  ctx.run("op=encode", n, [&] {
+    auto encoded = delta_encoder::encode(source.data(), n);
+    bench::do_not_optimize(encoded.get());
+  });
+
+  auto encoded = delta_encoder::encode(source.data(), n);
+  std::vector<uint64_t> dest(n);
+  ctx.run("op=decode", n, [&] {
+    delta_decoder::decode<uint64_t>(encoded.get(), dest.data());
+    bench::do_not_optimize(dest[n - 1]);
+  });
+}
+
+#endif /* CONFLUO_BENCH_ENCODE_BENCH_H_ */
@@ -0,0 +1,114 @@
+#ifndef CONFLUO_BENCH_MONOLOG_BENCH_H_
+#define CONFLUO_BENCH_MONOLOG_BENCH_H_
+
+#include <thread>
+
+#include "container/data_log.h"
+#include "container/reflog.h"
+#include "benchmark.h"
+
+using namespace ::confluo;
+
+/**
+ * Appends fixed size records to a data log (monolog_linear) from several
+ * threads at once; all runs append to the same log, since data log buckets
+ * are only released with the process
+ */
+CONFLUO_BENCHMARK(monolog_linear_append) {
+  const size_t record_size = 64;
+  const uint64_t n = ctx.scaled(1ULL << 16);
+  std::vector<uint8_t> record(record_size, 0xAB);
+  data_log log("bench_data_log", "/tmp", storage::IN_MEMORY);
+  for (size_t nthreads : ctx.thread_counts()) {
+    ctx.run_timed("threads=" + std::to_string(nthreads), n, [&](bench::bench_timer &timer) {
+      std::vector<std::thread> writers;
+      timer.start();
+      for (size_t t = 0; t < nthreads; t++) {
+        writers.push_back(std::thread([&, t] {
+          for (uint64_t i = t; i < n; i += nthreads)
+            log.append(record.data(), record_size);
+        }));
+      }
+      for (auto &w : writers)
+        w.join();
+      timer.stop();
+    });
+  }
+}
+
+/**
+ * Reads fixed size records from a data log (monolog_linear), sequentially
+ * and at random offsets
+ */
+CONFLUO_BENCHMARK(monolog_linear_read) {
+  const size_t record_size = 64;
+  const uint64_t n = ctx.scaled(1ULL << 18);
+  std::vector<uint8_t> record(record_size, 0xAB);
+  data_log log("bench_data_log", "/tmp", storage::IN_MEMORY);
+  for (uint64_t i = 0; i < n; i++)
+    log.append(record.data(), record_size);
+
+  std::vector<uint64_t> offsets(n);
+  for (uint64_t i = 0; i < n; i++)
+    offsets[i] = ((i * UINT64_C(2654435761)) % n) * record_size;
+
+  uint8_t buf[record_size];
+  ctx.run("order=sequential", n, [&] {
+    for (uint64_t i = 0; i < n; i++) {
+      log.read(i * record_size, buf, record_size);
+      bench::do_not_optimize(buf[0]);
+    }
+  });
+  ctx.run("order=random", n, [&] {
+    for (uint64_t off : offsets) {
+      log.read(off, buf, record_size);
+      bench::do_not_optimize(buf[0]);
+    }
+  });
+}
+
+/**
+ * Appends offsets to a reflog (monolog_exp2_linear) from several threads
+ * at once
+ */
+CONFLUO_BENCHMARK(monolog_exp2_linear_append) {
+  const uint64_t n = ctx.scaled(1ULL << 22);
+  for (size_t nthreads : ctx.thread_counts()) {
+    ctx.run_timed("threads=" + std::to_string(nthreads), n, [&](bench::bench_timer &timer) {
+      reflog refs;
+      std::vector<std::thread> writers;
+      timer.start();
+      for (size_t t = 0; t < nthreads; t++) {
+        writers.push_back(std::thread([&, t] {
+          for (uint64_t i = t; i < n; i += nthreads)
+            refs.push_back(i);
+        }));
+      }
+      for (auto &w : writers)
+        w.join();
+      timer.stop();
+    });
+  }
+}
+
+/**
+ * Reads offsets from a reflog (monolog_exp2_linear), sequentially and at
+ * random positions
+ */
+CONFLUO_BENCHMARK(monolog_exp2_linear_read) {
+  const uint64_t n = ctx.scaled(1ULL << 22);
+  reflog refs;
+  for (uint64_t i = 0; i < n; i++)
+    refs.push_back(i);
+
+  ctx.run("order=sequential", n, [&] {
+    for (uint64_t i = 0; i < n; i++)
+      bench::do_not_optimize(refs.at(i));
+  });
+  ctx.run("order=random", n, [&] {
+    for (uint64_t i = 0; i < n; i++)
+      bench::do_not_optimize(refs.at((i * UINT64_C(2654435761)) % n));
+  });
+}
+
+#endif /* CONFLUO_BENCH_MONOLOG_BENCH_H_ */
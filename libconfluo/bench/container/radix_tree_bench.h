@@ -0,0 +1,108 @@
+#ifndef CONFLUO_BENCH_RADIX_TREE_BENCH_H_
+#define CONFLUO_BENCH_RADIX_TREE_BENCH_H_
+
+#include "container/radix_tree.h"
+#include "storage/allocator.h"
+#include "benchmark.h"
+
+using namespace ::confluo;
+
+/**
+ * Inserts offsets for 8-byte keys into a radix index, in key order and in a
+ * scattered order; every key receives many offsets, since each distinct key
+ * owns a reflog
+ */
+CONFLUO_BENCHMARK(radix_tree_insert) {
+  const uint64_t n = ctx.scaled(1ULL << 18);
+  const uint64_t nkeys = 1024;
+  ctx.run_timed("keys=sequential", n, [&](bench::bench_timer &timer) {
+    index::radix_index tree(sizeof(uint64_t), 256);
+    timer.start();
+    for (uint64_t i = 0; i < n; i++)
+      tree.insert(byte_string(i * nkeys / n), i);
+    timer.stop();
+  });
+  ctx.run_timed("keys=scattered", n, [&](bench::bench_timer &timer) {
+    index::radix_index tree(sizeof(uint64_t), 256);
+    timer.start();
+    for (uint64_t i = 0; i < n; i++)
+      tree.insert(byte_string(((i * UINT64_C(2654435761)) % nkeys) << 20), i);
+    timer.stop();
+  });
+}
+
+/**
+ * Looks up key ranges of increasing width in a radix index and iterates
+ * over the matching offsets
+ */
+CONFLUO_BENCHMARK(radix_tree_range_lookup) {
+  const uint64_t n = ctx.scaled(1ULL << 18);
+  const uint64_t nkeys = 4096;
+  const uint64_t nlookups = 1000;
+  index::radix_index tree(sizeof(uint64_t), 256);
+  for (uint64_t i = 0; i < n; i++)
+    tree.insert(byte_string(i % nkeys), i);
+
+  for (uint64_t width : {UINT64_C(1), UINT64_C(16), UINT64_C(256)}) {
+    ctx.run("width=" + std::to_string(width), nlookups, [&] {
+      for (uint64_t i = 0; i < nlookups; i++) {
+        uint64_t begin = (i * UINT64_C(2654435761)) % (nkeys - width + 1);
+        auto res = tree.range_lookup(byte_string(begin), byte_string(begin + width - 1));
+        uint64_t count = 0;
+        for (auto it = res.begin(); it != res.end(); ++it)
+          count += *it;
+        bench::do_not_optimize(count);
+      }
+    });
+  }
+}
+
+/**
+ * Measures the memory the index structure takes per key, for dense keys that
+ * fill the last level of the tree and for scattered keys that share little
+ * but the root; keys are created without offsets, so that reflog buckets do
+ * not hide the inner nodes
+ */
+CONFLUO_BENCHMARK(radix_tree_memory) {
+  const uint64_t nkeys = ctx.scaled(1ULL << 16);
+  std::pair<std::string, uint64_t> dists[] = {{"dense", UINT64_C(1)}, {"scattered", UINT64_C(0x9E3779B97F4A7C15)}};
+  for (const auto &dist : dists) {
+    uint64_t bytes = 0;
+    ctx.run_timed("keys=" + dist.first, nkeys, [&](bench::bench_timer &timer) {
+      size_t before = allocator::instance().memory_utilization();
+      index::radix_index tree(sizeof(uint64_t), 256);
+      timer.start();
+      for (uint64_t i = 0; i < nkeys; i++)
+        tree.get_or_create(byte_string(i * dist.second));
+      timer.stop();
+      bytes = allocator::instance().memory_utilization() - before;
+    });
+    ctx.set_bytes(bytes);
+  }
+}
+
+/**
+ * Looks up single keys present in a radix index, for dense and scattered
+ * keys, in an order that does not follow the tree; keys hold no offsets,
+ * since a lookup only walks the tree
+ */
+CONFLUO_BENCHMARK(radix_tree_point_lookup) {
+  const uint64_t nkeys = ctx.scaled(1ULL << 16);
+  const uint64_t nlookups = ctx.scaled(1ULL << 18);
+  std::pair<std::string, uint64_t> dists[] = {{"dense", UINT64_C(1)}, {"scattered", UINT64_C(0x9E3779B97F4A7C15)}};
+  for (const auto &dist : dists) {
+    index::radix_index tree(sizeof(uint64_t), 256);
+    for (uint64_t i = 0; i < nkeys; i++)
+      tree.get_or_create(byte_string(i * dist.second));
+    ctx.run("keys=" + dist.first, nlookups, [&] {
+      uint64_t found = 0;
+      for (uint64_t i = 0; i < nlookups; i++) {
+        uint64_t k = (i * UINT64_C(2654435761)) % nkeys;
+        found += tree.get(byte_string(k * dist.second)) != nullptr;
+      }
+      bench::do_not_optimize(found);
+    });
+  }
+}
+
+#endif /* CONFLUO_BENCH_RADIX_TREE_BENCH_H_ */
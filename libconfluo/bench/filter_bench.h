@@ -0,0 +1,55 @@
+#ifndef CONFLUO_BENCH_FILTER_BENCH_H_
+#define CONFLUO_BENCH_FILTER_BENCH_H_
+
+#include "filter.h"
+#include "schema/schema.h"
+#include "benchmark.h"
+
+using namespace ::confluo;
+
+/**
+ * Updates a filter with runs of records in one time-block, as staged and
+ * batched appends do, with and without aggregates; a filter with aggregates
+ * also updates one entry per time-rollup level, so the difference between
+ * aggs=0 and aggs=1 is the per-update cost of the rollups and the filter's
+ * own aggregate
+ */
+CONFLUO_BENCHMARK(filter_update) {
+  struct rec {
+    int64_t ts;
+    int64_t val;
+  }__attribute__((packed));
+
+  schema_t schema(schema_builder().add_column(primitive_types::LONG_TYPE(), "val").get_columns());
+  auto snap = schema.snapshot();
+  const uint64_t n = ctx.scaled(1ULL << 20);
+  const size_t run_sizes[] = {1, 64};
+  std::vector<rec> recs(run_sizes[1]);
+  for (size_t i = 0; i < recs.size(); i++)
+    recs[i] = {0, static_cast<int64_t>(i)};
+
+  thread_manager::register_thread();
+  for (size_t naggs : {0, 1, 4}) {
+    for (size_t run_size : run_sizes) {
+      ctx.run_timed("aggs=" + std::to_string(naggs) + "/run=" + std::to_string(run_size), n,
+                    [&](bench::bench_timer &timer) {
+                      filter f;
+                      for (size_t i = 0; i < naggs; i++)
+                        f.add_aggregate(new aggregate_info("agg" + std::to_string(i),
+                                                           aggregate_manager::get_aggregator("sum"), 1));
+                      timer.start();
+                      for (uint64_t off = 0; off < n; off += run_size) {
+                        // A new time-block every 1024 records; no readers hold
+                        // older versions, so they are pruned as writers go
+                        auto time_block = static_cast<int64_t>(off / 1024);
+                        f.update(off * sizeof(rec), snap, recs.data(), run_size, time_block, sizeof(rec),
+                                 off * sizeof(rec));
+                      }
+                      timer.stop();
+                    });
+    }
+  }
+  thread_manager::deregister_thread();
+}
+
+#endif /* CONFLUO_BENCH_FILTER_BENCH_H_ */
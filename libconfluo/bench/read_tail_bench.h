@@ -0,0 +1,48 @@
+#ifndef CONFLUO_BENCH_READ_TAIL_BENCH_H_
+#define CONFLUO_BENCH_READ_TAIL_BENCH_H_
+
+#include <thread>
+
+#include "read_tail.h"
+#include "benchmark.h"
+
+using namespace ::confluo;
+
+/**
+ * Advances a read tail from several writer threads at once, each of which
+ * reserves its range from a shared write tail as data log appends do; one
+ * run per storage mode, since each mode flushes the tail differently
+ */
+CONFLUO_BENCHMARK(read_tail_advance) {
+  const uint32_t record_size = 64;
+  const uint64_t n = ctx.scaled(1ULL << 20);
+  std::pair<storage::storage_mode, std::string> modes[] = {
+      {storage::IN_MEMORY, "in_memory"},
+      {storage::DURABLE_RELAXED, "durable_relaxed"},
+      {storage::DURABLE, "durable"}
+  };
+  for (const auto &mode : modes) {
+    // Durable flushes are much slower; keep the run short
+    uint64_t ops = mode.first == storage::DURABLE ? std::max(n / 64, UINT64_C(1)) : n;
+    for (size_t nthreads : ctx.thread_counts()) {
+      ctx.run_timed("mode=" + mode.second + "/threads=" + std::to_string(nthreads), ops,
+                    [&](bench::bench_timer &timer) {
+                      read_tail rt("/tmp", mode.first);
+                      atomic::type<uint64_t> write_tail(0);
+                      std::vector<std::thread> writers;
+                      timer.start();
+                      for (size_t t = 0; t < nthreads; t++) {
+                        writers.push_back(std::thread([&, t] {
+                          for (uint64_t i = t; i < ops; i += nthreads)
+                            rt.advance(atomic::faa(&write_tail, static_cast<uint64_t>(record_size)), record_size);
+                        }));
+                      }
+                      for (auto &w : writers)
+                        w.join();
+                      timer.stop();
+                    });
+    }
+  }
+}
+
+#endif /* CONFLUO_BENCH_READ_TAIL_BENCH_H_ */
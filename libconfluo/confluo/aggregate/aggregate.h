@@ -2,6 +2,7 @@
 #define CONFLUO_AGGREGATE_H_
 
 #include <utility>
+#include <vector>
 #include "atomic.h"
 #include "threads/thread_manager.h"
 #include "aggregate_ops.h"
@@ -14,7 +15,10 @@ namespace confluo {
 class aggregate;
 
 /**
- * A node containing data about the aggregate 
+ * A node containing data about the aggregate. Besides the link to the
+ * previous (older) node, each node carries a skip link to an older node
+ * at a depth determined by its own depth, which allows versions to be
+ * looked up in logarithmic time.
  */
 struct aggregate_node {
 
@@ -28,8 +32,10 @@ struct aggregate_node {
    * @param agg The numeric containing the aggregate
    * @param version The version of the aggregate
    * @param next A pointer to the next aggregate
+   * @param skip A pointer to the older node at skip_depth(depth), if
+   * it is still retained
    */
-  aggregate_node(numeric agg, uint64_t version, aggregate_node *next);
+  aggregate_node(numeric agg, uint64_t version, aggregate_node *next, aggregate_node *skip = nullptr);
 
   /** 
    * @return The value of the aggregate
@@ -41,15 +47,48 @@ struct aggregate_node {
    */
   uint64_t version() const;
 
+  /**
+   * @return The number of nodes ever added before this one
+   */
+  uint64_t depth() const;
+
   /**
    * @return A pointer to the next aggregate
    */
   aggregate_node *next();
 
+  /**
+   * @return A pointer to the skip node, or nullptr if there is none
+   */
+  aggregate_node *skip();
+
+  /**
+   * @return The version of the skip node; only meaningful if there is one
+   */
+  uint64_t skip_version() const;
+
+  /**
+   * Sets the next node; the nodes it previously led to must no longer be
+   * reachable by readers.
+   * @param next A pointer to the next aggregate
+   */
+  void set_next(aggregate_node *next);
+
+  /**
+   * Gets the depth of the node that a node at the given depth skips to
+   *
+   * @param depth The depth of the node
+   * @return The depth of its skip node
+   */
+  static uint64_t skip_depth(uint64_t depth);
+
  private:
   numeric value_;
   uint64_t version_;
-  aggregate_node *next_;
+  uint64_t depth_;
+  atomic::type<aggregate_node *> next_;
+  aggregate_node *skip_;
+  uint64_t skip_version_;
 };
 
 /**
@@ -57,6 +96,9 @@ struct aggregate_node {
  */
 class aggregate_list {
  public:
+  /** Number of retained versions beyond which updates try to reclaim older ones */
+  static const uint64_t PRUNE_THRESHOLD = 64;
+
   /**
    * Default constructor that initializes an empty list of aggregates
    */
@@ -121,16 +163,28 @@ class aggregate_list {
    *
    * @param value The value with which the aggregate is to be updated.
    * @param version The aggregate version.
+   * @param floor The oldest version any reader may still request; older
+   * versions may be reclaimed. 0 disables reclamation.
    */
-  void comb_update(const numeric &value, uint64_t version);
+  void comb_update(const numeric &value, uint64_t version, uint64_t floor = 0);
 
   /**
    * Update the aggregate value with the given version, using the sequential operator.
    *
    * @param value The value with which the aggregate is to be updated.
    * @param version The aggregate version.
+   * @param floor The oldest version any reader may still request; older
+   * versions may be reclaimed. 0 disables reclamation.
    */
-  void seq_update(const numeric &value, uint64_t version);
+  void seq_update(const numeric &value, uint64_t version, uint64_t floor = 0);
+
+  /**
+   * Gets the number of versions currently retained in the list.
+   * Note: only safe to call from the updating thread.
+   *
+   * @return The number of retained versions
+   */
+  size_t num_versions() const;
 
  private:
   /**
@@ -141,7 +195,61 @@ class aggregate_list {
    */
   aggregate_node *get_node(aggregate_node *head, uint64_t version) const;
 
+  /**
+   * Find the first node from head with version smaller than or equal to
+   * version, following skip links; only valid if the list is sorted.
+   *
+   * @param head The head of the list.
+   * @param version The version being searched for.
+   * @return The node (if any), nullptr otherwise.
+   */
+  static aggregate_node *find_sorted(aggregate_node *head, uint64_t version);
+
+  /**
+   * Get the retained ancestor of a node at the given depth.
+   *
+   * @param node The node to start from.
+   * @param depth The depth of the ancestor; must not exceed the node's.
+   * @return The ancestor, or nullptr if it has been reclaimed.
+   */
+  aggregate_node *ancestor(aggregate_node *node, uint64_t depth) const;
+
+  /**
+   * Prepend a new node to the list.
+   *
+   * @param head The current head of the list.
+   * @param value The aggregate value for the node.
+   * @param version The version for the node.
+   */
+  void prepend(aggregate_node *head, const numeric &value, uint64_t version);
+
+  /**
+   * Reclaim all nodes older than the newest node with version at most
+   * floor, once enough versions have accumulated. Readers never request
+   * versions below floor, so they can never reach the reclaimed nodes.
+   *
+   * @param floor The oldest version any reader may still request.
+   */
+  void prune(uint64_t floor);
+
+  /**
+   * Free a chain of nodes.
+   *
+   * @param node The first node of the chain.
+   */
+  static void free_nodes(aggregate_node *node);
+
+  /**
+   * Copy all nodes from another list, preserving their order.
+   *
+   * @param other The other aggregate_list.
+   */
+  void copy_nodes(const aggregate_list &other);
+
   atomic::type<aggregate_node *> head_;
+  atomic::type<bool> sorted_;  // True if versions never increase from head to tail
+  uint64_t tail_depth_;        // Depth of the oldest retained node
+  uint64_t pruned_floor_;      // Floor used by the last reclamation
   aggregator agg_;
   data_type type_;
 };
@@ -161,9 +269,10 @@ class aggregate {
    *
    * @param type The type of the aggregate
    * @param agg The aggregate to initialize
-   * @param concurrency Max number of threads to run
+   * @param concurrency Max number of threads to run; by default one list
+   * for each thread id
    */
-  aggregate(const data_type &type, aggregator agg, int concurrency = thread_manager::get_max_concurrency());
+  aggregate(const data_type &type, aggregator agg, int concurrency = thread_manager::get_num_ids());
 
   /**
    * Initializes an aggregate from another aggregate
@@ -208,8 +317,9 @@ class aggregate {
    * @param thread_id The identifier for the thread
    * @param value The value to update to
    * @param version The version of the multilog
+   * @param floor The oldest version any reader may still request
    */
-  void seq_update(int thread_id, const numeric &value, uint64_t version);
+  void seq_update(int thread_id, const numeric &value, uint64_t version, uint64_t floor = 0);
 
   /**
    * A combinational update of an aggregate for a thread
@@ -217,8 +327,9 @@ class aggregate {
    * @param thread_id The identifier for a thread
    * @param value The value of the numeric
    * @param version The version of the multilog
+   * @param floor The oldest version any reader may still request
    */
-  void comb_update(int thread_id, const numeric &value, uint64_t version);
+  void comb_update(int thread_id, const numeric &value, uint64_t version, uint64_t floor = 0);
 
   /**
    * Gets the aggregate at the specified version
@@ -229,6 +340,16 @@ class aggregate {
    */
   numeric get(uint64_t version) const;
 
+  /**
+   * Gets the number of versions retained for a thread.
+   * Note: only safe to call when the thread is not updating.
+   *
+   * @param thread_id The identifier for the thread
+   *
+   * @return The number of retained versions
+   */
+  size_t num_versions(int thread_id) const;
+
  private:
   data_type type_;
   aggregator agg_;
@@ -63,8 +63,9 @@ class aggregated_reflog : public reflog {
    * @param aid aggregate id
    * @param value value to update with
    * @param version data log version
+   * @param floor oldest version readers may still request
    */
-  void seq_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version);
+  void seq_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version, uint64_t floor = 0);
 
   /**
    * Updates an aggregate. Assumes no contention with archiver calling swap_aggregates.
@@ -73,8 +74,9 @@ class aggregated_reflog : public reflog {
    * @param aid aggregate id
    * @param value value to update with
    * @param version data log version
+   * @param floor oldest version readers may still request
    */
-  void comb_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version);
+  void comb_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version, uint64_t floor = 0);
 
   /**
    * Gets the number of aggregates.
@@ -0,0 +1,117 @@
+#ifndef CONFLUO_APPEND_STAGER_H_
+#define CONFLUO_APPEND_STAGER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "atomic.h"
+#include "threads/thread_manager.h"
+
+namespace confluo {
+
+/**
+ * Stages single-record appends per thread, so that filters and indexes are
+ * updated once per run of consecutive records, with one reflog reservation
+ * and one aggregate update per filter and aggregate, instead of once per
+ * record.
+ *
+ * A thread's stage holds copies of records it has appended at consecutive
+ * data log offsets within one time block. The stage is applied when it is
+ * full, when the thread appends a record that does not extend the run, or
+ * when a reader, the monitor or the archiver flushes all stages. Any thread
+ * may apply a stage, under the stage's thread id: a thread's own updates to
+ * filters and indexes go through direct_update(), which applies its stage
+ * first under the same lock, so updates under one thread id never race.
+ *
+ * Records must be staged before the read tail is advanced past them, so
+ * that the visible tail never covers a record whose filters and indexes
+ * have not been updated.
+ */
+class append_stager {
+ public:
+  /** Maximum number of records in a stage */
+  static const size_t MAX_STAGED_RECORDS = 64;
+  /** Marks a stage that holds no records */
+  static const uint64_t NONE = UINT64_MAX;
+
+  /**
+   * Applies a run of staged records to filters and indexes
+   *
+   * @param offset The data log offset of the first record
+   * @param data The records
+   * @param nrecords The number of records
+   * @param time_block The time block of the records
+   * @param record_size The size of each record
+   * @param thread_id The thread id of the stage
+   */
+  typedef std::function<void(uint64_t offset, uint8_t *data, size_t nrecords, int64_t time_block, size_t record_size,
+                             int thread_id)> apply_fn;
+
+  /**
+   * Constructor
+   *
+   * @param apply The function that applies staged records
+   */
+  explicit append_stager(apply_fn apply);
+
+  /**
+   * Stages a record appended by a registered thread, applying the thread's
+   * stage first if the record does not extend it
+   *
+   * @param thread_id The thread id of the appending thread
+   * @param offset The data log offset of the record
+   * @param data The record
+   * @param time_block The time block of the record
+   * @param record_size The size of the record
+   */
+  void stage(int thread_id, uint64_t offset, const void *data, int64_t time_block, size_t record_size);
+
+  /**
+   * Applies every stage that holds records
+   */
+  void flush_all();
+
+  /**
+   * Updates filters and indexes for a thread outside its stage, applying the
+   * thread's stage first; both run under the stage's lock
+   *
+   * @param thread_id The thread id of the updating thread
+   * @param update The update
+   */
+  void direct_update(int thread_id, const std::function<void()> &update);
+
+  /**
+   * Gets the tail up to which staged records have all been applied
+   *
+   * @param tail The read tail, loaded before calling
+   * @return The smaller of the read tail and the offset of the oldest
+   * record staged but not applied
+   */
+  uint64_t visible(uint64_t tail) const;
+
+ private:
+  /** A thread's staged records */
+  struct stage_t {
+    std::mutex mtx;
+    std::vector<uint8_t> data;
+    uint64_t start;
+    size_t record_size;
+    size_t nrecords;
+    int64_t time_block;
+    /** Offset of the first staged record, NONE when empty */
+    atomic::type<uint64_t> pending;
+  };
+
+  void apply(int thread_id, stage_t &s);
+
+  apply_fn apply_;
+  std::unique_ptr<stage_t[]> stages_;
+  size_t num_stages_;
+};
+
+}
+
+#endif /* CONFLUO_APPEND_STAGER_H_ */
@@ -1,6 +1,8 @@
 #ifndef CONFLUO_ARCHIVAL_METADATA_H_
 #define CONFLUO_ARCHIVAL_METADATA_H_
 
+#include <vector>
+
 #include "types/byte_string.h"
 #include "io/incremental_file_reader.h"
 #include "io/incremental_file_writer.h"
@@ -127,6 +129,46 @@ class radix_tree_archival_metadata {
   size_t bucket_size_; // size of bucket
 };
 
+class zone_map_archival_metadata {
+ public:
+  /**
+   * Constructor.
+   * @param bucket_idx index of the data log bucket the bounds belong to
+   * @param bounds zone map bounds of the bucket
+   */
+  zone_map_archival_metadata(size_t bucket_idx, std::vector<uint64_t> bounds);
+
+  /**
+   * Read metadata from archives reader.
+   * @param reader archives reader
+   * @return metadata
+   */
+  static zone_map_archival_metadata read(incremental_file_reader &reader);
+
+  /**
+   * Append metadata to file.
+   * @param metadata archival metadata
+   * @param writer archives writer
+   */
+  static void append(const zone_map_archival_metadata &metadata, incremental_file_writer &writer);
+
+  /**
+   *
+   * @return index of the data log bucket the bounds belong to
+   */
+  size_t bucket_idx() const;
+
+  /**
+   *
+   * @return zone map bounds of the bucket, empty if it has none
+   */
+  const std::vector<uint64_t> &bounds() const;
+
+ private:
+  size_t bucket_idx_;
+  std::vector<uint64_t> bounds_;
+};
+
 }
 }
 
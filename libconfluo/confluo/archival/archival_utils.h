@@ -4,6 +4,7 @@
 #include "atomic.h"
 #include "types/primitive_types.h"
 #include "container/reflog.h"
+#include "threads/task_pool.h"
 
 namespace confluo {
 namespace archival {
@@ -30,6 +31,13 @@ class archival_utils {
    */
   static std::string index_archival_path(const std::string &index_log_path, size_t index_id);
 
+  /**
+   * Gets the pool that archivers of all multilogs share for compression and
+   * for archiving filters and indexes alongside the data log.
+   * @return archival worker pool
+   */
+  static task_pool &archival_pool();
+
   /**
    * Convenience method to swap a bucket pointer of a reflog.
    * @param refs reflog
@@ -8,6 +8,7 @@
 #include "index_log.h"
 #include "index_log_archiver.h"
 #include "read_tail.h"
+#include "zone_map_archiver.h"
 
 namespace confluo {
 namespace archival {
@@ -19,19 +20,22 @@ class atomic_multilog_archiver {
   /**
    * Constructor.
    * @param path directory to store archives in or where archives are currently stored
-   * @param rt data log read tail
+   * @param rt data log read tail, which a loaded multilog only initializes
+   * after building its archiver
    * @param log data log
    * @param filters atomic multilog filters
    * @param indexes atomic multilog indexes
    * @param schema data log schema
+   * @param zones data log zone maps
    * @param clear
    */
   atomic_multilog_archiver(const std::string &path,
-                           read_tail rt,
+                           const read_tail *rt,
                            data_log *log,
                            filter_log *filters,
                            index_log *indexes,
                            schema_t *schema,
+                           zone_map *zones,
                            bool clear = true);
 
   /**
@@ -66,13 +70,32 @@ class atomic_multilog_archiver {
    */
   std::string index_log_path();
 
+  /**
+   *
+   * @return path of directory in which zone map archives are stored
+   */
+  std::string zone_map_path();
+
+  /**
+   * Resume zone map archival from a data log offset, after a load.
+   * @param tail data log offset up to which zone maps have been archived
+   */
+  void set_zone_map_tail(size_t tail);
+
  private:
+  /**
+   * Gets the layout of data log records, for columnar encodings.
+   * @return record layout
+   */
+  columnar_layout layout() const;
+
   std::string path_;
-  read_tail rt_;
-  size_t record_size_;
+  const read_tail *rt_;
+  schema_t *schema_;
   data_log_archiver data_log_archiver_;
   filter_log_archiver filter_log_archiver_;
   index_log_archiver index_log_archiver_;
+  zone_map_archiver zone_map_archiver_;
 
 };
 
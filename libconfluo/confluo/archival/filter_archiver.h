@@ -54,8 +54,7 @@ class filter_archiver : public archiver {
    * @param key key to which reflog belongs to in radix_tree
    * @param reflog reflog to which bucket belongs
    * @param bucket reflog bucket starting at idx
-   * @param offset max data log offset in bucket
-   * @return reflog index to which bucket is archived
+   * @param offset data log offset past the last ref in bucket
    */
   void archive_bucket(byte_string key, reflog &refs, uint64_t *bucket, size_t offset);
 
@@ -67,6 +66,22 @@ class filter_archiver : public archiver {
    */
   void archive_reflog_aggregates(byte_string key, aggregated_reflog &reflog, size_t version);
 
+  /**
+   * Collapse the aggregates of rollup entries that only cover archived
+   * time-blocks, releasing their per-update versions.
+   * @param ts_block_end time-block below which all reflogs have been archived
+   * @param version version to get aggregates for
+   */
+  void archive_rollups(uint64_t ts_block_end, size_t version);
+
+  /**
+   * Replace the aggregates of an aggregated reflog with single-version
+   * aggregates holding their values at a version.
+   * @param reflog aggregated reflog
+   * @param version version to get aggregates for
+   */
+  void collapse_aggregates(aggregated_reflog &reflog, size_t version);
+
  private:
   monitor::filter *filter_;
   incremental_file_writer refs_writer_;
@@ -74,6 +89,7 @@ class filter_archiver : public archiver {
 
   size_t refs_tail_; // data in the current reflog up to this tail has been archived
   uint64_t ts_tail_; // reflogs in the filter up to this timestamp have been archived
+  uint64_t rollup_tails_[filter::NUM_ROLLUP_LEVELS]; // rollup entries below these keys have been collapsed
 
 };
 
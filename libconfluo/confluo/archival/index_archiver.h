@@ -56,7 +56,7 @@ class index_archiver : public archiver {
    * @param reflog reflog to which bucket belongs
    * @param idx reflog index at which bucket starts
    * @param bucket reflog bucket starting at idx
-   * @param offset max data log offset in bucket
+   * @param offset data log offset past the last ref in bucket
    * @return reflog index to which bucket is archived
    */
   size_t archive_bucket(byte_string key, reflog &refs, size_t idx, uint64_t *bucket, size_t offset);
@@ -12,8 +12,14 @@
 #include "index_archiver.h"
 #include "index_log.h"
 #include "monolog_linear_archiver.h"
+#include "planner/index_stats.h"
 #include "container/reflog.h"
 #include "storage/ptr_aux_block.h"
+#include "conf/configuration_params.h"
+#include "threads/task_pool.h"
+#include "threads/thread_manager.h"
+#include "zone_map_archiver.h"
+#include "logger.h"
 
 namespace confluo {
 namespace archival {
@@ -21,9 +27,70 @@ namespace archival {
 using namespace ::utils;
 using namespace storage;
 
+/**
+ * Tracks the progress of a data log replay, logging it at every tenth of
+ * the replayed bytes.
+ */
+class replay_progress {
+ public:
+  /**
+   * Constructor
+   * @param total_bytes total number of bytes to replay
+   */
+  explicit replay_progress(size_t total_bytes);
+
+  /**
+   * Record that a number of bytes have been replayed.
+   * @param bytes number of bytes replayed
+   */
+  void advance(size_t bytes);
+
+ private:
+  size_t total_;
+  atomic::type<size_t> done_;
+  atomic::type<size_t> reported_;
+};
+
 class load_utils {
 
  public:
+  /**
+   * A filter to replay the data log over, from a data log offset onwards.
+   */
+  struct filter_replay {
+    /** The filter */
+    monitor::filter *filter;
+    /** The data log offset to start replaying from */
+    size_t start_off;
+  };
+
+  /**
+   * An index to replay the data log over, from a data log offset onwards.
+   */
+  struct index_replay {
+    /** The index */
+    index::radix_index *index;
+    /** The schema field the index is on */
+    size_t field_idx;
+    /** The data log offset to start replaying from */
+    size_t start_off;
+    /** Statistics to sample the replayed keys into, if any */
+    planner::index_stats *stats;
+  };
+
+  /**
+   * Zone maps to replay the data log over, from a data log offset onwards.
+   */
+  struct zone_map_replay {
+    /** The zone maps, nullptr for none */
+    zone_map *zones;
+    /** The data log offset to start replaying from */
+    size_t start_off;
+  };
+
+  /** Maximum number of records read from the data log at once during replay */
+  static const size_t REPLAY_BATCH_RECORDS = 4096;
+
   /**
    * Load data log. Archived buckets are loaded first,
    * followed by durably written buckets if available.
@@ -39,6 +106,23 @@ class load_utils {
    */
   static void load_data_log_storage(data_log &log, size_t start_bucket_idx);
 
+  /**
+   * Load filter and index logs archived on disk, and replay remaining
+   * data from the data log over all filters, indexes and zone maps in a
+   * single pass.
+   * @param filter_path path to filter log data
+   * @param index_path path to index log data
+   * @param filters filter log to load/replay over
+   * @param indexes index log to load/replay over
+   * @param log data log to replay records from
+   * @param schema data log schema
+   * @param stats statistics of each index, sampled from the replayed records, if any
+   * @param zones zone maps to replay over, already loaded from disk
+   */
+  static void load_replay(const std::string &filter_path, const std::string &index_path, filter_log &filters,
+                          index_log &indexes, data_log &log, schema_t &schema,
+                          planner::index_stats_log *stats = nullptr, const zone_map_replay &zones = zone_map_replay());
+
   /**
    * Load filter log archived on disk and replay
    * remaining data from data log over the filters.
@@ -75,6 +159,52 @@ class load_utils {
    */
   static size_t load_index(const std::string &path, index::radix_index *index);
 
+  /**
+   * Load zone map bounds archived on disk.
+   * @param path path to data
+   * @param zones zone maps to load into
+   * @return data log offset up to which zone maps have been archived
+   */
+  static size_t load_zone_map(const std::string &path, zone_map &zones);
+
+  /**
+   * Replay the data log over a set of filters and indexes, and optionally
+   * zone maps, in a single pass. The data log is split into bucket-aligned
+   * ranges, each replayed by its own worker; records are grouped by time
+   * block and fed through the block update path of every filter, and index
+   * keys are inserted a batch at a time, grouped by key. Workers that
+   * replay filters run under thread ids reserved for maintenance work, so
+   * there are at most as many as there are reserved ids.
+   * @param log data log to replay from
+   * @param schema record schema
+   * @param filters filters to replay over
+   * @param indexes indexes to replay over
+   * @param num_threads maximum number of replay workers
+   * @param zones zone maps to replay over
+   */
+  static void replay(data_log &log, schema_t &schema, const std::vector<filter_replay> &filters,
+                     const std::vector<index_replay> &indexes,
+                     size_t num_threads = static_cast<size_t>(configuration_params::RECOVERY_THREADS()),
+                     const zone_map_replay &zones = zone_map_replay());
+
+  /**
+   * Backfill a set of filters and indexes added to a live multilog with the
+   * data log records below the handoff offset, in the same way as replay();
+   * records at or past the handoff are inserted by their writers. All records
+   * below the handoff must have been written.
+   * @param log data log to backfill from
+   * @param schema record schema
+   * @param filters filters to backfill
+   * @param indexes indexes to backfill
+   * @param handoff data log offset to stop backfilling at
+   * @param num_threads maximum number of backfill workers
+   * @param zones zone maps to backfill
+   */
+  static void backfill(data_log &log, schema_t &schema, const std::vector<filter_replay> &filters,
+                       const std::vector<index_replay> &indexes, size_t handoff,
+                       size_t num_threads = static_cast<size_t>(configuration_params::RECOVERY_THREADS()),
+                       const zone_map_replay &zones = zone_map_replay());
+
   /**
    * Replay data log over filter.
    * @param filter filter to replay over
@@ -87,13 +217,49 @@ class load_utils {
   /**
    * Replay data log over index.
    * @param index index to replay over
-   * @param id index id
+   * @param id schema field the index is on
    * @param log data log to replay from
    * @param schema record schema
    * @param start_off data log offset to start replaying from
    */
   static void replay_index(index::radix_index *index, uint16_t id, data_log &log, schema_t &schema, size_t start_off);
 
+ private:
+  /**
+   * Load the valid filters of a filter log archived on disk.
+   * @param path path to filter log data
+   * @param filters filter log to load
+   * @return the loaded filters with the data log offsets to replay them from
+   */
+  static std::vector<filter_replay> load_filters(const std::string &path, filter_log &filters);
+
+  /**
+   * Load the indexes of an index log archived on disk.
+   * @param path path to index log data
+   * @param indexes index log to load
+   * @param schema record schema
+   * @param stats statistics of each index, if any
+   * @return the loaded indexes with the data log offsets to replay them from
+   */
+  static std::vector<index_replay> load_indexes(const std::string &path, index_log &indexes, schema_t &schema,
+                                                planner::index_stats_log *stats = nullptr);
+
+  /**
+   * Replay a range of the data log over a set of filters, indexes and zone
+   * maps.
+   * @param log data log to replay from
+   * @param snap snapshot of the record schema
+   * @param record_size record size
+   * @param filters filters to replay over
+   * @param indexes indexes to replay over
+   * @param zones zone maps to replay over
+   * @param begin first data log offset to replay
+   * @param end data log offset to stop replaying at
+   * @param progress replay progress, advanced as records are replayed
+   */
+  static void replay_range(data_log &log, const schema_snapshot &snap, size_t record_size,
+                           const std::vector<filter_replay> &filters, const std::vector<index_replay> &indexes,
+                           const zone_map_replay &zones, size_t begin, size_t end, replay_progress &progress);
 };
 
 }
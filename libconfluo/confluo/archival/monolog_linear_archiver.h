@@ -1,12 +1,17 @@
 #ifndef CONFLUO_ARCHIVAL_MONOLOG_LINEAR_ARCHIVER_H_
 #define CONFLUO_ARCHIVAL_MONOLOG_LINEAR_ARCHIVER_H_
 
+#include <deque>
+#include <future>
+
 #include "compression/confluo_encoder.h"
 #include "archival_actions.h"
 #include "storage/allocator.h"
 #include "file_utils.h"
 #include "archival_metadata.h"
+#include "archival_utils.h"
 #include "archiver.h"
+#include "conf/configuration_params.h"
 #include "io/incremental_file_reader.h"
 #include "io/incremental_file_writer.h"
 #include "storage/ptr_aux_block.h"
@@ -38,49 +43,123 @@ class monolog_linear_archiver : public archiver {
   monolog_linear_archiver(const std::string &path, monolog *log)
       : writer_(path, "monolog_linear", archival_configuration_params::MAX_FILE_SIZE()),
         archival_tail_(0),
-        log_(log) {
+        log_(log),
+        layout_{0, {}} {
     writer_.close();
   }
 
   /**
    * Archive buckets from the archival tail to the bucket of the offset.
+   * Buckets are encoded in parallel on the archival pool, and written,
+   * committed and swapped in order as their encodings complete, so that
+   * writing a bucket overlaps encoding the ones after it. At most
+   * encode_window() buckets are in flight at a time.
    * @param offset monolog offset
    */
   void archive(size_t offset) {
     writer_.open();
     // TODO replace with bucket iterator later
-    storage::read_only_encoded_ptr<T> bucket_ptr;
-    while (archival_tail_ < offset) {
-      log_->ptr(archival_tail_, bucket_ptr);
-      T *data = bucket_ptr.get().template ptr_as<T>();
-      auto aux = ptr_aux_block::get(ptr_metadata::get(data));
-      if (aux.state_ != state_type::D_IN_MEMORY) {
-        archival_tail_ += BUCKET_SIZE;
-        continue;
-      }
-      if (log_->size() - archival_tail_ < BUCKET_SIZE) {
-        break;
-      }
-      archive_bucket(data);
-      archival_tail_ += BUCKET_SIZE;
+    std::deque<pending_bucket> pending;
+    try {
+      archive(offset, pending);
+    } catch (...) {
+      // Encodings still in flight read buckets that only pending keeps alive
+      for (pending_bucket &bucket : pending)
+        if (bucket.encoded.valid())
+          bucket.encoded.wait();
+      writer_.close();
+      throw;
     }
     writer_.close();
   }
+  /**
+   * Gets the number of buckets to encode ahead of the one being written.
+   * Archival under memory pressure encodes one bucket at a time, so that it
+   * holds at most one encoded copy of a bucket while freeing memory.
+   * @return number of buckets to keep in flight
+   */
+  static size_t encode_window() {
+    if (allocator::instance().memory_utilization() >= configuration_params::MAX_MEMORY())
+      return 1;
+    return std::max(archival_configuration_params::THREADS(), static_cast<size_t>(1));
+  }
 
   size_t tail() {
     return archival_tail_;
   }
 
+  /**
+   * Set the layout of the records in the monolog, which columnar encodings
+   * split buckets by. Records are laid out back to back from offset 0.
+   * @param layout record layout
+   */
+  void set_columnar_layout(const columnar_layout &layout) {
+    layout_ = layout;
+  }
+
  private:
+  /** A bucket queued for archival */
+  struct pending_bucket {
+    /** Keeps the bucket from being freed while it is encoded */
+    storage::read_only_encoded_ptr<T> ptr;
+    T *data;
+    /** The encoded bucket, if the bucket is still in memory */
+    std::future<unique_byte_array> encoded;
+  };
+
+  /**
+   * Archive buckets up to the bucket of the offset, leaving the buckets
+   * still in flight in pending if archival fails.
+   * @param offset monolog offset
+   * @param pending buckets in flight
+   */
+  void archive(size_t offset, std::deque<pending_bucket> &pending) {
+    size_t scan_tail = archival_tail_;
+    uint8_t encoding = archival_configuration_params::DATA_LOG_ENCODING_TYPE();
+    while (scan_tail < offset || !pending.empty()) {
+      size_t window = encode_window();
+      while (scan_tail < offset && pending.size() < window) {
+        pending_bucket bucket;
+        log_->ptr(scan_tail, bucket.ptr);
+        bucket.data = bucket.ptr.get().template ptr_as<T>();
+        auto aux = ptr_aux_block::get(ptr_metadata::get(bucket.data));
+        if (aux.state_ == state_type::D_IN_MEMORY) {
+          if (log_->size() - scan_tail < BUCKET_SIZE) {
+            offset = scan_tail;
+            break;
+          }
+          T *data = bucket.data;
+          size_t size = ptr_metadata::get(data)->data_size_;
+          size_t record_size = layout_.record_size;
+          size_t first_record = record_size == 0 ? 0 : (record_size - scan_tail % record_size) % record_size;
+          columnar_layout layout = layout_;
+          bucket.encoded = archival_utils::archival_pool().submit([data, size, encoding, layout, first_record] {
+            return confluo_encoder::encode(data, size, encoding, layout, first_record);
+          });
+        }
+        pending.push_back(std::move(bucket));
+        scan_tail += BUCKET_SIZE;
+      }
+      if (pending.empty())
+        break;
+
+      // Buckets archived already are only skipped over
+      pending_bucket &bucket = pending.front();
+      if (bucket.encoded.valid())
+        archive_bucket(bucket.data, bucket.encoded.get());
+      archival_tail_ += BUCKET_SIZE;
+      pending.pop_front();
+    }
+  }
+
   /**
    * Archive bucket and swap the pointer to the in-memory
    * bucket in the monolog with the archived version.
    * @param bucket bucket to archive
+   * @param encoded_bucket encoded bucket contents
    */
-  void archive_bucket(T *bucket) {
+  void archive_bucket(T *bucket, unique_byte_array encoded_bucket) {
     auto metadata = ptr_metadata::get(bucket);
-    auto encoded_bucket = confluo_encoder::encode(bucket, metadata->data_size_,
-                                                  archival_configuration_params::DATA_LOG_ENCODING_TYPE());
     size_t enc_size = encoded_bucket.size();
     auto off = writer_.append<ptr_metadata, uint8_t>(metadata, 1, encoded_bucket.get(), enc_size);
 
@@ -95,6 +174,7 @@ class monolog_linear_archiver : public archiver {
   incremental_file_writer writer_;
   size_t archival_tail_;
   monolog *log_;
+  columnar_layout layout_;
 
 };
 
@@ -0,0 +1,72 @@
+#ifndef CONFLUO_ARCHIVAL_ZONE_MAP_ARCHIVER_H_
+#define CONFLUO_ARCHIVAL_ZONE_MAP_ARCHIVER_H_
+
+#include "archival_actions.h"
+#include "archival_metadata.h"
+#include "conf/configuration_params.h"
+#include "container/zone_map.h"
+#include "io/incremental_file_reader.h"
+#include "io/incremental_file_writer.h"
+
+namespace confluo {
+namespace archival {
+
+/**
+ * Archives the zone map bounds of data log buckets, so that a loaded
+ * multilog can prune archived buckets without decoding them to rebuild
+ * their bounds.
+ */
+class zone_map_archiver {
+
+ public:
+  zone_map_archiver();
+
+  /**
+   * Constructor.
+   * @param path directory to archive in
+   * @param zones zone maps to archive
+   */
+  zone_map_archiver(const std::string &path, zone_map *zones);
+
+  /**
+   * Archive the bounds of every bucket all of whose records lie below a
+   * data log offset.
+   * @param offset data log offset
+   * @param record_size record size
+   */
+  void archive(size_t offset, size_t record_size);
+
+  /**
+   *
+   * @return data log offset up to which bucket bounds have been archived
+   */
+  size_t tail();
+
+  /**
+   * Resume archival from a data log offset, after a load.
+   * @param tail data log offset up to which bucket bounds have been archived
+   */
+  void set_tail(size_t tail);
+
+ private:
+  incremental_file_writer writer_;
+  size_t archival_tail_;
+  zone_map *zones_;
+
+};
+
+class zone_map_load_utils {
+ public:
+  /**
+   * Load the zone map bounds archived on disk.
+   * @param path path to data
+   * @param zones zone maps to load into
+   * @return data log offset up to which bucket bounds have been archived
+   */
+  static size_t load(const std::string &path, zone_map *zones);
+};
+
+}
+}
+
+#endif /* CONFLUO_ARCHIVAL_ZONE_MAP_ARCHIVER_H_ */
@@ -4,6 +4,7 @@
 #include <cmath>
 
 #include <functional>
+#include <map>
 #include <numeric>
 #include <thread>
 
@@ -15,6 +16,7 @@
 #include "trigger.h"
 #include "types/type_manager.h"
 #include "alert_index.h"
+#include "append_stager.h"
 #include "archival/atomic_multilog_archiver.h"
 #include "atomic_multilog_metadata.h"
 #include "conf/configuration_params.h"
@@ -24,6 +26,7 @@
 #include "container/monolog/monolog.h"
 #include "container/radix_tree.h"
 #include "container/string_map.h"
+#include "container/zone_map.h"
 #include "filter.h"
 #include "filter_log.h"
 #include "index_log.h"
@@ -34,6 +37,7 @@
 #include "parser/trigger_parser.h"
 #include "planner/query_planner.h"
 #include "read_tail.h"
+#include "version_tracker.h"
 #include "schema/column.h"
 #include "schema/record_batch.h"
 #include "schema/schema.h"
@@ -42,6 +46,7 @@
 #include "string_utils.h"
 #include "threads/periodic_task.h"
 #include "threads/task_pool.h"
+#include "threads/task_scheduler.h"
 
 /**
  * \mainpage libconfluo Documentation
@@ -128,9 +133,11 @@ class atomic_multilog {
    * @param path The path of the atomic multilog
    * @param mode The storage mode of the atomic multilog
    * @param pool The pool of tasks
+   * @param scheduler The scheduler that runs the periodic tasks of the multilog
    */
   atomic_multilog(const std::string &name, const std::vector<column_t> &schema, const std::string &path,
-                  const storage::storage_mode &s_mode, const archival_mode &a_mode, task_pool &pool);
+                  const storage::storage_mode &s_mode, const archival_mode &a_mode, task_pool &pool,
+                  task_scheduler &scheduler = task_scheduler::instance());
 
   /**
    * Initializes an atomic multilog from the given parameters
@@ -140,17 +147,21 @@ class atomic_multilog {
    * @param path The path to store multilog data
    * @param mode The storage mode of the multilog
    * @param pool The pool of tasks for the multilog
+   * @param scheduler The scheduler that runs the periodic tasks of the multilog
    */
   atomic_multilog(const std::string &name, const std::string &schema, const std::string &path,
-                  const storage::storage_mode &storage_mode, const archival_mode &a_mode, task_pool &pool);
+                  const storage::storage_mode &storage_mode, const archival_mode &a_mode, task_pool &pool,
+                  task_scheduler &scheduler = task_scheduler::instance());
 
   /**
    * Constructor that initializes atomic multilog from existing archives.
    * @param name The atomic multilog name
    * @param path The path of the atomic multilog
    * @param pool The pool of tasks
+   * @param scheduler The scheduler that runs the periodic tasks of the multilog
    */
-  atomic_multilog(const std::string &name, const std::string &path, task_pool &pool);
+  atomic_multilog(const std::string &name, const std::string &path, task_pool &pool,
+                  task_scheduler &scheduler = task_scheduler::instance());
 
   /**
    * Force archival of multilog up to the read tail.
@@ -158,19 +169,25 @@ class atomic_multilog {
   void archive();
 
   /**
-   * Force archival of multilog up to an offset.
+   * Force archival of multilog up to an offset, or up to the visible tail
+   * if that is smaller.
    * @param offset The offset into the data log at which the data is stored
    */
   void archive(size_t offset);
 
   // Management ops
   /**
-   * Adds index to the atomic multilog
+   * Adds index to the atomic multilog. Records already in the multilog are
+   * backfilled into the index while appends continue; the column is only
+   * marked indexed once the index covers the entire data log.
    * @param field_name The name of the field in the atomic multilog
    * @param bucket_size The size of the bucket
+   * @param type The kind of index; a hash index keeps wide columns such as
+   * strings shallow, but only serves equality lookups
    * @throw ex Management exception
    */
-  void add_index(const std::string &field_name, double bucket_size = configuration_params::INDEX_BUCKET_SIZE());
+  void add_index(const std::string &field_name, double bucket_size = configuration_params::INDEX_BUCKET_SIZE(),
+                 index_type_t type = RADIX_INDEX);
 
   /**
    * Removes index from the atomic multilog
@@ -188,7 +205,8 @@ class atomic_multilog {
   bool is_indexed(const std::string &field_name);
 
   /**
-   * Adds filter to the atomic multilog
+   * Adds filter to the atomic multilog. Records already in the multilog are
+   * backfilled into the filter while appends continue.
    * @param name The name of the filter
    * @param expr The expression to filter out elements in the atomic multilog
    * @throw ex Management exception
@@ -251,6 +269,46 @@ class atomic_multilog {
    */
   size_t append_batch(record_batch &batch);
 
+  /**
+   * Appends a batch of record blocks to the atomic multilog, copying each
+   * block's data straight into reserved data log space, without first
+   * gathering the blocks into a record batch. Blocks may straddle data log
+   * buckets.
+   *
+   * @tparam BLOCKS Container of blocks, each exposing time_block and its
+   * serialized records as a std::string data
+   * @param blocks The record blocks
+   * @throw invalid_operation_exception If the length of a block is not a
+   * multiple of the record size
+   * @return The offset where the batch is located
+   */
+  template<typename BLOCKS>
+  size_t append_blocks(const BLOCKS &blocks) {
+    size_t record_size = schema_.record_size();
+    size_t batch_bytes = 0;
+    for (const auto &block : blocks) {
+      if (block.data.length() % record_size != 0)
+        THROW(invalid_operation_exception, "Record block length " + std::to_string(block.data.length())
+            + " is not a multiple of the record size " + std::to_string(record_size));
+      batch_bytes += block.data.length();
+    }
+
+    size_t log_offset = data_log_.reserve(batch_bytes);
+    pre_alloc_buckets(log_offset, batch_bytes);
+    size_t cur_offset = log_offset;
+    for (const auto &block : blocks) {
+      size_t block_bytes = block.data.length();
+      data_log_.write(cur_offset, reinterpret_cast<const uint8_t *>(block.data.data()), block_bytes);
+      update_aux_logged_block(cur_offset, block_bytes / record_size, static_cast<int64_t>(block.time_block),
+                              record_size);
+      cur_offset += block_bytes;
+    }
+
+    data_log_.flush(log_offset, batch_bytes);
+    rt_.advance(log_offset, static_cast<uint32_t>(batch_bytes));
+    return log_offset;
+  }
+
   /**
    * Appends data to the atomic multilog
    * @param data The data to be stored
@@ -322,6 +380,21 @@ class atomic_multilog {
    */
   std::unique_ptr<record_cursor> execute_filter(const std::string &expr) const;
 
+  /**
+   * Gets the query plan that executing the filter expression would use
+   * @param expr The filter expression
+   * @return A string representation of the query plan
+   */
+  std::string explain_filter(const std::string &expr) const;
+
+  /**
+   * Replaces the cost model the query planner uses to choose between index
+   * lookups and a full scan. Queries already being planned keep the model
+   * they started with.
+   * @param model The cost model
+   */
+  void set_query_cost_model(std::shared_ptr<planner::cost_model> model);
+
   // TODO: Add tests
   /**
    * Executes an aggregate
@@ -405,7 +478,18 @@ class atomic_multilog {
    */
   size_t record_size() const;
 
+  /**
+   * Gets the statistics on the runs of the multilog's periodic tasks,
+   * including the runs that overshot their intervals
+   * @return The statistics of the archival, prealloc and monitor tasks, by
+   * task name
+   */
+  std::map<std::string, task_scheduler::task_stats> task_stats() const;
+
  protected:
+  /** The period of the task allocating data log buckets ahead of the tail */
+  static const uint64_t PREALLOC_PERIODICITY_MS = 100;
+
   /**
    * Load multilog from archives. Expects metadata to be loaded
    * and archiver to be initialized.
@@ -430,14 +514,115 @@ class atomic_multilog {
    */
   void update_aux_record_block(uint64_t log_offset, record_block &block, size_t record_size);
 
+  /**
+   * Updates filters and indexes with consecutive records that share a time
+   * block
+   * @param log_offset The offset of the first record in the data log
+   * @param data Pointer to the first record
+   * @param nrecords The number of records
+   * @param time_block The time block of the records
+   * @param record_size The size of each record
+   * @param thread_id The id to update aggregates with
+   */
+  void update_aux_record_block(uint64_t log_offset, void *data, size_t nrecords, int64_t time_block,
+                               size_t record_size, int thread_id);
+
+  /**
+   * Updates filters and indexes with consecutive records that share a time
+   * block and have already been written to the data log, reading them
+   * from the data log; a record that straddles a bucket boundary is
+   * copied out first. The calling thread's staged appends are applied
+   * before it
+   * @param log_offset The offset of the first record in the data log
+   * @param nrecords The number of records
+   * @param time_block The time block of the records
+   * @param record_size The size of each record
+   */
+  void update_aux_logged_block(uint64_t log_offset, size_t nrecords, int64_t time_block, size_t record_size);
+
+  /**
+   * Updates filters and indexes with consecutive records already written to
+   * the data log, for update_aux_logged_block
+   * @param log_offset The offset of the first record in the data log
+   * @param nrecords The number of records
+   * @param time_block The time block of the records
+   * @param record_size The size of each record
+   * @param thread_id The id to update aggregates with
+   */
+  void update_aux_logged_run(uint64_t log_offset, size_t nrecords, int64_t time_block, size_t record_size,
+                             int thread_id);
+
+  /**
+   * Gets the index a writer must insert a record into for a column; a
+   * column that is being indexed only receives records past its backfill
+   * handoff from writers
+   * @param snap The schema snapshot taken by the writer
+   * @param i The index of the column
+   * @param offset The data log offset of the record
+   * @return The index, or nullptr if the record must not be inserted
+   */
+  radix_index *writer_index(const schema_snapshot &snap, size_t i, size_t offset);
+
+  /**
+   * Gets the statistics of the index a writer inserts a record into for a
+   * column, if the record is sampled
+   * @param snap The schema snapshot taken by the writer
+   * @param i The index of the column
+   * @param offset The data log offset of the record
+   * @return The statistics, or nullptr if the record is not sampled
+   */
+  index_stats *writer_stats(const schema_snapshot &snap, size_t i, size_t offset);
+
+  /**
+   * Checks whether a writer must update a filter with a record
+   * @param f The filter
+   * @param offset The data log offset of the record
+   * @return True if the filter is valid and the record is past its backfill
+   * handoff, false otherwise
+   */
+  bool writer_updates(filter *f, size_t offset);
+
+  /**
+   * Gets the number of leading records of a run that lie below a resolved
+   * backfill handoff, and are left to the backfill
+   * @param handoff The handoff, resolved to cover the last record of the run
+   * @param offset The data log offset of the first record of the run
+   * @param record_size The size of each record
+   * @return The number of records to skip
+   */
+  static size_t writer_skip(const backfill_handoff &handoff, size_t offset, size_t record_size);
+
+  /**
+   * Fixes the handoff offset of a backfill, and waits for all records below
+   * it to be written
+   * @param handoff The backfill handoff
+   * @return The handoff offset
+   */
+  size_t await_handoff(backfill_handoff &handoff);
+
+  /**
+   * Backfills a newly added index with the records below its handoff, and
+   * marks the column indexed
+   * @param field_name The name of the indexed field
+   */
+  void backfill_index(const std::string &field_name);
+
+  /**
+   * Backfills a newly added filter with the records below its handoff
+   * @param name The name of the filter
+   */
+  void backfill_filter(const std::string &name);
+
   /**
    * Adds an index to the schema for a given field
    *
    * @param field_name The name of the field to index
    * @param bucket_size The bucket_size used for indexing
+   * @param type The kind of index
    * @param ex The exception when the index could not be added
    */
-  void add_index_task(const std::string &field_name, double bucket_size, optional<management_exception> &ex);
+  void add_index_task(const std::string &field_name, double bucket_size, index_type_t type,
+                      optional<management_exception> &ex);
 
   /**
    * Removes an index for a given field in the schema
@@ -508,6 +693,29 @@ class atomic_multilog {
    */
   void remove_trigger_task(const std::string &name, optional<management_exception> &ex);
 
+  /**
+   * Applies all staged appends and gets the tail up to which records are
+   * visible to queries, with their filters and indexes updated
+   *
+   * @return The visible tail
+   */
+  uint64_t visible_tail() const;
+
+  /**
+   * Schedules allocation of the data log buckets ahead of the tail, once a
+   * reservation moves the tail past the middle of a bucket. Keeps writers
+   * from allocating and zeroing buckets when they first reach them.
+   *
+   * @param offset The offset of the reservation
+   * @param len The length of the reservation
+   */
+  void pre_alloc_buckets(size_t offset, size_t len);
+
+  /**
+   * Allocates the data log buckets ahead of the tail
+   */
+  void prealloc_task();
+
   /**
    * Archives until only a configured number of bytes
    * of the data log are resident in memory.
@@ -519,16 +727,24 @@ class atomic_multilog {
    */
   void monitor_task();
 
+  /** Window aggregates already computed for one aggregate, keyed by window */
+  typedef std::map<std::pair<uint64_t, uint64_t>, optional<numeric>> window_cache;
+
   /**
-   * Checks the time bucket and adds alerts when necessary
+   * Checks a trigger against its aggregate over a window and adds an alert,
+   * keyed by the start of the window, when necessary
    *
-   * @param f The filter 
+   * @param f The filter
+   * @param aid The identifier of the trigger's aggregate within the filter
    * @param t The trigger
-   * @param tid The thread identifier
-   * @param time_bucket The time_bucket to check
+   * @param begin_ms The start of the window
+   * @param end_ms The end of the window, exclusive
    * @param version The version to check
+   * @param windows The window aggregates computed so far for the aggregate,
+   * shared by its triggers
    */
-  void check_time_bucket(filter *f, trigger *t, size_t tid, uint64_t time_bucket, uint64_t version);
+  void check_window(filter *f, size_t aid, trigger *t, uint64_t begin_ms, uint64_t end_ms, uint64_t version,
+                    window_cache &windows);
 
   /** The name of the multilog */
   std::string name_;
@@ -539,6 +755,10 @@ class atomic_multilog {
   data_log_type data_log_;
   /** The read tail */
   read_tail_type rt_;
+  /** The oldest version that in-flight readers may still request */
+  version_tracker read_versions_;
+  /** Per-thread stages of single-record appends, applied in runs */
+  mutable append_stager stager_;
   /** The metadata associated with the multilog */
   metadata_writer_type metadata_;
 
@@ -547,6 +767,10 @@ class atomic_multilog {
   filter_log filters_;
   /** The list of indexes */
   index_log indexes_;
+  /** Statistics on the keys of each index, by index id */
+  index_stats_log index_stats_;
+  /** Bounds of the numeric columns in each data log bucket and zone */
+  zone_map zone_map_;
   /** The list of alerts */
   alert_index alerts_;
 
@@ -562,8 +786,15 @@ class atomic_multilog {
 
   // Archival
   atomic_multilog_archiver archiver_;
+  /** Serializes archival runs */
+  std::mutex archival_mtx_;
   periodic_task archival_task_;
-  task_pool archival_pool_;
+
+  // Allocation
+  /** The number of data log buckets allocated ahead of the tail */
+  size_t prealloc_buckets_;
+  /** The task that allocates data log buckets ahead of the tail */
+  periodic_task prealloc_task_;
 
   // Manangement
   /** The pool of tasks */
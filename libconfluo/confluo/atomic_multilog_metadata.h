@@ -34,7 +34,9 @@ enum metadata_type
   /** Metadata for storage mode */
       D_STORAGE_MODE_METADATA = 5,
   /** Metadata for archival mode */
-      D_ARCHIVAL_MODE_METADATA = 6
+      D_ARCHIVAL_MODE_METADATA = 6,
+  /** Metadata for an index of a type other than the radix index */
+      D_TYPED_INDEX_METADATA = 7
 };
 
 /**
@@ -47,8 +49,9 @@ struct index_metadata {
    *
    * @param field_name The field_name to create an index for
    * @param bucket_size The bucket_size for lookup
+   * @param type The kind of index
    */
-  index_metadata(const std::string &field_name, double bucket_size);
+  index_metadata(const std::string &field_name, double bucket_size, index_type_t type = RADIX_INDEX);
 
   /**
    * Gets the field name
@@ -64,9 +67,17 @@ struct index_metadata {
    */
   double bucket_size() const;
 
+  /**
+   * Gets the kind of index
+   *
+   * @return The index type
+   */
+  index_type_t index_type() const;
+
  private:
   std::string field_name_;
   double bucket_size_;
+  index_type_t index_type_;
 };
 
 /**
@@ -249,12 +260,14 @@ class metadata_writer {
   void write_schema(const schema_t &schema);
 
   /**
-   * Writes metadata about an index
+   * Writes metadata about an index; radix indexes are written in the
+   * untyped format, so that older readers can still load them
    *
    * @param name The name of the index
    * @param bucket_size The bucket_size used for lookup
+   * @param type The kind of index
    */
-  void write_index_metadata(const std::string &name, double bucket_size);
+  void write_index_metadata(const std::string &name, double bucket_size, index_type_t type);
 
   /**
    * Writes the metadata for a specified filter
@@ -324,12 +337,19 @@ class metadata_reader {
   schema_t next_schema();
 
   /**
-   * Reads the next metadata for an index
+   * Reads the next metadata for a radix index
    *
    * @return The index metadata that was read
    */
   index_metadata next_index_metadata();
 
+  /**
+   * Reads the next metadata for an index along with its type
+   *
+   * @return The index metadata that was read
+   */
+  index_metadata next_typed_index_metadata();
+
   /**
    * Reads the next metadata for a filter
    *
@@ -0,0 +1,114 @@
+#ifndef CONFLUO_BACKFILL_HANDOFF_H_
+#define CONFLUO_BACKFILL_HANDOFF_H_
+
+#include <cstdint>
+
+#include "atomic.h"
+
+namespace confluo {
+
+/**
+ * The data log offset at which writers take over from a backfill of an index
+ * or filter that was added to a populated multilog.
+ *
+ * Records below the handoff offset are inserted by the backfill, and records
+ * at or above it by the writers that appended them, so that every record is
+ * inserted exactly once. The offset is fixed by the first thread, writer or
+ * backfill, to observe the published handoff: it is the data log tail as
+ * read after publishing, so any writer that reserved space at or past it
+ * must also observe the published handoff. A handoff of 0 covers the entire
+ * data log.
+ */
+class backfill_handoff {
+ public:
+  /** No structure has been published; writers must skip it */
+  static const uint64_t UNPUBLISHED;
+  /** The structure has been published, but the handoff offset is not fixed */
+  static const uint64_t PENDING;
+
+  /**
+   * Constructs a handoff at the given offset
+   *
+   * @param offset The handoff offset
+   */
+  explicit backfill_handoff(uint64_t offset = 0);
+
+  /**
+   * Constructs a handoff from another handoff
+   *
+   * @param other The other handoff
+   */
+  backfill_handoff(const backfill_handoff &other);
+
+  /**
+   * Assigns another handoff to this handoff
+   *
+   * @param other The other handoff
+   *
+   * @return This handoff
+   */
+  backfill_handoff &operator=(const backfill_handoff &other);
+
+  /**
+   * Gets the handoff offset, or one of UNPUBLISHED and PENDING
+   *
+   * @return The handoff offset
+   */
+  uint64_t get() const;
+
+  /**
+   * Publishes the structure to writers, leaving the offset to be fixed
+   */
+  void publish();
+
+  /**
+   * Fixes the handoff offset if it is pending
+   *
+   * @param tail The data log tail, read after observing the handoff pending
+   *
+   * @return The handoff offset
+   */
+  uint64_t resolve(uint64_t tail);
+
+  /**
+   * Checks whether a record must be inserted by its writer
+   *
+   * @tparam TAIL_FN Type of the function reading the data log tail
+   * @param offset The data log offset of the record
+   * @param tail_fn The function reading the data log tail, used only if the
+   * handoff offset is yet to be fixed
+   *
+   * @return True if the record lies at or past the handoff offset
+   */
+  template<typename TAIL_FN>
+  bool covers(uint64_t offset, TAIL_FN tail_fn) {
+    uint64_t handoff = get();
+    if (handoff == PENDING)
+      handoff = resolve(tail_fn());
+    return offset >= handoff;
+  }
+
+  /**
+   * Marks the backfill as complete, handing the entire data log to writers
+   */
+  void complete();
+
+  /**
+   * Checks whether writers cover the entire data log
+   *
+   * @return True if the backfill is complete, false otherwise
+   */
+  bool is_complete() const;
+
+  /**
+   * Withdraws the structure from writers
+   */
+  void reset();
+
+ private:
+  atomic::type<uint64_t> offset_;
+};
+
+}
+
+#endif /* CONFLUO_BACKFILL_HANDOFF_H_ */
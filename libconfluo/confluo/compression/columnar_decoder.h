@@ -0,0 +1,122 @@
+#ifndef CONFLUO_COMPRESSION_COLUMNAR_DECODER_H_
+#define CONFLUO_COMPRESSION_COLUMNAR_DECODER_H_
+
+#include <cstdint>
+#include <cstddef>
+
+#include "compression/columnar_encoder.h"
+
+namespace confluo {
+namespace compression {
+
+/**
+ * A stateless decoder for buckets encoded by the columnar_encoder. Decodes
+ * byte ranges of the bucket back into rows, or single columns of a range of
+ * records, so that scans can read only the columns they need. Frame of
+ * reference and dictionary coded values are decoded in place; LZ4 coded
+ * values only inflate the blocks that hold them, and keep them in the
+ * shared lz4_block_cache.
+ */
+class columnar_decoder {
+ public:
+  /**
+   * Gets the size of the decoded bucket
+   *
+   * @param encoded The encoded bucket
+   * @return The size of the decoded bucket in bytes
+   */
+  static size_t decoded_size(const uint8_t *encoded);
+
+  /**
+   * Gets the offset of the first whole record in the bucket
+   *
+   * @param encoded The encoded bucket
+   * @return The offset of the first whole record
+   */
+  static size_t first_record(const uint8_t *encoded);
+
+  /**
+   * Gets the number of whole records in the bucket
+   *
+   * @param encoded The encoded bucket
+   * @return The number of whole records
+   */
+  static size_t num_records(const uint8_t *encoded);
+
+  /**
+   * Gets the number of columns in the bucket; bytes of a record outside of
+   * the layout's columns make up columns of their own
+   *
+   * @param encoded The encoded bucket
+   * @return The number of columns
+   */
+  static size_t num_columns(const uint8_t *encoded);
+
+  /**
+   * Gets the descriptor of a column
+   *
+   * @param encoded The encoded bucket
+   * @param col The index of the column
+   * @return The descriptor of the column
+   */
+  static column_chunk column(const uint8_t *encoded, size_t col);
+
+  /**
+   * Gets the smallest value of a column, if the bucket has any records
+   *
+   * @param encoded The encoded bucket
+   * @param col The index of the column
+   * @return Pointer to the width bytes of the value
+   */
+  static const uint8_t *column_min(const uint8_t *encoded, size_t col);
+
+  /**
+   * Gets the largest value of a column, if the bucket has any records
+   *
+   * @param encoded The encoded bucket
+   * @param col The index of the column
+   * @return Pointer to the width bytes of the value
+   */
+  static const uint8_t *column_max(const uint8_t *encoded, size_t col);
+
+  /**
+   * Decodes the values of a column for a range of records
+   *
+   * @param encoded The encoded bucket
+   * @param col The index of the column
+   * @param buffer The buffer to fill with count values of the column's width
+   * @param first The index of the first record
+   * @param count The number of records
+   */
+  static void decode_column(const uint8_t *encoded, size_t col, uint8_t *buffer, size_t first, size_t count);
+
+  /**
+   * Decodes a range of bytes of the bucket
+   *
+   * @param encoded The encoded bucket
+   * @param buffer The buffer to fill with the decoded bytes
+   * @param start The offset of the first byte in the bucket
+   * @param len The number of bytes
+   */
+  static void decode(const uint8_t *encoded, uint8_t *buffer, size_t start, size_t len);
+
+  /**
+   * Decodes a byte of the bucket
+   *
+   * @param encoded The encoded bucket
+   * @param idx The offset of the byte in the bucket
+   * @return The decoded byte
+   */
+  static uint8_t decode(const uint8_t *encoded, size_t idx);
+
+ private:
+  static columnar_header header(const uint8_t *encoded);
+
+  static void decode_raw(const uint8_t *encoded, const columnar_header &h, uint8_t *buffer, size_t start,
+                         size_t len);
+};
+
+}
+}
+
+#endif /* CONFLUO_COMPRESSION_COLUMNAR_DECODER_H_ */
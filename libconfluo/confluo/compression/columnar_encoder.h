@@ -0,0 +1,148 @@
+#ifndef CONFLUO_COMPRESSION_COLUMNAR_ENCODER_H_
+#define CONFLUO_COMPRESSION_COLUMNAR_ENCODER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "container/unique_byte_array.h"
+
+namespace confluo {
+namespace compression {
+
+/**
+ * Kinds of column values, which decide the codecs that apply to a column
+ * and how its min/max are ordered.
+ */
+typedef struct column_kind {
+  static const uint8_t D_SIGNED = 0;
+  static const uint8_t D_UNSIGNED = 1;
+  static const uint8_t D_FLOAT = 2;
+  static const uint8_t D_BYTES = 3;
+} column_kind;
+
+/**
+ * Codecs for a column chunk.
+ */
+typedef struct column_codec {
+  /** Frame of reference: offsets from the chunk minimum, bit-packed */
+  static const uint8_t D_FOR = 0;
+  /** Sorted dictionary of distinct values, with bit-packed codes */
+  static const uint8_t D_DICTIONARY = 1;
+  /** LZ4 over the column's values */
+  static const uint8_t D_LZ4 = 2;
+} column_codec;
+
+/**
+ * A fixed-width field of a record.
+ */
+struct column_spec {
+  /** Offset of the field within the record */
+  uint32_t offset;
+  /** Width of the field in bytes */
+  uint32_t width;
+  /** Kind of the field's values */
+  uint8_t kind;
+};
+
+/**
+ * The layout of the fixed-width records in a bucket. An empty layout has
+ * no records, and leaves the bucket to LZ4.
+ */
+struct columnar_layout {
+  /** The size of a record in bytes */
+  size_t record_size;
+  /** The fields of a record */
+  std::vector<column_spec> columns;
+};
+
+/**
+ * Header of a columnar-encoded bucket. Each column of the whole records in
+ * the bucket is a chunk described by a column_chunk that follows the header.
+ * Bytes outside of whole records, at either end of the bucket, are kept
+ * LZ4-encoded at raw_offset.
+ */
+struct columnar_header {
+  /** The size of the decoded bucket in bytes */
+  uint64_t decoded_size;
+  /** Offset of the first whole record in the bucket */
+  uint64_t first_record;
+  /** Number of whole records in the bucket */
+  uint64_t num_records;
+  /** The size of a record in bytes */
+  uint64_t record_size;
+  /** Number of column chunks */
+  uint64_t num_columns;
+  /** Offset of the LZ4-encoded bytes outside of whole records */
+  uint64_t raw_offset;
+};
+
+/**
+ * Describes the chunk holding one column of a columnar-encoded bucket. The
+ * chunk's data starts with its min and max values, each padded to a word,
+ * followed by the codec's payload. LZ4 payloads are split into blocks of
+ * columnar_encoder::LZ4_BLOCK_RECORDS values, so that reading a few records
+ * only inflates the blocks holding them.
+ */
+struct column_chunk {
+  /** Offset of the field within the record */
+  uint32_t offset;
+  /** Width of the field in bytes */
+  uint32_t width;
+  /** Kind of the field's values */
+  uint8_t kind;
+  /** The codec of the chunk */
+  uint8_t codec;
+  /** Bits per packed value, for frame of reference and dictionary codes */
+  uint8_t bit_width;
+  uint8_t pad[5];
+  /** Frame of reference base */
+  uint64_t base;
+  /** Number of dictionary entries */
+  uint64_t dictionary_size;
+  /** Offset of the chunk's data in the encoded bucket */
+  uint64_t data_offset;
+};
+
+/**
+ * Encodes buckets of fixed-width records column by column: records are
+ * transposed into one chunk per field, and each chunk picks its codec.
+ * Integers are frame-of-reference coded and bit-packed, low-cardinality
+ * byte fields are dictionary coded, and all else falls back to LZ4.
+ */
+class columnar_encoder {
+ public:
+  /** Maximum number of dictionary entries for a chunk */
+  static const size_t MAX_DICTIONARY_SIZE = 65536;
+  /** Number of values per LZ4 block of a chunk */
+  static const size_t LZ4_BLOCK_RECORDS = 1024;
+
+  /**
+   * Encodes a bucket of records.
+   *
+   * @param ptr The bucket
+   * @param size The size of the bucket in bytes
+   * @param layout The layout of the records; bytes of a record that no
+   * column covers are encoded as byte columns of their own
+   * @param first_record Offset of the first whole record in the bucket
+   * @return The encoded bucket
+   */
+  static unique_byte_array encode(uint8_t *ptr, size_t size, const columnar_layout &layout, size_t first_record);
+
+ private:
+  static std::vector<column_spec> cover(const columnar_layout &layout);
+
+  static void encode_chunk(const uint8_t *records, size_t num_records, size_t record_size, column_chunk &chunk,
+                           std::vector<uint8_t> &out);
+
+  static bool encode_for(const std::vector<uint64_t> &values, column_chunk &chunk, std::vector<uint8_t> &out);
+
+  static bool encode_dictionary(const uint8_t *values, size_t num_values, column_chunk &chunk,
+                                std::vector<uint8_t> &out);
+
+  static void encode_lz4(const uint8_t *values, size_t num_values, size_t width, std::vector<uint8_t> &out);
+};
+
+}
+}
+
+#endif /* CONFLUO_COMPRESSION_COLUMNAR_ENCODER_H_ */
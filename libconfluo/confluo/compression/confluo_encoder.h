@@ -1,6 +1,7 @@
 #ifndef CONFLUO_COMPRESSION_CONFLUO_ENCODER_H_
 #define CONFLUO_COMPRESSION_CONFLUO_ENCODER_H_
 
+#include "columnar_encoder.h"
 #include "delta_encoder.h"
 #include "lz4_encoder.h"
 #include "exceptions.h"
@@ -23,6 +24,19 @@ class confluo_encoder {
    */
   static unique_byte_array encode(void *ptr, size_t size, uint8_t encoding);
 
+  /**
+   * Encode pointer to a bucket of records. Columnar encodings split the
+   * records into columns by the layout; other encodings ignore it.
+   * @param ptr unencoded data pointer, allocated by the storage allocator.
+   * @param size size of unencoded data in bytes
+   * @param encoding encoding type
+   * @param layout layout of the records
+   * @param first_record offset of the first whole record in the bucket
+   * @return pointer to raw encoded data
+   */
+  static unique_byte_array encode(void *ptr, size_t size, uint8_t encoding, const columnar_layout &layout,
+                                  size_t first_record);
+
  private:
   /**
    * No-op deleter.
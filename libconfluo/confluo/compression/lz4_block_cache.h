@@ -0,0 +1,117 @@
+#ifndef CONFLUO_COMPRESSION_LZ4_BLOCK_CACHE_H_
+#define CONFLUO_COMPRESSION_LZ4_BLOCK_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "compression/lz4_decoder.h"
+
+namespace confluo {
+namespace compression {
+
+/**
+ * A small, direct-mapped cache of decoded blocks from LZ4 encoded buffers,
+ * shared by all readers so that reads on neighboring offsets of an archived
+ * bucket only inflate each block once. Columnar buckets cache the LZ4
+ * blocks of their columns here as well.
+ */
+class lz4_block_cache {
+ public:
+  /** Number of bytes per decoded block */
+  static const size_t BLOCK_SIZE = 65536;
+  /** Number of cached blocks */
+  static const size_t NUM_SLOTS = 64;
+
+  /** Type definition for a decoded block */
+  typedef std::shared_ptr<uint8_t> block_ptr;
+
+  /**
+   * Gets the shared block cache instance
+   *
+   * @return The block cache
+   */
+  static lz4_block_cache &instance();
+
+  /**
+   * Gets a decoded block, decoding it on a miss
+   *
+   * @param encoded The LZ4 encoded buffer
+   * @param block_idx The index of the block
+   * @return The decoded block
+   */
+  block_ptr get(uint8_t *encoded, size_t block_idx);
+
+  /**
+   * Gets a decoded block of an encoded buffer with its own block format,
+   * decoding it on a miss
+   *
+   * @param encoded The encoded buffer
+   * @param block_idx The index of the block, unique within the buffer
+   * @param size The size of the decoded block in bytes
+   * @param decode_fn Decodes the block into a buffer of size bytes
+   * @return The decoded block
+   */
+  template<typename DECODE_FN>
+  block_ptr get(const uint8_t *encoded, size_t block_idx, size_t size, DECODE_FN decode_fn) {
+    slot &s = slot_for(encoded, block_idx);
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      if (s.encoded == encoded && s.block_idx == block_idx && s.block != nullptr)
+        return s.block;
+    }
+
+    // Decode outside the lock; concurrent misses on the same block are benign
+    block_ptr block(new uint8_t[size], std::default_delete<uint8_t[]>());
+    decode_fn(block.get());
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.encoded = encoded;
+    s.block_idx = block_idx;
+    s.block = block;
+    return block;
+  }
+
+  /**
+   * Decodes a length number of bytes from the src_index position in the
+   * encoded buffer, inflating only the blocks covering the range
+   *
+   * @param encoded The LZ4 encoded buffer
+   * @param dest_buffer The destination buffer to be filled with decoded data
+   * @param src_index The index into the unencoded buffer to begin decoding
+   * @param length The number of bytes to decode
+   */
+  void decode(uint8_t *encoded, uint8_t *dest_buffer, size_t src_index, size_t length);
+
+  /**
+   * Drops all cached blocks of an encoded buffer; must be called before the
+   * buffer is deallocated
+   *
+   * @param encoded The LZ4 encoded buffer
+   */
+  void invalidate(const uint8_t *encoded);
+
+ private:
+  struct slot {
+    std::mutex mutex;
+    const uint8_t *encoded{nullptr};
+    size_t block_idx{0};
+    block_ptr block;
+  };
+
+  /**
+   * Gets the slot for a block
+   *
+   * @param encoded The LZ4 encoded buffer
+   * @param block_idx The index of the block
+   * @return The slot for the block
+   */
+  slot &slot_for(const uint8_t *encoded, size_t block_idx);
+
+  slot slots_[NUM_SLOTS];
+};
+
+}
+}
+
+#endif /* CONFLUO_COMPRESSION_LZ4_BLOCK_CACHE_H_ */
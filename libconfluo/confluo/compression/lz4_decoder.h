@@ -151,6 +151,34 @@ class lz4_decoder {
     return val;
   }
 
+  /**
+   * Decodes a single block of the LZ4 encoded buffer
+   *
+   * @param input_buffer The LZ4 encoded buffer
+   * @param block_idx The index of the block to decode
+   * @param dest_buffer The buffer to contain the decoded block; must have
+   * space for BYTES_PER_BLOCK bytes
+   */
+  static void decode_block(uint8_t *input_buffer, size_t block_idx, uint8_t *dest_buffer) {
+    size_t decoded_buf_size = decoded_size(input_buffer);
+    size_t encode_size = lz4_encoder<BYTES_PER_BLOCK>::get_buffer_size(decoded_buf_size);
+    input_buffer += sizeof(size_t);
+
+    size_t offset = *reinterpret_cast<size_t *>(input_buffer + block_idx * sizeof(size_t));
+    size_t compress_size = 0;
+    size_t max_index = decoded_buf_size / BYTES_PER_BLOCK;
+
+    // Gets the size of the encoded block
+    if (block_idx + 1 < max_index) {
+      compress_size = *reinterpret_cast<size_t *>(input_buffer + (block_idx + 1) * sizeof(size_t)) - offset;
+    } else {
+      compress_size = encode_size - offset;
+    }
+
+    LZ4_decompress_safe((char *) input_buffer + offset, (char *) dest_buffer, static_cast<int>(compress_size),
+                        static_cast<int>(BYTES_PER_BLOCK));
+  }
+
   /**
    * Decodes the whole LZ4 encoded pointer starting from a particular index
    *
@@ -1,6 +1,7 @@
 #ifndef CONFLUO_COMPRESSION_LZ4_ENCODER_H_
 #define CONFLUO_COMPRESSION_LZ4_ENCODER_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <cassert>
 #include <cstddef>
@@ -45,7 +46,9 @@ class lz4_encoder {
     size_t output_array_position = 0;
     for (size_t i = 0; i < source_length; i += BYTES_PER_BLOCK) {
       uint8_t *output_ptr = output_buffer + output_block_position;
-      size_t size = encode((char *) output_ptr, (char *) (source_buffer + i), BYTES_PER_BLOCK);
+      // The last block may be short; compressing past it reads beyond the buffer
+      size_t block_size = std::min(BYTES_PER_BLOCK, source_length - i);
+      size_t size = encode((char *) output_ptr, (char *) (source_buffer + i), block_size);
       output_block_position += size;
 
       uint8_t *output_array_ptr = output_buffer + output_array_position;
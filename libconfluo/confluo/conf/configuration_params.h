@@ -36,6 +36,11 @@ class archival_configuration_params {
                                           archival_defaults::DEFAULT_IN_MEMORY_FILTER_WINDOW_NS());
   }
 
+  // Number of workers compressing data log buckets and archiving filters and indexes
+  static size_t THREADS() {
+    return conf::instance().get<size_t>("archival_threads", archival_defaults::DEFAULT_THREADS());
+  }
+
   // Maximum archival file size in bytes. Cannot be smaller than a data log bucket.
   static size_t MAX_FILE_SIZE() {
     return conf::instance().get<size_t>("max_archival_file_size", archival_defaults::DEFAULT_MAX_FILE_SIZE());
@@ -88,6 +93,27 @@ class configuration_params {
   static uint64_t MONITOR_PERIODICITY_MS() {
     return conf::instance().get<uint64_t>("monitor_periodicity_ms", defaults::DEFAULT_MONITOR_PERIODICITY_MS());
   }
+
+  /** Number of workers running periodic tasks, such as monitoring and archival */
+  static int SCHEDULER_THREADS() {
+    return conf::instance().get<int>("scheduler_threads", defaults::DEFAULT_SCHEDULER_THREADS());
+  }
+
+  /** Number of data log buckets allocated ahead of the tail; 0 disables */
+  static size_t DATA_LOG_PREALLOC_BUCKETS() {
+    return conf::instance().get<size_t>("data_log_prealloc_buckets", defaults::DEFAULT_DATA_LOG_PREALLOC_BUCKETS());
+  }
+
+  /** Number of thread ids reserved for maintenance work, past the
+   max_concurrency ids available to writers */
+  static int MAINTENANCE_THREADS() {
+    return conf::instance().get<int>("maintenance_threads", defaults::DEFAULT_MAINTENANCE_THREADS());
+  }
+
+  /** Number of threads replaying the data log on recovery */
+  static int RECOVERY_THREADS() {
+    return conf::instance().get<int>("recovery_threads", defaults::DEFAULT_RECOVERY_THREADS());
+  }
 };
 
 }
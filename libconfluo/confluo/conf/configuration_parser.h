@@ -18,6 +18,9 @@ class encoding_params {
   static inline std::string ELIAS_GAMMA() {
     return "elias_gamma";
   }
+  static inline std::string COLUMNAR() {
+    return "columnar";
+  }
 };
 
 class configuration_parser {
@@ -29,6 +32,8 @@ class configuration_parser {
       return storage::encoding_type::D_LZ4;
     } else if (param == encoding_params::ELIAS_GAMMA()) {
       return storage::encoding_type::D_ELIAS_GAMMA;
+    } else if (param == encoding_params::COLUMNAR()) {
+      return storage::encoding_type::D_COLUMNAR;
     } else {
       THROW(illegal_state_exception, "Invalid encoding type!");
     }
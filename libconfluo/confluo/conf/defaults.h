@@ -36,6 +36,11 @@ class archival_defaults {
   static inline uint64_t DEFAULT_IN_MEMORY_FILTER_WINDOW_NS() {
     return static_cast<const uint64_t>(10 * 1e3);
   }
+
+  static inline size_t DEFAULT_THREADS() {
+    size_t hw_concurrency = std::thread::hardware_concurrency();
+    return hw_concurrency > 0 ? hw_concurrency : 1;
+  }
 };
 
 /**
@@ -79,6 +84,26 @@ class defaults {
   static inline uint64_t DEFAULT_MONITOR_PERIODICITY_MS() {
     return 1;
   }
+
+  /** Default number of workers running periodic tasks */
+  static inline int DEFAULT_SCHEDULER_THREADS() {
+    return 4;
+  }
+
+  /** Default number of data log buckets allocated ahead of the tail */
+  static inline size_t DEFAULT_DATA_LOG_PREALLOC_BUCKETS() {
+    return 1;
+  }
+
+  /** Default number of thread ids reserved for maintenance work */
+  static inline int DEFAULT_MAINTENANCE_THREADS() {
+    return 4;
+  }
+
+  /** Default number of threads replaying the data log on recovery */
+  static inline int DEFAULT_RECOVERY_THREADS() {
+    return HARDWARE_CONCURRENCY();
+  }
 };
 
 }
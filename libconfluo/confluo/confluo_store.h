@@ -9,6 +9,7 @@
 #include "file_utils.h"
 #include "storage/storage.h"
 #include "threads/task_pool.h"
+#include "threads/task_scheduler.h"
 
 using namespace ::utils;
 
@@ -94,6 +95,12 @@ class confluo_store {
    */
   int64_t remove_atomic_multilog(int64_t id);
 
+  /**
+   * Gets the scheduler that runs the periodic tasks of the store
+   * @return The scheduler
+   */
+  task_scheduler &scheduler();
+
  private:
   /**
    * Memory management task
@@ -153,6 +160,8 @@ class confluo_store {
 
   // Manangement
   task_pool mgmt_pool_;
+  /** Runs the periodic tasks of all multilogs */
+  task_scheduler scheduler_;
 
   // Tables
   monolog::monolog_exp2<atomic_multilog *> atomic_multilogs_;
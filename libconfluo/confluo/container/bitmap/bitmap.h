@@ -124,38 +124,66 @@ class bitmap {
    */
   template<typename T>
   typename std::enable_if<std::is_arithmetic<T>::value>::type set_val_pos(pos_type pos, T val, width_type bits) {
+    set_val_pos(data_, pos, val, bits);
+  }
+
+  /**
+   * Gets the value at the position
+   * @param pos The position
+   * @param bits The number of bits
+   * @return The data at the position
+   */
+  template<typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value, T>::type get_val_pos(pos_type pos, width_type bits) const {
+    return get_val_pos<T>(data_, pos, bits);
+  }
+
+  /**
+   * Sets the value at a specific position of a bit-array the bitmap does
+   * not own, such as a serialized one
+   * @param data The blocks of the bit-array
+   * @param pos The position
+   * @param val The value
+   * @param bits The number of bits
+   */
+  template<typename T>
+  static typename std::enable_if<std::is_arithmetic<T>::value>::type set_val_pos(data_type *data, pos_type pos, T val,
+                                                                                 width_type bits) {
     using namespace ::utils;
     pos_type s_off = pos % 64;
     pos_type s_idx = pos / 64;
 
     if (s_off + bits <= 64) {
       // Can be accommodated in 1 bitmap block
-      data_[s_idx] = (data_[s_idx] & (low_bits_set[s_off] | low_bits_unset[s_off + bits])) | val << s_off;
+      data[s_idx] = (data[s_idx] & (low_bits_set[s_off] | low_bits_unset[s_off + bits])) | val << s_off;
     } else {
       // Must use 2 bitmap blocks
-      data_[s_idx] = (data_[s_idx] & low_bits_set[s_off]) | val << s_off;
-      data_[s_idx + 1] = (data_[s_idx + 1] & low_bits_unset[(s_off + bits) % 64]) | (val >> (64 - s_off));
+      data[s_idx] = (data[s_idx] & low_bits_set[s_off]) | val << s_off;
+      data[s_idx + 1] = (data[s_idx + 1] & low_bits_unset[(s_off + bits) % 64]) | (val >> (64 - s_off));
     }
   }
 
   /**
-   * Gets the value at the position
+   * Gets the value at the position of a bit-array the bitmap does not own
+   * @param data The blocks of the bit-array
    * @param pos The position
    * @param bits The number of bits
    * @return The data at the position
    */
   template<typename T>
-  typename std::enable_if<std::is_arithmetic<T>::value, T>::type get_val_pos(pos_type pos, width_type bits) const {
+  static typename std::enable_if<std::is_arithmetic<T>::value, T>::type get_val_pos(const data_type *data,
+                                                                                    pos_type pos,
+                                                                                    width_type bits) {
     using namespace ::utils;
     pos_type s_off = pos % 64;
     pos_type s_idx = pos / 64;
 
     if (s_off + bits <= 64) {
       // Can be read from a single block
-      return static_cast<T>((data_[s_idx] >> s_off) & low_bits_set[bits]);
+      return static_cast<T>((data[s_idx] >> s_off) & low_bits_set[bits]);
     } else {
       // Must be read from two blocks
-      return static_cast<T>(((data_[s_idx] >> s_off) | (data_[s_idx + 1] << (64 - s_off))) & low_bits_set[bits]);
+      return static_cast<T>(((data[s_idx] >> s_off) | (data[s_idx + 1] << (64 - s_off))) & low_bits_set[bits]);
     }
   }
 
@@ -5,6 +5,8 @@
 #include <sys/types.h>
 #include <cstdint>
 
+#include "storage/epoch_manager.h"
+
 namespace confluo {
 
 /**
@@ -29,6 +31,7 @@ class batched_cursor {
    * must call this method in its constructor.
    */
   void init() {
+    storage::epoch_manager::guard guard;
     current_batch_size_ = load_next_batch();
   }
 
@@ -60,6 +63,8 @@ class batched_cursor {
   void advance() {
     current_batch_pos_++;
     if (current_batch_pos_ >= current_batch_size_) {
+      // Loads within the batch share a single epoch
+      storage::epoch_manager::guard guard;
       current_batch_size_ = load_next_batch();
       current_batch_pos_ = 0;
     }
@@ -81,6 +86,14 @@ class batched_cursor {
     return !has_more();
   }
 
+  /**
+   * Gets the maximum number of elements the cursor buffers at a time.
+   * @return The batch capacity of the cursor.
+   */
+  size_t batch_capacity() const {
+    return current_batch_.size();
+  }
+
  protected:
   /**
    * Populates the batch with elements for the next batch.
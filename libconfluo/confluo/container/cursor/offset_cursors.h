@@ -35,6 +35,31 @@ class data_log_cursor : public offset_cursor {
   uint64_t record_size_;
 };
 
+/**
+ * A cursor over a list of offsets that it owns
+ */
+class offset_list_cursor : public offset_cursor {
+ public:
+  /**
+   * Initializes the offset list cursor
+   *
+   * @param offsets The offsets
+   * @param batch_size The number of records in a batch
+   */
+  offset_list_cursor(std::vector<uint64_t> &&offsets, size_t batch_size = 64);
+
+  /**
+   * Loads the next batch in the cursor
+   *
+   * @return The size of the batch
+   */
+  virtual size_t load_next_batch() override;
+
+ private:
+  std::vector<uint64_t> offsets_;
+  size_t pos_;
+};
+
 /**
  * An offset iterator cursor
  *
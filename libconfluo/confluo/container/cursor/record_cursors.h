@@ -6,8 +6,10 @@
 #include "batched_cursor.h"
 #include "offset_cursors.h"
 #include "schema/record.h"
+#include "parser/batch_expression.h"
 #include "parser/expression_compiler.h"
 #include "container/data_log.h"
+#include "container/zone_map.h"
 
 namespace confluo {
 
@@ -61,11 +63,13 @@ class filter_record_cursor : public record_cursor {
    * @param schema The schema
    * @param cexpr The filter expression
    * @param batch_size The number of records in the batch
+   * @param zones The zone maps of the data log, used to skip offsets whose
+   * zones cannot match before reading their records
    */
   filter_record_cursor(std::unique_ptr<offset_cursor> o_cursor,
                        const data_log *dlog, const schema_t *schema,
                        const parser::compiled_expression &cexpr,
-                       size_t batch_size = 64);
+                       size_t batch_size = 64, const zone_map *zones = nullptr);
 
   /**
    * Loads the next batch from the cursor
@@ -78,7 +82,138 @@ class filter_record_cursor : public record_cursor {
   std::unique_ptr<offset_cursor> o_cursor_;
   const data_log *dlog_;
   const schema_t *schema_;
-  const parser::compiled_expression &cexpr_;
+  const parser::compiled_expression cexpr_;
+  zone_filter zone_filter_;
+};
+
+/**
+ * Scans the data log in blocks of consecutive records, evaluating the filter
+ * expression over each block with typed kernels. With zone maps, buckets
+ * and zones that cannot match are skipped without being read, and blocks do
+ * not extend past the zone they start in.
+ */
+class record_block_scanner {
+ public:
+  /** The default number of records evaluated per block */
+  static const size_t DEFAULT_BLOCK_SIZE = 1024;
+
+  /**
+   * Initializes the record block scanner
+   *
+   * @param version The version of the data log
+   * @param dlog The data log pointer
+   * @param schema The schema
+   * @param cexpr The filter expression
+   * @param block_size The number of records evaluated per block
+   * @param zones The zone maps of the data log, if any
+   */
+  record_block_scanner(uint64_t version, const data_log *dlog, const schema_t *schema,
+                       const parser::compiled_expression &cexpr, size_t block_size = DEFAULT_BLOCK_SIZE,
+                       const zone_map *zones = nullptr);
+
+  /**
+   * Loads and evaluates the next block of records from the data log
+   *
+   * @return The number of records in the block, 0 if the scan is complete
+   */
+  size_t next_block();
+
+  /**
+   * Gets the data log offset of the first record in the current block
+   *
+   * @return The offset of the block
+   */
+  uint64_t block_offset() const;
+
+  /**
+   * Gets the records in the current block; valid until the next block is
+   * loaded
+   *
+   * @return Pointer to the first record in the block
+   */
+  const uint8_t *block_data() const;
+
+  /**
+   * Gets the selection flags for the current block, one per record
+   *
+   * @return The selection flags
+   */
+  const uint8_t *selection() const;
+
+  /**
+   * Gets the size of each record
+   *
+   * @return The record size
+   */
+  uint64_t record_size() const;
+
+ private:
+  /**
+   * Moves the next offset past the buckets and zones that cannot match
+   */
+  void skip_pruned();
+
+  /**
+   * Gets the offset of the first record at or past a data log offset
+   *
+   * @param offset The data log offset
+   * @return The offset of the record
+   */
+  uint64_t record_at_or_after(uint64_t offset) const;
+
+  uint64_t version_;
+  uint64_t record_size_;
+  const data_log *dlog_;
+  parser::batch_expression bexpr_;
+  size_t block_size_;
+  zone_filter zone_filter_;
+
+  uint64_t next_offset_;
+  uint64_t block_offset_;
+  read_only_data_log_ptr ptr_;
+  data_ptr block_;
+  std::vector<uint8_t> sel_;
+  std::vector<uint8_t> scratch_;
+};
+
+/**
+ * A record cursor that scans the data log in blocks of consecutive records,
+ * evaluating the filter expression over each block with typed kernels and
+ * only materializing the records that match
+ */
+class block_scan_record_cursor : public record_cursor {
+ public:
+  /** The default number of records evaluated per block */
+  static const size_t DEFAULT_BLOCK_SIZE = record_block_scanner::DEFAULT_BLOCK_SIZE;
+
+  /**
+   * Initializes the block scan record cursor
+   *
+   * @param version The version of the data log
+   * @param dlog The data log pointer
+   * @param schema The schema
+   * @param cexpr The filter expression
+   * @param batch_size The number of records in the batch
+   * @param block_size The number of records evaluated per block
+   * @param zones The zone maps of the data log, if any
+   */
+  block_scan_record_cursor(uint64_t version, const data_log *dlog, const schema_t *schema,
+                           const parser::compiled_expression &cexpr, size_t batch_size = 64,
+                           size_t block_size = DEFAULT_BLOCK_SIZE, const zone_map *zones = nullptr);
+
+  /**
+   * Loads the next batch from the cursor
+   *
+   * @return The size of the batch
+   */
+  virtual size_t load_next_batch() override;
+
+ private:
+  const schema_t *schema_;
+  record_block_scanner scanner_;
+
+  size_t block_len_;
+  size_t block_pos_;
 };
 
 }
@@ -68,11 +68,11 @@ class monolog_exp2_linear_base {
     size_t start_cont_idx, end_cont_idx, start_bucket_idx, end_bucket_idx;
     raw_data_location(start_idx, start_cont_idx, start_bucket_idx);
     raw_data_location(end_idx, end_cont_idx, end_bucket_idx);
-    // TODO fix this
     for (size_t i = start_cont_idx; i <= end_cont_idx; i++) {
       __atomic_bucket_ref *container = atomic::load(&bucket_containers_[i]);
       size_t cur_start_bucket_idx = (i == start_cont_idx) ? start_bucket_idx : 0;
-      size_t cur_end_bucket_idx = (i == end_cont_idx) ? end_cont_idx << (i + fcs_hibit_) : end_bucket_idx;
+      // Containers before the last are covered to their last bucket
+      size_t cur_end_bucket_idx = (i == end_cont_idx) ? end_bucket_idx : (1UL << (i + FCB_HIBIT)) - 1;
       if (container == nullptr) {
         try_allocate_container(i);
         for (size_t j = cur_start_bucket_idx; j <= cur_end_bucket_idx; j++) {
@@ -255,9 +255,8 @@ class monolog_exp2_linear_base {
     size_t bucket_remaining = BUCKET_SIZE * sizeof(T);
     while (data_remaining) {
       size_t bytes_to_read = std::min(bucket_remaining, data_remaining);
-      __atomic_bucket_copy_ref bucket;
-      load_bucket_copy(container_idx, bucket_idx, bucket);
-      bucket.decode(data + data_off, bucket_off, bytes_to_read / sizeof(T));
+      __atomic_bucket_ref *container = atomic::load(&bucket_containers_[container_idx]);
+      container[bucket_idx].atomic_decode(data + data_off, bucket_off, bytes_to_read / sizeof(T));
       data_remaining -= bytes_to_read;
       data_off += bytes_to_read;
       bucket_idx++;
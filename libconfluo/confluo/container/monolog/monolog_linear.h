@@ -1,6 +1,7 @@
 #ifndef CONFLUO_CONTAINER_MONOLOG_MONOLOG_LINEAR_H_
 #define CONFLUO_CONTAINER_MONOLOG_MONOLOG_LINEAR_H_
 
+#include <algorithm>
 #include <array>
 #include <vector>
 
@@ -82,6 +83,30 @@ class monolog_linear_base {
     buckets_[0].ensure_alloc();
   }
 
+  /**
+   * Pre-allocates a run of buckets, stopping at the last bucket.
+   *
+   * @param bucket_idx The first bucket to allocate.
+   * @param count The number of buckets to allocate.
+   */
+  void pre_alloc(size_t bucket_idx, size_t count) {
+    for (size_t i = bucket_idx; i < std::min(bucket_idx + count, MAX_BUCKETS); i++) {
+      buckets_[i].ensure_alloc();
+    }
+  }
+
+  /**
+   * Gets the first bucket that should be allocated ahead of a tail: the
+   * bucket after the tail's own once the tail is past its middle, the
+   * tail's own bucket before that.
+   *
+   * @param tail The tail of the monolog.
+   * @return The first bucket to allocate ahead of the tail.
+   */
+  static size_t pre_alloc_bucket(size_t tail) {
+    return (tail + BUCKET_SIZE / 2) / BUCKET_SIZE;
+  }
+
   /**
    * Get the name of the monolog.
    *
@@ -172,9 +172,7 @@ class monolog_linear_bucket {
    * @param len The number of bytes to read.
    */
   void read(size_t offset, T *data, size_t len) const {
-    __atomic_block_copy_ref copy;
-    data_.atomic_copy(copy);
-    copy.decode(data, offset, len);
+    data_.atomic_decode(data, offset, len);
   }
 
   void ptr(size_t offset, __atomic_block_copy_ref &data_ptr) {
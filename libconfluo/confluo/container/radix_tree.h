@@ -14,7 +14,64 @@ namespace confluo {
 namespace index {
 
 /**
- * A node in the radix tree
+ * A block of child pointers for an inner radix tree node. Sparse blocks hold
+ * up to capacity children in insertion order, filled as a prefix, and are
+ * searched by the children's keys; direct blocks are indexed by key.
+ */
+template<typename node_t>
+struct radix_tree_child_block {
+  /** The child type */
+  typedef atomic::type<node_t *> child_t;
+  /** The block type */
+  typedef radix_tree_child_block<node_t> block_t;
+
+  /**
+   * Allocates a new child block with all child slots empty
+   *
+   * @param capacity The number of child slots
+   * @param direct Whether the block is indexed by key
+   * @param retired The block this block replaces, if any
+   *
+   * @return The allocated block
+   */
+  static block_t *create(size_t capacity, bool direct, block_t *retired) {
+    void *raw = allocator::instance().alloc(sizeof(block_t) + sizeof(child_t) * (capacity - 1));
+    block_t *block = static_cast<block_t *>(raw);
+    block->capacity = capacity;
+    block->direct = direct;
+    block->retired = retired;
+    for (size_t i = 0; i < capacity; i++) {
+      atomic::init(&(block->slots[i]), static_cast<node_t *>(nullptr));
+    }
+    return block;
+  }
+
+  /**
+   * Deallocates a block along with all the blocks it replaced
+   *
+   * @param block The block
+   */
+  static void destroy(block_t *block) {
+    while (block != nullptr) {
+      block_t *retired = block->retired;
+      allocator::instance().dealloc(block);
+      block = retired;
+    }
+  }
+
+  /** The number of child slots */
+  size_t capacity;
+  /** Whether the block is indexed by key */
+  bool direct;
+  /** The smaller block this block replaced; kept alive for concurrent readers */
+  block_t *retired;
+  /** The child slots */
+  child_t slots[1];
+};
+
+/**
+ * A node in the radix tree. Inner nodes start with a small sparse child block
+ * and grow it (4, 16, 48, then width children) as children are added.
  */
 template<typename reflog>
 struct radix_tree_node {
@@ -22,9 +79,16 @@ struct radix_tree_node {
   typedef radix_tree_node<reflog> node_t;
   /** The child type */
   typedef atomic::type<node_t *> child_t;
+  /** The child block type */
+  typedef radix_tree_child_block<node_t> block_t;
   /** The key */
   typedef byte_string key_t;
 
+  /** The number of children in the smallest child block */
+  static const size_t MIN_CAPACITY = 4;
+  /** The largest number of children held in a sparse child block */
+  static const size_t MAX_SPARSE_CAPACITY = 48;
+
   /**
    * Constructs a new node from the specified arguments
    *
@@ -60,12 +124,8 @@ struct radix_tree_node {
         depth_(static_cast<uint8_t>(node_depth)),
         is_leaf_(false),
         parent_(node_parent) {
-    size_t alloc_size = sizeof(child_t) * node_width;
-    data_ = allocator::instance().alloc(alloc_size);
-
-    for (size_t i = 0; i < node_width; i++) {
-      atomic::init(&(children()[i]), static_cast<node_t *>(nullptr));
-    }
+    size_t capacity = node_width < MIN_CAPACITY ? node_width : MIN_CAPACITY;
+    atomic::init(&children_, block_t::create(capacity, capacity == node_width, nullptr));
   }
 
   /**
@@ -76,7 +136,7 @@ struct radix_tree_node {
       refs()->~reflog();
       allocator::instance().dealloc(refs());
     } else {
-      allocator::instance().dealloc(children());
+      block_t::destroy(atomic::load(&children_));
     }
   }
 
@@ -86,7 +146,7 @@ struct radix_tree_node {
    * @return The reflog reference containing the data
    */
   inline reflog *&refs() {
-    return reinterpret_cast<reflog *&>(data_);
+    return data_;
   }
 
   /**
@@ -95,25 +155,63 @@ struct radix_tree_node {
    * @return A constant reference to the reflog containing the data
    */
   inline reflog *const &refs() const {
-    return reinterpret_cast<reflog *const &>(data_);
+    return data_;
   }
 
   /**
-   * Gets the children of the node
+   * Gets the child of the node with the given key
    *
-   * @return Reference to the children
+   * @param key The child key
+   *
+   * @return A pointer to the child (nullptr if there is no such child)
    */
-  inline child_t *&children() {
-    return reinterpret_cast<child_t *&>(data_);
+  node_t *child(uint8_t key) const {
+    block_t *block = atomic::load(&children_);
+    if (block->direct)
+      return atomic::load(&(block->slots[key]));
+
+    for (size_t i = 0; i < block->capacity; i++) {
+      node_t *child = atomic::load(&(block->slots[i]));
+      if (child == nullptr || child->key_ == key)
+        return child;
+    }
+    return nullptr;
   }
 
   /**
-   * Gets a constant reference to the children
+   * Adds a child to the node, unless a child with the same key already
+   * exists; grows the child block if it is full
+   *
+   * @param node_width The node width
+   * @param new_child The child to add
    *
-   * @return A constant pointer to the children
+   * @return The child now stored in the node for the new child's key; the
+   * caller owns new_child if this is not new_child
    */
-  inline child_t *const &children() const {
-    return reinterpret_cast<child_t *const &>(data_);
+  node_t *add_child(size_t node_width, node_t *new_child) {
+    uint8_t key = new_child->key_;
+    while (true) {
+      block_t *block = atomic::load(&children_);
+      if (block->direct) {
+        node_t *expected = nullptr;
+        if (atomic::strong::cas(&(block->slots[key]), &expected, new_child))
+          return new_child;
+        return expected;
+      }
+
+      // Sparse slots are filled in order, so every existing child is seen
+      // before an empty slot is claimed
+      for (size_t i = 0; i < block->capacity; i++) {
+        node_t *expected = nullptr;
+        if (atomic::strong::cas(&(block->slots[i]), &expected, new_child))
+          return new_child;
+        if (expected->key_ == key)
+          return expected;
+      }
+
+      // The block is full and no longer changes; replace it with a larger one
+      grow(node_width, block);
+    }
   }
 
   /**
@@ -124,12 +222,16 @@ struct radix_tree_node {
    * @return A pointer to the first child
    */
   const node_t *first_child(size_t width) const {
-    size_t cur_key = 0;
-    const node_t *child = nullptr;
-    while (cur_key < width && (child = atomic::load(&(children()[cur_key]))) == nullptr) {
-      ++cur_key;
+    block_t *block = atomic::load(&children_);
+    if (block->direct) {
+      size_t cur_key = 0;
+      const node_t *child = nullptr;
+      while (cur_key < width && (child = atomic::load(&(block->slots[cur_key]))) == nullptr) {
+        ++cur_key;
+      }
+      return child;
     }
-    return child;
+    return sparse_next_child(block, -1);
   }
 
   /**
@@ -140,12 +242,16 @@ struct radix_tree_node {
    * @return A pointer to the child
    */
   const node_t *last_child(size_t width) const {
-    int16_t cur_key = static_cast<int16_t>(width - 1);
-    const node_t *child = nullptr;
-    while (cur_key >= 0 && (child = atomic::load(&(children()[cur_key]))) == nullptr) {
-      --cur_key;
+    block_t *block = atomic::load(&children_);
+    if (block->direct) {
+      int16_t cur_key = static_cast<int16_t>(width - 1);
+      const node_t *child = nullptr;
+      while (cur_key >= 0 && (child = atomic::load(&(block->slots[cur_key]))) == nullptr) {
+        --cur_key;
+      }
+      return child;
     }
-    return child;
+    return sparse_prev_child(block, static_cast<int16_t>(width));
   }
 
   /**
@@ -157,12 +263,16 @@ struct radix_tree_node {
    * @return node_t
    */
   const node_t *next_child(uint8_t key, size_t width) const {
-    size_t cur_key = key + 1;
-    const node_t *child = nullptr;
-    while (cur_key < width && (child = atomic::load(&(children()[cur_key]))) == nullptr) {
-      ++cur_key;
+    block_t *block = atomic::load(&children_);
+    if (block->direct) {
+      size_t cur_key = key + 1;
+      const node_t *child = nullptr;
+      while (cur_key < width && (child = atomic::load(&(block->slots[cur_key]))) == nullptr) {
+        ++cur_key;
+      }
+      return child;
     }
-    return child;
+    return sparse_next_child(block, key);
   }
 
   /**
@@ -177,12 +287,16 @@ struct radix_tree_node {
     if (key == 0)
       return nullptr;
 
-    int16_t cur_key = static_cast<int16_t>(key - 1);
-    const node_t *child = nullptr;
-    while (cur_key >= 0 && (child = atomic::load(&(children()[cur_key]))) == nullptr) {
-      --cur_key;
+    block_t *block = atomic::load(&children_);
+    if (block->direct) {
+      int16_t cur_key = static_cast<int16_t>(key - 1);
+      const node_t *child = nullptr;
+      while (cur_key >= 0 && (child = atomic::load(&(block->slots[cur_key]))) == nullptr) {
+        --cur_key;
+      }
+      return child;
     }
-    return child;
+    return sparse_prev_child(block, key);
   }
 
   /**
@@ -281,12 +395,87 @@ struct radix_tree_node {
   uint8_t key_;
   /** Depth of the radix tree node */
   uint8_t depth_;
-  /** Data that the node contains */
-  void *data_;
   /** Whether the node is a leaf node */
   bool is_leaf_;
+  union {
+    /** Data that the node contains, for leaf nodes */
+    reflog *data_;
+    /** Children of the node, for inner nodes */
+    atomic::type<block_t *> children_;
+  };
   /** The parent of the radix tree node */
   node_t *parent_;
+
+ private:
+  /**
+   * Replaces a full sparse child block with the next larger block
+   *
+   * @param node_width The node width
+   * @param block The full block
+   */
+  void grow(size_t node_width, block_t *block) {
+    size_t capacity = block->capacity * 4;
+    if (block->capacity == MAX_SPARSE_CAPACITY || capacity > node_width)
+      capacity = node_width;
+    else if (capacity > MAX_SPARSE_CAPACITY)
+      capacity = MAX_SPARSE_CAPACITY;
+    bool direct = capacity == node_width;
+
+    block_t *grown = block_t::create(capacity, direct, block);
+    for (size_t i = 0; i < block->capacity; i++) {
+      node_t *child = atomic::load(&(block->slots[i]));
+      atomic::store(&(grown->slots[direct ? child->key_ : i]), child);
+    }
+
+    // Another thread may have grown the block first; use its block instead
+    block_t *expected = block;
+    if (!atomic::strong::cas(&children_, &expected, grown)) {
+      grown->retired = nullptr;
+      block_t::destroy(grown);
+    }
+  }
+
+  /**
+   * Gets the child with the smallest key larger than the given key, from a
+   * sparse child block
+   *
+   * @param block The sparse child block
+   * @param key The key
+   *
+   * @return A pointer to the child (nullptr if none were found)
+   */
+  static const node_t *sparse_next_child(block_t *block, int16_t key) {
+    const node_t *next = nullptr;
+    for (size_t i = 0; i < block->capacity; i++) {
+      const node_t *child = atomic::load(&(block->slots[i]));
+      if (child == nullptr)
+        break;
+      if (child->key_ > key && (next == nullptr || child->key_ < next->key_))
+        next = child;
+    }
+    return next;
+  }
+
+  /**
+   * Gets the child with the largest key smaller than the given key, from a
+   * sparse child block
+   *
+   * @param block The sparse child block
+   * @param key The key
+   *
+   * @return A pointer to the child (nullptr if none were found)
+   */
+  static const node_t *sparse_prev_child(block_t *block, int16_t key) {
+    const node_t *prev = nullptr;
+    for (size_t i = 0; i < block->capacity; i++) {
+      const node_t *child = atomic::load(&(block->slots[i]));
+      if (child == nullptr)
+        break;
+      if (child->key_ < key && (prev == nullptr || child->key_ > prev->key_))
+        prev = child;
+    }
+    return prev;
+  }
 };
 
 /**
@@ -508,7 +697,8 @@ class rt_reflog_range_result {
 
 /**
  * Radix Tree class. The radix tree uses a fixed-depth, fixed-width (k)-ary
- * tree to index reflogs based on a byte_array key.
+ * tree to index reflogs based on a byte_array key. Inner nodes only allocate
+ * space for as many children as they hold, up to the full width.
  *
  * @tparam reflog The reflog type.
  */
@@ -577,19 +767,19 @@ class radix_tree {
     node_t *node = root_;
     for (size_t d = 0; d < depth_ - 1; d++) {
       node_t *child = nullptr;
-      if ((child = atomic::load(&(node->children()[key[d]]))) == nullptr) {
+      if ((child = node->child(key[d])) == nullptr) {
         // Try & allocate child node
         void *raw = allocator::instance().alloc(sizeof(node_t));
         child = new(raw) node_t(key[d], width_, d + 1, node);
-        node_t *expected = nullptr;
 
-        // If thread was not successful in swapping newly allocated memory,
+        // If thread was not successful in adding newly allocated node,
         // then it should de-allocate memory, and accept whatever the
         // successful thread allocated as the de-facto storage for child node.
-        if (!atomic::strong::cas(&(node->children()[key[d]]), &expected, child)) {
+        node_t *existing = node->add_child(width_, child);
+        if (existing != child) {
           child->~node_t();
           allocator::instance().dealloc(child);
-          child = expected;
+          child = existing;
         }
       }
       // child is definitely allocated now
@@ -599,19 +789,19 @@ class radix_tree {
     // Reached leaf
     size_t d = depth_ - 1;
     node_t *child = nullptr;
-    if ((child = atomic::load(&(node->children()[key[d]]))) == nullptr) {
+    if ((child = node->child(key[d])) == nullptr) {
       // Try & allocate child node
       void *raw = allocator::instance().alloc(sizeof(node_t));
       child = new(raw) node_t(key[d], width_, d + 1, node, true, std::forward<ARGS>(args)...);
-      node_t *expected = nullptr;
 
-      // If thread was not successful in swapping newly allocated memory,
+      // If thread was not successful in adding newly allocated node,
       // then it should de-allocate memory, and accept whatever the
       // successful thread allocated as the de-facto storage for child node.
-      if (!atomic::strong::cas(&(node->children()[key[d]]), &expected, child)) {
+      node_t *existing = node->add_child(width_, child);
+      if (existing != child) {
         child->~node_t();
         allocator::instance().dealloc(child);
-        child = expected;
+        child = existing;
       }
     }
 
@@ -647,7 +837,7 @@ class radix_tree {
     node_t *node = root_;
     size_t d;
     for (d = 0; d < depth_; d++) {
-      node_t *child = atomic::load(&(node->children()[key[d]]));
+      node_t *child = node->child(key[d]);
       if (child == nullptr)
         return nullptr;
       node = child;
@@ -667,7 +857,7 @@ class radix_tree {
     node_t *node = root_;
     size_t d;
     for (d = 0; d < depth_; d++) {
-      node_t *child = atomic::load(&(node->children()[key[d]]));
+      node_t *child = node->child(key[d]);
       if (child == nullptr)
         return nullptr;
       node = child;
@@ -686,7 +876,7 @@ class radix_tree {
     node_t *node = root_;
     size_t d;
     for (d = 0; d < depth_; d++) {
-      node_t *child = atomic::load(&(node->children()[key[d]]));
+      node_t *child = node->child(key[d]);
       if (child == nullptr)
         return nullptr;
       node = child;
@@ -793,7 +983,7 @@ class radix_tree {
     std::pair<key_t, const node_t *> ret(key, root_);
     size_t d;
     for (d = 0; d < depth_; d++) {
-      node_t *child = atomic::load(&(ret.second->children()[key[d]]));
+      node_t *child = ret.second->child(key[d]);
       if (child == nullptr)
         break;
       ret.second = child;
@@ -825,7 +1015,7 @@ class radix_tree {
     std::pair<key_t, const node_t *> ret(key, root_);
     size_t d;
     for (d = 0; d < depth_; d++) {
-      node_t *child = atomic::load(&(ret.second->children()[key[d]]));
+      node_t *child = ret.second->child(key[d]);
       if (child == nullptr)
         break;
       ret.second = child;
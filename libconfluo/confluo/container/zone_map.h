@@ -0,0 +1,229 @@
+#ifndef CONFLUO_CONTAINER_ZONE_MAP_H_
+#define CONFLUO_CONTAINER_ZONE_MAP_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "atomic.h"
+#include "container/data_log.h"
+#include "parser/expression_compiler.h"
+#include "schema/schema.h"
+
+namespace confluo {
+
+/**
+ * Zone maps over the data log: the smallest and largest value of every
+ * numeric column among the records that start in each data log bucket, and
+ * in each ZONE_SIZE block of a bucket. Scans consult them to skip buckets
+ * and blocks none of whose records can match a filter, without reading, or
+ * for archived buckets decoding, their records.
+ *
+ * Values are kept as order-preserving 64-bit keys, so that bounds are
+ * maintained on append with an atomic compare-and-swap and compared without
+ * regard to the column type. The bounds of a bucket are allocated by the
+ * first record that starts in it. Writers update the bounds of a record
+ * before the read tail moves past it, so that readers never see a record
+ * outside of its zone's bounds.
+ */
+class zone_map {
+ public:
+  /** Size of the data log blocks with bounds of their own, in bytes */
+  static const size_t ZONE_SIZE = 65536;
+  /** Size of a data log bucket in bytes */
+  static const size_t BUCKET_SIZE = data_log_constants::BUCKET_SIZE;
+  /** Number of zones in a data log bucket */
+  static const size_t ZONES_PER_BUCKET = BUCKET_SIZE / ZONE_SIZE;
+  /** Maximum number of data log buckets */
+  static const size_t MAX_BUCKETS = data_log_constants::MAX_BUCKETS;
+
+  /**
+   * Constructs zone maps that track no columns
+   */
+  zone_map();
+
+  /**
+   * Deallocates the bounds of every bucket
+   */
+  ~zone_map();
+
+  zone_map(const zone_map &) = delete;
+  zone_map &operator=(const zone_map &) = delete;
+
+  /**
+   * Tracks the numeric columns of a schema; must be called before any
+   * record is added
+   *
+   * @param schema The schema
+   */
+  void init(const schema_t &schema);
+
+  /**
+   * Gets the number of tracked columns
+   *
+   * @return The number of tracked columns
+   */
+  size_t num_columns() const;
+
+  /**
+   * Gets the tracked column for a schema field
+   *
+   * @param field_idx The index of the field in the schema
+   * @return The index of the tracked column, or -1 if the field is not tracked
+   */
+  int column_of(size_t field_idx) const;
+
+  /**
+   * Gets the order-preserving key of a value of a tracked column
+   *
+   * @param col The index of the tracked column
+   * @param value Pointer to the value
+   * @return The key
+   */
+  uint64_t key(size_t col, const void *value) const;
+
+  /**
+   * Adds consecutive records to the bounds of the zones they start in
+   *
+   * @param offset The data log offset of the first record
+   * @param data The records
+   * @param nrecords The number of records
+   * @param record_size The size of a record
+   */
+  void update(uint64_t offset, const void *data, size_t nrecords, size_t record_size);
+
+  /**
+   * Gets the bounds of a tracked column in a bucket
+   *
+   * @param bucket_idx The index of the bucket
+   * @param col The index of the tracked column
+   * @param min The smallest key, set if the bucket has bounds
+   * @param max The largest key, set if the bucket has bounds
+   * @return False if the bucket has no bounds, in which case nothing is
+   * known about its records; true otherwise. Bounds with min greater than
+   * max hold no values.
+   */
+  bool bucket_bounds(size_t bucket_idx, size_t col, uint64_t &min, uint64_t &max) const;
+
+  /**
+   * Gets the bounds of a tracked column in a zone
+   *
+   * @param zone_idx The index of the zone in the data log
+   * @param col The index of the tracked column
+   * @param min The smallest key, set if the zone has bounds
+   * @param max The largest key, set if the zone has bounds
+   * @return False if the zone has no bounds, true otherwise
+   */
+  bool zone_bounds(size_t zone_idx, size_t col, uint64_t &min, uint64_t &max) const;
+
+  /**
+   * Gets all the bounds of a bucket, for archival
+   *
+   * @param bucket_idx The index of the bucket
+   * @return The bounds of the bucket followed by those of its zones, min
+   * and max for each tracked column; empty if the bucket has no bounds
+   */
+  std::vector<uint64_t> snapshot(size_t bucket_idx) const;
+
+  /**
+   * Restores all the bounds of a bucket from archives
+   *
+   * @param bucket_idx The index of the bucket
+   * @param bounds The bounds, as returned by snapshot
+   */
+  void restore(size_t bucket_idx, const std::vector<uint64_t> &bounds);
+
+ private:
+  struct tracked_column {
+    size_t offset;
+    size_t type_id;
+  };
+
+  typedef atomic::type<uint64_t> bound_t;
+
+  bound_t *bucket(size_t bucket_idx) const;
+
+  bound_t *get_or_create(size_t bucket_idx);
+
+  size_t bounds_per_bucket() const;
+
+  bool bounds(size_t bucket_idx, size_t slot, size_t col, uint64_t &min, uint64_t &max) const;
+
+  static void lower(bound_t *bound, uint64_t key);
+
+  static void raise(bound_t *bound, uint64_t key);
+
+  std::vector<tracked_column> columns_;
+  std::vector<int> column_of_;
+  std::unique_ptr<atomic::type<bound_t *>[]> buckets_;
+};
+
+/**
+ * A filter expression reduced to what zone maps can rule out: for every
+ * minterm, its predicates on tracked columns other than inequality, with
+ * the predicate's constant as a key. A range of records can be skipped if
+ * every minterm has a predicate that no value within the range's bounds
+ * satisfies.
+ */
+class zone_filter {
+ public:
+  /**
+   * Reduces an expression
+   *
+   * @param zones The zone maps
+   * @param cexpr The filter expression
+   */
+  zone_filter(const zone_map *zones, const parser::compiled_expression &cexpr);
+
+  /**
+   * Checks whether the filter can skip any records at all
+   *
+   * @return True if some minterm can be ruled out, false otherwise
+   */
+  bool is_active() const;
+
+  /**
+   * Checks whether records that start in a bucket may match the expression
+   *
+   * @param bucket_idx The index of the bucket
+   * @return False if no such record matches, true otherwise
+   */
+  bool may_match_bucket(size_t bucket_idx) const;
+
+  /**
+   * Checks whether records that start in a zone may match the expression
+   *
+   * @param zone_idx The index of the zone in the data log
+   * @return False if no such record matches, true otherwise
+   */
+  bool may_match_zone(size_t zone_idx) const;
+
+  /**
+   * Checks whether the record at an offset may match the expression, from
+   * the bounds of the zone it starts in
+   *
+   * @param offset The data log offset of the record
+   * @return False if the record does not match, true otherwise
+   */
+  bool may_match(uint64_t offset) const;
+
+ private:
+  struct zone_predicate {
+    size_t col;
+    reational_op_id op;
+    uint64_t key;
+  };
+
+  template<typename BOUNDS>
+  bool may_match_bounds(BOUNDS bounds) const;
+
+  static bool may_satisfy(const zone_predicate &p, uint64_t min, uint64_t max);
+
+  const zone_map *zones_;
+  std::vector<std::vector<zone_predicate>> minterms_;
+  bool active_;
+};
+
+}
+
+#endif /* CONFLUO_CONTAINER_ZONE_MAP_H_ */
@@ -2,6 +2,7 @@
 #define CONFLUO_FILTER_H_
 
 #include "aggregated_reflog.h"
+#include "backfill_handoff.h"
 #include "container/radix_tree.h"
 #include "container/reflog.h"
 #include "trigger.h"
@@ -49,6 +50,19 @@ class filter {
   typedef idx_t::rt_result range_result;
   typedef idx_t::rt_reflog_result reflog_result;
 
+  /** Number of time-rollup levels maintained above the filter index. Each
+  update of a filter with aggregates looks up (or creates) one entry per
+  level and updates its aggregates as well, so aggregate maintenance costs
+  NUM_ROLLUP_LEVELS + 1 reflog lookups and version nodes per update; writers
+  that stage appends pay this once per run of records rather than per record
+  (see the filter_update benchmark). Rollup entries are collapsed to a single
+  version once the time-blocks they cover have been archived. */
+  static const size_t NUM_ROLLUP_LEVELS = 4;
+  /** Number of time-blocks covered by a single entry at each rollup level;
+  with the default millisecond time resolution, these correspond to
+  seconds, minutes, hours and days. */
+  static const uint64_t ROLLUP_BLOCKS[NUM_ROLLUP_LEVELS];
+
   /**
    * Constructor that initializes filter with provided compiled expression and
    * filter function.
@@ -111,8 +125,42 @@ class filter {
    * @param snap The snapshot of the schema
    * @param block The record block
    * @param record_size The size of the record
+   * @param version_floor The oldest version readers may still request;
+   * aggregate versions older than it may be reclaimed
+   */
+  void update(size_t log_offset, const schema_snapshot &snap, record_block &block, size_t record_size,
+              uint64_t version_floor = 0);
+
+  /**
+   * Updates the filter index with consecutive data points that share a time
+   * block. If data points pass the filter, their references are stored.
+   * @param log_offset The offset from the log
+   * @param snap The snapshot of the schema
+   * @param data Pointer to the first record
+   * @param nrecords The number of records
+   * @param time_block The time block of the records
+   * @param record_size The size of the record
+   * @param version_floor The oldest version readers may still request;
+   * aggregate versions older than it may be reclaimed
    */
-  void update(size_t log_offset, const schema_snapshot &snap, record_block &block, size_t record_size);
+  void update(size_t log_offset, const schema_snapshot &snap, void *data, size_t nrecords, int64_t time_block,
+              size_t record_size, uint64_t version_floor = 0);
+
+  /**
+   * Updates the filter index with consecutive data points that share a time
+   * block, updating aggregates with a given id rather than the calling
+   * thread's id.
+   * @param log_offset The offset from the log
+   * @param snap The snapshot of the schema
+   * @param data Pointer to the first record
+   * @param nrecords The number of records
+   * @param time_block The time block of the records
+   * @param record_size The size of the record
+   * @param version_floor The oldest version readers may still request
+   * @param thread_id The id to update aggregates with
+   */
+  void update(size_t log_offset, const schema_snapshot &snap, void *data, size_t nrecords, int64_t time_block,
+              size_t record_size, uint64_t version_floor, int thread_id);
 
   // TODO rename later
   /**
@@ -148,6 +196,28 @@ class filter {
    */
   reflog_result lookup_range_reflogs(uint64_t ts_block_begin, uint64_t ts_block_end) const;
 
+  /**
+   * Get the aggregate over all time-blocks in a given range, as of the
+   * specified version. Partial aggregates maintained at coarser time-rollup
+   * levels are combined wherever a rollup entry is fully contained in the
+   * range, so that only the edges of the range are resolved at finer levels.
+   *
+   * @param aid The aggregate id.
+   * @param ts_block_begin Beginning time-block.
+   * @param ts_block_end End time-block (inclusive).
+   * @param version The version of the multilog to read the aggregate at.
+   * @return The aggregate over the time range.
+   */
+  numeric get_aggregate(size_t aid, uint64_t ts_block_begin, uint64_t ts_block_end, uint64_t version) const;
+
+  /**
+   * Rebuilds the time-rollup levels from the aggregates of reflogs in the
+   * filter index; used after loading archived aggregates during recovery.
+   *
+   * @param version The version to tag the rebuilt rollup aggregates with.
+   */
+  void rebuild_rollups(uint64_t version);
+
   /**
    * Invalidates the filter expression
    *
@@ -162,18 +232,85 @@ class filter {
    */
   bool is_valid();
 
+  /**
+   * Gets the handoff between the backfill of the filter and writers; a
+   * filter added to a populated multilog is only updated by writers past
+   * the handoff offset
+   *
+   * @return The backfill handoff
+   */
+  backfill_handoff &handoff();
+
   /**
    * Note: It is dangerous to modify this data structure.
    * @return underlying radix tree
    */
   idx_t &data();
 
+  /**
+   * Note: It is dangerous to modify this data structure.
+   *
+   * @param level The rollup level, from 0 (finest) to NUM_ROLLUP_LEVELS - 1,
+   * whose entries each cover ROLLUP_BLOCKS[level] time-blocks
+   * @return underlying radix tree for the rollup level
+   */
+  idx_t &rollup_data(size_t level);
+
  private:
+  /**
+   * Get the rollup index for a level; level 0 is the filter index itself.
+   *
+   * @param level The rollup level.
+   * @return The index for the rollup level.
+   */
+  const idx_t &rollup(size_t level) const;
+
+  /**
+   * Get the number of entries at a level covered by one entry at the next
+   * coarser level.
+   *
+   * @param level The rollup level.
+   * @return The fan-out from the next coarser level to this level.
+   */
+  static uint64_t rollup_factor(size_t level);
+
+  /**
+   * Combine aggregates over a range at a level, delegating all fully covered
+   * entries of the next coarser level to that level.
+   *
+   * @param a The aggregate info.
+   * @param aid The aggregate id.
+   * @param level The rollup level the range is expressed at.
+   * @param begin Beginning of the range at the level.
+   * @param end End of the range at the level (inclusive).
+   * @param version The version to read aggregates at.
+   * @return The combined aggregate.
+   */
+  numeric merge_rollups(aggregate_info *a, size_t aid, size_t level, uint64_t begin, uint64_t end,
+                        uint64_t version) const;
+
+  /**
+   * Combine aggregates of all entries in a range at a single level; entries
+   * created before the aggregate was added are resolved at the finer level.
+   *
+   * @param a The aggregate info.
+   * @param aid The aggregate id.
+   * @param level The rollup level the range is expressed at.
+   * @param begin Beginning of the range at the level.
+   * @param end End of the range at the level (inclusive).
+   * @param version The version to read aggregates at.
+   * @return The combined aggregate.
+   */
+  numeric merge_level(aggregate_info *a, size_t aid, size_t level, uint64_t begin, uint64_t end,
+                      uint64_t version) const;
+
   compiled_expression exp_;         // The compiled filter expression
   filter_fn fn_;                    // Filter function
   idx_t idx_;                       // The filtered data index
+  std::vector<idx_t> rollups_;      // Pre-combined aggregates at coarser time granularities
   aggregate_log aggregates_;        // List of aggregates on this filter
   atomic::type<bool> is_valid_;     // Marks if the filter is valid or not
+  backfill_handoff handoff_;        // Offset past which writers update the filter
 };
 
 }
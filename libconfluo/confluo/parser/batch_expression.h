@@ -0,0 +1,97 @@
+#ifndef CONFLUO_PARSER_BATCH_EXPRESSION_H_
+#define CONFLUO_PARSER_BATCH_EXPRESSION_H_
+
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "parser/expression_compiler.h"
+#include "schema/schema.h"
+#include "types/mutable_value.h"
+
+namespace confluo {
+namespace parser {
+
+/**
+ * Type definition for a typed selection kernel: evaluates a relational
+ * operator between a field of n consecutive records and a constant, and
+ * clears the selection flag of every record that fails.
+ *
+ * @param op The relational operator
+ * @param field Pointer to the field in the first record
+ * @param record_size The size of each record
+ * @param n The number of records
+ * @param value Pointer to the constant
+ * @param sel The selection flags, one per record
+ */
+typedef void (*select_kernel_t)(reational_op_id op, const uint8_t *field, size_t record_size, size_t n,
+                                const void *value, uint8_t *sel);
+
+/**
+ * A compiled predicate bound to the physical layout of a fixed-width
+ * schema, evaluated over a block of records at a time.
+ */
+class batch_predicate {
+ public:
+  /**
+   * Binds a compiled predicate to a schema.
+   *
+   * @param p The compiled predicate
+   * @param schema The schema
+   */
+  batch_predicate(const compiled_predicate &p, const schema_t &schema);
+
+  /**
+   * Clears the selection flag of every record in the block that fails the
+   * predicate.
+   *
+   * @param records Pointer to the first record in the block
+   * @param record_size The size of each record
+   * @param n The number of records in the block
+   * @param sel The selection flags, one per record
+   */
+  void select(const uint8_t *records, size_t record_size, size_t n, uint8_t *sel) const;
+
+ private:
+  size_t offset_;
+  data_type type_;
+  reational_op_id op_;
+  mutable_value val_;
+  select_kernel_t kernel_;
+};
+
+/**
+ * A compiled expression bound to the physical layout of a fixed-width
+ * schema. Evaluates the expression over blocks of records, producing one
+ * selection flag per record: predicates within a minterm are combined by
+ * AND-ing their flags, and minterms by OR-ing them.
+ */
+class batch_expression {
+ public:
+  /**
+   * Binds a compiled expression to a schema.
+   *
+   * @param cexpr The compiled expression
+   * @param schema The schema
+   */
+  batch_expression(const compiled_expression &cexpr, const schema_t &schema);
+
+  /**
+   * Evaluates the expression over a block of records.
+   *
+   * @param records Pointer to the first record in the block
+   * @param record_size The size of each record
+   * @param n The number of records in the block
+   * @param sel The selection flags to fill in, one per record
+   */
+  void evaluate(const uint8_t *records, size_t record_size, size_t n, uint8_t *sel);
+
+ private:
+  std::vector<std::vector<batch_predicate>> minterms_;
+  std::vector<uint8_t> minterm_sel_;
+};
+
+}
+}
+
+#endif /* CONFLUO_PARSER_BATCH_EXPRESSION_H_ */
@@ -0,0 +1,80 @@
+#ifndef CONFLUO_PLANNER_COST_MODEL_H_
+#define CONFLUO_PLANNER_COST_MODEL_H_
+
+#include <cstdint>
+
+namespace confluo {
+namespace planner {
+
+/**
+ * Estimates the cost of the ways a query plan can read records, so that the
+ * planner can weigh index lookups against a full scan of the data log
+ */
+class cost_model {
+ public:
+  virtual ~cost_model();
+
+  /**
+   * Gets the cost of reading offsets from an index
+   *
+   * @param offsets The number of offsets read
+   *
+   * @return The cost
+   */
+  virtual double lookup_cost(double offsets) const = 0;
+
+  /**
+   * Gets the cost of fetching records at arbitrary offsets from the data
+   * log and testing them against the filter
+   *
+   * @param records The number of records fetched
+   *
+   * @return The cost
+   */
+  virtual double fetch_cost(double records) const = 0;
+
+  /**
+   * Gets the cost of scanning records sequentially from the data log and
+   * testing them against the filter
+   *
+   * @param records The number of records scanned
+   *
+   * @return The cost
+   */
+  virtual double scan_cost(double records) const = 0;
+};
+
+/**
+ * Cost model with a fixed cost per offset or record, relative to reading
+ * one index offset
+ */
+class linear_cost_model : public cost_model {
+ public:
+  /** Default cost of fetching one record at an arbitrary offset */
+  static constexpr double DEFAULT_FETCH_COST = 8.0;
+  /** Default cost of scanning one record */
+  static constexpr double DEFAULT_SCAN_COST = 1.0;
+
+  /**
+   * Constructs a linear cost model
+   *
+   * @param fetch_cost The cost of fetching one record at an arbitrary offset
+   * @param scan_cost The cost of scanning one record
+   */
+  linear_cost_model(double fetch_cost = DEFAULT_FETCH_COST, double scan_cost = DEFAULT_SCAN_COST);
+
+  virtual double lookup_cost(double offsets) const override;
+
+  virtual double fetch_cost(double records) const override;
+
+  virtual double scan_cost(double records) const override;
+
+ private:
+  double fetch_cost_;
+  double scan_cost_;
+};
+
+}
+}
+
+#endif /* CONFLUO_PLANNER_COST_MODEL_H_ */
@@ -0,0 +1,128 @@
+#ifndef CONFLUO_PLANNER_INDEX_STATS_H_
+#define CONFLUO_PLANNER_INDEX_STATS_H_
+
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "atomic.h"
+#include "optional.h"
+#include "container/monolog/monolog_exp2.h"
+#include "types/byte_string.h"
+
+namespace confluo {
+namespace planner {
+
+/**
+ * Statistics on the keys of an indexed column, maintained on append from a
+ * sample of the records: the smallest and largest key, an equi-depth
+ * histogram and a distinct count sketch. They let the planner estimate how
+ * many records a key range matches without walking the index.
+ *
+ * Writers update the statistics with every SAMPLE_INTERVAL-th record of
+ * the data log. The sampled keys are kept in a reservoir, from which the
+ * histogram is rebuilt once the reservoir has changed enough; distinct keys
+ * are counted with a HyperLogLog sketch. A writer that finds the statistics
+ * busy skips its sample rather than wait.
+ */
+class index_stats {
+ public:
+  /** Number of data log records per sampled record */
+  static const uint64_t SAMPLE_INTERVAL = 64;
+  /** Maximum number of sampled keys kept */
+  static const size_t RESERVOIR_SIZE = 4096;
+  /** Number of buckets in the equi-depth histogram */
+  static const size_t HISTOGRAM_BUCKETS = 128;
+  /** Number of samples below which no estimate is made */
+  static const size_t MIN_SAMPLES = 32;
+  /** Number of registers in the distinct count sketch */
+  static const size_t SKETCH_REGISTERS = 256;
+
+  /**
+   * Constructs empty statistics
+   */
+  index_stats();
+
+  /**
+   * Checks whether the statistics sample a record
+   *
+   * @param record_idx The index of the record in the data log
+   *
+   * @return True if the record is sampled, false otherwise
+   */
+  static bool is_sampled(uint64_t record_idx);
+
+  /**
+   * Adds the key of a sampled record
+   *
+   * @param key The index key of the record
+   */
+  void update(const byte_string &key);
+
+  /**
+   * Gets the number of sampled records
+   *
+   * @return The number of sampled records
+   */
+  size_t num_samples();
+
+  /**
+   * Estimates the fraction of records whose keys lie in a range. Keys that
+   * no sample saw may still be present, so the estimate is never below one
+   * record in the records the samples stand for.
+   *
+   * @param begin The first key of the range
+   * @param end The last key of the range
+   *
+   * @return The estimated fraction, if enough records have been sampled
+   */
+  utils::optional<double> selectivity(const byte_string &begin, const byte_string &end);
+
+  /**
+   * Estimates the number of distinct keys among the sampled records
+   *
+   * @return The estimated number of distinct keys
+   */
+  double distinct_count() const;
+
+  /**
+   * Gets the smallest sampled key
+   *
+   * @return The smallest sampled key
+   */
+  byte_string min();
+
+  /**
+   * Gets the largest sampled key
+   *
+   * @return The largest sampled key
+   */
+  byte_string max();
+
+ private:
+  void rebuild_histogram();
+
+  static uint64_t hash(const byte_string &key);
+
+  std::mutex mtx_;
+  std::minstd_rand rng_;
+  size_t seen_;
+  std::vector<byte_string> reservoir_;
+  byte_string min_;
+  byte_string max_;
+
+  // Bucket boundaries; each bucket holds an equal share of the samples
+  std::vector<byte_string> histogram_;
+  size_t histogram_seen_;
+
+  atomic::type<uint8_t> sketch_[SKETCH_REGISTERS];
+};
+
+/** Statistics for each index, by index id */
+typedef monolog::monolog_exp2<index_stats *> index_stats_log;
+
+}
+}
+
+#endif /* CONFLUO_PLANNER_INDEX_STATS_H_ */
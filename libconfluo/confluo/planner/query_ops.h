@@ -22,7 +22,9 @@ enum query_op_type {
   /** Operation that is invalid */
       D_NO_VALID_INDEX_OP = 2,
   /** Index operation */
-      D_INDEX_OP = 3
+      D_INDEX_OP = 3,
+  /** Intersection of index operations */
+      D_INTERSECT_OP = 4
 };
 
 /**
@@ -186,6 +188,51 @@ class index_op : public query_op {
   key_range range_;
 };
 
+/**
+ * Intersection operation class. A specific implementation of a query
+ * operation that intersects the offsets of several index operations before
+ * any record is read from the data log.
+ */
+class intersect_op : public query_op {
+ public:
+  /**
+   * Initializes the intersection operation
+   *
+   * @param ops The index operations, cheapest first
+   * @param estimate The estimated number of offsets in the intersection
+   */
+  intersect_op(const std::vector<std::shared_ptr<index_op>> &ops, uint64_t estimate);
+
+  /**
+   * Gets a string representation of the intersection operation
+   *
+   * @return The index operations that are intersected in a string
+   */
+  virtual std::string to_string() const override;
+
+  /**
+   * Gets the cost of the intersection operation
+   *
+   * @return The estimated number of offsets in the intersection
+   */
+  virtual uint64_t cost() const override;
+
+  /**
+   * Gets the offsets present in every index operation. The offsets of the
+   * cheapest operation are collected and sorted, and each of the other
+   * operations marks the ones it contains.
+   *
+   * @param version Version limit for the offsets
+   *
+   * @return The sorted offsets in the intersection
+   */
+  std::vector<uint64_t> query_offsets(uint64_t version);
+
+ private:
+  std::vector<std::shared_ptr<index_op>> ops_;
+  uint64_t estimate_;
+};
+
 }
 }
 
@@ -1,6 +1,8 @@
 #ifndef CONFLUO_PLANNER_QUERY_PLAN_H_
 #define CONFLUO_PLANNER_QUERY_PLAN_H_
 
+#include <unordered_set>
+
 #include <types/numeric.h>
 #include <aggregate/aggregate_ops.h>
 #include "container/lazy/stream.h"
@@ -8,6 +10,7 @@
 #include "container/cursor/record_cursors.h"
 #include "parser/expression_compiler.h"
 #include "query_ops.h"
+#include "streaming_aggregate.h"
 #include "exceptions.h"
 
 namespace confluo {
@@ -24,8 +27,10 @@ class query_plan : public std::vector<std::shared_ptr<query_op>> {
    * @param dlog The data log
    * @param schema The schema for the query plan
    * @param expr The query plan expression
+   * @param zones The zone maps of the data log, if any
    */
-  query_plan(const data_log *dlog, const schema_t *schema, const parser::compiled_expression &expr);
+  query_plan(const data_log *dlog, const schema_t *schema, const parser::compiled_expression &expr,
+             const zone_map *zones = nullptr);
 
   /**
    * Gets a string representation of the query plan
@@ -62,7 +67,8 @@ class query_plan : public std::vector<std::shared_ptr<query_op>> {
 
  private:
   /**
-   * Executes the query plan using full scan
+   * Executes the query plan using full scan, skipping the data log buckets
+   * and zones whose zone maps rule out the expression
    * @param version Version limit for execution
    * @return A record cursor over matching records
    */
@@ -75,9 +81,37 @@ class query_plan : public std::vector<std::shared_ptr<query_op>> {
    */
   std::unique_ptr<record_cursor> using_indexes(uint64_t version);
 
+  /**
+   * Aggregates matching records using a full scan, without materializing them
+   * @param version Version limit for execution
+   * @param sagg The aggregate to update
+   */
+  void aggregate_using_full_scan(uint64_t version, streaming_aggregate &sagg);
+
+  /**
+   * Aggregates matching records using indexes, without materializing them
+   * @param version Version limit for execution
+   * @param sagg The aggregate to update
+   */
+  void aggregate_using_indexes(uint64_t version, streaming_aggregate &sagg);
+
+  /**
+   * Checks whether any minterm intersects several indexes
+   * @return True if the plan contains an intersection, false otherwise
+   */
+  bool has_intersection();
+
+  /**
+   * Collects the offsets matched by the index lookups of every minterm
+   * @param version Version limit for the offsets
+   * @return The sorted, distinct offsets
+   */
+  std::vector<uint64_t> index_offsets(uint64_t version);
+
   const data_log *dlog_;
   const schema_t *schema_;
   const parser::compiled_expression &expr_;
+  const zone_map *zones_;
 };
 
 }
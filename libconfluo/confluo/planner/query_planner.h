@@ -7,6 +7,8 @@
 #include "container/radix_tree.h"
 #include "exceptions.h"
 #include "index_log.h"
+#include "cost_model.h"
+#include "index_stats.h"
 #include "query_ops.h"
 #include "query_plan.h"
 
@@ -36,8 +38,18 @@ class query_planner {
    * @param dlog A pointer to a data_log
    * @param idx_list A pointer to an index_log
    * @param schema A pointer to the schema
+   * @param stats A pointer to the statistics of each index, if any
+   * @param zones A pointer to the zone maps of the data log, if any
    */
-  query_planner(const data_log *dlog, const index_log *idx_list, const schema_t *schema);
+  query_planner(const data_log *dlog, const index_log *idx_list, const schema_t *schema,
+                const index_stats_log *stats = nullptr, const zone_map *zones = nullptr);
+
+  /**
+   * Replaces the cost model used to choose between plans. Plans already
+   * being made keep the model they started with.
+   * @param model The cost model
+   */
+  void set_cost_model(std::shared_ptr<cost_model> model);
 
   /**
    * Converts a compiled_expression to a list of query_ops
@@ -69,18 +81,38 @@ class query_planner {
    */
   bool add_range(key_range_map &ranges, uint32_t id, const key_range &r) const;
 
+  /**
+   * Estimates the number of offsets an index lookup returns, from the index
+   * statistics if they have enough samples and from the index otherwise
+   *
+   * @param index_id The id of the index
+   * @param r The key range to look up
+   * @param num_records The number of records in the data log
+   *
+   * @return The estimated number of offsets
+   */
+  double estimate_count(uint32_t index_id, const key_range &r, double num_records) const;
+
   /**
    * Optimizes the compiled minterm expression using the key ranges
    *
    * @param m The minterm to optimize
+   * @param num_records The number of records in the data log
+   * @param model The cost model to plan with
+   * @param cost The estimated cost of the returned index operation
    *
    * @return Pointer to the optimized query operation
    */
-  std::shared_ptr<query_op> optimize_minterm(const parser::compiled_minterm &m) const;
+  std::shared_ptr<query_op> optimize_minterm(const parser::compiled_minterm &m, double num_records,
+                                             const cost_model &model, double &cost) const;
 
   const data_log *dlog_;
   const index_log *idx_list_;
   const schema_t *schema_;
+  const index_stats_log *stats_;
+  const zone_map *zones_;
+  // Only accessed through std::atomic_load and std::atomic_store
+  std::shared_ptr<cost_model> cost_model_;
 };
 
 }
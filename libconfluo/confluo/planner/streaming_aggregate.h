@@ -0,0 +1,66 @@
+#ifndef CONFLUO_PLANNER_STREAMING_AGGREGATE_H_
+#define CONFLUO_PLANNER_STREAMING_AGGREGATE_H_
+
+#include <memory>
+
+#include "aggregate/aggregate_ops.h"
+#include "schema/column.h"
+#include "types/numeric.h"
+
+namespace confluo {
+namespace planner {
+
+/**
+ * Computes one of the standard aggregates (sum, min, max, count) over a
+ * primitive column, reading the field at its fixed offset straight from
+ * record data into a native accumulator. The result is only converted to a
+ * numeric at the end.
+ */
+class streaming_aggregate {
+ public:
+  /**
+   * Default destructor
+   */
+  virtual ~streaming_aggregate() = default;
+
+  /**
+   * Creates a streaming aggregate for an aggregator over a column
+   *
+   * @param agg The aggregator
+   * @param col The column to aggregate
+   *
+   * @return The streaming aggregate, or nullptr if the aggregator or the
+   * column type has no native implementation
+   */
+  static std::unique_ptr<streaming_aggregate> create(const aggregator &agg, const column_t &col);
+
+  /**
+   * Adds a single record to the aggregate
+   *
+   * @param record Pointer to the record
+   */
+  virtual void update(const uint8_t *record) = 0;
+
+  /**
+   * Adds the selected records of a block of consecutive records to the
+   * aggregate
+   *
+   * @param records Pointer to the first record in the block
+   * @param record_size The size of each record
+   * @param n The number of records in the block
+   * @param sel The selection flags, one per record
+   */
+  virtual void update_block(const uint8_t *records, size_t record_size, size_t n, const uint8_t *sel) = 0;
+
+  /**
+   * Gets the aggregate over all records added so far
+   *
+   * @return The aggregate
+   */
+  virtual numeric result() const = 0;
+};
+
+}
+}
+
+#endif /* CONFLUO_PLANNER_STREAMING_AGGREGATE_H_ */
@@ -2,6 +2,7 @@
 #define CONFLUO_READ_TAIL_H_
 
 #include <cstdint>
+#include <memory>
 #include <thread>
 
 #include "atomic.h"
@@ -9,6 +10,65 @@
 
 namespace confluo {
 
+/**
+ * A fixed-size, lock-free ring of completed write ranges that have not yet
+ * been folded into the read tail. Ranges are keyed by their start offset.
+ */
+class completion_ring {
+ public:
+  /** Log of the number of slots in the ring */
+  static const size_t RING_BITS = 10;
+  /** Number of slots in the ring */
+  static const size_t RING_SIZE = 1ULL << RING_BITS;
+  /** Marks a free slot */
+  static const uint64_t EMPTY = 0;
+  /** Marks a slot that is being filled */
+  static const uint64_t BUSY = UINT64_MAX;
+
+  /**
+   * A completed range [start, end); the start is stored offset by one
+   * so that a range starting at zero is distinguishable from a free slot.
+   */
+  struct slot {
+    atomic::type<uint64_t> start;
+    atomic::type<uint64_t> end;
+  };
+
+  /**
+   * Initializes an empty completion ring
+   */
+  completion_ring();
+
+  /**
+   * Publishes a completed range.
+   *
+   * @param start The start offset of the range
+   * @param end The end offset of the range
+   * @return True if the range was published, false if its slot was occupied
+   */
+  bool publish(uint64_t start, uint64_t end);
+
+  /**
+   * Removes the completed range starting at the given offset, if any.
+   *
+   * @param start The start offset of the range
+   * @param end Set to the end offset of the range on success
+   * @return True if a completed range was removed, false otherwise
+   */
+  bool consume(uint64_t start, uint64_t &end);
+
+ private:
+  /**
+   * Gets the slot for a range.
+   *
+   * @param start The start offset of the range
+   * @return The slot for the range
+   */
+  slot &slot_for(uint64_t start);
+
+  slot slots_[RING_SIZE];
+};
+
 /**
  * The read tail marker. Contains operations for modifying and setting
  * the marker for read requests.
@@ -47,7 +107,12 @@ class read_tail {
   uint64_t get() const;
 
   /**
-   * Advances the read tail marker by the specified number of bytes
+   * Marks the range [old_tail, old_tail + bytes) as written. Writers do not
+   * take turns advancing the marker: if the range is not at the read tail,
+   * it is left in the completion ring, and the writer that completes the
+   * range at the read tail advances it over all contiguous completed ranges,
+   * flushing the marker once per group. Either way, the range is readable
+   * and the marker flushed past it when this returns.
    *
    * @param old_tail The old tail marker
    * @param bytes The number of bytes to advance the read tail marker
@@ -55,8 +120,25 @@ class read_tail {
   void advance(uint64_t old_tail, uint32_t bytes);
 
  private:
+  /**
+   * Advances the read tail over all contiguous completed ranges, starting
+   * with a range ending at the given offset whose start is the read tail.
+   *
+   * @param tail The end offset of the range at the read tail
+   */
+  void commit_group(uint64_t tail);
+
+  /**
+   * Records that the marker has been flushed up to an offset.
+   *
+   * @param tail The flushed marker
+   */
+  void publish_flushed(uint64_t tail);
+
   atomic::type<uint64_t> *read_tail_{};
   storage::storage_mode mode_;
+  std::shared_ptr<completion_ring> completions_;
+  std::shared_ptr<atomic::type<uint64_t>> flushed_tail_;
 };
 
 }
@@ -83,6 +83,25 @@ class column_t {
    */
   double index_bucket_size() const;
 
+  /**
+   * Gets the kind of index on the column
+   * @return The index type
+   */
+  index_type_t index_type() const;
+
+  /**
+   * Gets the key under which a value is found in the column index
+   * @param value The value
+   * @return The index key
+   */
+  byte_string index_key(const immutable_value &value) const;
+
+  /**
+   * Gets the smallest and largest keys the column index may hold
+   * @return The range of index keys
+   */
+  std::pair<byte_string, byte_string> index_key_range() const;
+
   /**
    * Whether the column is indexed
    * @return True if the column is indexed, false otherwise
@@ -95,12 +114,28 @@ class column_t {
    */
   bool set_indexing();
 
+  /**
+   * Assigns an index to the column while it is being indexed, publishing it
+   * to writers for backfill
+   * @param index_id The id of the index
+   * @param bucket_size The size of the bucket
+   * @param type The kind of index
+   */
+  void set_backfilling(uint16_t index_id, double bucket_size, index_type_t type = RADIX_INDEX);
+
+  /**
+   * Gets the handoff between the backfill of the column index and writers
+   * @return The backfill handoff
+   */
+  backfill_handoff &index_handoff();
+
   /**
    * Sets index
    * @param index_id The id of the index
    * @param bucket_size The size of the bucket
+   * @param type The kind of index
    */
-  void set_indexed(uint16_t index_id, double bucket_size);
+  void set_indexed(uint16_t index_id, double bucket_size, index_type_t type = RADIX_INDEX);
 
   /**
    * Unindexes the column
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 
+#include "schema/index_state.h"
 #include "types/data_type.h"
 
 namespace confluo {
@@ -17,10 +18,14 @@ struct column_snapshot {
   size_t offset;
   /** Whether the column is indexed */
   bool indexed;
+  /** Whether the column is being indexed */
+  bool indexing;
   /** The identifier for the index */
   uint32_t index_id;
   /** The bucket size for the index */
   double index_bucket_size;
+  /** The kind of index */
+  index_type_t index_type;
 };
 
 }
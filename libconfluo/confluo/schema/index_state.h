@@ -3,16 +3,30 @@
 
 #include <cstdint>
 #include "atomic.h"
+#include "backfill_handoff.h"
 
 namespace confluo {
 
+/**
+ * Kinds of index that can be built on a column
+ */
+enum index_type_t : uint8_t {
+  /** Radix index over the column keys, one level per key byte; supports
+  equality and range lookups */
+  RADIX_INDEX = 0,
+  /** Radix index over 8-byte hashes of the column keys; supports equality
+  lookups only, and keeps wide keys such as strings shallow */
+  HASH_INDEX = 1
+};
+
 /**
  * Possible index stages
  */
 struct index_state_t {
   /** Not indexed */
   static const uint8_t UNINDEXED = 0;
-  /** In the process of being indexed */
+  /** In the process of being indexed; once an index has been assigned,
+  writers insert records past the backfill handoff into it */
   static const uint8_t INDEXING = 1;
   /** Already indexed */
   static const uint8_t INDEXED = 2;
@@ -43,6 +57,13 @@ struct index_state_t {
    */
   double bucket_size() const;
 
+  /**
+   * Gets the kind of index of this index state
+   *
+   * @return The index type
+   */
+  index_type_t type() const;
+
   /**
    * Assigns the other index state to this index state
    *
@@ -53,6 +74,20 @@ struct index_state_t {
    */
   index_state_t &operator=(const index_state_t &other);
 
+  /**
+   * Gets the current index stage
+   *
+   * @return The index stage
+   */
+  uint8_t state() const;
+
+  /**
+   * Gets the handoff between the backfill of the index and writers
+   *
+   * @return The backfill handoff
+   */
+  backfill_handoff &handoff();
+
   /**
    * Checks whether this index state is in the indexed stage
    *
@@ -67,13 +102,24 @@ struct index_state_t {
    */
   bool set_indexing();
 
+  /**
+   * Assigns an index to a column in the indexing stage, and publishes it to
+   * writers so that the index can be backfilled
+   *
+   * @param index_id The identifier for the index
+   * @param bucket_size The bucket size for lookup
+   * @param type The kind of index
+   */
+  void set_backfilling(uint16_t index_id, double bucket_size, index_type_t type = RADIX_INDEX);
+
   /**
    * Sets the index stage to be indexed
    *
    * @param index_id The identifier for the index
    * @param bucket_size The bucket size for lookup
+   * @param type The kind of index
    */
-  void set_indexed(uint16_t index_id, double bucket_size);
+  void set_indexed(uint16_t index_id, double bucket_size, index_type_t type = RADIX_INDEX);
 
   /**
    * Sets the index stage to be not indexed
@@ -91,6 +137,8 @@ struct index_state_t {
   atomic::type<uint8_t> state_;
   uint16_t id_;
   double bucket_size_;
+  index_type_t type_;
+  backfill_handoff handoff_;
 };
 
 }
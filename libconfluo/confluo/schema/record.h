@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <memory>
 
 #include "storage/swappable_encoded_ptr.h"
 #include "field.h"
@@ -41,6 +42,15 @@ struct record_t {
    */
   record_t(size_t log_offset, storage::read_only_encoded_ptr<uint8_t> data, size_t size);
 
+  /**
+   * Constructor using a copy of the data that the record shares ownership
+   * of, so that it does not pin the data log
+   * @param log_offset log offset
+   * @param data shared copy of the data
+   * @param size size of data
+   */
+  record_t(size_t log_offset, std::shared_ptr<uint8_t> data, size_t size);
+
   /**
    * Reserves n bytes for the record
    *
@@ -165,6 +175,7 @@ struct record_t {
   size_t log_offset_;
   uint8_t *data_;
   storage::read_only_encoded_ptr<uint8_t> ptr_;
+  std::shared_ptr<uint8_t> decoded_;
   size_t size_;
   uint64_t version_;
   std::vector<field_t> fields_;
@@ -120,6 +120,16 @@ class schema_t {
    */
   record_t apply(size_t offset, storage::read_only_encoded_ptr<uint8_t> &data) const;
 
+  /**
+   * Applies the schema on a copy of raw data to get a record
+   *
+   * @param offset The offset of the record from the log
+   * @param data The copy of the data, which the record shares ownership of
+   *
+   * @return Record containing the data
+   */
+  record_t apply(size_t offset, std::shared_ptr<uint8_t> data) const;
+
   /**
    * Applies the schema on raw data to get a record.
    * Note that usage of the record relies on the lifetime of
@@ -139,6 +149,14 @@ class schema_t {
    */
   schema_snapshot snapshot() const;
 
+  /**
+   * Refreshes an existing snapshot of the schema in place, reusing its
+   * storage
+   *
+   * @param snap The snapshot to refresh
+   */
+  void snapshot(schema_snapshot &snap) const;
+
   /**
    * Gets a vector of columns from the schema
    *
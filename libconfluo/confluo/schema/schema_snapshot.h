@@ -32,6 +32,11 @@ class schema_snapshot {
    */
   void add_column(column_snapshot &&snap);
 
+  /**
+   * Removes all columns from the snapshot, retaining its storage
+   */
+  void clear();
+
   /**
    * Gets the data for a specific column in the schema snapshot
    *
@@ -57,7 +62,8 @@ class schema_snapshot {
    * @param ptr The pointer to wherere the key is
    * @param i The index of the column snapshot to find the key
    *
-   * @return Byte string containing the key of the snapshot
+   * @return Byte string containing the key of the snapshot, hashed if the
+   * column has a hash index
    */
   byte_string get_key(void *ptr, uint32_t i) const;
 
@@ -80,6 +86,24 @@ class schema_snapshot {
    */
   bool is_indexed(size_t i) const;
 
+  /**
+   * Whether the specified column snapshot is being indexed
+   *
+   * @param i The index of the column snapshot
+   *
+   * @return True if the column snapshot is being indexed, false otherwise
+   */
+  bool is_indexing(size_t i) const;
+
+  /**
+   * Gets the kind of index of a column snapshot
+   *
+   * @param i The index of the column snapshot
+   *
+   * @return The index type
+   */
+  index_type_t index_type(size_t i) const;
+
   /**
    * Gets the id of the index of a column snapshot
    *
@@ -1,7 +1,9 @@
 #ifndef CONFLUO_STORAGE_ENCODED_PTR_H_
 #define CONFLUO_STORAGE_ENCODED_PTR_H_
 
+#include "compression/columnar_decoder.h"
 #include "compression/delta_decoder.h"
+#include "compression/lz4_block_cache.h"
 #include "compression/lz4_decoder.h"
 #include "ptr_metadata.h"
 
@@ -105,9 +107,13 @@ class encoded_ptr {
         return decoded;
       }
       case encoding_type::D_LZ4: {
-        T decoded = compression::lz4_decoder<>::decode(this->ptr_as<uint8_t>(), idx);
+        uint8_t decoded;
+        compression::lz4_block_cache::instance().decode(this->ptr_as<uint8_t>(), &decoded, idx, 1);
         return decoded;
       }
+      case encoding_type::D_COLUMNAR: {
+        return compression::columnar_decoder::decode(this->ptr_as<uint8_t>(), idx);
+      }
       default: {
         THROW(illegal_state_exception, "Invalid encoding type!");
       }
@@ -132,8 +138,13 @@ class encoded_ptr {
         break;
       }
       case encoding_type::D_LZ4: {
-        compression::lz4_decoder<>::decode(this->ptr_as<uint8_t>(),
-                                           reinterpret_cast<uint8_t *>(buffer), start_idx, len);
+        compression::lz4_block_cache::instance().decode(this->ptr_as<uint8_t>(),
+                                                        reinterpret_cast<uint8_t *>(buffer), start_idx, len);
+        break;
+      }
+      case encoding_type::D_COLUMNAR: {
+        compression::columnar_decoder::decode(this->ptr_as<uint8_t>(), reinterpret_cast<uint8_t *>(buffer),
+                                              start_idx, len);
         break;
       }
       default: {
@@ -180,12 +191,44 @@ class encoded_ptr {
         compression::lz4_decoder<>::decode(this->ptr_as<uint8_t>(), decoded, start_idx);
         return decoded_ptr<T>(reinterpret_cast<T *>(decoded), detail::array_delete<T>);
       }
+      case encoding_type::D_COLUMNAR: {
+        size_t decoded_size = compression::columnar_decoder::decoded_size(this->ptr_as<uint8_t>());
+        uint8_t *decoded = new uint8_t[decoded_size - start_idx];
+        compression::columnar_decoder::decode(this->ptr_as<uint8_t>(), decoded, start_idx, decoded_size - start_idx);
+        return decoded_ptr<T>(reinterpret_cast<T *>(decoded), detail::array_delete<T>);
+      }
       default: {
         THROW(illegal_state_exception, "Invalid encoding type!");
       }
     }
   }
 
+  /**
+   * Decode pointer, starting at an index, for a known number of elements.
+   * Unlike decode(start_idx), encoded data is only decoded for the requested
+   * range, so the returned pointer is only valid for len elements.
+   * @param start_idx index to start decoding at
+   * @param len number of elements
+   * @return decoded pointer
+   */
+  decoded_ptr<T> decode_ptr(size_t start_idx, size_t len) const {
+    auto aux = ptr_aux_block::get(ptr_metadata::get(ptr_));
+    if (aux.encoding_ == encoding_type::D_UNENCODED) {
+      return decoded_ptr<T>(this->ptr_as<T>() + start_idx, detail::no_op_delete<T>);
+    }
+    T *decoded = new T[len];
+    decode(decoded, start_idx, len);
+    return decoded_ptr<T>(decoded, detail::array_delete<T>);
+  }
+
+  /**
+   * Check if the pointer is backed by encoded data.
+   * @return true if decoding the pointer requires a copy, false otherwise
+   */
+  bool is_encoded() const {
+    return ptr_aux_block::get(ptr_metadata::get(ptr_)).encoding_ != encoding_type::D_UNENCODED;
+  }
+
  private:
   void *ptr_; // encoded data stored at this pointer
 
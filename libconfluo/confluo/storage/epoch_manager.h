@@ -0,0 +1,133 @@
+#ifndef CONFLUO_STORAGE_EPOCH_MANAGER_H_
+#define CONFLUO_STORAGE_EPOCH_MANAGER_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#include "atomic.h"
+
+namespace confluo {
+namespace storage {
+
+/**
+ * Epoch-based reclamation for pointers that readers load without taking a
+ * reference, such as buckets swapped out by archival.
+ *
+ * Readers enter the current epoch before loading a pointer and leave once
+ * they no longer use it. Reader counts for the two most recent epochs are
+ * kept per thread slot, so that concurrent readers do not contend on a
+ * single counter. A retired pointer is tagged with the epoch it was retired
+ * in, and is destroyed once the epoch has advanced twice past it: every
+ * reader that could have loaded it has left by then.
+ *
+ * Entering is re-entrant on a thread; only the outermost enter and leave
+ * touch the reader counts.
+ */
+class epoch_manager {
+ public:
+  /** Number of per-thread slots */
+  static const size_t NUM_SLOTS = 64;
+
+  /** Destroys and deallocates a retired pointer */
+  typedef void (*deleter_fn)(void *);
+
+  /**
+   * Keeps the current epoch entered for the lifetime of the guard. Must be
+   * destroyed on the thread that created it.
+   */
+  class guard {
+   public:
+    /**
+     * Enters the current epoch
+     */
+    guard();
+
+    /**
+     * Leaves the entered epoch
+     */
+    ~guard();
+
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+  };
+
+  /**
+   * Gets the epoch manager shared by all storage
+   *
+   * @return The epoch manager
+   */
+  static epoch_manager &instance();
+
+  /**
+   * Enters the current epoch, unless the calling thread is already in one
+   */
+  void enter();
+
+  /**
+   * Leaves the epoch entered by the matching call to enter()
+   */
+  void leave();
+
+  /**
+   * Defers destruction of a pointer until no reader can hold it
+   *
+   * @param ptr The pointer to retire
+   * @param deleter The function that destroys and deallocates it
+   */
+  void retire(void *ptr, deleter_fn deleter);
+
+  /**
+   * Advances the epoch as far as readers allow, and destroys the retired
+   * pointers no reader can hold anymore
+   *
+   * @return The number of pointers destroyed
+   */
+  size_t try_reclaim();
+
+  /**
+   * Gets the number of retired pointers not destroyed yet
+   *
+   * @return The number of retired pointers
+   */
+  size_t pending();
+
+  /**
+   * Gets the current epoch
+   *
+   * @return The current epoch
+   */
+  uint64_t epoch() const;
+
+ private:
+  /** A slot, aligned to its own cache line */
+  struct alignas(64) slot {
+    atomic::type<int64_t> readers[2];
+  };
+
+  /** A pointer waiting to be destroyed */
+  struct retired_ptr {
+    void *ptr;
+    deleter_fn deleter;
+    uint64_t epoch;
+  };
+
+  epoch_manager();
+
+  bool try_advance();
+
+  int64_t readers(uint64_t epoch) const;
+
+  static size_t thread_slot();
+
+  slot slots_[NUM_SLOTS];
+  atomic::type<uint64_t> epoch_;
+  std::mutex retired_mtx_;
+  std::vector<retired_ptr> retired_;
+};
+
+}
+}
+
+#endif /* CONFLUO_STORAGE_EPOCH_MANAGER_H_ */
@@ -4,6 +4,7 @@
 #include "atomic.h"
 #include <cstdlib>
 #include <cstdint>
+#include <mutex>
 
 namespace confluo {
 namespace storage {
@@ -11,10 +12,19 @@ namespace storage {
 /**
  * The memory stat class. Contains functionality for modifying the amount
  * of memory used.
+ *
+ * Updates go to one of a fixed number of per-thread slots, so that
+ * threads allocating concurrently do not contend on a single counter; the
+ * slots are summed when the total is read.
  */
 class memory_stat {
 
  public:
+  /** Number of per-thread slots */
+  static const size_t NUM_SLOTS = 64;
+  /** Bytes a slot may grow by before the approximate total is refreshed */
+  static const int64_t SYNC_BYTES = 1024 * 1024;
+
   /**
    * Initializes memory statistics.
    */
@@ -35,14 +45,35 @@ class memory_stat {
   void decrement(size_t size);
 
   /**
-   * Loads the amount of memory used
+   * Loads the amount of memory used, summing all slots. Sums are taken one
+   * at a time, so that a slower sum never overwrites a newer approximate
+   * total.
    *
    * @return The amount of memory used
    */
   size_t get();
 
+  /**
+   * Loads the amount of memory used as of the last refresh, without
+   * summing the slots. It may lag behind growth by up to SYNC_BYTES per
+   * slot.
+   *
+   * @return The approximate amount of memory used
+   */
+  size_t approximate() const;
+
  private:
-  atomic::type<size_t> memory_used_;
+  /** A slot, aligned to its own cache line */
+  struct alignas(64) slot {
+    atomic::type<int64_t> used;
+    atomic::type<int64_t> unsynced;
+  };
+
+  static size_t thread_slot();
+
+  slot slots_[NUM_SLOTS];
+  atomic::type<size_t> approximate_;
+  std::mutex sum_mtx_;
 
 };
 
@@ -22,6 +22,7 @@ typedef struct encoding_type {
   static const uint8_t D_UNENCODED = 0;
   static const uint8_t D_LZ4 = 1;
   static const uint8_t D_ELIAS_GAMMA = 2;
+  static const uint8_t D_COLUMNAR = 3;
 } encoding_type;
 
 /**
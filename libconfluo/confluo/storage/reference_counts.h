@@ -23,6 +23,10 @@ class reference_counts {
 
   void increment_both();
 
+  bool increment_first_if_nonzero();
+
+  bool increment_second_if_nonzero();
+
   void decrement_first();
 
   void decrement_second();
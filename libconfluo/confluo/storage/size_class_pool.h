@@ -0,0 +1,89 @@
+#ifndef CONFLUO_STORAGE_SIZE_CLASS_POOL_H_
+#define CONFLUO_STORAGE_SIZE_CLASS_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace confluo {
+namespace storage {
+
+/**
+ * Thread-local pools of memory blocks, one per size class. Requests are
+ * rounded up to the next of four size classes per power of two, and freed
+ * blocks are kept on the freeing thread's list for that class, so that
+ * the fixed-size objects allocated on hot paths (aggregate nodes, radix
+ * tree nodes, reflog buckets) are recycled without going through malloc.
+ * Requests larger than MAX_POOLED_SIZE go to malloc directly.
+ *
+ * Blocks cached on a thread's free lists are not returned to malloc until
+ * the thread exits; a thread caches at most MAX_CACHED_BYTES, or
+ * MIN_CACHED_BLOCKS blocks, per class.
+ */
+class size_class_pool {
+ public:
+  /** Size of the smallest class */
+  static const size_t MIN_CLASS_SIZE = 32;
+  /** Size of the largest class */
+  static const size_t MAX_POOLED_SIZE = 32768;
+  /** Number of size classes */
+  static const size_t NUM_CLASSES = 41;
+  /** Bytes a thread keeps on the free list of a class, beyond a minimum
+   * number of blocks */
+  static const size_t MAX_CACHED_BYTES = 1024 * 1024;
+  /** Blocks a thread may keep on the free list of any class */
+  static const size_t MIN_CACHED_BLOCKS = 16;
+
+  /**
+   * Allocates a block of at least the given size
+   *
+   * @param size The size in bytes
+   * @return Pointer to the block
+   */
+  static void *alloc(size_t size);
+
+  /**
+   * Frees a block returned by alloc
+   *
+   * @param ptr Pointer to the block
+   * @param size The size the block was allocated with
+   */
+  static void dealloc(void *ptr, size_t size);
+
+  /**
+   * Gets the size class of a request
+   *
+   * @param size The size in bytes
+   * @return The size class, NUM_CLASSES if the request is not pooled
+   */
+  static size_t class_of(size_t size);
+
+  /**
+   * Gets the size of the blocks of a size class
+   *
+   * @param size_class The size class
+   * @return The size of its blocks in bytes
+   */
+  static size_t class_size(size_t size_class);
+
+  /**
+   * Gets the size of the block that serves a request, including the
+   * rounding up to its size class
+   *
+   * @param size The size in bytes
+   * @return The size of the block in bytes
+   */
+  static size_t block_size(size_t size);
+
+  /**
+   * Gets the number of blocks the calling thread keeps for a size class
+   *
+   * @param size_class The size class
+   * @return The number of cached blocks
+   */
+  static size_t cached_blocks(size_t size_class);
+};
+
+}
+}
+
+#endif /* CONFLUO_STORAGE_SIZE_CLASS_POOL_H_ */
@@ -10,14 +10,14 @@
 #include "mmap_utils.h"
 #include "ptr_aux_block.h"
 #include "ptr_metadata.h"
+#include "size_class_pool.h"
 
 namespace confluo {
 namespace storage {
 
-// TODO: delegate requests to memory pools
-
 /**
- * Storage allocator class. Interface for managing memory and storage
+ * Storage allocator class. Interface for managing memory and storage.
+ * In-memory allocations are served from thread-local size class pools.
  */
 class storage_allocator {
  public:
@@ -70,7 +70,10 @@ class storage_allocator {
   void dealloc(void *ptr);
 
   /**
-   * Gets the memory utilization stats
+   * Gets the memory utilization stats. In-memory allocations count the
+   * size of the pooled block that serves them, including the rounding up
+   * to its size class. Freed blocks that threads keep cached for reuse are
+   * not counted; see size_class_pool for how much a thread may cache.
    *
    * @return The utilization of memory
    */
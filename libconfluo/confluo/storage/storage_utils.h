@@ -2,6 +2,7 @@
 #define CONFLUO_STORAGE_STORAGE_UTILS_H_
 
 #include <new>
+#include "allocator.h"
 #include "ptr_metadata.h"
 
 namespace confluo {
@@ -44,6 +45,17 @@ struct lifecycle_util<T, std::enable_if<std::is_fundamental<T>::value>> {
   static void destroy(void *ptr) {}
 };
 
+/**
+ * Destroys and deallocates a pointer allocated by the allocator. Serves as
+ * the deleter for pointers retired to the epoch manager.
+ * @param ptr pointer to array allocated by an allocator
+ */
+template<typename T>
+void destroy_and_dealloc(void *ptr) {
+  lifecycle_util<T>::destroy(ptr);
+  allocator::instance().dealloc(ptr);
+}
+
 }
 }
 
@@ -4,6 +4,7 @@
 #include "allocator.h"
 #include "atomic.h"
 #include "encoded_ptr.h"
+#include "epoch_manager.h"
 #include "reference_counts.h"
 #include "storage_utils.h"
 
@@ -51,6 +52,18 @@ class read_only_encoded_ptr {
     }
   }
 
+  /**
+   * Move constructor. Takes over the reference of the other pointer.
+   * @param other other pointer
+   */
+  read_only_encoded_ptr(read_only_encoded_ptr<T> &&other)
+      : enc_ptr_(other.enc_ptr_),
+        offset_(other.offset_),
+        ref_counts_(other.ref_counts_) {
+    other.enc_ptr_ = encoded_ptr<T>();
+    other.ref_counts_ = nullptr;
+  }
+
   /**
    * Assignment operator. Increments reference count.
    * @param other other pointer
@@ -67,6 +80,20 @@ class read_only_encoded_ptr {
     return *this;
   }
 
+  /**
+   * Move assignment operator. Takes over the reference of the other pointer.
+   * @param other other pointer
+   * @return this read only pointer
+   */
+  read_only_encoded_ptr &operator=(read_only_encoded_ptr<T> &&other) {
+    if (this != &other) {
+      init(other.enc_ptr_, other.offset_, other.ref_counts_);
+      other.enc_ptr_ = encoded_ptr<T>();
+      other.ref_counts_ = nullptr;
+    }
+    return *this;
+  }
+
   ~read_only_encoded_ptr() {
     decrement_compare_dealloc();
   }
@@ -142,6 +169,24 @@ class read_only_encoded_ptr {
     return enc_ptr_.decode(idx + offset_);
   }
 
+  /**
+   * Decode pointer from index onwards, for a known number of elements.
+   * @param idx start index
+   * @param len number of elements
+   * @return decoded pointer, valid for len elements
+   */
+  decoded_ptr<T> decode_ptr(size_t idx, size_t len) const {
+    return enc_ptr_.decode_ptr(idx + offset_, len);
+  }
+
+  /**
+   * Check if the pointer is backed by encoded data.
+   * @return true if decoding the pointer requires a copy, false otherwise
+   */
+  bool is_encoded() const {
+    return enc_ptr_.is_encoded();
+  }
+
   /**
    * Decodes length bytes of pointer from
    * index onwards and stores in a buffer.
@@ -170,7 +215,9 @@ class read_only_encoded_ptr {
  private:
   /**
    * Decrements the reference count if pointer and reference count are
-   * not null. Destroys and deallocates the pointer if reference count reaches 0.
+   * not null. If the reference count reaches 0, retires a swapped out
+   * pointer, which readers in an epoch may still be using, and destroys
+   * and deallocates any other pointer.
    */
   void decrement_compare_dealloc() {
     void *internal_ptr = enc_ptr_.ptr();
@@ -178,8 +225,7 @@ class read_only_encoded_ptr {
       auto *metadata = ptr_metadata::get(internal_ptr);
       bool uses_first_count = ptr_aux_block::get(metadata).state_ == state_type::D_IN_MEMORY;
       if (uses_first_count && ref_counts_->decrement_first_and_compare()) {
-        lifecycle_util<T>::destroy(internal_ptr);
-        allocator::instance().dealloc(internal_ptr);
+        epoch_manager::instance().retire(internal_ptr, destroy_and_dealloc<T>);
       } else if (!uses_first_count && ref_counts_->decrement_second_and_compare()) {
         lifecycle_util<T>::destroy(internal_ptr);
         allocator::instance().dealloc(internal_ptr);
@@ -274,9 +320,9 @@ class swappable_encoded_ptr {
   }
 
   /**
-   * Get the stored pointer. It is unsafe to access the pointer
-   * through this method since it may be deallocated. For safe
-   * access create a read-only copy.
+   * Get the stored pointer. The pointer is only safe to access while
+   * the epoch it was loaded in is entered, since a swap may retire it;
+   * to hold on to it beyond that, create a read-only copy.
    * @return pointer
    */
   encoded_ptr<T> atomic_load() const {
@@ -298,9 +344,10 @@ class swappable_encoded_ptr {
     encoded_ptr<T> old_ptr = atomic::load(&enc_ptr_).ptr();
     // Store new pointer
     atomic::store(&enc_ptr_, new_ptr);
-    // Deallocate old pointer if there are no copies.
+    // Retire old pointer if there are no copies; readers that loaded it
+    // within an epoch may still be using it.
     if (ref_counts_.decrement_first_and_compare()) {
-      destroy_dealloc(old_ptr);
+      epoch_manager::instance().retire(old_ptr.ptr(), destroy_and_dealloc<T>);
     }
   }
 
@@ -310,10 +357,20 @@ class swappable_encoded_ptr {
    * @return value at index
    */
   T atomic_get_decode(size_t idx) const {
-    ref_counts_.increment_both();
-    T result = atomic::load(&enc_ptr_).decode_at(idx);
-    ref_counts_.decrement_both();
-    return result;
+    epoch_manager::guard guard;
+    return atomic::load(&enc_ptr_).decode_at(idx);
+  }
+
+  /**
+   * Atomically decode len elements from the logical index idx onwards
+   * into a buffer.
+   * @param buffer buffer to store in
+   * @param idx logical index into decoded data
+   * @param len number of elements
+   */
+  void atomic_decode(T *buffer, size_t idx, size_t len) const {
+    epoch_manager::guard guard;
+    atomic::load(&enc_ptr_).decode(buffer, idx, len);
   }
 
   /**
@@ -323,33 +380,30 @@ class swappable_encoded_ptr {
    * @param offset The offset into pointer
    */
   void atomic_copy(read_only_encoded_ptr<T> &copy, size_t offset = 0) const {
-    // Increment both counters to guarantee that the loaded
-    // pointer can't be deallocated if there are no copies.
-    // Protects against loading before a swap begins and
-    // making a copy after the swap finishes.
-    ref_counts_.increment_both();
-    encoded_ptr<T> ptr = atomic::load(&enc_ptr_);
-
-    if (ptr.ptr() == nullptr) {
-      // Decrement both ref counts (no possibility of them reaching 0 here)
-      ref_counts_.decrement_both();
-      return;
-    }
+    // The epoch keeps the loaded pointer from being deallocated until its
+    // count is taken. A count that already dropped to 0 belongs to a
+    // pointer that was swapped out and retired; reload the new one.
+    epoch_manager::guard guard;
+    while (true) {
+      encoded_ptr<T> ptr = atomic::load(&enc_ptr_);
+      if (ptr.ptr() == nullptr) {
+        return;
+      }
 
-    // Correct the other counter and create the copy.
-    auto aux = ptr_aux_block::get(ptr_metadata::get(ptr.ptr()));
-    if (aux.state_ == state_type::D_IN_MEMORY) {
-      // decrement other ref count (no possibility of it reaching 0 here)
-      ref_counts_.decrement_second();
-      copy.init(ptr, offset, &ref_counts_);
-      return;
-    } else if (aux.state_ == state_type::D_ARCHIVED) {
-      // decrement other ref count (no possibility of it reaching 0 here)
-      ref_counts_.decrement_first();
-      copy.init(ptr, offset, &ref_counts_);
-      return;
-    } else {
-      THROW(memory_exception, "Unsupported pointer state during copy!");
+      auto aux = ptr_aux_block::get(ptr_metadata::get(ptr.ptr()));
+      if (aux.state_ == state_type::D_IN_MEMORY) {
+        if (ref_counts_.increment_first_if_nonzero()) {
+          copy.init(ptr, offset, &ref_counts_);
+          return;
+        }
+      } else if (aux.state_ == state_type::D_ARCHIVED) {
+        if (ref_counts_.increment_second_if_nonzero()) {
+          copy.init(ptr, offset, &ref_counts_);
+          return;
+        }
+      } else {
+        THROW(memory_exception, "Unsupported pointer state during copy!");
+      }
     }
   }
 
@@ -3,6 +3,7 @@
 
 #include "allocator.h"
 #include "atomic.h"
+#include "epoch_manager.h"
 #include "reference_counts.h"
 #include "storage_utils.h"
 
@@ -102,15 +103,16 @@ class read_only_ptr {
  private:
   /**
    * Decrements the reference count if pointer and reference count are
-   * not null. Destroys and deallocates the pointer if reference count reaches 0.
+   * not null. If the reference count reaches 0, retires a swapped out
+   * pointer, which readers in an epoch may still be using, and destroys
+   * and deallocates any other pointer.
    */
   void decrement_compare_dealloc() {
     if (ptr_ != nullptr && ref_counts_ != nullptr) {
       auto aux = ptr_aux_block::get(ptr_metadata::get(ptr_));
       bool uses_first_count = aux.state_ == state_type::D_IN_MEMORY;
       if (uses_first_count && ref_counts_->decrement_first_and_compare()) {
-        lifecycle_util<T>::destroy(ptr_);
-        allocator::instance().dealloc(ptr_);
+        epoch_manager::instance().retire(ptr_, destroy_and_dealloc<T>);
       } else if (!uses_first_count && ref_counts_->decrement_second_and_compare()) {
         lifecycle_util<T>::destroy(ptr_);
         allocator::instance().dealloc(ptr_);
@@ -203,9 +205,9 @@ class swappable_ptr {
   }
 
   /**
-   * Get the stored pointer. It is unsafe to access the pointer
-   * through this method since it may be deallocated. For safe
-   * access create a read-only copy.
+   * Get the stored pointer. The pointer is only safe to access while
+   * the epoch it was loaded in is entered, since a swap may retire it;
+   * to hold on to it beyond that, create a read-only copy.
    * @return pointer
    */
   T *atomic_load() const {
@@ -227,9 +229,10 @@ class swappable_ptr {
     T *old_ptr = atomic::load(&ptr_);
     // Store new pointer
     atomic::store(&ptr_, new_ptr);
-    // Deallocate old pointer if there are no copies.
+    // Retire old pointer if there are no copies; readers that loaded it
+    // within an epoch may still be using it.
     if (ref_counts_.decrement_first_and_compare()) {
-      destroy_dealloc(old_ptr);
+      epoch_manager::instance().retire(old_ptr, destroy_and_dealloc<T>);
     }
   }
 
@@ -252,33 +255,30 @@ class swappable_ptr {
    * @param offset offset into pointer
    */
   void atomic_copy(read_only_ptr<T> &copy, size_t offset = 0) const {
-    // Increment both counters to guarantee that the loaded
-    // pointer can't be deallocated if there are no copies.
-    // Protects against loading before a swap begins and
-    // making a copy after the swap finishes.
-    ref_counts_.increment_both();
-    T *ptr = atomic::load(&ptr_);
-
-    if (ptr == nullptr) {
-      // Decrement both ref counts (no possibility of them reaching 0 here)
-      ref_counts_.decrement_both();
-      return;
-    }
+    // The epoch keeps the loaded pointer from being deallocated until its
+    // count is taken. A count that already dropped to 0 belongs to a
+    // pointer that was swapped out and retired; reload the new one.
+    epoch_manager::guard guard;
+    while (true) {
+      T *ptr = atomic::load(&ptr_);
+      if (ptr == nullptr) {
+        return;
+      }
 
-    // Correct the other counter and create the copy.
-    auto aux = ptr_aux_block::get(ptr_metadata::get(ptr));
-    if (aux.state_ == state_type::D_IN_MEMORY) {
-      // decrement other ref count (no possibility of it reaching 0 here)
-      ref_counts_.decrement_second();
-      copy.init(ptr, offset, &ref_counts_);
-      return;
-    } else if (aux.state_ == state_type::D_ARCHIVED) {
-      // decrement other ref count (no possibility of it reaching 0 here)
-      ref_counts_.decrement_first();
-      copy.init(ptr, offset, &ref_counts_);
-      return;
-    } else {
-      THROW(memory_exception, "Unsupported pointer state during copy!");
+      auto aux = ptr_aux_block::get(ptr_metadata::get(ptr));
+      if (aux.state_ == state_type::D_IN_MEMORY) {
+        if (ref_counts_.increment_first_if_nonzero()) {
+          copy.init(ptr, offset, &ref_counts_);
+          return;
+        }
+      } else if (aux.state_ == state_type::D_ARCHIVED) {
+        if (ref_counts_.increment_second_if_nonzero()) {
+          copy.init(ptr, offset, &ref_counts_);
+          return;
+        }
+      } else {
+        THROW(memory_exception, "Unsupported pointer state during copy!");
+      }
     }
   }
 
@@ -9,18 +9,20 @@
 
 #include "atomic.h"
 #include "logger.h"
+#include "task_scheduler.h"
 
 /**
  * The periodic task class. Contains functionality to start and stop
- * the specified task.
+ * the specified task, which runs on the workers of a task scheduler.
  */
 class periodic_task {
  public:
   /**
    * Constructor for periodic name that initializes the task
    * @param name The name of the task
+   * @param scheduler The scheduler that runs the task
    */
-  periodic_task(const std::string &name);
+  periodic_task(const std::string &name, task_scheduler &scheduler = task_scheduler::instance());
 
   /**
    * Default destructor that stops the task
@@ -28,7 +30,7 @@ class periodic_task {
   ~periodic_task();
 
   /**
-   * Stops the periodic task
+   * Stops the periodic task, waiting for a run in progress to finish
    * @return True if the task was successfully stopped, false if the
    * task was already stopped
    */
@@ -38,14 +40,29 @@ class periodic_task {
    * Starts the periodic task to run
    * @param task The function that represents the work to do
    * @param interval_ms The time in between executions of the task
-   * @return True if the task was executed successfully, false otherwise
+   * @return True if the task was started, false if it was already running
    */
   bool start(std::function<void(void)> task, uint64_t interval_ms = 1);
 
+  /**
+   * Runs the task as soon as possible, ahead of its interval
+   */
+  void notify();
+
+  /**
+   * Gets the statistics on the runs of the task, including the runs that
+   * overshot its interval
+   * @return The statistics on the runs of the task, all zero if the task
+   * is not running
+   */
+  task_scheduler::task_stats stats() const;
+
  private:
   std::string name_;
-  atomic::type<bool> enabled_;
-  std::thread executor_;
+  task_scheduler &scheduler_;
+  mutable std::mutex mtx_;
+  bool enabled_;
+  task_scheduler::task_id id_;
 };
 
 #endif /* CONFLUO_THREADS_PERIODIC_TASK_H_ */
@@ -0,0 +1,175 @@
+#ifndef CONFLUO_THREADS_TASK_SCHEDULER_H_
+#define CONFLUO_THREADS_TASK_SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "logger.h"
+
+/**
+ * Runs timed tasks on a bounded pool of workers, so that many periodic
+ * tasks share a few threads instead of owning one each.
+ *
+ * A single ticker thread drives a timer wheel: tasks due at a tick hash to
+ * the wheel slot for that tick, and tasks due after more than a rotation
+ * stay in their slot until their tick comes around. The ticker sleeps
+ * until the next tick a task is due at, and catches up on the slots of the
+ * ticks it slept through. Due tasks join a FIFO ready queue served by the
+ * workers. A task is never queued or run more than once at a time; a run
+ * that overruns the task's interval is recorded in the task's statistics
+ * and logged at most once per OVERRUN_LOG_INTERVAL_MS, and the task is
+ * queued behind the tasks that became due meanwhile, so that a slow task
+ * cannot starve the others.
+ */
+class task_scheduler {
+ public:
+  /** Identifier of a scheduled task */
+  typedef uint64_t task_id;
+
+  /** Number of slots in the timer wheel */
+  static const size_t WHEEL_SLOTS = 512;
+
+  /** Minimum time between two overrun warnings of a task */
+  static const uint64_t OVERRUN_LOG_INTERVAL_MS = 10000;
+
+  /**
+   * Statistics on the runs of a task
+   */
+  struct task_stats {
+    /** The number of completed runs */
+    uint64_t runs;
+    /** The number of runs that took longer than the interval */
+    uint64_t overruns;
+    /** The longest time a run took beyond the interval, in microseconds */
+    uint64_t max_overrun_us;
+    /** The time the last overrun took beyond the interval, in microseconds */
+    uint64_t last_overrun_us;
+  };
+
+  /**
+   * Starts the ticker and the workers
+   *
+   * @param num_workers The number of workers
+   * @param tick_ms The length of a tick in milliseconds
+   */
+  explicit task_scheduler(size_t num_workers = 1, uint64_t tick_ms = 1);
+
+  /**
+   * Stops the ticker and the workers, after the runs in progress
+   */
+  ~task_scheduler();
+
+  task_scheduler(const task_scheduler &) = delete;
+  task_scheduler &operator=(const task_scheduler &) = delete;
+
+  /**
+   * Gets the scheduler shared by tasks created outside a store
+   *
+   * @return The scheduler
+   */
+  static task_scheduler &instance();
+
+  /**
+   * Schedules a task to run every interval, starting an interval from now
+   *
+   * @param name The name of the task
+   * @param task The work to do
+   * @param interval_ms The time between the starts of consecutive runs
+   * @return The identifier of the task
+   */
+  task_id schedule(const std::string &name, std::function<void(void)> task, uint64_t interval_ms);
+
+  /**
+   * Runs a task as soon as a worker is free, ahead of its interval. A task
+   * notified while it runs runs once more right after.
+   *
+   * @param id The identifier of the task
+   */
+  void notify(task_id id);
+
+  /**
+   * Cancels a task, waiting for a run in progress to finish. Must not be
+   * called from the task itself.
+   *
+   * @param id The identifier of the task
+   * @return True if the task was cancelled, false if there was no such task
+   */
+  bool cancel(task_id id);
+
+  /**
+   * Gets the statistics on the runs of a task
+   *
+   * @param id The identifier of the task
+   * @return The statistics, all zero if there is no such task
+   */
+  task_stats stats(task_id id) const;
+
+  /**
+   * Gets the number of workers
+   *
+   * @return The number of workers
+   */
+  size_t num_workers() const;
+
+ private:
+  struct task_entry {
+    std::string name;
+    std::function<void(void)> fn;
+    uint64_t interval_ticks;
+    uint64_t due_tick;
+    bool queued;
+    bool running;
+    bool notified;
+    task_stats stats;
+    uint64_t unlogged_overruns;
+    std::chrono::steady_clock::time_point last_overrun_log;
+  };
+
+  struct wheel_entry {
+    task_id id;
+    uint64_t due_tick;
+  };
+
+  void tick_loop();
+
+  void work_loop();
+
+  void enqueue(task_id id, task_entry &entry);
+
+  void add_to_wheel(task_id id, task_entry &entry, uint64_t due_tick);
+
+  void log_overrun(task_entry &entry);
+
+  uint64_t now_tick() const;
+
+  uint64_t next_due_tick() const;
+
+  uint64_t tick_ms_;
+  std::chrono::steady_clock::time_point epoch_;
+  uint64_t tick_;
+  uint64_t wake_tick_;
+  task_id next_id_;
+  bool stop_;
+
+  mutable std::mutex mtx_;
+  std::condition_variable ready_cv_;
+  std::condition_variable done_cv_;
+  std::condition_variable tick_cv_;
+  std::unordered_map<task_id, std::shared_ptr<task_entry>> tasks_;
+  std::vector<std::vector<wheel_entry>> wheel_;
+  std::deque<task_id> ready_;
+
+  std::thread ticker_;
+  std::vector<std::thread> workers_;
+};
+
+#endif /* CONFLUO_THREADS_TASK_SCHEDULER_H_ */
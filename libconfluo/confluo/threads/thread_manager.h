@@ -36,6 +36,21 @@ class thread_manager {
    */
   static int register_thread(thread_id_t thread_id = pthread_self());
 
+  /**
+   * Registers a thread to a free id among those reserved for maintenance
+   * work, such as replaying the data log; these ids are never handed to
+   * writers
+   * @return The id of the thread, or -2 if every reserved id is taken
+   */
+  static int register_maintenance_thread(thread_id_t thread_id = pthread_self());
+
+  /**
+   * Registers a thread to an id reserved for maintenance work, waiting for
+   * one if other threads hold them all
+   * @return The reserved id
+   */
+  static int register_reserved_thread(thread_id_t thread_id = pthread_self());
+
   /**
    * Deregisters the thread
    * @return The id of the deregistered thread
@@ -54,6 +69,20 @@ class thread_manager {
    */
   static int get_max_concurrency();
 
+  /**
+   * Gets the number of ids reserved for maintenance work, numbered from
+   * get_max_concurrency()
+   * @return The number of reserved ids
+   */
+  static int get_max_maintenance_concurrency();
+
+  /**
+   * Gets the number of distinct thread ids, including the reserved ids;
+   * per-thread state indexed by thread id must have this many entries
+   * @return The number of thread ids
+   */
+  static int get_num_ids();
+
  private:
   /**
    * Initializes info for each thread
@@ -86,6 +115,9 @@ class thread_manager {
   /** The maximum amount of threads Confluo supports */
   static int MAX_CONCURRENCY();
 
+  /** The number of ids reserved for maintenance work */
+  static int MAINTENANCE_CONCURRENCY();
+
   /** The thread info */
   static thread_info *THREAD_INFO();
 };
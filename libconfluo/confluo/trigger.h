@@ -63,6 +63,20 @@ struct trigger {
    */
   uint64_t periodicity_ms() const;
 
+  /**
+   * Gets the end of the next window the monitor evaluates the trigger over.
+   * Only the monitor reads or updates it.
+   * @return The end of the next window in milliseconds, 0 if the trigger
+   * has not been evaluated yet
+   */
+  uint64_t next_window_ms() const;
+
+  /**
+   * Sets the end of the next window the monitor evaluates the trigger over
+   * @param ms The end of the next window in milliseconds
+   */
+  void set_next_window_ms(uint64_t ms);
+
   /**
    * Invalidates the trigger
    * @return Whether trigger was successfully invalidated
@@ -88,6 +102,7 @@ struct trigger {
   numeric threshold_;
 
   uint64_t periodicity_ms_;
+  uint64_t next_window_ms_;
   atomic::type<bool> is_valid_;
 };
 
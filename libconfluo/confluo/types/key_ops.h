@@ -83,6 +83,30 @@ inline byte_string key_transform<std::string>(const immutable_raw_data &v, doubl
   return byte_string(v.as<std::string>());
 }
 
+/**
+ * Reduces a key of any width to a fixed 8-byte key, for indexes that hash
+ * their keys (64-bit FNV-1a, followed by a final avalanche so that the
+ * leading bytes of the result, which select the top levels of a radix
+ * index, are well mixed). Distinct keys may share a hashed key, so matches
+ * must be verified against the record.
+ *
+ * @param key The key to hash
+ *
+ * @return The hashed key
+ */
+inline byte_string hash_key(const byte_string &key) {
+  uint64_t h = UINT64_C(14695981039346656037);
+  const uint8_t *data = key.data();
+  for (size_t i = 0; i < key.size(); i++) {
+    h ^= data[i];
+    h *= UINT64_C(1099511628211);
+  }
+  h ^= h >> 33;
+  h *= UINT64_C(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  return byte_string(h);
+}
+
 /**
  * Key transformation for void types
  *
@@ -0,0 +1,96 @@
+#ifndef CONFLUO_VERSION_TRACKER_H_
+#define CONFLUO_VERSION_TRACKER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "atomic.h"
+#include "storage/reference_counts.h"
+
+namespace confluo {
+
+/**
+ * Tracks the oldest version that readers of the multilog may still request,
+ * so that versioned state older than it can be reclaimed.
+ *
+ * Readers enter the current epoch before loading the read tail and leave it
+ * once done; the reader counts for the two most recent epochs are kept in a
+ * single reference_counts. Each call to advance() flips the epoch, recording
+ * the read tail observed just before. Once every reader of the epoch before
+ * a flip has left, no reader can hold a version older than the tail recorded
+ * at that flip, and it becomes the new floor.
+ */
+class version_tracker {
+ public:
+  /**
+   * Keeps the epoch entered for the lifetime of a read
+   */
+  class read_guard {
+   public:
+    /**
+     * Enters the current epoch of the tracker
+     *
+     * @param tracker The version tracker
+     */
+    explicit read_guard(version_tracker &tracker);
+
+    /**
+     * Leaves the entered epoch
+     */
+    ~read_guard();
+
+    read_guard(const read_guard &) = delete;
+    read_guard &operator=(const read_guard &) = delete;
+
+   private:
+    version_tracker &tracker_;
+    uint64_t epoch_;
+  };
+
+  /**
+   * Constructs a version tracker with no readers and a floor of 0
+   */
+  version_tracker();
+
+  /**
+   * Enters the current epoch; must precede loading the version to read at
+   *
+   * @return The epoch entered
+   */
+  uint64_t enter();
+
+  /**
+   * Leaves an epoch
+   *
+   * @param epoch The epoch returned by enter()
+   */
+  void leave(uint64_t epoch);
+
+  /**
+   * Publishes a new floor if the readers of the previous epoch have left,
+   * and moves on to the next epoch. Must only be called from one thread at
+   * a time.
+   *
+   * @param tail The current read tail
+   */
+  void advance(uint64_t tail);
+
+  /**
+   * Gets the oldest version that readers may still request
+   *
+   * @return The floor
+   */
+  uint64_t floor() const;
+
+ private:
+  size_t readers(uint64_t epoch);
+
+  atomic::type<uint64_t> epoch_;
+  storage::reference_counts readers_;
+  uint64_t pending_floor_;
+  atomic::type<uint64_t> floor_;
+};
+
+}
+
+#endif /* CONFLUO_VERSION_TRACKER_H_ */
@@ -6,10 +6,13 @@ aggregate_node::aggregate_node()
     : aggregate_node(primitive_types::NONE_TYPE(), 0, nullptr) {
 }
 
-aggregate_node::aggregate_node(numeric agg, uint64_t version, aggregate_node *next)
+aggregate_node::aggregate_node(numeric agg, uint64_t version, aggregate_node *next, aggregate_node *skip)
     : value_(std::move(agg)),
       version_(version),
-      next_(next) {
+      depth_(next == nullptr ? 0 : next->depth() + 1),
+      next_(next),
+      skip_(skip),
+      skip_version_(skip == nullptr ? 0 : skip->version()) {
 }
 
 numeric aggregate_node::value() const {
@@ -20,59 +23,75 @@ uint64_t aggregate_node::version() const {
   return version_;
 }
 
+uint64_t aggregate_node::depth() const {
+  return depth_;
+}
+
 aggregate_node *aggregate_node::next() {
-  return next_;
+  return atomic::load(&next_);
+}
+
+aggregate_node *aggregate_node::skip() {
+  return skip_;
+}
+
+uint64_t aggregate_node::skip_version() const {
+  return skip_version_;
 }
 
+void aggregate_node::set_next(aggregate_node *next) {
+  atomic::store(&next_, next);
+}
+
+uint64_t aggregate_node::skip_depth(uint64_t depth) {
+  // Clears the lowest set bits so that skips span exponentially growing
+  // distances, while consecutive nodes rarely skip to the same depth
+  if (depth < 2)
+    return 0;
+  auto invert_lowest_one = [](uint64_t n) { return n & (n - 1); };
+  return (depth & 1) ? invert_lowest_one(invert_lowest_one(depth - 1)) + 1 : invert_lowest_one(depth);
+}
+
+const uint64_t aggregate_list::PRUNE_THRESHOLD;
+
 aggregate_list::aggregate_list()
     : head_(nullptr),
+      sorted_(true),
+      tail_depth_(0),
+      pruned_floor_(0),
       agg_(aggregators::invalid_aggregator()),
       type_(primitive_types::NONE_TYPE()) {
 }
 
 aggregate_list::aggregate_list(data_type type, aggregator agg)
     : head_(nullptr),
+      sorted_(true),
+      tail_depth_(0),
+      pruned_floor_(0),
       agg_(std::move(agg)),
       type_(type) {
 }
 
 aggregate_list::aggregate_list(const aggregate_list &other)
     : head_(nullptr),
+      sorted_(true),
+      tail_depth_(0),
+      pruned_floor_(0),
       agg_(other.agg_),
       type_(other.type_) {
-  aggregate_node *other_tail = atomic::load(&other.head_);
-  while (other_tail != nullptr) {
-    aggregate_node* cur_head = atomic::load(&head_);
-    void* raw = allocator::instance().alloc(sizeof(aggregate_node));
-    aggregate_node* new_head = new(raw) aggregate_node(other_tail->value(), other_tail->version(), cur_head);
-    atomic::store(&head_, new_head);
-    other_tail = other_tail->next();
-  }
+  copy_nodes(other);
 }
 
 aggregate_list &aggregate_list::operator=(const aggregate_list &other) {
   head_ = nullptr;
   agg_ = other.agg_;
   type_ = other.type_;
-  aggregate_node *other_tail = atomic::load(&other.head_);
-  while (other_tail != nullptr) {
-    aggregate_node* cur_head = atomic::load(&head_);
-    void* raw = allocator::instance().alloc(sizeof(aggregate_node));
-    aggregate_node* new_head = new(raw) aggregate_node(other_tail->value(), other_tail->version(), cur_head);
-    atomic::store(&head_, new_head);
-    other_tail = other_tail->next();
-  }
+  copy_nodes(other);
   return *this;
 }
 
 aggregate_list::~aggregate_list() {
-  aggregate_node *cur_node = atomic::load(&head_);
-  while (cur_node != nullptr) {
-    aggregate_node* next = cur_node->next();
-    cur_node->~aggregate_node();
-    allocator::instance().dealloc(cur_node);
-    cur_node = next;
-  }
+  free_nodes(atomic::load(&head_));
 }
 
 numeric aggregate_list::get(uint64_t version) const {
@@ -83,28 +102,36 @@ numeric aggregate_list::get(uint64_t version) const {
   return agg_.zero;
 }
 
-void aggregate_list::comb_update(const numeric &value, uint64_t version) {
+void aggregate_list::comb_update(const numeric &value, uint64_t version, uint64_t floor) {
   aggregate_node *cur_head = atomic::load(&head_);
   aggregate_node *req = get_node(cur_head, version);
   numeric old_agg = (req == nullptr) ? agg_.zero : req->value();
-  void* raw = allocator::instance().alloc(sizeof(aggregate_node));
-  aggregate_node *node = new(raw) aggregate_node(agg_.comb_op(old_agg, value), version, cur_head);
-  atomic::store(&head_, node);
+  prepend(cur_head, agg_.comb_op(old_agg, value), version);
+  prune(floor);
 }
 
-void aggregate_list::seq_update(const numeric &value, uint64_t version) {
+void aggregate_list::seq_update(const numeric &value, uint64_t version, uint64_t floor) {
   aggregate_node *cur_head = atomic::load(&head_);
   aggregate_node *req = get_node(cur_head, version);
   numeric old_agg = (req == nullptr) ? agg_.zero : req->value();
-  void* raw = allocator::instance().alloc(sizeof(aggregate_node));
-  aggregate_node *node = new(raw) aggregate_node(agg_.seq_op(old_agg, value), version, cur_head);
-  atomic::store(&head_, node);
+  prepend(cur_head, agg_.seq_op(old_agg, value), version);
+  prune(floor);
+}
+
+size_t aggregate_list::num_versions() const {
+  aggregate_node *head = atomic::load(&head_);
+  return head == nullptr ? 0 : static_cast<size_t>(head->depth() - tail_depth_ + 1);
 }
 
 aggregate_node *aggregate_list::get_node(aggregate_node *head, uint64_t version) const {
   if (head == nullptr)
     return nullptr;
 
+  // Each writer updates its list at increasing versions, so the skip links
+  // lead to the node we are looking for in logarithmic time
+  if (atomic::load(&sorted_))
+    return find_sorted(head, version);
+
   aggregate_node *node = head;
   aggregate_node *ret = nullptr;
   uint64_t max_version = 0;
@@ -122,6 +149,88 @@ aggregate_node *aggregate_list::get_node(aggregate_node *head, uint64_t version)
   return ret;
 }
 
+aggregate_node *aggregate_list::find_sorted(aggregate_node *head, uint64_t version) {
+  // Only nodes newer than the requested version are passed over, and their
+  // skip versions are read from the node itself, so reclaimed nodes (all
+  // older than any version readers may request) are never dereferenced
+  aggregate_node *node = head;
+  while (node != nullptr && node->version() > version) {
+    aggregate_node *skip = node->skip();
+    node = (skip != nullptr && node->skip_version() > version) ? skip : node->next();
+  }
+  return node;
+}
+
+aggregate_node *aggregate_list::ancestor(aggregate_node *node, uint64_t depth) const {
+  if (depth < tail_depth_)
+    return nullptr;
+  uint64_t cur_depth = node->depth();
+  while (cur_depth > depth) {
+    uint64_t skip_depth = aggregate_node::skip_depth(cur_depth);
+    uint64_t skip_depth_prev = aggregate_node::skip_depth(cur_depth - 1);
+    // Follow the skip link unless the previous node's skip gets closer
+    if (node->skip() != nullptr && (skip_depth == depth || (skip_depth > depth
+        && !(skip_depth_prev + 2 < skip_depth && skip_depth_prev >= depth)))) {
+      node = node->skip();
+      cur_depth = skip_depth;
+    } else {
+      node = node->next();
+      cur_depth--;
+    }
+  }
+  return node;
+}
+
+void aggregate_list::prepend(aggregate_node *head, const numeric &value, uint64_t version) {
+  if (head != nullptr && version < head->version())
+    atomic::store(&sorted_, false);
+  aggregate_node *skip = nullptr;
+  if (head != nullptr)
+    skip = ancestor(head, aggregate_node::skip_depth(head->depth() + 1));
+  void* raw = allocator::instance().alloc(sizeof(aggregate_node));
+  aggregate_node *node = new(raw) aggregate_node(value, version, head, skip);
+  atomic::store(&head_, node);
+}
+
+void aggregate_list::prune(uint64_t floor) {
+  if (floor <= pruned_floor_ || !atomic::load(&sorted_))
+    return;
+  aggregate_node *head = atomic::load(&head_);
+  if (head == nullptr || head->depth() - tail_depth_ < PRUNE_THRESHOLD)
+    return;
+
+  pruned_floor_ = floor;
+  aggregate_node *keep = find_sorted(head, floor);
+  if (keep == nullptr || keep->next() == nullptr)
+    return;
+  aggregate_node *old = keep->next();
+  keep->set_next(nullptr);
+  tail_depth_ = keep->depth();
+  free_nodes(old);
+}
+
+void aggregate_list::free_nodes(aggregate_node *node) {
+  while (node != nullptr) {
+    aggregate_node *next = node->next();
+    node->~aggregate_node();
+    allocator::instance().dealloc(node);
+    node = next;
+  }
+}
+
+void aggregate_list::copy_nodes(const aggregate_list &other) {
+  // Rebuild from the oldest node so that depths and skip links are recomputed
+  std::vector<aggregate_node *> other_nodes;
+  for (aggregate_node *n = atomic::load(&other.head_); n != nullptr; n = n->next())
+    other_nodes.push_back(n);
+  tail_depth_ = 0;
+  pruned_floor_ = 0;
+  atomic::store(&head_, static_cast<aggregate_node *>(nullptr));
+  for (auto it = other_nodes.rbegin(); it != other_nodes.rend(); ++it)
+    prepend(atomic::load(&head_), (*it)->value(), (*it)->version());
+  atomic::store(&sorted_, atomic::load(&other.sorted_));
+}
+
 aggregate::aggregate()
     : type_(primitive_types::NONE_TYPE()),
       agg_(aggregators::invalid_aggregator()),
@@ -180,12 +289,12 @@ aggregate &aggregate::operator=(aggregate &&other) noexcept {
   return *this;
 }
 
-void aggregate::seq_update(int thread_id, const numeric &value, uint64_t version) {
-  aggs_[thread_id].seq_update(value, version);
+void aggregate::seq_update(int thread_id, const numeric &value, uint64_t version, uint64_t floor) {
+  aggs_[thread_id].seq_update(value, version, floor);
 }
 
-void aggregate::comb_update(int thread_id, const numeric &value, uint64_t version) {
-  aggs_[thread_id].comb_update(value, version);
+void aggregate::comb_update(int thread_id, const numeric &value, uint64_t version, uint64_t floor) {
+  aggs_[thread_id].comb_update(value, version, floor);
 }
 
 numeric aggregate::get(uint64_t version) const {
@@ -195,4 +304,8 @@ numeric aggregate::get(uint64_t version) const {
   return val;
 }
 
+size_t aggregate::num_versions(int thread_id) const {
+  return aggs_[thread_id].num_versions();
+}
+
 }
\ No newline at end of file
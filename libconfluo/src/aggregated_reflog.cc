@@ -30,12 +30,14 @@ numeric aggregated_reflog::get_aggregate(size_t aid, uint64_t version) const {
   return copy.get()[aid].get(version);
 }
 
-void aggregated_reflog::seq_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version) {
-  aggregates_.atomic_load()[aid].seq_update(thread_id, value, version);
+void aggregated_reflog::seq_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version,
+                                             uint64_t floor) {
+  aggregates_.atomic_load()[aid].seq_update(thread_id, value, version, floor);
 }
 
-void aggregated_reflog::comb_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version) {
-  aggregates_.atomic_load()[aid].comb_update(thread_id, value, version);
+void aggregated_reflog::comb_update_aggregate(int thread_id, size_t aid, const numeric &value, uint64_t version,
+                                             uint64_t floor) {
+  aggregates_.atomic_load()[aid].comb_update(thread_id, value, version, floor);
 }
 
 size_t aggregated_reflog::num_aggregates() const {
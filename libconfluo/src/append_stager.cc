@@ -0,0 +1,77 @@
+#include "append_stager.h"
+
+namespace confluo {
+
+const size_t append_stager::MAX_STAGED_RECORDS;
+const uint64_t append_stager::NONE;
+
+append_stager::append_stager(apply_fn apply)
+    : apply_(std::move(apply)),
+      stages_(new stage_t[thread_manager::get_num_ids()]),
+      num_stages_(static_cast<size_t>(thread_manager::get_num_ids())) {
+  for (size_t i = 0; i < num_stages_; i++) {
+    stages_[i].start = 0;
+    stages_[i].record_size = 0;
+    stages_[i].nrecords = 0;
+    stages_[i].time_block = 0;
+    atomic::init(&stages_[i].pending, NONE);
+  }
+}
+
+void append_stager::stage(int thread_id, uint64_t offset, const void *data, int64_t time_block, size_t record_size) {
+  stage_t &s = stages_[static_cast<size_t>(thread_id)];
+  std::lock_guard<std::mutex> lock(s.mtx);
+  if (s.nrecords > 0 && (offset != s.start + s.nrecords * record_size || time_block != s.time_block))
+    apply(thread_id, s);
+  if (s.nrecords == 0) {
+    s.data.resize(MAX_STAGED_RECORDS * record_size);
+    s.start = offset;
+    s.record_size = record_size;
+    s.time_block = time_block;
+    atomic::store(&s.pending, offset);
+  }
+  memcpy(&s.data[s.nrecords * record_size], data, record_size);
+  if (++s.nrecords == MAX_STAGED_RECORDS)
+    apply(thread_id, s);
+}
+
+void append_stager::flush_all() {
+  for (size_t i = 0; i < num_stages_; i++) {
+    stage_t &s = stages_[i];
+    if (atomic::load(&s.pending) == NONE)
+      continue;
+    std::lock_guard<std::mutex> lock(s.mtx);
+    if (s.nrecords > 0)
+      apply(static_cast<int>(i), s);
+  }
+}
+
+uint64_t append_stager::visible(uint64_t tail) const {
+  for (size_t i = 0; i < num_stages_; i++)
+    tail = std::min(tail, atomic::load(&stages_[i].pending));
+  return tail;
+}
+
+void append_stager::direct_update(int thread_id, const std::function<void()> &update) {
+  stage_t &s = stages_[static_cast<size_t>(thread_id)];
+  std::lock_guard<std::mutex> lock(s.mtx);
+  if (s.nrecords > 0)
+    apply(thread_id, s);
+  update();
+}
+
+void append_stager::apply(int thread_id, stage_t &s) {
+  size_t nrecords = s.nrecords;
+  // The stage is emptied even if applying it fails, so that it does not
+  // hold the visible tail back
+  s.nrecords = 0;
+  try {
+    apply_(s.start, s.data.data(), nrecords, s.time_block, s.record_size, thread_id);
+  } catch (...) {
+    atomic::store(&s.pending, NONE);
+    throw;
+  }
+  atomic::store(&s.pending, NONE);
+}
+
+}
@@ -35,5 +35,33 @@ size_t filter_aggregates_archival_metadata::num_aggregates() {
   return num_aggs_;
 }
 
+zone_map_archival_metadata::zone_map_archival_metadata(size_t bucket_idx, std::vector<uint64_t> bounds)
+    : bucket_idx_(bucket_idx), bounds_(std::move(bounds)) {
+}
+
+zone_map_archival_metadata zone_map_archival_metadata::read(incremental_file_reader &reader) {
+  size_t bucket_idx = reader.read<size_t>();
+  size_t num_bounds = reader.read<size_t>();
+  std::vector<uint64_t> bounds(num_bounds);
+  for (size_t i = 0; i < num_bounds; i++)
+    bounds[i] = reader.read<uint64_t>();
+  return zone_map_archival_metadata(bucket_idx, std::move(bounds));
+}
+
+void zone_map_archival_metadata::append(const zone_map_archival_metadata &metadata, incremental_file_writer &writer) {
+  writer.append<size_t>(metadata.bucket_idx_);
+  writer.append<size_t>(metadata.bounds_.size());
+  if (!metadata.bounds_.empty())
+    writer.append<const uint64_t>(metadata.bounds_.data(), metadata.bounds_.size());
+}
+
+size_t zone_map_archival_metadata::bucket_idx() const {
+  return bucket_idx_;
+}
+
+const std::vector<uint64_t> &zone_map_archival_metadata::bounds() const {
+  return bounds_;
+}
+
 }
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "archival/archival_utils.h"
 
+#include "conf/configuration_params.h"
+
 namespace confluo {
 namespace archival {
 
@@ -11,6 +13,11 @@ std::string archival_utils::index_archival_path(const std::string &index_log_pat
   return index_log_path + "/index_" + std::to_string(index_id) + "/";
 }
 
+task_pool &archival_utils::archival_pool() {
+  static task_pool pool(archival_configuration_params::THREADS());
+  return pool;
+}
+
 void archival_utils::swap_bucket_ptr(reflog &refs, size_t idx, encoded_reflog_ptr encoded_bucket) {
   size_t bucket_idx, container_idx;
   refs.raw_data_location(idx, container_idx, bucket_idx);
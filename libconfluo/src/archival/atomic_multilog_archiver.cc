@@ -4,35 +4,54 @@ namespace confluo {
 namespace archival {
 
 atomic_multilog_archiver::atomic_multilog_archiver()
-    : atomic_multilog_archiver("", read_tail(), nullptr, nullptr, nullptr, nullptr, false) {
+    : atomic_multilog_archiver("", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, false) {
 }
 
 atomic_multilog_archiver::atomic_multilog_archiver(const std::string &path,
-                                                   read_tail rt,
+                                                   const read_tail *rt,
                                                    data_log *log,
                                                    filter_log *filters,
                                                    index_log *indexes,
                                                    schema_t *schema,
+                                                   zone_map *zones,
                                                    bool clear)
     : path_(path),
       rt_(rt),
-      record_size_(schema->record_size()) {
+      schema_(schema) {
   if (clear) {
     file_utils::clear_dir(data_log_path());
     file_utils::clear_dir(filter_log_path());
     file_utils::clear_dir(index_log_path());
+    file_utils::clear_dir(zone_map_path());
   }
   data_log_archiver_ = data_log_archiver(data_log_path(), log);
   filter_log_archiver_ = filter_log_archiver(filter_log_path(), filters);
   index_log_archiver_ = index_log_archiver(index_log_path(), indexes, schema);
+  zone_map_archiver_ = zone_map_archiver(zone_map_path(), zones);
 }
 
 void atomic_multilog_archiver::archive(size_t offset) {
-  offset = std::min(offset - offset % record_size_, (size_t) rt_.get());
+  // The schema of a loaded multilog is only read after the archiver is built
+  size_t record_size = schema_->record_size();
+  offset = std::min(offset - offset % record_size, (size_t) rt_->get());
   if (offset > data_log_archiver_.tail()) {
+    data_log_archiver_.set_columnar_layout(layout());
     data_log_archiver_.archive(offset);
-    filter_log_archiver_.archive(offset);
-    index_log_archiver_.archive(offset);
+    // Filters and indexes are never archived past the data log: on reload,
+    // their archived reflogs must not point at offsets the data log gives
+    // out again. They keep transaction logs of their own, so they are
+    // archived alongside each other.
+    size_t tail = std::min(offset, data_log_archiver_.tail());
+    task_pool &pool = archival_utils::archival_pool();
+    std::future<void> filters = pool.submit([this, tail] { filter_log_archiver_.archive(tail); });
+    try {
+      index_log_archiver_.archive(tail);
+    } catch (...) {
+      filters.wait();
+      throw;
+    }
+    filters.get();
+    zone_map_archiver_.archive(tail, record_size);
   }
 }
 
@@ -40,6 +59,37 @@ size_t atomic_multilog_archiver::tail() {
   return data_log_archiver_.tail();
 }
 
+columnar_layout atomic_multilog_archiver::layout() const {
+  columnar_layout layout{schema_->record_size(), {}};
+  for (const column_t &col : schema_->columns()) {
+    uint8_t kind;
+    switch (col.type().id) {
+      case primitive_type::D_BOOL:
+      case primitive_type::D_UCHAR:
+      case primitive_type::D_USHORT:
+      case primitive_type::D_UINT:
+      case primitive_type::D_ULONG:
+        kind = column_kind::D_UNSIGNED;
+        break;
+      case primitive_type::D_CHAR:
+      case primitive_type::D_SHORT:
+      case primitive_type::D_INT:
+      case primitive_type::D_LONG:
+        kind = column_kind::D_SIGNED;
+        break;
+      case primitive_type::D_FLOAT:
+      case primitive_type::D_DOUBLE:
+        kind = column_kind::D_FLOAT;
+        break;
+      default:
+        kind = column_kind::D_BYTES;
+        break;
+    }
+    layout.columns.push_back(column_spec{col.offset(), static_cast<uint32_t>(col.type().size), kind});
+  }
+  return layout;
+}
+
 std::string atomic_multilog_archiver::data_log_path() {
   return path_ + "/archives/data_log/";
 }
@@ -52,5 +102,13 @@ std::string atomic_multilog_archiver::index_log_path() {
   return path_ + "/archives/indexes/";
 }
 
+std::string atomic_multilog_archiver::zone_map_path() {
+  return path_ + "/archives/zone_maps/";
+}
+
+void atomic_multilog_archiver::set_zone_map_tail(size_t tail) {
+  zone_map_archiver_.set_tail(tail);
+}
+
 }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@ filter_archiver::filter_archiver(const std::string &path, monitor::filter *filte
       aggs_writer_(path, "filter_aggs", archival_configuration_params::MAX_FILE_SIZE()),
       refs_tail_(0),
       ts_tail_(0) {
+  std::fill(rollup_tails_, rollup_tails_ + filter::NUM_ROLLUP_LEVELS, 0);
   refs_writer_.close();
   aggs_writer_.close();
 }
@@ -17,16 +18,22 @@ void filter_archiver::archive(size_t offset) {
   auto reflogs = filter_->lookup_range_reflogs(ts_tail_, static_cast<uint64_t>(limits::long_max));
   refs_writer_.open();
   aggs_writer_.open();
+  // Time-blocks below this one are outside the in-memory window and have all
+  // been archived
+  uint64_t archived_ts_end = (time_utils::cur_ns() - archival_configuration_params::IN_MEMORY_FILTER_WINDOW_NS())
+      / configuration_params::TIME_RESOLUTION_NS();
   for (auto it = reflogs.begin(); it != reflogs.end(); ++it) {
     auto &refs = *it;
     byte_string key = it.key();
     ts_tail_ = key.template as<uint64_t>();
     auto ts_tail_ns = ts_tail_ * configuration_params::TIME_RESOLUTION_NS();
     if (time_utils::cur_ns() - ts_tail_ns < archival_configuration_params::IN_MEMORY_FILTER_WINDOW_NS()) {
+      archived_ts_end = std::min(archived_ts_end, ts_tail_);
       break;
     }
     size_t data_log_archival_tail = archive_reflog(key, refs, offset);
     if (refs_tail_ < refs.size()) {
+      archived_ts_end = std::min(archived_ts_end, ts_tail_);
       break;
     }
     archive_reflog_aggregates(key, refs, data_log_archival_tail);
@@ -34,6 +41,7 @@ void filter_archiver::archive(size_t offset) {
   }
   refs_writer_.close();
   aggs_writer_.close();
+  archive_rollups(archived_ts_end, offset);
 }
 
 size_t filter_archiver::archive_reflog(byte_string key, reflog &refs, size_t offset) {
@@ -50,7 +58,9 @@ size_t filter_archiver::archive_reflog(byte_string key, reflog &refs, size_t off
       continue;
     }
     if ((data_log_archival_tail = archival_utils::max_in_reflog_bucket(data)) < offset) {
-      archive_bucket(key, refs, data, offset);
+      // The next bucket may still hold refs below offset, so replay on load
+      // resumes past this bucket rather than at offset
+      archive_bucket(key, refs, data, data_log_archival_tail + 1);
       refs_tail_ += reflog_constants::BUCKET_SIZE;
     }
   }
@@ -81,22 +91,44 @@ void filter_archiver::archive_reflog_aggregates(byte_string key, aggregated_refl
   auto metadata = filter_aggregates_archival_metadata(key, version, num_aggs);
   filter_aggregates_archival_metadata::append(metadata, aggs_writer_);
 
-  if (num_aggs > 0) {
-    size_t alloc_size = sizeof(aggregate) * num_aggs;
-    ptr_aux_block aux(state_type::D_ARCHIVED, encoding_type::D_UNENCODED);
-    aggregate *archived_aggs = static_cast<aggregate *>(allocator::instance().alloc(alloc_size, aux));
-    for (size_t i = 0; i < num_aggs; i++) {
-      numeric collapsed_aggregate = reflog.get_aggregate(i, version);
-      aggs_writer_.append<data_type>(collapsed_aggregate.type());
-      aggs_writer_.append<uint8_t>(collapsed_aggregate.data(), collapsed_aggregate.type().size);
-      new(archived_aggs + i) aggregate(collapsed_aggregate.type(), aggregators::sum_aggregator(), 1);
-      archived_aggs[i].seq_update(0, collapsed_aggregate, version);
-    }
-    reflog.aggregates().swap_ptr(archived_aggs);
+  for (size_t i = 0; i < num_aggs; i++) {
+    numeric collapsed_aggregate = reflog.get_aggregate(i, version);
+    aggs_writer_.append<data_type>(collapsed_aggregate.type());
+    aggs_writer_.append<uint8_t>(collapsed_aggregate.data(), collapsed_aggregate.type().size);
   }
+  collapse_aggregates(reflog, version);
   aggs_writer_.commit(filter_aggregates_archival_action(key).to_string());
 }
 
+void filter_archiver::archive_rollups(uint64_t ts_block_end, size_t version) {
+  // Rollups are not written out: they are rebuilt from the archived reflog
+  // aggregates on load
+  for (size_t l = 0; l < filter::NUM_ROLLUP_LEVELS; l++) {
+    uint64_t end = ts_block_end / filter::ROLLUP_BLOCKS[l];
+    if (end <= rollup_tails_[l])
+      continue;
+    auto reflogs = filter_->rollup_data(l).range_lookup_reflogs(byte_string(rollup_tails_[l]), byte_string(end - 1));
+    for (auto it = reflogs.begin(); it != reflogs.end(); ++it)
+      collapse_aggregates(*it, version);
+    rollup_tails_[l] = end;
+  }
+}
+
+void filter_archiver::collapse_aggregates(aggregated_reflog &reflog, size_t version) {
+  size_t num_aggs = reflog.num_aggregates();
+  if (num_aggs == 0)
+    return;
+  size_t alloc_size = sizeof(aggregate) * num_aggs;
+  ptr_aux_block aux(state_type::D_ARCHIVED, encoding_type::D_UNENCODED);
+  aggregate *archived_aggs = static_cast<aggregate *>(allocator::instance().alloc(alloc_size, aux));
+  for (size_t i = 0; i < num_aggs; i++) {
+    numeric collapsed_aggregate = reflog.get_aggregate(i, version);
+    new(archived_aggs + i) aggregate(collapsed_aggregate.type(), aggregators::sum_aggregator(), 1);
+    archived_aggs[i].seq_update(0, collapsed_aggregate, version);
+  }
+  reflog.aggregates().swap_ptr(archived_aggs);
+}
+
 size_t filter_load_utils::load_reflogs(const std::string &path, filter::idx_t &filter) {
   incremental_file_reader reader(path, "filter_data");
   size_t data_log_archival_tail = 0;
@@ -21,7 +21,8 @@ filter_log_archiver::~filter_log_archiver() {
 void filter_log_archiver::archive(size_t offset) {
   init_new_archivers();
   for (size_t i = 0; i < filters_->size(); i++) {
-    if (filters_->at(i)->is_valid())
+    // Filters still being backfilled may gain references below the offset
+    if (filters_->at(i)->is_valid() && filters_->at(i)->handoff().is_complete())
       filter_archivers_.at(i)->archive(offset);
   }
 }
@@ -13,9 +13,8 @@ index_archiver::index_archiver(const std::string &path, index::radix_index *inde
 
 void index_archiver::archive(size_t offset) {
   writer_.open();
-  byte_string min = column_.min().to_key(column_.index_bucket_size());
-  byte_string max = column_.max().to_key(column_.index_bucket_size());
-  auto reflogs = index_->range_lookup_reflogs(min, max);
+  auto range = column_.index_key_range();
+  auto reflogs = index_->range_lookup_reflogs(range.first, range.second);
   for (auto it = reflogs.begin(); it != reflogs.end(); it++) {
     auto &refs = *it;
     archive_reflog(it.key(), refs, offset);
@@ -38,7 +37,7 @@ void index_archiver::archive_reflog(byte_string key, reflog &refs, size_t offset
       continue;
     }
     if ((data_log_off = archival_utils::max_in_reflog_bucket(data)) < offset) {
-      reflog_idx = archive_bucket(key, refs, reflog_idx, data, data_log_off);
+      reflog_idx = archive_bucket(key, refs, reflog_idx, data, data_log_off + 1);
     }
   }
   reflog_tails_[key.to_string()] = reflog_idx;
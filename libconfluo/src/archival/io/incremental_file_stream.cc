@@ -22,6 +22,9 @@ std::string incremental_file_stream::transaction_log_path() {
 }
 
 void incremental_file_stream::truncate(incremental_file_offset incr_file_off, size_t transaction_log_off) {
+  // Nothing has been archived to a stream that was never written
+  if (!utils::file_utils::exists_file(incr_file_off.path()))
+    return;
   // TODO delete succeeding files as well
   utils::file_utils::truncate_file(incr_file_off.path(), incr_file_off.offset());
   utils::file_utils::truncate_file(transaction_log_path(), transaction_log_off);
@@ -3,6 +3,26 @@
 namespace confluo {
 namespace archival {
 
+replay_progress::replay_progress(size_t total_bytes)
+    : total_(total_bytes),
+      done_(0),
+      reported_(0) {
+}
+
+void replay_progress::advance(size_t bytes) {
+  size_t done = atomic::faa(&done_, bytes) + bytes;
+  size_t tenths = total_ == 0 ? 10 : done * 10 / total_;
+  size_t reported = atomic::load(&reported_);
+  while (tenths > reported) {
+    if (atomic::strong::cas(&reported_, &reported, tenths)) {
+      LOG_INFO << "Replayed " << done << "/" << total_ << " bytes of data log (" << tenths * 10 << "%)";
+      break;
+    }
+  }
+}
+
+const size_t load_utils::REPLAY_BATCH_RECORDS;
+
 void load_utils::load_data_log(const std::string &path, const storage_mode mode, data_log &log) {
   monolog_linear_load_utils::load<uint8_t,
                                   data_log_constants::MAX_BUCKETS,
@@ -27,26 +47,24 @@ void load_utils::load_data_log_storage(data_log &log, size_t start_bucket_idx) {
   }
 }
 
+void load_utils::load_replay(const std::string &filter_path,
+                             const std::string &index_path,
+                             filter_log &filters,
+                             index_log &indexes,
+                             data_log &log,
+                             schema_t &schema,
+                             planner::index_stats_log *stats,
+                             const zone_map_replay &zones) {
+  replay(log, schema, load_filters(filter_path, filters), load_indexes(index_path, indexes, schema, stats),
+         static_cast<size_t>(configuration_params::RECOVERY_THREADS()), zones);
+}
+
 void load_utils::load_replay_filter_log(const std::string &path, filter_log &filters, data_log &log, schema_t &schema) {
-  for (size_t i = 0; i < filters.size(); i++) {
-    monitor::filter *filter = filters[i];
-    if (filter->is_valid()) {
-      size_t data_log_archival_tail = load_filter(archival_utils::filter_archival_path(path, i), filter);
-      replay_filter(filter, log, schema, data_log_archival_tail);
-    }
-  }
+  replay(log, schema, load_filters(path, filters), {});
 }
 
 void load_utils::load_replay_index_log(const std::string &path, index_log &indexes, data_log &log, schema_t &schema) {
-  for (size_t i = 0; i < schema.size(); i++) {
-    auto &col = schema[i];
-    if (col.is_indexed()) {
-      size_t id = col.index_id();
-      auto *index = indexes[id];
-      size_t data_log_archival_tail = load_index(archival_utils::index_archival_path(path, id), index);
-      replay_index(index, col.index_id(), log, schema, data_log_archival_tail + schema.record_size());
-    }
-  }
+  replay(log, schema, {}, load_indexes(path, indexes, schema));
 }
 
 size_t load_utils::load_filter(const std::string &path, monitor::filter *filter) {
@@ -56,6 +74,9 @@ size_t load_utils::load_filter(const std::string &path, monitor::filter *filter)
   if (archival_tail > archival_tail2) {
     // TODO recovery for failure during aggregate writes edge case
   }
+  if (archival_tail > 0) {
+    filter->rebuild_rollups(archival_tail);
+  }
   return archival_tail;
 }
 
@@ -63,16 +84,12 @@ size_t load_utils::load_index(const std::string &path, index::radix_index *index
   return index_load_utils::load(path, index);
 }
 
+size_t load_utils::load_zone_map(const std::string &path, zone_map &zones) {
+  return zone_map_load_utils::load(path, &zones);
+}
+
 void load_utils::replay_filter(monitor::filter *filter, data_log &log, schema_t &schema, size_t start_off) {
-  size_t record_size = schema.record_size();
-  uint8_t *data_buf = new uint8_t[record_size];
-  for (size_t i = start_off; i < log.size(); i += record_size) {
-    // TODO this is inefficient, amortize with iterator
-    log.read(i, data_buf, schema.record_size());
-    record_t record = schema.apply_unsafe(i, data_buf);
-    filter->update(record);
-  }
-  delete[] data_buf;
+  replay(log, schema, {filter_replay{filter, start_off}}, {});
 }
 
 void load_utils::replay_index(index::radix_index *index,
@@ -80,14 +97,245 @@ void load_utils::replay_index(index::radix_index *index,
                               data_log &log,
                               schema_t &schema,
                               size_t start_off) {
-  uint8_t *data_buf = new uint8_t[schema.record_size()];
-  for (size_t i = start_off; i < log.size(); i += schema.record_size()) {
-    // TODO this is inefficient, amortize with iterator
-    log.read(i, data_buf, schema.record_size());
-    record_t r = schema.apply_unsafe(i, data_buf);
-    index->insert(r[id].get_key(), i);
+  replay(log, schema, {}, {index_replay{index, id, start_off, nullptr}});
+}
+
+void load_utils::replay(data_log &log,
+                        schema_t &schema,
+                        const std::vector<filter_replay> &filters,
+                        const std::vector<index_replay> &indexes,
+                        size_t num_threads,
+                        const zone_map_replay &zones) {
+  backfill(log, schema, filters, indexes, log.size(), num_threads, zones);
+}
+
+void load_utils::backfill(data_log &log,
+                          schema_t &schema,
+                          const std::vector<filter_replay> &filters,
+                          const std::vector<index_replay> &indexes,
+                          size_t handoff,
+                          size_t num_threads,
+                          const zone_map_replay &zones) {
+  size_t record_size = schema.record_size();
+  size_t end = handoff;
+  size_t begin = end;
+  for (const auto &f : filters)
+    begin = std::min(begin, f.start_off);
+  for (const auto &idx : indexes)
+    begin = std::min(begin, idx.start_off);
+  // Zone maps without columns to track have nothing to replay
+  zone_map_replay zone_replay = zones;
+  if (zone_replay.zones != nullptr && zone_replay.zones->num_columns() == 0)
+    zone_replay.zones = nullptr;
+  if (zone_replay.zones != nullptr)
+    begin = std::min(begin, zone_replay.start_off);
+  // Archived reflogs end past their last ref, and archived zone maps on a
+  // bucket boundary, neither of which need be a record boundary; replay
+  // starts from the first record past it
+  begin = (begin + record_size - 1) / record_size * record_size;
+  if (begin >= end)
+    return;
+
+  // Each worker replays a contiguous, bucket-aligned range of the data log,
+  // so that aggregate versions from any one thread are increasing
+  size_t bucket_size = data_log_constants::BUCKET_SIZE;
+  size_t first_bucket = begin / bucket_size;
+  size_t num_buckets = (end - 1) / bucket_size - first_bucket + 1;
+  // Filters update aggregates, so their workers need thread ids, and only
+  // take ids reserved for maintenance; index and zone map updates need none
+  bool needs_ids = !filters.empty();
+  size_t max_workers = needs_ids ? static_cast<size_t>(thread_manager::get_max_maintenance_concurrency()) : num_buckets;
+  size_t num_workers = std::max<size_t>(1, std::min(num_threads, std::min(num_buckets, max_workers)));
+  LOG_INFO << "Replaying " << (end - begin) << " bytes of data log over " << filters.size() << " filter(s), "
+           << indexes.size() << " index(es)" << (zone_replay.zones != nullptr ? " and zone maps" : "") << " using "
+           << num_workers << " thread(s)";
+
+  schema_snapshot snap = schema.snapshot();
+  replay_progress progress(end - begin);
+  auto range_boundary = [=](size_t k, size_t n) -> size_t {
+    if (k == n)
+      return end;
+    size_t off = (first_bucket + k * num_buckets / n) * bucket_size;
+    off = (off + record_size - 1) / record_size * record_size;
+    return std::min(end, std::max(begin, off));
+  };
+
+  // Workers register before any of them starts replaying, so no two share a
+  // thread id; the data log is split among the workers that could register.
+  // If other maintenance work holds every reserved id, one worker replays
+  // the whole range once a reserved id frees up. Writers' ids are never
+  // taken, so writers can always register.
+  std::mutex mtx;
+  std::condition_variable cv;
+  size_t num_arrived = 0;
+  size_t num_registered = 0;
+  bool reserved = false;
+  task_pool pool(num_workers);
+  std::vector<std::future<void>> replays;
+  for (size_t w = 0; w < num_workers; w++) {
+    replays.push_back(pool.submit([&, w] {
+      if (!needs_ids) {
+        replay_range(log, snap, record_size, filters, indexes, zone_replay, range_boundary(w, num_workers),
+                     range_boundary(w + 1, num_workers), progress);
+        return;
+      }
+
+      bool registered = thread_manager::register_maintenance_thread() >= 0;
+      bool use_reserved = false;
+      size_t rank = 0;
+      size_t n;
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (registered)
+          rank = num_registered++;
+        if (++num_arrived == num_workers)
+          cv.notify_all();
+        else
+          cv.wait(lock, [&] { return num_arrived == num_workers; });
+        n = num_registered;
+        if (n == 0 && !reserved)
+          reserved = use_reserved = true;
+      }
+      if (use_reserved) {
+        thread_manager::register_reserved_thread();
+        n = 1;
+      } else if (!registered) {
+        return;
+      }
+
+      try {
+        replay_range(log, snap, record_size, filters, indexes, zone_replay, range_boundary(rank, n),
+                     range_boundary(rank + 1, n), progress);
+      } catch (...) {
+        thread_manager::deregister_thread();
+        throw;
+      }
+      thread_manager::deregister_thread();
+    }));
+  }
+  for (auto &r : replays)
+    r.get();
+}
+
+std::vector<load_utils::filter_replay> load_utils::load_filters(const std::string &path, filter_log &filters) {
+  std::vector<filter_replay> replays;
+  for (size_t i = 0; i < filters.size(); i++) {
+    monitor::filter *filter = filters[i];
+    if (filter->is_valid()) {
+      size_t data_log_archival_tail = load_filter(archival_utils::filter_archival_path(path, i), filter);
+      replays.push_back(filter_replay{filter, data_log_archival_tail});
+    }
+  }
+  return replays;
+}
+
+std::vector<load_utils::index_replay> load_utils::load_indexes(const std::string &path,
+                                                               index_log &indexes,
+                                                               schema_t &schema,
+                                                               planner::index_stats_log *stats) {
+  std::vector<index_replay> replays;
+  for (size_t i = 0; i < schema.size(); i++) {
+    auto &col = schema[i];
+    if (col.is_indexed()) {
+      size_t id = col.index_id();
+      auto *index = indexes[id];
+      size_t data_log_archival_tail = load_index(archival_utils::index_archival_path(path, id), index);
+      // Records restored from the archived index are not sampled
+      replays.push_back(index_replay{index, i, data_log_archival_tail, stats != nullptr ? stats->at(id) : nullptr});
+    }
+  }
+  return replays;
+}
+
+void load_utils::replay_range(data_log &log,
+                              const schema_snapshot &snap,
+                              size_t record_size,
+                              const std::vector<filter_replay> &filters,
+                              const std::vector<index_replay> &indexes,
+                              const zone_map_replay &zones,
+                              size_t begin,
+                              size_t end,
+                              replay_progress &progress) {
+  uint64_t time_resolution = configuration_params::TIME_RESOLUTION_NS();
+  auto time_block_of = [&](uint8_t *rec) -> int64_t {
+    return static_cast<int64_t>(static_cast<uint64_t>(snap.get_timestamp(rec)) / time_resolution);
+  };
+
+  // Index of the first record at or past start_off among n records starting
+  // at data log offset base_off
+  auto first_record = [&](size_t base_off, size_t n, size_t start_off) -> size_t {
+    if (start_off <= base_off)
+      return 0;
+    return std::min(n, (start_off - base_off + record_size - 1) / record_size);
+  };
+
+  std::vector<uint8_t> buf(REPLAY_BATCH_RECORDS * record_size);
+  std::vector<std::pair<byte_string, size_t>> keys;
+  keys.reserve(REPLAY_BATCH_RECORDS);
+  size_t off = begin;
+  while (off < end) {
+    size_t nrecords = std::min(REPLAY_BATCH_RECORDS, (end - off) / record_size);
+    if (nrecords == 0)
+      break;
+    log.read(off, buf.data(), nrecords * record_size);
+
+    if (zones.zones != nullptr) {
+      size_t k = first_record(off, nrecords, zones.start_off);
+      if (k < nrecords)
+        zones.zones->update(off + k * record_size, &buf[k * record_size], nrecords - k, record_size);
+    }
+
+    // Feed each run of records sharing a time block through the block path
+    size_t i = 0;
+    while (i < nrecords) {
+      uint8_t *block = &buf[i * record_size];
+      int64_t time_block = time_block_of(block);
+      size_t j = i + 1;
+      while (j < nrecords && time_block_of(&buf[j * record_size]) == time_block)
+        j++;
+
+      size_t block_off = off + i * record_size;
+      size_t block_records = j - i;
+      for (const auto &f : filters) {
+        size_t k = first_record(block_off, block_records, f.start_off);
+        if (k < block_records)
+          f.filter->update(block_off + k * record_size, snap, block + k * record_size, block_records - k,
+                           time_block, record_size);
+      }
+      i = j;
+    }
+
+    // Sort the keys of the batch so that each distinct key is looked up in
+    // the index once, and its offsets are appended to its reflog at once
+    for (const auto &idx : indexes) {
+      keys.clear();
+      for (size_t k = first_record(off, nrecords, idx.start_off); k < nrecords; k++) {
+        keys.emplace_back(snap.get_key(&buf[k * record_size], static_cast<uint32_t>(idx.field_idx)),
+                          off + k * record_size);
+        // Records are sampled as their writers would have sampled them
+        if (idx.stats != nullptr && planner::index_stats::is_sampled(off / record_size + k))
+          idx.stats->update(keys.back().first);
+      }
+      std::stable_sort(keys.begin(), keys.end(),
+                       [](const std::pair<byte_string, size_t> &a, const std::pair<byte_string, size_t> &b) {
+                         return a.first < b.first;
+                       });
+      size_t k = 0;
+      while (k < keys.size()) {
+        size_t l = k + 1;
+        while (l < keys.size() && keys[l].first == keys[k].first)
+          l++;
+        auto &refs = idx.index->get_or_create(keys[k].first);
+        size_t pos = refs->reserve(l - k);
+        for (size_t m = k; m < l; m++)
+          refs->set(pos + m - k, keys[m].second);
+        k = l;
+      }
+    }
+
+    progress.advance(nrecords * record_size);
+    off += nrecords * record_size;
   }
-  delete[] data_buf;
 }
 
 }
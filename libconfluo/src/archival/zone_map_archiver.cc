@@ -0,0 +1,54 @@
+#include "archival/zone_map_archiver.h"
+
+namespace confluo {
+namespace archival {
+
+zone_map_archiver::zone_map_archiver()
+    : zone_map_archiver("", nullptr) {
+}
+
+zone_map_archiver::zone_map_archiver(const std::string &path, zone_map *zones)
+    : writer_(path, "zone_map", archival_configuration_params::MAX_FILE_SIZE()),
+      archival_tail_(0),
+      zones_(zones) {
+  writer_.close();
+}
+
+void zone_map_archiver::archive(size_t offset, size_t record_size) {
+  // Records that start in a bucket may end in the next one
+  if (archival_tail_ + zone_map::BUCKET_SIZE + record_size > offset)
+    return;
+  writer_.open();
+  while (archival_tail_ + zone_map::BUCKET_SIZE + record_size <= offset) {
+    size_t bucket_idx = archival_tail_ / zone_map::BUCKET_SIZE;
+    zone_map_archival_metadata::append(zone_map_archival_metadata(bucket_idx, zones_->snapshot(bucket_idx)), writer_);
+    archival_tail_ += zone_map::BUCKET_SIZE;
+    writer_.commit<monolog_linear_archival_action>(monolog_linear_archival_action(archival_tail_));
+  }
+  writer_.close();
+}
+
+size_t zone_map_archiver::tail() {
+  return archival_tail_;
+}
+
+void zone_map_archiver::set_tail(size_t tail) {
+  archival_tail_ = tail;
+}
+
+size_t zone_map_load_utils::load(const std::string &path, zone_map *zones) {
+  incremental_file_reader reader(path, "zone_map");
+  size_t archival_tail = 0;
+  while (reader.has_more()) {
+    auto action = reader.read_action<monolog_linear_archival_action>();
+    auto metadata = zone_map_archival_metadata::read(reader);
+    if (!metadata.bounds().empty())
+      zones->restore(metadata.bucket_idx(), metadata.bounds());
+    archival_tail = action.archival_tail();
+  }
+  reader.truncate(reader.tell(), reader.tell_transaction_log());
+  return archival_tail;
+}
+
+}
+}
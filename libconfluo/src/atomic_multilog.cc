@@ -3,24 +3,33 @@
 
 namespace confluo {
 
+const uint64_t atomic_multilog::PREALLOC_PERIODICITY_MS;
+
 atomic_multilog::atomic_multilog(const std::string &name,
                                  const std::vector<column_t> &schema,
                                  const std::string &path,
                                  const storage::storage_mode &s_mode,
                                  const archival_mode &a_mode,
-                                 task_pool &pool)
+                                 task_pool &pool,
+                                 task_scheduler &scheduler)
     : name_(name),
       schema_(schema),
       data_log_("data_log", path, s_mode),
       rt_(path, s_mode),
+      stager_([this](uint64_t offset, uint8_t *data, size_t nrecords, int64_t time_block, size_t record_size,
+                     int thread_id) {
+        update_aux_record_block(offset, data, nrecords, time_block, record_size, thread_id);
+      }),
       metadata_(path),
-      planner_(&data_log_, &indexes_, &schema_),
-      archiver_(path, rt_, &data_log_, &filters_, &indexes_, &schema_),
-      archival_task_("archival"),
-      archival_pool_(),
+      planner_(&data_log_, &indexes_, &schema_, &index_stats_, &zone_map_),
+      archiver_(path, &rt_, &data_log_, &filters_, &indexes_, &schema_, &zone_map_),
+      archival_task_("archival", scheduler),
+      prealloc_buckets_(configuration_params::DATA_LOG_PREALLOC_BUCKETS()),
+      prealloc_task_("prealloc", scheduler),
       mgmt_pool_(pool),
-      monitor_task_("monitor") {
+      monitor_task_("monitor", scheduler) {
   data_log_.pre_alloc();
+  zone_map_.init(schema_);
   metadata_.write_schema(schema_);
   metadata_.write_storage_mode(s_mode);
   metadata_.write_archival_mode(a_mode);
@@ -29,6 +38,11 @@ atomic_multilog::atomic_multilog(const std::string &name,
     archival_task_.start(std::bind(&atomic_multilog::archival_task, this),
                          archival_configuration_params::PERIODICITY_MS());
   }
+  if (prealloc_buckets_ > 0) {
+    // Notified when the tail passes the middle of a bucket; the period only
+    // catches up on notifications that arrive mid-run
+    prealloc_task_.start(std::bind(&atomic_multilog::prealloc_task, this), PREALLOC_PERIODICITY_MS);
+  }
 }
 
 atomic_multilog::atomic_multilog(const std::string &name,
@@ -36,26 +50,34 @@ atomic_multilog::atomic_multilog(const std::string &name,
                                  const std::string &path,
                                  const storage::storage_mode &storage_mode,
                                  const archival_mode &a_mode,
-                                 task_pool &pool)
-    : atomic_multilog(name, parser::parse_schema(schema), path, storage_mode, a_mode, pool) {
+                                 task_pool &pool,
+                                 task_scheduler &scheduler)
+    : atomic_multilog(name, parser::parse_schema(schema), path, storage_mode, a_mode, pool, scheduler) {
 }
 
-atomic_multilog::atomic_multilog(const std::string &name, const std::string &path, task_pool &pool)
+atomic_multilog::atomic_multilog(const std::string &name, const std::string &path, task_pool &pool,
+                                 task_scheduler &scheduler)
     : name_(name),
       schema_(),
       data_log_(),
       rt_(),
+      stager_([this](uint64_t offset, uint8_t *data, size_t nrecords, int64_t time_block, size_t record_size,
+                     int thread_id) {
+        update_aux_record_block(offset, data, nrecords, time_block, record_size, thread_id);
+      }),
       metadata_(),
-      planner_(&data_log_, &indexes_, &schema_),
-      archiver_(path, rt_, &data_log_, &filters_, &indexes_, &schema_, false),
-      archival_task_("archival"),
-      archival_pool_(),
+      planner_(&data_log_, &indexes_, &schema_, &index_stats_, &zone_map_),
+      archiver_(path, &rt_, &data_log_, &filters_, &indexes_, &schema_, &zone_map_, false),
+      archival_task_("archival", scheduler),
+      prealloc_buckets_(configuration_params::DATA_LOG_PREALLOC_BUCKETS()),
+      prealloc_task_("prealloc", scheduler),
       mgmt_pool_(pool),
-      monitor_task_("monitor") {
+      monitor_task_("monitor", scheduler) {
   // Load multilog metadata
   storage_mode s_mode;
   archival_mode a_mode;
   load_metadata(path, s_mode, a_mode);
+  zone_map_.init(schema_);
   metadata_ = metadata_writer(path, false);
   // Load multilog data
   data_log_.init("data_log", path, s_mode);
@@ -75,31 +97,34 @@ atomic_multilog::atomic_multilog(const std::string &name, const std::string &pat
     archival_task_.start(std::bind(&atomic_multilog::archival_task, this),
                          archival_configuration_params::PERIODICITY_MS());
   }
+  if (prealloc_buckets_ > 0) {
+    // Notified when the tail passes the middle of a bucket; the period only
+    // catches up on notifications that arrive mid-run
+    prealloc_task_.start(std::bind(&atomic_multilog::prealloc_task, this), PREALLOC_PERIODICITY_MS);
+  }
 }
 
 void atomic_multilog::archive() {
-  archive(rt_.get());
+  archive(visible_tail());
 }
 
 void atomic_multilog::archive(size_t offset) {
-  optional<management_exception> ex;
-  std::future<void> ret = archival_pool_.submit([this, offset] {
-    archiver_.archive(offset);
-  });
-  ret.wait();
-  if (ex.has_value())
-    throw ex.value();
+  std::lock_guard<std::mutex> lock(archival_mtx_);
+  // Staged records are not archived before their filters and indexes are
+  // updated
+  archiver_.archive(std::min(offset, visible_tail()));
 }
 
-void atomic_multilog::add_index(const std::string &field_name, double bucket_size) {
+void atomic_multilog::add_index(const std::string &field_name, double bucket_size, index_type_t type) {
   optional<management_exception> ex;
   std::future<void> ret = mgmt_pool_.submit(
-      [field_name, bucket_size, &ex, this] {
-        add_index_task(field_name, bucket_size, ex);
+      [field_name, bucket_size, type, &ex, this] {
+        add_index_task(field_name, bucket_size, type, ex);
       });
   ret.wait();
   if (ex.has_value())
     throw ex.value();
+  backfill_index(field_name);
 }
 
 void atomic_multilog::remove_index(const std::string &field_name) {
@@ -132,6 +157,7 @@ void atomic_multilog::add_filter(const std::string &name, const std::string &exp
   ret.wait();
   if (ex.has_value())
     throw ex.value();
+  backfill_filter(name);
 }
 
 void atomic_multilog::remove_filter(const std::string &name) {
@@ -207,36 +233,23 @@ record_batch_builder atomic_multilog::get_batch_builder() const {
 }
 
 size_t atomic_multilog::append_batch(record_batch &batch) {
-  size_t record_size = schema_.record_size();
-  size_t batch_bytes = batch.nrecords * record_size;
-  size_t log_offset = data_log_.reserve(batch_bytes);
-  size_t cur_offset = log_offset;
-  for (record_block &block : batch.blocks) {
-    data_log_.write(cur_offset,
-                    reinterpret_cast<const uint8_t *>(block.data.data()),
-                    block.data.length());
-    update_aux_record_block(cur_offset, block, record_size);
-    cur_offset += block.data.length();
-  }
-
-  data_log_.flush(log_offset, batch_bytes);
-  rt_.advance(log_offset, static_cast<uint32_t>(batch_bytes));
-  return log_offset;
+  return append_blocks(batch.blocks);
 }
 
 size_t atomic_multilog::append(void *data) {
   size_t record_size = schema_.record_size();
   size_t offset = data_log_.append((const uint8_t *) data, record_size);
-  record_t r = schema_.apply_unsafe(offset, data);
-
-  size_t nfilters = filters_.size();
-  for (size_t i = 0; i < nfilters; i++)
-    if (filters_.at(i)->is_valid())
-      filters_.at(i)->update(r);
-
-  for (const field_t &f : r)
-    if (f.is_indexed())
-      indexes_.at(f.index_id())->insert(f.get_key(), offset);
+  pre_alloc_buckets(offset, record_size);
+
+  // Stage the record so that filters and indexes are updated once per run
+  // of consecutive records; staging must precede the read tail advance
+  int tid = thread_manager::get_id();
+  int64_t time_block = static_cast<int64_t>(static_cast<uint64_t>(*reinterpret_cast<int64_t *>(data))
+      / configuration_params::TIME_RESOLUTION_NS());
+  if (tid >= 0)
+    stager_.stage(tid, offset, data, time_block, record_size);
+  else
+    update_aux_record_block(offset, data, 1, time_block, record_size, tid);
 
   data_log_.flush(offset, record_size);
   rt_.advance(offset, static_cast<uint32_t>(record_size));
@@ -278,7 +291,7 @@ void atomic_multilog::read(uint64_t offset, uint64_t &version, read_only_data_lo
 std::vector<std::string> atomic_multilog::read(uint64_t offset, uint64_t &version) const {
   read_only_data_log_ptr rptr;
   read(offset, version, rptr);
-  data_ptr dptr = rptr.decode();
+  data_ptr dptr = rptr.decode_ptr(0, schema_.record_size());
   return schema_.data_to_record_vector(dptr.get());
 }
 
@@ -288,18 +301,28 @@ std::vector<std::string> atomic_multilog::read(uint64_t offset) const {
 }
 
 std::unique_ptr<record_cursor> atomic_multilog::execute_filter(const std::string &expr) const {
-  uint64_t version = rt_.get();
+  uint64_t version = visible_tail();
   auto t = parser::parse_expression(expr);
   auto cexpr = parser::compile_expression(t, schema_);
   query_plan plan = planner_.plan(cexpr);
   return plan.execute(version);
 }
 
+std::string atomic_multilog::explain_filter(const std::string &expr) const {
+  auto t = parser::parse_expression(expr);
+  auto cexpr = parser::compile_expression(t, schema_);
+  return planner_.plan(cexpr).to_string();
+}
+
+void atomic_multilog::set_query_cost_model(std::shared_ptr<planner::cost_model> model) {
+  planner_.set_cost_model(model);
+}
+
 numeric atomic_multilog::execute_aggregate(const std::string &aggregate_expr, const std::string &filter_expr) {
   auto pa = parser::parse_aggregate(aggregate_expr);
   aggregator agg = aggregate_manager::get_aggregator(pa.agg);
   uint16_t field_idx = schema_[pa.field_name].idx();
-  uint64_t version = rt_.get();
+  uint64_t version = visible_tail();
   auto t = parser::parse_expression(filter_expr);
   auto cexpr = parser::compile_expression(t, schema_);
   query_plan plan = planner_.plan(cexpr);
@@ -315,9 +338,9 @@ std::unique_ptr<record_cursor> atomic_multilog::query_filter(const std::string &
         "Filter " + filter_name + " does not exist.");
   }
 
+  uint64_t version = visible_tail();
   filter::range_result res = filters_.at(filter_id)->lookup_range(begin_ms,
                                                                   end_ms);
-  uint64_t version = rt_.get();
   std::unique_ptr<offset_cursor> o_cursor(
       new offset_iterator_cursor<filter::range_result::iterator>(res.begin(),
                                                                  res.end(),
@@ -339,11 +362,12 @@ std::unique_ptr<record_cursor> atomic_multilog::query_filter(const std::string &
         "Filter " + filter_name + " does not exist.");
   }
 
+  uint64_t version = visible_tail();
   filter::range_result res = filters_.at(filter_id)->lookup_range(begin_ms, end_ms);
-  uint64_t version = rt_.get();
   std::unique_ptr<offset_cursor> o_cursor(
       new offset_iterator_cursor<filter::range_result::iterator>(res.begin(), res.end(), version));
-  return std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o_cursor), &data_log_, &schema_, e));
+  return std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o_cursor), &data_log_, &schema_, e, 64,
+                                                                 &zone_map_));
 }
 
 numeric atomic_multilog::get_aggregate(const std::string &aggregate_name, uint64_t begin_ms, uint64_t end_ms) {
@@ -351,19 +375,11 @@ numeric atomic_multilog::get_aggregate(const std::string &aggregate_name, uint64
   if (aggregate_map_.get(aggregate_name, aggregate_id) == -1) {
     throw invalid_operation_exception("Aggregate " + aggregate_name + " does not exist.");
   }
-  uint64_t version = rt_.get();
+  version_tracker::read_guard guard(read_versions_);
+  uint64_t version = visible_tail();
   size_t fid = aggregate_id.filter_idx;
   size_t aid = aggregate_id.aggregate_idx;
-  aggregate_info *a = filters_.at(fid)->get_aggregate_info(aid);
-  numeric agg = a->zero();
-  for (uint64_t t = begin_ms; t <= end_ms; t++) {
-    aggregated_reflog const *refs;
-    if ((refs = filters_.at(fid)->lookup(t)) == nullptr)
-      continue;
-    numeric t_agg = refs->get_aggregate(aid, version);
-    agg = a->comb_op(agg, t_agg);
-  }
-  return agg;
+  return filters_.at(fid)->get_aggregate(aid, begin_ms, end_ms, version);
 }
 
 std::unique_ptr<alert_cursor> atomic_multilog::get_alerts(uint64_t begin_ms, uint64_t end_ms) const {
@@ -392,9 +408,19 @@ size_t atomic_multilog::record_size() const {
   return schema_.record_size();
 }
 
+std::map<std::string, task_scheduler::task_stats> atomic_multilog::task_stats() const {
+  std::map<std::string, task_scheduler::task_stats> stats;
+  stats["archival"] = archival_task_.stats();
+  stats["prealloc"] = prealloc_task_.stats();
+  stats["monitor"] = monitor_task_.stats();
+  return stats;
+}
+
 void atomic_multilog::load(const storage::storage_mode &mode) {
-  load_utils::load_replay_filter_log(archiver_.filter_log_path(), filters_, data_log_, schema_);
-  load_utils::load_replay_index_log(archiver_.index_log_path(), indexes_, data_log_, schema_);
+  size_t zone_map_tail = load_utils::load_zone_map(archiver_.zone_map_path(), zone_map_);
+  archiver_.set_zone_map_tail(zone_map_tail);
+  load_utils::load_replay(archiver_.filter_log_path(), archiver_.index_log_path(), filters_, indexes_, data_log_,
+                          schema_, &index_stats_, load_utils::zone_map_replay{&zone_map_, zone_map_tail});
 }
 
 void atomic_multilog::load_metadata(const std::string &path, storage_mode &s_mode, archival_mode &a_mode) {
@@ -413,7 +439,12 @@ void atomic_multilog::load_metadata(const std::string &path, storage_mode &s_mod
       }
       case D_INDEX_METADATA: {
         auto index_metadata = reader.next_index_metadata();
-        add_index(index_metadata.field_name(), index_metadata.bucket_size());
+        add_index(index_metadata.field_name(), index_metadata.bucket_size(), index_metadata.index_type());
+        break;
+      }
+      case D_TYPED_INDEX_METADATA: {
+        auto index_metadata = reader.next_typed_index_metadata();
+        add_index(index_metadata.field_name(), index_metadata.bucket_size(), index_metadata.index_type());
         break;
       }
       case D_AGGREGATE_METADATA: {
@@ -444,39 +475,168 @@ void atomic_multilog::load_metadata(const std::string &path, storage_mode &s_mod
 }
 
 void atomic_multilog::update_aux_record_block(uint64_t log_offset, record_block &block, size_t record_size) {
+  update_aux_record_block(log_offset, &block.data[0], block.nrecords, block.time_block, record_size,
+                          thread_manager::get_id());
+}
+
+void atomic_multilog::update_aux_record_block(uint64_t log_offset, void *data, size_t nrecords, int64_t time_block,
+                                              size_t record_size, int thread_id) {
+  if (nrecords == 0)
+    return;
+  zone_map_.update(log_offset, data, nrecords, record_size);
   schema_snapshot snap = schema_.snapshot();
+  uint64_t version_floor = read_versions_.floor();
+  // Writers only cover the records of a run past the handoff of a structure
+  // being backfilled, which may fall in the middle of a staged run
+  uint64_t last_offset = log_offset + (nrecords - 1) * record_size;
   for (size_t i = 0; i < filters_.size(); i++) {
-    if (filters_.at(i)->is_valid()) {
-      filters_.at(i)->update(log_offset, snap, block, record_size);
+    filter *f = filters_.at(i);
+    if (writer_updates(f, last_offset)) {
+      size_t skip = writer_skip(f->handoff(), log_offset, record_size);
+      f->update(log_offset + skip * record_size, snap, reinterpret_cast<uint8_t *>(data) + skip * record_size,
+                nrecords - skip, time_block, record_size, version_floor, thread_id);
     }
   }
 
   for (size_t i = 0; i < schema_.size(); i++) {
-    if (snap.is_indexed(i)) {
-      radix_index *idx = indexes_.at(snap.index_id(i));
+    radix_index *idx = writer_index(snap, i, last_offset);
+    if (idx != nullptr) {
+      size_t skip = snap.is_indexed(i) ? 0 : writer_skip(schema_[i].index_handoff(), log_offset, record_size);
       // Handle timestamp differently
       // TODO: What if indexing requested for finer granularity?
-      if (i == 0) {  // Timestamp
-        auto &refs = idx->get_or_create(snap.time_key(block.time_block));
-        size_t off = refs->reserve(block.nrecords);
-        for (size_t j = 0; j < block.nrecords; j++) {
-          refs->set(off + j, log_offset + j * record_size);
+      if (i == 0 && snap.index_type(i) == RADIX_INDEX) {  // Timestamp
+        byte_string key = snap.time_key(time_block);
+        auto &refs = idx->get_or_create(key);
+        size_t off = refs->reserve(nrecords - skip);
+        for (size_t j = skip; j < nrecords; j++) {
+          size_t record_offset = log_offset + j * record_size;
+          index_stats *stats = writer_stats(snap, i, record_offset);
+          if (stats != nullptr)
+            stats->update(key);
+          refs->set(off + j - skip, record_offset);
         }
       } else {
-        for (size_t j = 0; j < block.nrecords; j++) {
+        for (size_t j = skip; j < nrecords; j++) {
           size_t block_offset = j * record_size;
           size_t record_offset = log_offset + block_offset;
-          void *rec_ptr = reinterpret_cast<uint8_t *>(&block.data[0])
-              + block_offset;
-          idx->insert(snap.get_key(rec_ptr, static_cast<uint32_t>(i)), record_offset);
+          void *rec_ptr = reinterpret_cast<uint8_t *>(data) + block_offset;
+          byte_string key = snap.get_key(rec_ptr, static_cast<uint32_t>(i));
+          index_stats *stats = writer_stats(snap, i, record_offset);
+          if (stats != nullptr)
+            stats->update(key);
+          idx->insert(key, record_offset);
         }
       }
     }
   }
 }
 
+void atomic_multilog::update_aux_logged_block(uint64_t log_offset, size_t nrecords, int64_t time_block,
+                                              size_t record_size) {
+  int tid = thread_manager::get_id();
+  if (tid < 0) {
+    update_aux_logged_run(log_offset, nrecords, time_block, record_size, tid);
+    return;
+  }
+  // The thread's staged appends are applied first, so that its updates to
+  // aggregates stay in offset order
+  stager_.direct_update(tid, [&] {
+    update_aux_logged_run(log_offset, nrecords, time_block, record_size, tid);
+  });
+}
+
+void atomic_multilog::update_aux_logged_run(uint64_t log_offset, size_t nrecords, int64_t time_block,
+                                            size_t record_size, int thread_id) {
+  std::vector<uint8_t> straddler;
+  uint64_t end = log_offset + nrecords * record_size;
+  while (log_offset < end) {
+    uint64_t bucket_end = (log_offset / data_log_constants::BUCKET_SIZE + 1) * data_log_constants::BUCKET_SIZE;
+    size_t run = static_cast<size_t>((std::min(end, bucket_end) - log_offset) / record_size);
+    if (run > 0) {
+      read_only_data_log_ptr rptr;
+      data_log_.ptr(log_offset, rptr);
+      data_ptr dptr = rptr.decode_ptr(0, run * record_size);
+      update_aux_record_block(log_offset, dptr.get(), run, time_block, record_size, thread_id);
+      log_offset += run * record_size;
+    } else {
+      straddler.resize(record_size);
+      data_log_.read(log_offset, straddler.data(), record_size);
+      update_aux_record_block(log_offset, straddler.data(), 1, time_block, record_size, thread_id);
+      log_offset += record_size;
+    }
+  }
+}
+
+radix_index *atomic_multilog::writer_index(const schema_snapshot &snap, size_t i, size_t offset) {
+  if (snap.is_indexed(i))
+    return indexes_.at(snap.index_id(i));
+  if (snap.is_indexing(i)) {
+    column_t &col = schema_[i];
+    if (col.index_handoff().covers(offset, [this] { return data_log_.size(); }))
+      return indexes_.at(col.index_id());
+  }
+  return nullptr;
+}
+
+index_stats *atomic_multilog::writer_stats(const schema_snapshot &snap, size_t i, size_t offset) {
+  if (!index_stats::is_sampled(offset / schema_.record_size()))
+    return nullptr;
+  return index_stats_.at(snap.is_indexed(i) ? snap.index_id(i) : schema_[i].index_id());
+}
+
+bool atomic_multilog::writer_updates(filter *f, size_t offset) {
+  return f->is_valid() && f->handoff().covers(offset, [this] { return data_log_.size(); });
+}
+
+size_t atomic_multilog::writer_skip(const backfill_handoff &handoff, size_t offset, size_t record_size) {
+  uint64_t h = handoff.get();
+  return h > offset ? static_cast<size_t>((h - offset) / record_size) : 0;
+}
+
+size_t atomic_multilog::await_handoff(backfill_handoff &handoff) {
+  size_t offset = handoff.resolve(data_log_.size());
+  // Writers that reserved space below the handoff may still be writing, or
+  // hold records below it in their stages; an empty data log, as when
+  // loading metadata, has nothing to wait for
+  while (offset > 0 && visible_tail() < offset)
+    std::this_thread::yield();
+  return offset;
+}
+
+void atomic_multilog::backfill_index(const std::string &field_name) {
+  uint16_t idx = static_cast<uint16_t>(schema_.get_field_index(field_name));
+  column_t &col = schema_[idx];
+  size_t handoff = await_handoff(col.index_handoff());
+  radix_index *index = indexes_.at(col.index_id());
+  index_stats *stats = index_stats_.at(col.index_id());
+  try {
+    load_utils::backfill(data_log_, schema_, {}, {load_utils::index_replay{index, idx, 0, stats}}, handoff);
+  } catch (std::exception &e) {
+    col.set_unindexed();
+    THROW(management_exception, "Could not backfill index for " + field_name + ": " + e.what());
+  }
+  col.set_indexed(col.index_id(), col.index_bucket_size(), col.index_type());
+}
+
+void atomic_multilog::backfill_filter(const std::string &name) {
+  filter_id_t filter_id;
+  if (filter_map_.get(name, filter_id) == -1)
+    return;
+  filter *f = filters_.at(filter_id);
+  size_t handoff = await_handoff(f->handoff());
+  try {
+    load_utils::backfill(data_log_, schema_, {load_utils::filter_replay{f, 0}}, {}, handoff);
+  } catch (std::exception &e) {
+    f->invalidate();
+    filter_map_.remove(name, filter_id);
+    THROW(management_exception, "Could not backfill filter " + name + ": " + e.what());
+  }
+  f->handoff().complete();
+}
+
 void atomic_multilog::add_index_task(const std::string &field_name,
                                      double bucket_size,
+                                     index_type_t type,
                                      optional<management_exception> &ex) {
   size_t idx;
   try {
@@ -489,14 +649,18 @@ void atomic_multilog::add_index_task(const std::string &field_name,
   column_t &col = schema_[idx];
   bool success = col.set_indexing();
   if (success) {
-    uint16_t index_id = UINT16_MAX;
-    if (col.type().is_valid()) {
-      index_id = static_cast<uint16_t>(indexes_.push_back(new radix_index(col.type().size, 256)));
-    } else {
+    if (!col.type().is_valid()) {
+      col.set_unindexed();
       ex = management_exception("Index not supported for field type");
+      return;
     }
-    col.set_indexed(index_id, bucket_size);
-    metadata_.write_index_metadata(field_name, bucket_size);
+    // The index is published to writers before it is backfilled
+    // A hash index holds 8-byte hashed keys, whatever the width of the column
+    size_t key_size = type == HASH_INDEX ? sizeof(uint64_t) : col.type().size;
+    uint16_t index_id = static_cast<uint16_t>(indexes_.push_back(new radix_index(key_size, 256)));
+    index_stats_.push_back(new index_stats());
+    col.set_backfilling(index_id, bucket_size, type);
+    metadata_.write_index_metadata(field_name, bucket_size, type);
   } else {
     ex = management_exception("Could not index " + field_name + ": already indexed/indexing");
     return;
@@ -528,7 +692,10 @@ void atomic_multilog::add_filter_task(const std::string &name,
   }
   auto t = parser::parse_expression(expr);
   auto cexpr = parser::compile_expression(t, schema_);
-  filter_id = filters_.push_back(new filter(cexpr, default_filter));
+  filter *f = new filter(cexpr, default_filter);
+  // Writers only update the filter past its handoff; the rest is backfilled
+  f->handoff().publish();
+  filter_id = filters_.push_back(f);
   metadata_.write_filter_metadata(name, expr);
   if (filter_map_.put(name, filter_id) == -1) {
     ex = management_exception("Could not add filter " + name + " to filter map.");
@@ -636,20 +803,42 @@ void atomic_multilog::remove_trigger_task(const std::string &name, optional<mana
   trigger_map_.remove(name, trigger_id);
 }
 
+uint64_t atomic_multilog::visible_tail() const {
+  stager_.flush_all();
+  return stager_.visible(rt_.get());
+}
+
+void atomic_multilog::pre_alloc_buckets(size_t offset, size_t len) {
+  if (data_log_type::pre_alloc_bucket(offset + len) != data_log_type::pre_alloc_bucket(offset))
+    prealloc_task_.notify();
+}
+
+void atomic_multilog::prealloc_task() {
+  data_log_.pre_alloc(data_log_type::pre_alloc_bucket(data_log_.size()), prealloc_buckets_);
+}
+
 void atomic_multilog::archival_task() {
-  optional<management_exception> ex;
-  std::future<void> ret = archival_pool_.submit([this] {
-    if (rt_.get() > archival_configuration_params::IN_MEMORY_DATALOG_WINDOW_BYTES())
-      archiver_.archive(rt_.get() - archival_configuration_params::IN_MEMORY_DATALOG_WINDOW_BYTES());
-  });
-  ret.wait();
-  if (ex.has_value())
-    throw ex.value();
+  std::lock_guard<std::mutex> lock(archival_mtx_);
+  uint64_t tail = visible_tail();
+  if (tail > archival_configuration_params::IN_MEMORY_DATALOG_WINDOW_BYTES())
+    archiver_.archive(tail - archival_configuration_params::IN_MEMORY_DATALOG_WINDOW_BYTES());
+  // Free swapped out buckets that readers have since moved past
+  storage::epoch_manager::instance().try_reclaim();
 }
 
 void atomic_multilog::monitor_task() {
-  uint64_t cur_ms = time_utils::cur_ms();
-  uint64_t version = rt_.get();
+  // Staged appends are applied here at the latest, a monitor period after
+  // they were appended
+  read_versions_.advance(visible_tail());
+  // Windows ending at or before the horizon are evaluated, once each; appends
+  // to them have had a monitor window to land. Windows ending a monitor
+  // window before that are too stale to alert on, and are skipped.
+  uint64_t window_ms = configuration_params::MONITOR_WINDOW_MS();
+  uint64_t horizon = time_utils::cur_ms() - window_ms;
+  uint64_t stale = horizon - window_ms;
+  version_tracker::read_guard guard(read_versions_);
+  uint64_t version = visible_tail();
+  window_cache windows;
   size_t nfilters = filters_.size();
   for (size_t i = 0; i < nfilters; i++) {
     filter *f = filters_.at(i);
@@ -658,15 +847,16 @@ void atomic_multilog::monitor_task() {
       for (size_t aid = 0; aid < naggs; aid++) {
         aggregate_info *a = f->get_aggregate_info(aid);
         if (a->is_valid()) {
+          windows.clear();
           size_t ntriggers = a->num_triggers();
           for (size_t tid = 0; tid < ntriggers; tid++) {
             trigger *t = a->get_trigger(tid);
             if (t->is_valid()) {
-              for (uint64_t ms = cur_ms - configuration_params::MONITOR_WINDOW_MS(); ms <= cur_ms; ms++) {
-                if (ms % t->periodicity_ms() == 0) {
-                  check_time_bucket(f, t, tid, ms, version);
-                }
-              }
+              uint64_t period = t->periodicity_ms();
+              uint64_t end = std::max(t->next_window_ms(), (stale / period + 1) * period);
+              for (; end <= horizon; end += period)
+                check_window(f, aid, t, end - period, end, version, windows);
+              t->set_next_window_ms(end);
             }
           }
         }
@@ -675,17 +865,21 @@ void atomic_multilog::monitor_task() {
   }
 }
 
-void atomic_multilog::check_time_bucket(filter *f, trigger *t, size_t tid, uint64_t time_bucket, uint64_t version) {
-  size_t window_size = t->periodicity_ms();
-  for (uint64_t ms = time_bucket - window_size; ms < time_bucket; ms++) {
-    const aggregated_reflog *ar = f->lookup(ms);
-    if (ar != nullptr) {
-      numeric agg = ar->get_aggregate(tid, version);
-      if (numeric::relop(t->op(), agg, t->threshold())) {
-        alerts_.add_alert(ms, t->name(), t->expr(), agg, version);
-      }
-    }
+void atomic_multilog::check_window(filter *f, size_t aid, trigger *t, uint64_t begin_ms, uint64_t end_ms,
+                                   uint64_t version, window_cache &windows) {
+  auto key = std::make_pair(begin_ms, end_ms);
+  auto it = windows.find(key);
+  if (it == windows.end()) {
+    // Windows without data raise no alerts
+    optional<numeric> agg;
+    auto reflogs = f->lookup_range_reflogs(begin_ms, end_ms - 1);
+    if (reflogs.begin() != reflogs.end())
+      agg = f->get_aggregate(aid, begin_ms, end_ms - 1, version);
+    it = windows.insert(std::make_pair(key, agg)).first;
   }
+
+  if (it->second.has_value() && numeric::relop(t->op(), it->second.value(), t->threshold()))
+    alerts_.add_alert(begin_ms, t->name(), t->expr(), it->second.value(), version);
 }
 
 }
\ No newline at end of file
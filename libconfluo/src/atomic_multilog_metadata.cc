@@ -3,9 +3,10 @@
 
 namespace confluo {
 
-index_metadata::index_metadata(const std::string &field_name, double bucket_size)
+index_metadata::index_metadata(const std::string &field_name, double bucket_size, index_type_t type)
     : field_name_(field_name),
-      bucket_size_(bucket_size) {
+      bucket_size_(bucket_size),
+      index_type_(type) {
 }
 std::string index_metadata::field_name() const {
   return field_name_;
@@ -13,6 +14,9 @@ std::string index_metadata::field_name() const {
 double index_metadata::bucket_size() const {
   return bucket_size_;
 }
+index_type_t index_metadata::index_type() const {
+  return index_type_;
+}
 filter_metadata::filter_metadata(const std::string &filter_name, const std::string &expr)
     : filter_name_(filter_name),
       expr_(expr) {
@@ -67,8 +71,9 @@ metadata_writer::metadata_writer(const std::string &path, bool overwrite)
 metadata_writer::metadata_writer(const metadata_writer &other)
     : filename_(other.filename_),
       state_(other.state_) {
+  // The other writer has already truncated the file if it had to
   out_.close();
-  out_.open(filename_);
+  out_.open(filename_, std::ofstream::app);
 }
 metadata_writer::~metadata_writer() {
   out_.close();
@@ -76,7 +81,7 @@ metadata_writer::~metadata_writer() {
 metadata_writer &metadata_writer::operator=(const metadata_writer &other) {
   out_.close();
   filename_ = other.filename_;
-  out_.open(filename_);
+  out_.open(filename_, std::ofstream::app);
   state_ = other.state_;
   return *this;
 }
@@ -108,12 +113,15 @@ void metadata_writer::write_schema(const schema_t &schema) {
     io_utils::flush(out_);
   }
 }
-void metadata_writer::write_index_metadata(const std::string &name, double bucket_size) {
+void metadata_writer::write_index_metadata(const std::string &name, double bucket_size, index_type_t index_type) {
   if (state_) {
-    metadata_type type = metadata_type::D_INDEX_METADATA;
+    bool typed = index_type != RADIX_INDEX;
+    metadata_type type = typed ? metadata_type::D_TYPED_INDEX_METADATA : metadata_type::D_INDEX_METADATA;
     io_utils::write(out_, type);
     io_utils::write(out_, name);
     io_utils::write(out_, bucket_size);
+    if (typed)
+      io_utils::write(out_, index_type);
     io_utils::flush(out_);
   }
 }
@@ -173,7 +181,13 @@ schema_t metadata_reader::next_schema() {
 index_metadata metadata_reader::next_index_metadata() {
   std::string field_name = io_utils::read<std::string>(in_);
   auto bucket_size = io_utils::read<double>(in_);
-  return index_metadata(field_name, bucket_size);
+  return index_metadata(field_name, bucket_size, RADIX_INDEX);
+}
+index_metadata metadata_reader::next_typed_index_metadata() {
+  std::string field_name = io_utils::read<std::string>(in_);
+  auto bucket_size = io_utils::read<double>(in_);
+  auto index_type = io_utils::read<index_type_t>(in_);
+  return index_metadata(field_name, bucket_size, index_type);
 }
 filter_metadata metadata_reader::next_filter_metadata() {
   std::string filter_name = io_utils::read<std::string>(in_);
@@ -0,0 +1,48 @@
+#include "backfill_handoff.h"
+
+namespace confluo {
+
+const uint64_t backfill_handoff::UNPUBLISHED = UINT64_MAX;
+const uint64_t backfill_handoff::PENDING = UINT64_MAX - 1;
+
+backfill_handoff::backfill_handoff(uint64_t offset)
+    : offset_(offset) {
+}
+
+backfill_handoff::backfill_handoff(const backfill_handoff &other)
+    : offset_(other.get()) {
+}
+
+backfill_handoff &backfill_handoff::operator=(const backfill_handoff &other) {
+  atomic::init(&offset_, other.get());
+  return *this;
+}
+
+uint64_t backfill_handoff::get() const {
+  return atomic::load(&offset_);
+}
+
+void backfill_handoff::publish() {
+  atomic::store(&offset_, PENDING);
+}
+
+uint64_t backfill_handoff::resolve(uint64_t tail) {
+  uint64_t expected = PENDING;
+  if (atomic::strong::cas(&offset_, &expected, tail))
+    return tail;
+  return expected;
+}
+
+void backfill_handoff::complete() {
+  atomic::store(&offset_, UINT64_C(0));
+}
+
+bool backfill_handoff::is_complete() const {
+  return get() == 0;
+}
+
+void backfill_handoff::reset() {
+  atomic::store(&offset_, UNPUBLISHED);
+}
+
+}
@@ -0,0 +1,166 @@
+#include "compression/columnar_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "lz4.h"
+#include "compression/lz4_block_cache.h"
+#include "container/bitmap/bitmap.h"
+#include "exceptions.h"
+
+namespace confluo {
+namespace compression {
+
+size_t columnar_decoder::decoded_size(const uint8_t *encoded) {
+  return header(encoded).decoded_size;
+}
+
+size_t columnar_decoder::first_record(const uint8_t *encoded) {
+  return header(encoded).first_record;
+}
+
+size_t columnar_decoder::num_records(const uint8_t *encoded) {
+  return header(encoded).num_records;
+}
+
+size_t columnar_decoder::num_columns(const uint8_t *encoded) {
+  return header(encoded).num_columns;
+}
+
+column_chunk columnar_decoder::column(const uint8_t *encoded, size_t col) {
+  column_chunk chunk;
+  memcpy(&chunk, encoded + sizeof(columnar_header) + col * sizeof(column_chunk), sizeof(column_chunk));
+  return chunk;
+}
+
+const uint8_t *columnar_decoder::column_min(const uint8_t *encoded, size_t col) {
+  return encoded + column(encoded, col).data_offset;
+}
+
+const uint8_t *columnar_decoder::column_max(const uint8_t *encoded, size_t col) {
+  column_chunk chunk = column(encoded, col);
+  return encoded + chunk.data_offset + ((chunk.width + 7) & ~UINT32_C(7));
+}
+
+void columnar_decoder::decode_column(const uint8_t *encoded, size_t col, uint8_t *buffer, size_t first,
+                                     size_t count) {
+  column_chunk chunk = column(encoded, col);
+  size_t width = chunk.width;
+  const uint8_t *payload = encoded + chunk.data_offset + 2 * ((width + 7) & ~static_cast<size_t>(7));
+  switch (chunk.codec) {
+    case column_codec::D_FOR: {
+      const uint64_t *packed = reinterpret_cast<const uint64_t *>(payload);
+      for (size_t i = 0; i < count; i++) {
+        uint64_t delta = chunk.bit_width == 0 ? 0 :
+                         bitmap::get_val_pos<uint64_t>(packed, (first + i) * chunk.bit_width, chunk.bit_width);
+        uint64_t v = chunk.base + delta;
+        memcpy(buffer + i * width, &v, width);
+      }
+      break;
+    }
+    case column_codec::D_DICTIONARY: {
+      const uint8_t *dictionary = payload;
+      size_t dictionary_bytes = (chunk.dictionary_size * width + 7) & ~static_cast<size_t>(7);
+      const uint64_t *packed = reinterpret_cast<const uint64_t *>(payload + dictionary_bytes);
+      for (size_t i = 0; i < count; i++) {
+        uint64_t code = chunk.bit_width == 0 ? 0 :
+                        bitmap::get_val_pos<uint64_t>(packed, (first + i) * chunk.bit_width, chunk.bit_width);
+        memcpy(buffer + i * width, dictionary + code * width, width);
+      }
+      break;
+    }
+    case column_codec::D_LZ4: {
+      size_t n = num_records(encoded);
+      size_t num_blocks = (n + columnar_encoder::LZ4_BLOCK_RECORDS - 1) / columnar_encoder::LZ4_BLOCK_RECORDS;
+      const uint8_t *blocks = payload + (num_blocks + 1) * sizeof(uint64_t);
+      size_t idx = first;
+      while (idx < first + count) {
+        size_t block_idx = idx / columnar_encoder::LZ4_BLOCK_RECORDS;
+        size_t block_first = block_idx * columnar_encoder::LZ4_BLOCK_RECORDS;
+        size_t block_count = std::min(columnar_encoder::LZ4_BLOCK_RECORDS, n - block_first);
+        uint64_t begin, end;
+        memcpy(&begin, payload + block_idx * sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&end, payload + (block_idx + 1) * sizeof(uint64_t), sizeof(uint64_t));
+        // Blocks are cached under the bucket, numbered across its columns, so
+        // that reading records one at a time inflates each block once
+        lz4_block_cache::block_ptr block = lz4_block_cache::instance().get(
+            encoded, col * num_blocks + block_idx, block_count * width, [&](uint8_t *decoded) {
+              LZ4_decompress_safe(reinterpret_cast<const char *>(blocks + begin), reinterpret_cast<char *>(decoded),
+                                  static_cast<int>(end - begin), static_cast<int>(block_count * width));
+            });
+        size_t upto = std::min(first + count, block_first + block_count);
+        memcpy(buffer + (idx - first) * width, block.get() + (idx - block_first) * width, (upto - idx) * width);
+        idx = upto;
+      }
+      break;
+    }
+    default: {
+      THROW(illegal_state_exception, "Invalid column codec!");
+    }
+  }
+}
+
+void columnar_decoder::decode(const uint8_t *encoded, uint8_t *buffer, size_t start, size_t len) {
+  columnar_header h = header(encoded);
+  size_t end = start + len;
+  size_t records_end = h.first_record + h.num_records * h.record_size;
+
+  // Bytes before the first whole record
+  if (start < h.first_record)
+    decode_raw(encoded, h, buffer, start, std::min(end, static_cast<size_t>(h.first_record)) - start);
+
+  // Whole records, decoded column by column and stitched back into rows
+  size_t rec_start = std::max(start, static_cast<size_t>(h.first_record));
+  size_t rec_end = std::min(end, records_end);
+  if (rec_start < rec_end) {
+    size_t r0 = (rec_start - h.first_record) / h.record_size;
+    size_t r1 = (rec_end - h.first_record + h.record_size - 1) / h.record_size;
+    size_t count = r1 - r0;
+    std::vector<uint8_t> rows(count * h.record_size);
+    std::vector<uint8_t> values;
+    for (size_t col = 0; col < h.num_columns; col++) {
+      column_chunk chunk = column(encoded, col);
+      values.resize(count * chunk.width);
+      decode_column(encoded, col, values.data(), r0, count);
+      for (size_t i = 0; i < count; i++)
+        memcpy(&rows[i * h.record_size + chunk.offset], &values[i * chunk.width], chunk.width);
+    }
+    memcpy(buffer + (rec_start - start), &rows[rec_start - h.first_record - r0 * h.record_size], rec_end - rec_start);
+  }
+
+  // Bytes after the last whole record
+  size_t tail_start = std::max(start, records_end);
+  if (tail_start < end)
+    decode_raw(encoded, h, buffer + (tail_start - start), tail_start, end - tail_start);
+}
+
+uint8_t columnar_decoder::decode(const uint8_t *encoded, size_t idx) {
+  uint8_t decoded;
+  decode(encoded, &decoded, idx, 1);
+  return decoded;
+}
+
+columnar_header columnar_decoder::header(const uint8_t *encoded) {
+  columnar_header h;
+  memcpy(&h, encoded, sizeof(columnar_header));
+  return h;
+}
+
+void columnar_decoder::decode_raw(const uint8_t *encoded, const columnar_header &h, uint8_t *buffer,
+                                  size_t start, size_t len) {
+  size_t records_end = h.first_record + h.num_records * h.record_size;
+  size_t raw_size = h.first_record + (h.decoded_size - records_end);
+  uint64_t compressed_size;
+  memcpy(&compressed_size, encoded + h.raw_offset, sizeof(uint64_t));
+  std::vector<uint8_t> raw(raw_size);
+  LZ4_decompress_safe(reinterpret_cast<const char *>(encoded + h.raw_offset + sizeof(uint64_t)),
+                      reinterpret_cast<char *>(raw.data()), static_cast<int>(compressed_size),
+                      static_cast<int>(raw_size));
+  // Tail bytes follow the head bytes in the raw segment
+  size_t raw_start = start < h.first_record ? start : h.first_record + (start - records_end);
+  memcpy(buffer, &raw[raw_start], len);
+}
+
+}
+}
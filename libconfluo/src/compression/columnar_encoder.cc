@@ -0,0 +1,271 @@
+#include "compression/columnar_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "lz4.h"
+#include "bit_utils.h"
+#include "container/bitmap/bitmap.h"
+
+namespace confluo {
+namespace compression {
+
+const uint8_t column_kind::D_SIGNED;
+const uint8_t column_kind::D_UNSIGNED;
+const uint8_t column_kind::D_FLOAT;
+const uint8_t column_kind::D_BYTES;
+const uint8_t column_codec::D_FOR;
+const uint8_t column_codec::D_DICTIONARY;
+const uint8_t column_codec::D_LZ4;
+const size_t columnar_encoder::MAX_DICTIONARY_SIZE;
+const size_t columnar_encoder::LZ4_BLOCK_RECORDS;
+
+namespace {
+
+size_t word_align(size_t n) {
+  return (n + 7) & ~static_cast<size_t>(7);
+}
+
+size_t append(std::vector<uint8_t> &out, size_t len) {
+  size_t off = out.size();
+  out.resize(word_align(off + len), 0);
+  return off;
+}
+
+uint64_t load_int(const uint8_t *p, size_t width, uint8_t kind) {
+  uint64_t v = 0;
+  memcpy(&v, p, width);
+  if (kind == column_kind::D_SIGNED && width < 8 && ((v >> (8 * width - 1)) & 1))
+    v |= ::utils::low_bits_unset[8 * width];
+  return v;
+}
+
+bool is_int(const column_chunk &chunk) {
+  return (chunk.kind == column_kind::D_SIGNED || chunk.kind == column_kind::D_UNSIGNED) && chunk.width <= 8;
+}
+
+bool is_float(const column_chunk &chunk) {
+  return chunk.kind == column_kind::D_FLOAT && (chunk.width == sizeof(float) || chunk.width == sizeof(double));
+}
+
+bool less(const uint8_t *a, const uint8_t *b, const column_chunk &chunk) {
+  if (is_int(chunk)) {
+    uint64_t x = load_int(a, chunk.width, chunk.kind), y = load_int(b, chunk.width, chunk.kind);
+    return chunk.kind == column_kind::D_SIGNED ? static_cast<int64_t>(x) < static_cast<int64_t>(y) : x < y;
+  }
+  if (is_float(chunk)) {
+    if (chunk.width == sizeof(float)) {
+      float x, y;
+      memcpy(&x, a, sizeof(float));
+      memcpy(&y, b, sizeof(float));
+      return x < y;
+    }
+    double x, y;
+    memcpy(&x, a, sizeof(double));
+    memcpy(&y, b, sizeof(double));
+    return x < y;
+  }
+  return memcmp(a, b, chunk.width) < 0;
+}
+
+}
+
+unique_byte_array columnar_encoder::encode(uint8_t *ptr, size_t size, const columnar_layout &layout,
+                                           size_t first_record) {
+  std::vector<column_spec> columns = cover(layout);
+  columnar_header header;
+  header.decoded_size = size;
+  header.record_size = layout.record_size;
+  if (columns.empty() || first_record >= size) {
+    header.first_record = size;
+    header.num_records = 0;
+    columns.clear();
+  } else {
+    header.first_record = first_record;
+    header.num_records = (size - first_record) / layout.record_size;
+  }
+  header.num_columns = columns.size();
+
+  std::vector<uint8_t> out;
+  append(out, sizeof(columnar_header) + columns.size() * sizeof(column_chunk));
+  std::vector<column_chunk> chunks(columns.size());
+  for (size_t i = 0; i < columns.size(); i++) {
+    column_chunk &chunk = chunks[i];
+    memset(&chunk, 0, sizeof(column_chunk));
+    chunk.offset = columns[i].offset;
+    chunk.width = columns[i].width;
+    chunk.kind = columns[i].kind;
+    if (header.num_records > 0)
+      encode_chunk(ptr + first_record, header.num_records, layout.record_size, chunk, out);
+    else
+      chunk.data_offset = out.size();
+  }
+
+  // Bytes of records cut by either end of the bucket
+  size_t head_size = header.first_record;
+  size_t tail_start = header.first_record + header.num_records * header.record_size;
+  std::vector<uint8_t> raw(ptr, ptr + head_size);
+  raw.insert(raw.end(), ptr + tail_start, ptr + size);
+  header.raw_offset = append(out, sizeof(uint64_t));
+  uint64_t raw_size = 0;
+  if (!raw.empty()) {
+    int bound = LZ4_compressBound(static_cast<int>(raw.size()));
+    size_t off = append(out, static_cast<size_t>(bound));
+    raw_size = static_cast<uint64_t>(LZ4_compress_default(reinterpret_cast<const char *>(raw.data()),
+                                                          reinterpret_cast<char *>(&out[off]),
+                                                          static_cast<int>(raw.size()), bound));
+    out.resize(word_align(off + raw_size));
+  }
+  memcpy(&out[header.raw_offset], &raw_size, sizeof(uint64_t));
+
+  memcpy(&out[0], &header, sizeof(columnar_header));
+  if (!chunks.empty())
+    memcpy(&out[sizeof(columnar_header)], chunks.data(), chunks.size() * sizeof(column_chunk));
+  unique_byte_array encoded(out.size());
+  memcpy(encoded.get(), out.data(), out.size());
+  return encoded;
+}
+
+std::vector<column_spec> columnar_encoder::cover(const columnar_layout &layout) {
+  std::vector<column_spec> sorted = layout.columns;
+  std::sort(sorted.begin(), sorted.end(), [](const column_spec &a, const column_spec &b) {
+    return a.offset < b.offset;
+  });
+  std::vector<column_spec> columns;
+  size_t covered = 0;
+  for (const column_spec &col : sorted) {
+    // Overlapping or out of bounds columns are clipped to the bytes left
+    size_t start = std::max(static_cast<size_t>(col.offset), covered);
+    size_t end = std::min(static_cast<size_t>(col.offset) + col.width, layout.record_size);
+    if (start >= end)
+      continue;
+    if (start > covered)
+      columns.push_back(column_spec{static_cast<uint32_t>(covered), static_cast<uint32_t>(start - covered),
+                                    column_kind::D_BYTES});
+    uint8_t kind = (start == col.offset && end - start == col.width) ? col.kind : column_kind::D_BYTES;
+    columns.push_back(column_spec{static_cast<uint32_t>(start), static_cast<uint32_t>(end - start), kind});
+    covered = end;
+  }
+  if (covered > 0 && covered < layout.record_size)
+    columns.push_back(column_spec{static_cast<uint32_t>(covered), static_cast<uint32_t>(layout.record_size - covered),
+                                  column_kind::D_BYTES});
+  return columns;
+}
+
+void columnar_encoder::encode_chunk(const uint8_t *records, size_t num_records, size_t record_size,
+                                    column_chunk &chunk, std::vector<uint8_t> &out) {
+  size_t width = chunk.width;
+  std::vector<uint8_t> values(num_records * width);
+  size_t min_idx = 0, max_idx = 0;
+  for (size_t i = 0; i < num_records; i++) {
+    memcpy(&values[i * width], records + i * record_size + chunk.offset, width);
+    if (less(&values[i * width], &values[min_idx * width], chunk))
+      min_idx = i;
+    if (less(&values[max_idx * width], &values[i * width], chunk))
+      max_idx = i;
+  }
+
+  chunk.data_offset = out.size();
+  size_t min_off = append(out, width);
+  memcpy(&out[min_off], &values[min_idx * width], width);
+  size_t max_off = append(out, width);
+  memcpy(&out[max_off], &values[max_idx * width], width);
+
+  if (is_int(chunk)) {
+    std::vector<uint64_t> ints(num_records);
+    for (size_t i = 0; i < num_records; i++)
+      ints[i] = load_int(&values[i * width], width, chunk.kind);
+    chunk.base = ints[min_idx];
+    if (encode_for(ints, chunk, out))
+      return;
+  } else if (chunk.kind == column_kind::D_BYTES) {
+    if (encode_dictionary(values.data(), num_records, chunk, out))
+      return;
+  }
+  chunk.codec = column_codec::D_LZ4;
+  encode_lz4(values.data(), num_records, width, out);
+}
+
+bool columnar_encoder::encode_for(const std::vector<uint64_t> &values, column_chunk &chunk,
+                                  std::vector<uint8_t> &out) {
+  uint64_t range = 0;
+  for (uint64_t v : values)
+    range = std::max(range, v - chunk.base);
+  size_t bits = range == 0 ? 0 : ::utils::bit_utils::bit_width(range);
+  if (bits >= 8 * chunk.width)
+    return false;
+
+  chunk.codec = column_codec::D_FOR;
+  chunk.bit_width = static_cast<uint8_t>(bits);
+  size_t off = append(out, ((values.size() * bits + 63) / 64) * sizeof(uint64_t));
+  uint64_t *packed = reinterpret_cast<uint64_t *>(&out[off]);
+  for (size_t i = 0; i < values.size() && bits > 0; i++)
+    bitmap::set_val_pos<uint64_t>(packed, i * bits, values[i] - chunk.base, chunk.bit_width);
+  return true;
+}
+
+bool columnar_encoder::encode_dictionary(const uint8_t *values, size_t num_values, column_chunk &chunk,
+                                         std::vector<uint8_t> &out) {
+  size_t width = chunk.width;
+  std::vector<uint32_t> order(num_values);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [values, width](uint32_t a, uint32_t b) {
+    return memcmp(values + a * width, values + b * width, width) < 0;
+  });
+
+  std::vector<uint32_t> codes(num_values);
+  std::vector<uint32_t> entries;
+  for (size_t i = 0; i < num_values; i++) {
+    uint32_t idx = order[i];
+    if (entries.empty() || memcmp(values + entries.back() * width, values + idx * width, width) != 0) {
+      if (entries.size() == MAX_DICTIONARY_SIZE)
+        return false;
+      entries.push_back(idx);
+    }
+    codes[idx] = static_cast<uint32_t>(entries.size() - 1);
+  }
+
+  size_t bits = entries.size() <= 1 ? 0 : ::utils::bit_utils::bit_width(entries.size() - 1);
+  size_t dictionary_bytes = word_align(entries.size() * width);
+  size_t code_bytes = ((num_values * bits + 63) / 64) * sizeof(uint64_t);
+  if (2 * (dictionary_bytes + code_bytes) >= num_values * width)
+    return false;
+
+  chunk.codec = column_codec::D_DICTIONARY;
+  chunk.bit_width = static_cast<uint8_t>(bits);
+  chunk.dictionary_size = entries.size();
+  size_t dict_off = append(out, dictionary_bytes);
+  for (size_t i = 0; i < entries.size(); i++)
+    memcpy(&out[dict_off + i * width], values + entries[i] * width, width);
+  size_t off = append(out, code_bytes);
+  uint64_t *packed = reinterpret_cast<uint64_t *>(&out[off]);
+  for (size_t i = 0; i < num_values && bits > 0; i++)
+    bitmap::set_val_pos<uint64_t>(packed, i * bits, codes[i], chunk.bit_width);
+  return true;
+}
+
+void columnar_encoder::encode_lz4(const uint8_t *values, size_t num_values, size_t width,
+                                  std::vector<uint8_t> &out) {
+  size_t num_blocks = (num_values + LZ4_BLOCK_RECORDS - 1) / LZ4_BLOCK_RECORDS;
+  size_t table_off = append(out, (num_blocks + 1) * sizeof(uint64_t));
+  size_t blocks_off = out.size();
+  for (size_t i = 0; i < num_blocks; i++) {
+    size_t count = std::min(LZ4_BLOCK_RECORDS, num_values - i * LZ4_BLOCK_RECORDS);
+    int src_size = static_cast<int>(count * width);
+    int bound = LZ4_compressBound(src_size);
+    size_t off = out.size();
+    out.resize(off + static_cast<size_t>(bound));
+    int size = LZ4_compress_default(reinterpret_cast<const char *>(values + i * LZ4_BLOCK_RECORDS * width),
+                                    reinterpret_cast<char *>(&out[off]), src_size, bound);
+    out.resize(off + static_cast<size_t>(size));
+    uint64_t block_off = off - blocks_off;
+    memcpy(&out[table_off + i * sizeof(uint64_t)], &block_off, sizeof(uint64_t));
+  }
+  uint64_t end = out.size() - blocks_off;
+  memcpy(&out[table_off + num_blocks * sizeof(uint64_t)], &end, sizeof(uint64_t));
+  out.resize(word_align(out.size()), 0);
+}
+
+}
+}
@@ -17,12 +17,25 @@ unique_byte_array confluo_encoder::encode(void *ptr, size_t size, uint8_t encodi
       uint8_t *casted = reinterpret_cast<uint8_t *>(ptr);
       return lz4_encoder<>::encode(casted, size);
     }
+    case encoding_type::D_COLUMNAR: {
+      // Without a layout the whole bucket is kept as bytes outside of records
+      uint8_t *casted = reinterpret_cast<uint8_t *>(ptr);
+      return columnar_encoder::encode(casted, size, columnar_layout{0, {}}, 0);
+    }
     default : {
       THROW(illegal_state_exception, "Invalid encoding type!");
     }
   }
 }
 
+unique_byte_array confluo_encoder::encode(void *ptr, size_t size, uint8_t encoding, const columnar_layout &layout,
+                                          size_t first_record) {
+  if (encoding == encoding_type::D_COLUMNAR) {
+    return columnar_encoder::encode(reinterpret_cast<uint8_t *>(ptr), size, layout, first_record);
+  }
+  return encode(ptr, size, encoding);
+}
+
 void confluo_encoder::no_op_delete(uint8_t *) {}
 
 }
@@ -0,0 +1,50 @@
+#include "compression/lz4_block_cache.h"
+
+namespace confluo {
+namespace compression {
+
+const size_t lz4_block_cache::BLOCK_SIZE;
+const size_t lz4_block_cache::NUM_SLOTS;
+
+lz4_block_cache &lz4_block_cache::instance() {
+  static lz4_block_cache cache;
+  return cache;
+}
+
+lz4_block_cache::block_ptr lz4_block_cache::get(uint8_t *encoded, size_t block_idx) {
+  return get(encoded, block_idx, BLOCK_SIZE, [encoded, block_idx](uint8_t *block) {
+    lz4_decoder<BLOCK_SIZE>::decode_block(encoded, block_idx, block);
+  });
+}
+
+void lz4_block_cache::decode(uint8_t *encoded, uint8_t *dest_buffer, size_t src_index, size_t length) {
+  while (length > 0) {
+    size_t block_idx = src_index / BLOCK_SIZE;
+    size_t block_off = src_index % BLOCK_SIZE;
+    size_t len = std::min(length, BLOCK_SIZE - block_off);
+    block_ptr block = get(encoded, block_idx);
+    std::memcpy(dest_buffer, block.get() + block_off, len);
+    dest_buffer += len;
+    src_index += len;
+    length -= len;
+  }
+}
+
+void lz4_block_cache::invalidate(const uint8_t *encoded) {
+  for (auto &s : slots_) {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.encoded == encoded) {
+      s.encoded = nullptr;
+      s.block = nullptr;
+    }
+  }
+}
+
+lz4_block_cache::slot &lz4_block_cache::slot_for(const uint8_t *encoded, size_t block_idx) {
+  // Consecutive blocks of a buffer map to consecutive slots
+  auto base = static_cast<size_t>(reinterpret_cast<uintptr_t>(encoded) * 11400714819323198485ULL >> 32);
+  return slots_[(base + block_idx) % NUM_SLOTS];
+}
+
+}
+}
@@ -3,7 +3,8 @@
 namespace confluo {
 
 confluo_store::confluo_store(const std::string &data_path)
-    : data_path_(utils::file_utils::full_path(data_path)) {
+    : data_path_(utils::file_utils::full_path(data_path)),
+      scheduler_(static_cast<size_t>(configuration_params::SCHEDULER_THREADS())) {
   utils::file_utils::create_dir(data_path_);
   // Note that this assumes a one-to-one relationship between the confluo_store and allocator
   allocator::instance().register_cleanup_callback(std::bind(&confluo_store::memory_management_callback, this));
@@ -82,6 +83,10 @@ int64_t confluo_store::remove_atomic_multilog(int64_t id) {
   return remove_atomic_multilog(get_atomic_multilog(id)->get_name());
 }
 
+task_scheduler &confluo_store::scheduler() {
+  return scheduler_;
+}
+
 void confluo_store::memory_management_task() {
   if (allocator::instance().memory_utilization() >= configuration_params::MAX_MEMORY()) {
     for (size_t id = 0; id < atomic_multilogs_.size(); id++) {
@@ -111,7 +116,7 @@ int64_t confluo_store::create_atomic_multilog_task(const std::string &name,
   }
   utils::file_utils::create_dir(data_path_ + "/" + name);
   atomic_multilog *t = new atomic_multilog(name, schema, data_path_ + "/" + name,
-                                           mode, a_mode, mgmt_pool_);
+                                           mode, a_mode, mgmt_pool_, scheduler_);
   id = atomic_multilogs_.push_back(t);
   if (multilog_map_.put(name, id) == -1) {
     ex = management_exception("Could not add atomic multilog " + name + " to atomic multilog map");
@@ -132,7 +137,7 @@ int64_t confluo_store::create_atomic_multilog_task(const std::string &name,
   }
   utils::file_utils::create_dir(data_path_ + "/" + name);
   atomic_multilog *t = new atomic_multilog(name, schema, data_path_ + "/" + name,
-                                           mode, a_mode, mgmt_pool_);
+                                           mode, a_mode, mgmt_pool_, scheduler_);
   id = atomic_multilogs_.push_back(t);
   if (multilog_map_.put(name, id) == -1) {
     ex = management_exception("Could not add atomic multilog " + name + " to atomic multilog map");
@@ -147,7 +152,7 @@ int64_t confluo_store::load_atomic_multilog_task(const std::string &name, option
     ex = management_exception("Table " + name + " already loaded.");
     return INT64_C(-1);
   }
-  atomic_multilog *t = new atomic_multilog(name, data_path_ + "/" + name, mgmt_pool_);
+  atomic_multilog *t = new atomic_multilog(name, data_path_ + "/" + name, mgmt_pool_, scheduler_);
   id = atomic_multilogs_.push_back(t);
   if (multilog_map_.put(name, id) == -1) {
     ex = management_exception("Could not add atomic multilog " + name + " to atomic multilog map");
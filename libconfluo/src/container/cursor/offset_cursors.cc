@@ -18,4 +18,19 @@ size_t data_log_cursor::load_next_batch() {
   return i;
 }
 
-}
\ No newline at end of file
+offset_list_cursor::offset_list_cursor(std::vector<uint64_t> &&offsets, size_t batch_size)
+    : offset_cursor(batch_size),
+      offsets_(std::move(offsets)),
+      pos_(0) {
+  init();
+}
+
+size_t offset_list_cursor::load_next_batch() {
+  size_t i = 0;
+  for (; i < current_batch_.size() && pos_ < offsets_.size(); i++, pos_++) {
+    current_batch_[i] = offsets_[pos_];
+  }
+  return i;
+}
+
+}
@@ -22,6 +22,11 @@ size_t distinct_record_cursor::load_next_batch() {
   return i;
 }
 
+// Buffer that the records of a batch share copies of their data in
+static std::shared_ptr<uint8_t> batch_buffer(size_t batch_size, size_t record_size) {
+  return std::shared_ptr<uint8_t>(new uint8_t[batch_size * record_size], std::default_delete<uint8_t[]>());
+}
+
 std::unique_ptr<record_cursor> make_distinct(std::unique_ptr<record_cursor> r_cursor, size_t batch_size) {
   return std::unique_ptr<record_cursor>(new distinct_record_cursor(std::move(r_cursor), batch_size));
 }
@@ -30,27 +35,164 @@ filter_record_cursor::filter_record_cursor(std::unique_ptr<offset_cursor> o_curs
                                            const data_log *dlog,
                                            const schema_t *schema,
                                            const parser::compiled_expression &cexpr,
-                                           size_t batch_size)
+                                           size_t batch_size,
+                                           const zone_map *zones)
     : record_cursor(batch_size),
       o_cursor_(std::move(o_cursor)),
       dlog_(dlog),
       schema_(schema),
-      cexpr_(cexpr) {
+      cexpr_(cexpr),
+      zone_filter_(zones, cexpr_) {
   init();
 }
 
 size_t filter_record_cursor::load_next_batch() {
+  // Records are copied into a buffer shared by the batch within the batch's
+  // epoch, rather than each holding a counted pointer into the data log
+  size_t record_size = schema_->record_size();
+  std::shared_ptr<uint8_t> buf = batch_buffer(current_batch_.size(), record_size);
   size_t i = 0;
   for (; i < current_batch_.size() && o_cursor_->has_more();
          ++i, o_cursor_->advance()) {
     uint64_t o = o_cursor_->get();
-    read_only_data_log_ptr ptr;
-    dlog_->cptr(o, ptr);
-    if (!cexpr_.test(current_batch_[i] = schema_->apply(o, ptr))) {
+    if (!zone_filter_.may_match(o)) {
+      i--;
+      continue;
+    }
+    uint8_t *rec = buf.get() + i * record_size;
+    dlog_->read(o, rec, record_size);
+    if (!cexpr_.test(current_batch_[i] = schema_->apply(o, std::shared_ptr<uint8_t>(buf, rec)))) {
       i--;
     }
   }
   return i;
 }
 
-}
\ No newline at end of file
+record_block_scanner::record_block_scanner(uint64_t version,
+                                           const data_log *dlog,
+                                           const schema_t *schema,
+                                           const parser::compiled_expression &cexpr,
+                                           size_t block_size,
+                                           const zone_map *zones)
+    : version_(version),
+      record_size_(schema->record_size()),
+      dlog_(dlog),
+      bexpr_(cexpr, *schema),
+      block_size_(block_size),
+      zone_filter_(zones, cexpr),
+      next_offset_(0),
+      block_offset_(0),
+      block_(nullptr, storage::detail::no_op_delete<uint8_t>),
+      sel_(block_size) {
+}
+
+size_t record_block_scanner::next_block() {
+  if (zone_filter_.is_active())
+    skip_pruned();
+  block_offset_ = next_offset_;
+  if (block_offset_ + record_size_ > version_)
+    return 0;
+
+  // Restrict the block to records that lie entirely within one bucket, so
+  // that it can be evaluated in place.
+  const uint64_t bucket_size = data_log_constants::BUCKET_SIZE;
+  uint64_t bucket_end = (block_offset_ / bucket_size + 1) * bucket_size;
+  uint64_t limit = std::min(bucket_end, version_);
+  if (zone_filter_.is_active()) {
+    // Keep records of the next zone out of the block, so that the zone can
+    // be pruned on its own
+    uint64_t zone_end = (block_offset_ / zone_map::ZONE_SIZE + 1) * zone_map::ZONE_SIZE;
+    limit = std::min(limit, record_at_or_after(zone_end));
+  }
+  size_t block_len = std::min(block_size_, static_cast<size_t>((limit - block_offset_) / record_size_));
+
+  if (block_len == 0) {
+    // The record straddles two buckets; evaluate a copy of it
+    block_len = 1;
+    scratch_.resize(record_size_);
+    dlog_->read(block_offset_, scratch_.data(), record_size_);
+    block_ = data_ptr(scratch_.data(), storage::detail::no_op_delete<uint8_t>);
+  } else {
+    dlog_->cptr(block_offset_, ptr_);
+    block_ = ptr_.decode_ptr(0, block_len * record_size_);
+  }
+  bexpr_.evaluate(block_.get(), record_size_, block_len, sel_.data());
+  next_offset_ = block_offset_ + block_len * record_size_;
+  return block_len;
+}
+
+void record_block_scanner::skip_pruned() {
+  while (next_offset_ + record_size_ <= version_) {
+    uint64_t bucket_idx = next_offset_ / zone_map::BUCKET_SIZE;
+    if (!zone_filter_.may_match_bucket(bucket_idx)) {
+      next_offset_ = record_at_or_after((bucket_idx + 1) * zone_map::BUCKET_SIZE);
+      continue;
+    }
+    uint64_t zone_idx = next_offset_ / zone_map::ZONE_SIZE;
+    if (!zone_filter_.may_match_zone(zone_idx)) {
+      next_offset_ = record_at_or_after((zone_idx + 1) * zone_map::ZONE_SIZE);
+      continue;
+    }
+    break;
+  }
+}
+
+uint64_t record_block_scanner::record_at_or_after(uint64_t offset) const {
+  return (offset + record_size_ - 1) / record_size_ * record_size_;
+}
+
+uint64_t record_block_scanner::block_offset() const {
+  return block_offset_;
+}
+
+const uint8_t *record_block_scanner::block_data() const {
+  return block_.get();
+}
+
+const uint8_t *record_block_scanner::selection() const {
+  return sel_.data();
+}
+
+uint64_t record_block_scanner::record_size() const {
+  return record_size_;
+}
+
+block_scan_record_cursor::block_scan_record_cursor(uint64_t version,
+                                                   const data_log *dlog,
+                                                   const schema_t *schema,
+                                                   const parser::compiled_expression &cexpr,
+                                                   size_t batch_size,
+                                                   size_t block_size,
+                                                   const zone_map *zones)
+    : record_cursor(batch_size),
+      schema_(schema),
+      scanner_(version, dlog, schema, cexpr, block_size, zones),
+      block_len_(0),
+      block_pos_(0) {
+  init();
+}
+
+size_t block_scan_record_cursor::load_next_batch() {
+  size_t record_size = scanner_.record_size();
+  std::shared_ptr<uint8_t> buf = batch_buffer(current_batch_.size(), record_size);
+  size_t i = 0;
+  while (i < current_batch_.size()) {
+    if (block_pos_ == block_len_) {
+      block_pos_ = 0;
+      if ((block_len_ = scanner_.next_block()) == 0)
+        break;
+    }
+    const uint8_t *sel = scanner_.selection();
+    for (; i < current_batch_.size() && block_pos_ < block_len_; block_pos_++) {
+      if (sel[block_pos_]) {
+        uint64_t o = scanner_.block_offset() + block_pos_ * record_size;
+        uint8_t *rec = buf.get() + i * record_size;
+        memcpy(rec, scanner_.block_data() + block_pos_ * record_size, record_size);
+        current_batch_[i++] = schema_->apply(o, std::shared_ptr<uint8_t>(buf, rec));
+      }
+    }
+  }
+  return i;
+}
+
+}
@@ -117,7 +117,8 @@ universal_sketch::key_t universal_sketch::get_key_hash(const record_t &r) {
 }
 
 universal_sketch::key_t universal_sketch::get_key_hash(const read_only_data_log_ptr &ptr) {
-  return hash_util::hash(column_.apply(ptr.decode().get()).value());
+  auto dptr = ptr.decode_ptr(0, column_.offset() + column_.type().size);
+  return hash_util::hash(column_.apply(dptr.get()).value());
 }
 
 universal_sketch::key_t universal_sketch::str_to_key_hash(const std::string &str) {
@@ -129,8 +130,9 @@ universal_sketch::key_t universal_sketch::str_to_key_hash(const std::string &str
 }
 
 std::string universal_sketch::record_key_to_string(const read_only_data_log_ptr &ptr) {
-  const void *fptr = reinterpret_cast<const uint8_t *>(ptr.decode().get()) + column_.offset();
   auto ftype = column_.type();
+  auto dptr = ptr.decode_ptr(0, column_.offset() + ftype.size);
+  const void *fptr = dptr.get() + column_.offset();
   return ftype.to_string_op()(immutable_raw_data(fptr, ftype.size));
 }
 
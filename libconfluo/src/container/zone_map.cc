@@ -0,0 +1,320 @@
+#include "container/zone_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "exceptions.h"
+
+namespace confluo {
+
+const size_t zone_map::ZONE_SIZE;
+const size_t zone_map::BUCKET_SIZE;
+const size_t zone_map::ZONES_PER_BUCKET;
+const size_t zone_map::MAX_BUCKETS;
+
+namespace {
+
+const uint64_t SIGN_BIT = UINT64_C(1) << 63;
+
+// Maps a double to a key with the same order; -0.0 and 0.0 share a key
+// since they compare equal
+uint64_t double_key(double d) {
+  if (d == 0)
+    d = 0;
+  uint64_t bits;
+  memcpy(&bits, &d, sizeof(double));
+  return (bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT;
+}
+
+template<typename T>
+uint64_t signed_key(const void *value) {
+  T v;
+  memcpy(&v, value, sizeof(T));
+  return static_cast<uint64_t>(static_cast<int64_t>(v)) ^ SIGN_BIT;
+}
+
+template<typename T>
+uint64_t unsigned_key(const void *value) {
+  T v;
+  memcpy(&v, value, sizeof(T));
+  return static_cast<uint64_t>(v);
+}
+
+bool is_tracked(size_t type_id) {
+  return type_id >= primitive_type::D_BOOL && type_id <= primitive_type::D_DOUBLE;
+}
+
+}
+
+zone_map::zone_map()
+    : buckets_(new atomic::type<bound_t *>[MAX_BUCKETS]) {
+  for (size_t i = 0; i < MAX_BUCKETS; i++)
+    atomic::init(&buckets_[i], static_cast<bound_t *>(nullptr));
+}
+
+zone_map::~zone_map() {
+  for (size_t i = 0; i < MAX_BUCKETS; i++)
+    delete[] atomic::load(&buckets_[i]);
+}
+
+void zone_map::init(const schema_t &schema) {
+  columns_.clear();
+  column_of_.assign(schema.size(), -1);
+  for (size_t i = 0; i < schema.size(); i++) {
+    const column_t &col = schema[i];
+    if (is_tracked(col.type().id)) {
+      column_of_[i] = static_cast<int>(columns_.size());
+      columns_.push_back(tracked_column{col.offset(), col.type().id});
+    }
+  }
+}
+
+size_t zone_map::num_columns() const {
+  return columns_.size();
+}
+
+int zone_map::column_of(size_t field_idx) const {
+  return field_idx < column_of_.size() ? column_of_[field_idx] : -1;
+}
+
+uint64_t zone_map::key(size_t col, const void *value) const {
+  switch (columns_[col].type_id) {
+    case primitive_type::D_BOOL:
+      return *reinterpret_cast<const uint8_t *>(value) != 0;
+    case primitive_type::D_CHAR:
+      return signed_key<int8_t>(value);
+    case primitive_type::D_UCHAR:
+      return unsigned_key<uint8_t>(value);
+    case primitive_type::D_SHORT:
+      return signed_key<int16_t>(value);
+    case primitive_type::D_USHORT:
+      return unsigned_key<uint16_t>(value);
+    case primitive_type::D_INT:
+      return signed_key<int32_t>(value);
+    case primitive_type::D_UINT:
+      return unsigned_key<uint32_t>(value);
+    case primitive_type::D_LONG:
+      return signed_key<int64_t>(value);
+    case primitive_type::D_ULONG:
+      return unsigned_key<uint64_t>(value);
+    case primitive_type::D_FLOAT: {
+      float f;
+      memcpy(&f, value, sizeof(float));
+      return double_key(f);
+    }
+    case primitive_type::D_DOUBLE: {
+      double d;
+      memcpy(&d, value, sizeof(double));
+      return double_key(d);
+    }
+    default:
+      THROW(illegal_state_exception, "Zone maps do not track non-numeric columns");
+  }
+}
+
+void zone_map::update(uint64_t offset, const void *data, size_t nrecords, size_t record_size) {
+  size_t ncols = columns_.size();
+  if (ncols == 0)
+    return;
+
+  const uint8_t *records = reinterpret_cast<const uint8_t *>(data);
+  std::vector<uint64_t> mins(ncols), maxs(ncols);
+  size_t i = 0;
+  while (i < nrecords) {
+    // Bounds of the run of records that start in the same zone are gathered
+    // locally, and merged into the shared bounds once
+    uint64_t off = offset + i * record_size;
+    size_t zone_idx = off / ZONE_SIZE;
+    uint64_t zone_end = (zone_idx + 1) * ZONE_SIZE;
+    size_t j = std::min(nrecords, i + static_cast<size_t>((zone_end - off + record_size - 1) / record_size));
+
+    std::fill(mins.begin(), mins.end(), UINT64_MAX);
+    std::fill(maxs.begin(), maxs.end(), 0);
+    for (size_t r = i; r < j; r++) {
+      const uint8_t *rec = records + r * record_size;
+      for (size_t c = 0; c < ncols; c++) {
+        const uint8_t *value = rec + columns_[c].offset;
+        // NaNs satisfy no comparison that zone maps rule out
+        if ((columns_[c].type_id == primitive_type::D_FLOAT && std::isnan(*reinterpret_cast<const float *>(value)))
+            || (columns_[c].type_id == primitive_type::D_DOUBLE
+                && std::isnan(*reinterpret_cast<const double *>(value))))
+          continue;
+        uint64_t k = key(c, value);
+        mins[c] = std::min(mins[c], k);
+        maxs[c] = std::max(maxs[c], k);
+      }
+    }
+
+    bound_t *b = get_or_create(off / BUCKET_SIZE);
+    bound_t *bucket_bounds = b;
+    bound_t *zone_bounds = b + (1 + zone_idx % ZONES_PER_BUCKET) * ncols * 2;
+    for (size_t c = 0; c < ncols; c++) {
+      if (mins[c] > maxs[c])
+        continue;
+      lower(&bucket_bounds[2 * c], mins[c]);
+      raise(&bucket_bounds[2 * c + 1], maxs[c]);
+      lower(&zone_bounds[2 * c], mins[c]);
+      raise(&zone_bounds[2 * c + 1], maxs[c]);
+    }
+    i = j;
+  }
+}
+
+bool zone_map::bucket_bounds(size_t bucket_idx, size_t col, uint64_t &min, uint64_t &max) const {
+  return bounds(bucket_idx, 0, col, min, max);
+}
+
+bool zone_map::zone_bounds(size_t zone_idx, size_t col, uint64_t &min, uint64_t &max) const {
+  return bounds(zone_idx / ZONES_PER_BUCKET, 1 + zone_idx % ZONES_PER_BUCKET, col, min, max);
+}
+
+std::vector<uint64_t> zone_map::snapshot(size_t bucket_idx) const {
+  std::vector<uint64_t> ret;
+  bound_t *b = bucket(bucket_idx);
+  if (b == nullptr)
+    return ret;
+  size_t n = bounds_per_bucket();
+  ret.resize(n);
+  for (size_t i = 0; i < n; i++)
+    ret[i] = atomic::load(&b[i]);
+  return ret;
+}
+
+void zone_map::restore(size_t bucket_idx, const std::vector<uint64_t> &bounds) {
+  if (bounds.size() != bounds_per_bucket())
+    THROW(illegal_state_exception, "Zone map bounds do not match the schema");
+  bound_t *b = get_or_create(bucket_idx);
+  for (size_t i = 0; i < bounds.size(); i++)
+    atomic::store(&b[i], bounds[i]);
+}
+
+zone_map::bound_t *zone_map::bucket(size_t bucket_idx) const {
+  return bucket_idx < MAX_BUCKETS ? atomic::load(&buckets_[bucket_idx]) : nullptr;
+}
+
+zone_map::bound_t *zone_map::get_or_create(size_t bucket_idx) {
+  bound_t *b = atomic::load(&buckets_[bucket_idx]);
+  if (b != nullptr)
+    return b;
+
+  size_t n = bounds_per_bucket();
+  bound_t *created = new bound_t[n];
+  for (size_t i = 0; i < n; i += 2) {
+    atomic::init(&created[i], UINT64_MAX);
+    atomic::init(&created[i + 1], UINT64_C(0));
+  }
+  if (atomic::strong::cas(&buckets_[bucket_idx], &b, created))
+    return created;
+  delete[] created;
+  return b;
+}
+
+size_t zone_map::bounds_per_bucket() const {
+  return (1 + ZONES_PER_BUCKET) * columns_.size() * 2;
+}
+
+bool zone_map::bounds(size_t bucket_idx, size_t slot, size_t col, uint64_t &min, uint64_t &max) const {
+  bound_t *b = bucket(bucket_idx);
+  if (b == nullptr)
+    return false;
+  bound_t *bound = b + (slot * columns_.size() + col) * 2;
+  min = atomic::load(&bound[0]);
+  max = atomic::load(&bound[1]);
+  return true;
+}
+
+void zone_map::lower(bound_t *bound, uint64_t key) {
+  uint64_t cur = atomic::load(bound);
+  while (key < cur && !atomic::weak::cas(bound, &cur, key));
+}
+
+void zone_map::raise(bound_t *bound, uint64_t key) {
+  uint64_t cur = atomic::load(bound);
+  while (key > cur && !atomic::weak::cas(bound, &cur, key));
+}
+
+zone_filter::zone_filter(const zone_map *zones, const parser::compiled_expression &cexpr)
+    : zones_(zones),
+      active_(zones != nullptr && zones->num_columns() > 0 && !cexpr.empty()) {
+  if (!active_)
+    return;
+  for (const auto &m : cexpr) {
+    std::vector<zone_predicate> preds;
+    for (const auto &p : m) {
+      int col = zones_->column_of(p.field_idx());
+      if (col < 0 || p.op() == reational_op_id::NEQ)
+        continue;
+      preds.push_back(zone_predicate{static_cast<size_t>(col), p.op(),
+                                     zones_->key(static_cast<size_t>(col), p.value().ptr())});
+    }
+    if (preds.empty()) {
+      // A minterm with nothing to rule out may match anywhere
+      active_ = false;
+      minterms_.clear();
+      return;
+    }
+    minterms_.push_back(std::move(preds));
+  }
+}
+
+bool zone_filter::is_active() const {
+  return active_;
+}
+
+bool zone_filter::may_match_bucket(size_t bucket_idx) const {
+  return !active_ || may_match_bounds([this, bucket_idx](size_t col, uint64_t &min, uint64_t &max) {
+    return zones_->bucket_bounds(bucket_idx, col, min, max);
+  });
+}
+
+bool zone_filter::may_match_zone(size_t zone_idx) const {
+  return !active_ || may_match_bounds([this, zone_idx](size_t col, uint64_t &min, uint64_t &max) {
+    return zones_->zone_bounds(zone_idx, col, min, max);
+  });
+}
+
+bool zone_filter::may_match(uint64_t offset) const {
+  return may_match_zone(offset / zone_map::ZONE_SIZE);
+}
+
+template<typename BOUNDS>
+bool zone_filter::may_match_bounds(BOUNDS bounds) const {
+  for (const auto &m : minterms_) {
+    bool ruled_out = false;
+    for (const auto &p : m) {
+      uint64_t min, max;
+      // Without bounds nothing is known about the records
+      if (!bounds(p.col, min, max))
+        return true;
+      if (!may_satisfy(p, min, max)) {
+        ruled_out = true;
+        break;
+      }
+    }
+    if (!ruled_out)
+      return true;
+  }
+  return false;
+}
+
+bool zone_filter::may_satisfy(const zone_predicate &p, uint64_t min, uint64_t max) {
+  if (min > max)
+    return false;
+  switch (p.op) {
+    case reational_op_id::LT:
+      return min < p.key;
+    case reational_op_id::LE:
+      return min <= p.key;
+    case reational_op_id::GT:
+      return max > p.key;
+    case reational_op_id::GE:
+      return max >= p.key;
+    case reational_op_id::EQ:
+      return min <= p.key && p.key <= max;
+    default:
+      return true;
+  }
+}
+
+}
@@ -2,18 +2,30 @@
 
 namespace confluo {
 
+const uint64_t filter::ROLLUP_BLOCKS[filter::NUM_ROLLUP_LEVELS] = {
+    1000ULL, 60ULL * 1000ULL, 60ULL * 60ULL * 1000ULL, 24ULL * 60ULL * 60ULL * 1000ULL
+};
+
 filter::filter(const compiled_expression &exp, filter_fn fn)
     : exp_(exp),
       fn_(fn),
       idx_(8, 256),
-      is_valid_(true) {
+      is_valid_(true),
+      handoff_() {
+  rollups_.reserve(NUM_ROLLUP_LEVELS);
+  for (size_t i = 0; i < NUM_ROLLUP_LEVELS; i++)
+    rollups_.emplace_back(8, 256);
 }
 
 filter::filter(filter_fn fn)
     : exp_(),
       fn_(fn),
       idx_(8, 256),
-      is_valid_(true) {
+      is_valid_(true),
+      handoff_() {
+  rollups_.reserve(NUM_ROLLUP_LEVELS);
+  for (size_t i = 0; i < NUM_ROLLUP_LEVELS; i++)
+    rollups_.emplace_back(8, 256);
 }
 
 size_t filter::add_aggregate(aggregate_info *a) {
@@ -34,38 +46,58 @@ size_t filter::num_aggregates() const {
 
 void filter::update(const record_t &r) {
   if (exp_.test(r) && fn_(r)) {
-    aggregated_reflog *refs = idx_.insert(
-        byte_string(r.timestamp() / configuration_params::TIME_RESOLUTION_NS()),
-        r.log_offset(), aggregates_);
+    uint64_t ts_block = r.timestamp() / configuration_params::TIME_RESOLUTION_NS();
+    aggregated_reflog *refs = idx_.insert(byte_string(ts_block), r.log_offset(), aggregates_);
     int tid = thread_manager::get_id();
     if (tid < 0) {
       throw std::runtime_error("Thread is not registered");
     }
-    for (size_t i = 0; i < refs->num_aggregates(); i++) {
+    size_t num_aggs = refs->num_aggregates();
+    if (num_aggs == 0)
+      return;
+
+    aggregated_reflog *rollup_refs[NUM_ROLLUP_LEVELS];
+    for (size_t l = 0; l < NUM_ROLLUP_LEVELS; l++)
+      rollup_refs[l] = rollups_[l].get_or_create(byte_string(ts_block / ROLLUP_BLOCKS[l]), aggregates_);
+
+    for (size_t i = 0; i < num_aggs; i++) {
       if (aggregates_.at(i)->is_valid()) {
         size_t field_idx = aggregates_.at(i)->field_idx();
         numeric val(r[field_idx].value());
         refs->seq_update_aggregate(tid, i, val, r.version());
+        for (size_t l = 0; l < NUM_ROLLUP_LEVELS; l++)
+          if (i < rollup_refs[l]->num_aggregates())
+            rollup_refs[l]->seq_update_aggregate(tid, i, val, r.version());
       }
     }
   }
 }
 
-void filter::update(size_t log_offset, const schema_snapshot &snap, record_block &block, size_t record_size) {
-  int tid = thread_manager::get_id();
+void filter::update(size_t log_offset, const schema_snapshot &snap, record_block &block, size_t record_size,
+                    uint64_t version_floor) {
+  update(log_offset, snap, &block.data[0], block.nrecords, block.time_block, record_size, version_floor);
+}
+
+void filter::update(size_t log_offset, const schema_snapshot &snap, void *data, size_t nrecords, int64_t time_block,
+                    size_t record_size, uint64_t version_floor) {
+  update(log_offset, snap, data, nrecords, time_block, record_size, version_floor, thread_manager::get_id());
+}
+
+void filter::update(size_t log_offset, const schema_snapshot &snap, void *data, size_t nrecords, int64_t time_block,
+                    size_t record_size, uint64_t version_floor, int tid) {
   if (tid < 0) {
     throw std::runtime_error("Thread is not registered");
   }
   aggregated_reflog *refs = nullptr;
   std::vector<numeric> local_aggs;
 
-  for (size_t i = 0; i < block.nrecords; i++) {
-    void *cur_rec = reinterpret_cast<uint8_t *>(&block.data[i * record_size]);
+  for (size_t i = 0; i < nrecords; i++) {
+    void *cur_rec = reinterpret_cast<uint8_t *>(data) + i * record_size;
     uint64_t rec_off = log_offset + i * record_size;
     if (exp_.test(snap, cur_rec)) {
       if (refs == nullptr) {
         refs = idx_.get_or_create(
-            byte_string(static_cast<uint64_t>(block.time_block)),
+            byte_string(static_cast<uint64_t>(time_block)),
             aggregates_);
         local_aggs.resize(refs->num_aggregates());
       }
@@ -77,10 +109,23 @@ void filter::update(size_t log_offset, const schema_snapshot &snap, record_block
     }
   }
 
-  size_t version = log_offset + block.nrecords * record_size;
-  for (size_t j = 0; j < local_aggs.size(); j++)
-    if (aggregates_.at(j)->is_valid() && !local_aggs[j].type().is_none())
-      refs->comb_update_aggregate(tid, j, local_aggs[j], version);
+  if (local_aggs.empty())
+    return;
+
+  auto ts_block = static_cast<uint64_t>(time_block);
+  aggregated_reflog *rollup_refs[NUM_ROLLUP_LEVELS];
+  for (size_t l = 0; l < NUM_ROLLUP_LEVELS; l++)
+    rollup_refs[l] = rollups_[l].get_or_create(byte_string(ts_block / ROLLUP_BLOCKS[l]), aggregates_);
+
+  size_t version = log_offset + nrecords * record_size;
+  for (size_t j = 0; j < local_aggs.size(); j++) {
+    if (aggregates_.at(j)->is_valid() && !local_aggs[j].type().is_none()) {
+      refs->comb_update_aggregate(tid, j, local_aggs[j], version, version_floor);
+      for (size_t l = 0; l < NUM_ROLLUP_LEVELS; l++)
+        if (j < rollup_refs[l]->num_aggregates())
+          rollup_refs[l]->comb_update_aggregate(tid, j, local_aggs[j], version, version_floor);
+    }
+  }
 }
 
 aggregated_reflog *filter::lookup_unsafe(uint64_t ts_block) const {
@@ -101,6 +146,79 @@ filter::reflog_result filter::lookup_range_reflogs(uint64_t ts_block_begin, uint
                                    byte_string(ts_block_end));
 }
 
+numeric filter::get_aggregate(size_t aid, uint64_t ts_block_begin, uint64_t ts_block_end, uint64_t version) const {
+  aggregate_info *a = aggregates_.at(aid);
+  if (ts_block_begin > ts_block_end)
+    return a->zero();
+  return merge_rollups(a, aid, 0, ts_block_begin, ts_block_end, version);
+}
+
+void filter::rebuild_rollups(uint64_t version) {
+  // Recovery runs before any writers, so the first thread's slot is free to use
+  int tid = 0;
+  auto reflogs = lookup_range_reflogs(0, limits::ulong_max);
+  for (auto it = reflogs.begin(); it != reflogs.end(); ++it) {
+    aggregated_reflog &refs = *it;
+    size_t num_aggs = refs.num_aggregates();
+    if (num_aggs == 0)
+      continue;
+    uint64_t ts_block = it.key().as<uint64_t>();
+    for (size_t l = 0; l < NUM_ROLLUP_LEVELS; l++) {
+      aggregated_reflog *rollup_refs = rollups_[l].get_or_create(byte_string(ts_block / ROLLUP_BLOCKS[l]),
+                                                                aggregates_);
+      for (size_t i = 0; i < num_aggs && i < rollup_refs->num_aggregates(); i++)
+        rollup_refs->comb_update_aggregate(tid, i, refs.get_aggregate(i, limits::ulong_max), version);
+    }
+  }
+}
+
+const filter::idx_t &filter::rollup(size_t level) const {
+  return level == 0 ? idx_ : rollups_[level - 1];
+}
+
+uint64_t filter::rollup_factor(size_t level) {
+  return level == 0 ? ROLLUP_BLOCKS[0] : ROLLUP_BLOCKS[level] / ROLLUP_BLOCKS[level - 1];
+}
+
+numeric filter::merge_rollups(aggregate_info *a, size_t aid, size_t level, uint64_t begin, uint64_t end,
+                              uint64_t version) const {
+  if (level == NUM_ROLLUP_LEVELS)
+    return merge_level(a, aid, level, begin, end, version);
+
+  // Entries [parent_begin, parent_end) at the next level lie entirely in range
+  uint64_t factor = rollup_factor(level);
+  uint64_t parent_begin = begin / factor + (begin % factor != 0);
+  uint64_t parent_end = end == limits::ulong_max ? end / factor : (end + 1) / factor;
+  if (parent_begin >= parent_end)
+    return merge_level(a, aid, level, begin, end, version);
+
+  numeric agg = a->zero();
+  if (begin < parent_begin * factor)
+    agg = a->comb_op(agg, merge_level(a, aid, level, begin, parent_begin * factor - 1, version));
+  agg = a->comb_op(agg, merge_rollups(a, aid, level + 1, parent_begin, parent_end - 1, version));
+  if (parent_end * factor <= end)
+    agg = a->comb_op(agg, merge_level(a, aid, level, parent_end * factor, end, version));
+  return agg;
+}
+
+numeric filter::merge_level(aggregate_info *a, size_t aid, size_t level, uint64_t begin, uint64_t end,
+                            uint64_t version) const {
+  numeric agg = a->zero();
+  auto reflogs = rollup(level).range_lookup_reflogs(byte_string(begin), byte_string(end));
+  for (auto it = reflogs.begin(); it != reflogs.end(); ++it) {
+    const aggregated_reflog &refs = *it;
+    if (aid < refs.num_aggregates()) {
+      agg = a->comb_op(agg, refs.get_aggregate(aid, version));
+    } else if (level > 0) {
+      // Rollup entry predates the aggregate; resolve it at the finer level
+      uint64_t key = it.key().as<uint64_t>();
+      uint64_t factor = rollup_factor(level - 1);
+      agg = a->comb_op(agg, merge_level(a, aid, level - 1, key * factor, (key + 1) * factor - 1, version));
+    }
+  }
+  return agg;
+}
+
 bool filter::invalidate() {
   bool expected = true;
   return atomic::strong::cas(&is_valid_, &expected, false);
@@ -110,8 +228,16 @@ bool filter::is_valid() {
   return atomic::load(&is_valid_);
 }
 
+backfill_handoff &filter::handoff() {
+  return handoff_;
+}
+
 filter::idx_t &filter::data() {
   return idx_;
 }
 
+filter::idx_t &filter::rollup_data(size_t level) {
+  return rollups_[level];
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "parser/batch_expression.h"
+
+namespace confluo {
+namespace parser {
+
+namespace {
+
+template<typename T, typename CMP>
+void select_records(const uint8_t *field, size_t record_size, size_t n, T value, uint8_t *sel, CMP cmp) {
+  for (size_t i = 0; i < n; i++, field += record_size) {
+    T v;
+    std::memcpy(&v, field, sizeof(T));
+    sel[i] &= static_cast<uint8_t>(cmp(v, value));
+  }
+}
+
+template<typename T>
+void select_kernel(reational_op_id op, const uint8_t *field, size_t record_size, size_t n,
+                   const void *value, uint8_t *sel) {
+  T val;
+  std::memcpy(&val, value, sizeof(T));
+  switch (op) {
+    case reational_op_id::LT: {
+      select_records(field, record_size, n, val, sel, std::less<T>());
+      break;
+    }
+    case reational_op_id::LE: {
+      select_records(field, record_size, n, val, sel, std::less_equal<T>());
+      break;
+    }
+    case reational_op_id::GT: {
+      select_records(field, record_size, n, val, sel, std::greater<T>());
+      break;
+    }
+    case reational_op_id::GE: {
+      select_records(field, record_size, n, val, sel, std::greater_equal<T>());
+      break;
+    }
+    case reational_op_id::EQ: {
+      select_records(field, record_size, n, val, sel, std::equal_to<T>());
+      break;
+    }
+    case reational_op_id::NEQ: {
+      select_records(field, record_size, n, val, sel, std::not_equal_to<T>());
+      break;
+    }
+  }
+}
+
+select_kernel_t get_select_kernel(const data_type &type) {
+  switch (type.id) {
+    case primitive_type::D_BOOL: return select_kernel<bool>;
+    case primitive_type::D_CHAR: return select_kernel<int8_t>;
+    case primitive_type::D_UCHAR: return select_kernel<uint8_t>;
+    case primitive_type::D_SHORT: return select_kernel<int16_t>;
+    case primitive_type::D_USHORT: return select_kernel<uint16_t>;
+    case primitive_type::D_INT: return select_kernel<int32_t>;
+    case primitive_type::D_UINT: return select_kernel<uint32_t>;
+    case primitive_type::D_LONG: return select_kernel<int64_t>;
+    case primitive_type::D_ULONG: return select_kernel<uint64_t>;
+    case primitive_type::D_FLOAT: return select_kernel<float>;
+    case primitive_type::D_DOUBLE: return select_kernel<double>;
+    default: return nullptr;
+  }
+}
+
+}
+
+batch_predicate::batch_predicate(const compiled_predicate &p, const schema_t &schema)
+    : offset_(schema[p.field_idx()].offset()),
+      type_(schema[p.field_idx()].type()),
+      op_(p.op()),
+      val_(p.value()),
+      kernel_(get_select_kernel(type_)) {
+}
+
+void batch_predicate::select(const uint8_t *records, size_t record_size, size_t n, uint8_t *sel) const {
+  const uint8_t *field = records + offset_;
+  if (kernel_ != nullptr) {
+    kernel_(op_, field, record_size, n, val_.ptr(), sel);
+    return;
+  }
+
+  // Types without a typed kernel fall back to the type's relational operator
+  relational_op_t relop = type_.relop(op_);
+  immutable_raw_data val = val_.to_data();
+  for (size_t i = 0; i < n; i++, field += record_size) {
+    if (sel[i])
+      sel[i] = static_cast<uint8_t>(relop(immutable_raw_data(field, type_.size), val));
+  }
+}
+
+batch_expression::batch_expression(const compiled_expression &cexpr, const schema_t &schema) {
+  for (auto &m : cexpr) {
+    std::vector<batch_predicate> minterm;
+    for (auto &p : m)
+      minterm.push_back(batch_predicate(p, schema));
+    minterms_.push_back(std::move(minterm));
+  }
+}
+
+void batch_expression::evaluate(const uint8_t *records, size_t record_size, size_t n, uint8_t *sel) {
+  if (minterms_.empty()) {
+    std::memset(sel, 1, n);
+    return;
+  }
+
+  std::memset(sel, 0, n);
+  minterm_sel_.resize(n);
+  for (auto &m : minterms_) {
+    std::memset(minterm_sel_.data(), 1, n);
+    for (auto &p : m)
+      p.select(records, record_size, n, minterm_sel_.data());
+    for (size_t i = 0; i < n; i++)
+      sel[i] |= minterm_sel_[i];
+  }
+}
+
+}
+}
@@ -0,0 +1,30 @@
+#include "planner/cost_model.h"
+
+namespace confluo {
+namespace planner {
+
+cost_model::~cost_model() {
+}
+
+constexpr double linear_cost_model::DEFAULT_FETCH_COST;
+constexpr double linear_cost_model::DEFAULT_SCAN_COST;
+
+linear_cost_model::linear_cost_model(double fetch_cost, double scan_cost)
+    : fetch_cost_(fetch_cost),
+      scan_cost_(scan_cost) {
+}
+
+double linear_cost_model::lookup_cost(double offsets) const {
+  return offsets;
+}
+
+double linear_cost_model::fetch_cost(double records) const {
+  return records * fetch_cost_;
+}
+
+double linear_cost_model::scan_cost(double records) const {
+  return records * scan_cost_;
+}
+
+}
+}
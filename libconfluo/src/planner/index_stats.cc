@@ -0,0 +1,145 @@
+#include "planner/index_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace confluo {
+namespace planner {
+
+const uint64_t index_stats::SAMPLE_INTERVAL;
+const size_t index_stats::RESERVOIR_SIZE;
+const size_t index_stats::HISTOGRAM_BUCKETS;
+const size_t index_stats::MIN_SAMPLES;
+const size_t index_stats::SKETCH_REGISTERS;
+
+index_stats::index_stats()
+    : seen_(0),
+      histogram_seen_(0) {
+  for (size_t i = 0; i < SKETCH_REGISTERS; i++)
+    atomic::init(&sketch_[i], static_cast<uint8_t>(0));
+}
+
+bool index_stats::is_sampled(uint64_t record_idx) {
+  return record_idx % SAMPLE_INTERVAL == 0;
+}
+
+void index_stats::update(const byte_string &key) {
+  // The top bits of the hash pick a register, which keeps the longest run
+  // of leading zeros seen in the remaining bits
+  uint64_t h = hash(key);
+  size_t reg = static_cast<size_t>(h >> 56);
+  uint64_t rest = h << 8;
+  uint8_t rank = static_cast<uint8_t>(rest == 0 ? 57 : __builtin_clzll(rest) + 1);
+  uint8_t cur = atomic::load(&sketch_[reg]);
+  while (rank > cur && !atomic::weak::cas(&sketch_[reg], &cur, rank));
+
+  std::unique_lock<std::mutex> lock(mtx_, std::try_to_lock);
+  if (!lock.owns_lock())
+    return;
+  if (seen_ == 0 || key < min_)
+    min_ = key;
+  if (seen_ == 0 || max_ < key)
+    max_ = key;
+  seen_++;
+  if (reservoir_.size() < RESERVOIR_SIZE) {
+    reservoir_.push_back(key);
+  } else {
+    size_t j = static_cast<size_t>(rng_() % seen_);
+    if (j < RESERVOIR_SIZE)
+      reservoir_[j] = key;
+  }
+}
+
+size_t index_stats::num_samples() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return seen_;
+}
+
+utils::optional<double> index_stats::selectivity(const byte_string &begin, const byte_string &end) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (seen_ < MIN_SAMPLES)
+    return utils::optional<double>();
+  double floor = 1.0 / static_cast<double>(seen_ * SAMPLE_INTERVAL);
+  if (end < min_ || max_ < begin)
+    return utils::optional<double>(floor);
+
+  // Rebuild once the samples have grown by an eighth
+  if ((seen_ - histogram_seen_) * 8 > histogram_seen_)
+    rebuild_histogram();
+
+  // Buckets inside the range count fully, buckets it cuts through by half
+  size_t buckets = histogram_.size() - 1;
+  double matched = 0.0;
+  double full = 0.0;
+  for (size_t i = 0; i < buckets; i++) {
+    const byte_string &lo = histogram_[i];
+    const byte_string &hi = histogram_[i + 1];
+    if (hi < begin || end < lo)
+      continue;
+    if (begin <= lo && hi <= end) {
+      matched += 1.0;
+      full += 1.0;
+    } else {
+      matched += 0.5;
+    }
+  }
+
+  // A single key that fills no bucket is assumed to be as frequent as an
+  // average key
+  if (begin == end && full == 0.0)
+    return utils::optional<double>(std::max(floor, 1.0 / std::max(1.0, distinct_count())));
+  return utils::optional<double>(std::max(floor, matched / buckets));
+}
+
+double index_stats::distinct_count() const {
+  const double m = static_cast<double>(SKETCH_REGISTERS);
+  double sum = 0.0;
+  size_t zeros = 0;
+  for (size_t i = 0; i < SKETCH_REGISTERS; i++) {
+    uint8_t r = atomic::load(&sketch_[i]);
+    sum += std::ldexp(1.0, -static_cast<int>(r));
+    zeros += (r == 0);
+  }
+  double estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0)
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  return estimate;
+}
+
+byte_string index_stats::min() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return min_;
+}
+
+byte_string index_stats::max() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return max_;
+}
+
+void index_stats::rebuild_histogram() {
+  std::vector<byte_string> sorted(reservoir_);
+  std::sort(sorted.begin(), sorted.end());
+  size_t buckets = std::min(HISTOGRAM_BUCKETS, sorted.size() - 1);
+  histogram_.clear();
+  for (size_t k = 0; k <= buckets; k++)
+    histogram_.push_back(sorted[k * (sorted.size() - 1) / buckets]);
+  histogram_seen_ = seen_;
+}
+
+uint64_t index_stats::hash(const byte_string &key) {
+  // FNV-1a, followed by a finalizer to spread the bits
+  uint64_t h = UINT64_C(14695981039346656037);
+  for (size_t i = 0; i < key.size(); i++) {
+    h ^= key[i];
+    h *= UINT64_C(1099511628211);
+  }
+  h ^= h >> 33;
+  h *= UINT64_C(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  h *= UINT64_C(0xc4ceb9fe1a85ec53);
+  h ^= h >> 33;
+  return h;
+}
+
+}
+}
@@ -1,5 +1,7 @@
 #include "planner/query_ops.h"
 
+#include <algorithm>
+
 namespace confluo {
 namespace planner {
 
@@ -68,5 +70,51 @@ index::radix_index::rt_result index_op::query_index() {
   return index_->range_lookup(range_.first, range_.second);
 }
 
+intersect_op::intersect_op(const std::vector<std::shared_ptr<index_op>> &ops, uint64_t estimate)
+    : query_op(query_op_type::D_INTERSECT_OP),
+      ops_(ops),
+      estimate_(estimate) {
+}
+
+std::string intersect_op::to_string() const {
+  std::string ret = "intersect(";
+  for (size_t i = 0; i < ops_.size(); i++) {
+    ret += (i == 0 ? "" : ", ") + ops_[i]->to_string();
+  }
+  return ret + ") estimate=" + std::to_string(estimate_);
+}
+
+uint64_t intersect_op::cost() const {
+  return estimate_;
+}
+
+std::vector<uint64_t> intersect_op::query_offsets(uint64_t version) {
+  std::vector<uint64_t> offsets;
+  for (uint64_t o : ops_[0]->query_index()) {
+    if (o < version)
+      offsets.push_back(o);
+  }
+  std::sort(offsets.begin(), offsets.end());
+  offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+
+  // An offset survives the i-th operation if it survived all earlier ones
+  std::vector<uint32_t> marks(offsets.size(), 0);
+  for (uint32_t i = 1; i < ops_.size() && !offsets.empty(); i++) {
+    for (uint64_t o : ops_[i]->query_index()) {
+      auto it = std::lower_bound(offsets.begin(), offsets.end(), o);
+      if (it != offsets.end() && *it == o && marks[it - offsets.begin()] == i - 1)
+        marks[it - offsets.begin()] = i;
+    }
+  }
+
+  size_t n = 0;
+  for (size_t j = 0; j < offsets.size(); j++) {
+    if (marks[j] == ops_.size() - 1)
+      offsets[n++] = offsets[j];
+  }
+  offsets.resize(n);
+  return offsets;
+}
+
 }
 }
\ No newline at end of file
@@ -1,13 +1,17 @@
 #include "planner/query_plan.h"
 
+#include <algorithm>
+
 namespace confluo {
 namespace planner {
 
-query_plan::query_plan(const data_log *dlog, const schema_t *schema, const parser::compiled_expression &expr)
+query_plan::query_plan(const data_log *dlog, const schema_t *schema, const parser::compiled_expression &expr,
+                       const zone_map *zones)
     : std::vector<std::shared_ptr<query_op>>(),
       dlog_(dlog),
       schema_(schema),
-      expr_(expr) {}
+      expr_(expr),
+      zones_(zones) {}
 
 std::string query_plan::to_string() {
   if (!is_optimized()) {
@@ -30,25 +34,42 @@ std::unique_ptr<record_cursor> query_plan::execute(uint64_t version) {
 }
 
 numeric query_plan::aggregate(uint64_t version, uint16_t field_idx, const aggregator &agg) {
+  std::unique_ptr<streaming_aggregate> sagg = streaming_aggregate::create(agg, (*schema_)[field_idx]);
+  if (sagg != nullptr) {
+    if (is_optimized()) {
+      aggregate_using_indexes(version, *sagg);
+    } else {
+      aggregate_using_full_scan(version, *sagg);
+    }
+    return sagg->result();
+  }
+
   std::unique_ptr<record_cursor> cursor = execute(version);
   numeric accum = agg.zero;
   while (cursor->has_more()) {
     accum = agg.seq_op(accum, numeric(cursor->get()[field_idx].value()));
+    cursor->advance();
   }
   return accum;
 }
 
 std::unique_ptr<record_cursor> query_plan::using_full_scan(uint64_t version) {
-  std::unique_ptr<offset_cursor> o_cursor(new data_log_cursor(version, schema_->record_size()));
-  return std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o_cursor), dlog_, schema_, expr_));
+  return std::unique_ptr<record_cursor>(new block_scan_record_cursor(version, dlog_, schema_, expr_, 64,
+                                                                     block_scan_record_cursor::DEFAULT_BLOCK_SIZE,
+                                                                     zones_));
 }
 
 std::unique_ptr<record_cursor> query_plan::using_indexes(uint64_t version) {
+  if (has_intersection()) {
+    std::unique_ptr<offset_cursor> o(new offset_list_cursor(index_offsets(version)));
+    return std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o), dlog_, schema_, expr_, 64, zones_));
+  }
   if (size() == 1) {
     index::radix_index::rt_result ret = std::dynamic_pointer_cast<index_op>(at(0))->query_index();
     std::unique_ptr<offset_cursor>
         o_cursor(new offset_iterator_cursor<index::radix_index::rt_result::iterator>(ret.begin(), ret.end(), version));
-    return std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o_cursor), dlog_, schema_, expr_));
+    return std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o_cursor), dlog_, schema_, expr_, 64,
+                                                                   zones_));
   }
   std::vector<index::radix_index::rt_result> res;
   for (size_t i = 0; i < size(); i++) {
@@ -57,8 +78,85 @@ std::unique_ptr<record_cursor> query_plan::using_indexes(uint64_t version) {
   flattened_container<std::vector<index::radix_index::rt_result>> c(res);
   typedef flattened_container<std::vector<index::radix_index::rt_result>>::iterator iterator_t;
   std::unique_ptr<offset_cursor> o(new offset_iterator_cursor<iterator_t>(c.begin(), c.end(), version));
-  return make_distinct(std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o), dlog_, schema_, expr_)));
+  return make_distinct(std::unique_ptr<record_cursor>(new filter_record_cursor(std::move(o), dlog_, schema_, expr_,
+                                                                                64, zones_)));
 }
 
+void query_plan::aggregate_using_full_scan(uint64_t version, streaming_aggregate &sagg) {
+  record_block_scanner scanner(version, dlog_, schema_, expr_, record_block_scanner::DEFAULT_BLOCK_SIZE, zones_);
+  size_t n;
+  while ((n = scanner.next_block()) != 0) {
+    sagg.update_block(scanner.block_data(), scanner.record_size(), n, scanner.selection());
+  }
+}
+
+void query_plan::aggregate_using_indexes(uint64_t version, streaming_aggregate &sagg) {
+  schema_snapshot snap = schema_->snapshot();
+  size_t record_size = schema_->record_size();
+  zone_filter zones(zones_, expr_);
+  // Records are read without pinning the data log; they are not kept
+  std::vector<uint8_t> rec(record_size);
+  auto update = [&](uint64_t o) {
+    if (!zones.may_match(o))
+      return;
+    dlog_->read(o, rec.data(), record_size);
+    if (expr_.test(snap, rec.data()))
+      sagg.update(rec.data());
+  };
+
+  if (has_intersection()) {
+    for (uint64_t o : index_offsets(version))
+      update(o);
+    return;
+  }
+
+  if (size() == 1) {
+    for (uint64_t o : std::dynamic_pointer_cast<index_op>(at(0))->query_index()) {
+      if (o < version)
+        update(o);
+    }
+    return;
+  }
+
+  std::vector<index::radix_index::rt_result> res;
+  for (size_t i = 0; i < size(); i++) {
+    res.push_back(std::dynamic_pointer_cast<index_op>(at(i))->query_index());
+  }
+  flattened_container<std::vector<index::radix_index::rt_result>> c(res);
+  std::unordered_set<uint64_t> seen;
+  for (uint64_t o : c) {
+    if (o < version && seen.insert(o).second)
+      update(o);
+  }
+}
+
+bool query_plan::has_intersection() {
+  for (auto &op : *this) {
+    if (op->op_type() == query_op_type::D_INTERSECT_OP)
+      return true;
+  }
+  return false;
+}
+
+std::vector<uint64_t> query_plan::index_offsets(uint64_t version) {
+  std::vector<uint64_t> offsets;
+  for (auto &op : *this) {
+    if (op->op_type() == query_op_type::D_INTERSECT_OP) {
+      std::vector<uint64_t> op_offsets = std::dynamic_pointer_cast<intersect_op>(op)->query_offsets(version);
+      offsets.insert(offsets.end(), op_offsets.begin(), op_offsets.end());
+    } else {
+      for (uint64_t o : std::dynamic_pointer_cast<index_op>(op)->query_index()) {
+        if (o < version)
+          offsets.push_back(o);
+      }
+    }
+  }
+  if (size() > 1 || at(0)->op_type() != query_op_type::D_INTERSECT_OP) {
+    std::sort(offsets.begin(), offsets.end());
+    offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+  }
+  return offsets;
+}
+
+}
 }
-}
\ No newline at end of file
@@ -1,18 +1,35 @@
 #include "planner/query_planner.h"
 
+#include <algorithm>
+
 namespace confluo {
 namespace planner {
 
-query_planner::query_planner(const data_log *dlog, const index_log *idx_list, const schema_t *schema)
+query_planner::query_planner(const data_log *dlog,
+                             const index_log *idx_list,
+                             const schema_t *schema,
+                             const index_stats_log *stats,
+                             const zone_map *zones)
     : dlog_(dlog),
       idx_list_(idx_list),
-      schema_(schema) {
+      schema_(schema),
+      stats_(stats),
+      zones_(zones),
+      cost_model_(std::make_shared<linear_cost_model>()) {
+}
+
+void query_planner::set_cost_model(std::shared_ptr<cost_model> model) {
+  std::atomic_store(&cost_model_, model);
 }
 
 query_plan query_planner::plan(const parser::compiled_expression &expr) const {
-  query_plan qp(dlog_, schema_, expr);
+  query_plan qp(dlog_, schema_, expr, zones_);
+  std::shared_ptr<cost_model> model = std::atomic_load(&cost_model_);
+  double num_records = static_cast<double>(dlog_->size() / schema_->record_size());
+  double index_cost = 0.0;
   for (const parser::compiled_minterm &m : expr) {
-    std::shared_ptr<query_op> op = optimize_minterm(m);
+    double cost = 0.0;
+    std::shared_ptr<query_op> op = optimize_minterm(m, num_records, *model, cost);
     switch (op->op_type()) {
       case query_op_type::D_NO_OP: {
         break;
@@ -22,8 +39,10 @@ query_plan query_planner::plan(const parser::compiled_expression &expr) const {
         qp.push_back(std::make_shared<full_scan_op>());
         return qp;
       }
-      case query_op_type::D_INDEX_OP: {
+      case query_op_type::D_INDEX_OP:
+      case query_op_type::D_INTERSECT_OP: {
         qp.push_back(op);
+        index_cost += cost;
         break;
       }
       default: {
@@ -31,6 +50,12 @@ query_plan query_planner::plan(const parser::compiled_expression &expr) const {
       }
     }
   }
+
+  // Indexes only pay off if reading their matches costs less than a scan
+  if (!qp.empty() && index_cost >= model->scan_cost(num_records)) {
+    qp.clear();
+    qp.push_back(std::make_shared<full_scan_op>());
+  }
   return qp;
 }
 
@@ -57,18 +82,36 @@ bool query_planner::add_range(query_planner::key_range_map &ranges,
   return false;  // Invalid key-range
 }
 
-std::shared_ptr<query_op> query_planner::optimize_minterm(const parser::compiled_minterm &m) const {
+double query_planner::estimate_count(uint32_t index_id, const key_range &r, double num_records) const {
+  if (stats_ != nullptr) {
+    utils::optional<double> selectivity = stats_->at(index_id)->selectivity(r.first, r.second);
+    if (selectivity.has_value())
+      return selectivity.value() * num_records;
+  }
+  // For a hash index, the count covers every key sharing the hashed key,
+  // all of which must be read to verify the match
+  return static_cast<double>(idx_list_->at(index_id)->approx_count(r.first, r.second));
+}
+
+std::shared_ptr<query_op> query_planner::optimize_minterm(const parser::compiled_minterm &m,
+                                                          double num_records,
+                                                          const cost_model &model,
+                                                          double &cost) const {
   // Get valid, condensed key-ranges for indexed attributes
   key_range_map m_key_ranges;
   for (const auto &p : m) {
     uint32_t idx = p.field_idx();
     const auto &col = (*schema_)[idx];
     if (col.is_indexed() && p.op() != reational_op_id::NEQ) {
+      // Hashed keys carry no order; ranges on hash indexes are left to other
+      // indexes or the full scan
+      if (col.index_type() == HASH_INDEX && p.op() != reational_op_id::EQ)
+        continue;
       double bucket_size = col.index_bucket_size();
       key_range r;
       switch (p.op()) {
         case reational_op_id::EQ: {
-          r = std::make_pair(p.value().to_key(bucket_size), p.value().to_key(bucket_size));
+          r = std::make_pair(col.index_key(p.value()), col.index_key(p.value()));
           break;
         }
         case reational_op_id::GE: {
@@ -103,20 +146,34 @@ std::shared_ptr<query_op> query_planner::optimize_minterm(const parser::compiled
   }
 
   // If we've reached here, we only have non-zero valid, indexed key-ranges.
-  // Now we only need to return the minimum cost index lookup
-  uint32_t min_id;
-  size_t min_cost = UINT64_MAX;
+  // Order the index lookups by their estimated number of offsets
+  std::vector<std::pair<double, uint32_t>> counts;
   for (const auto &m_entry : m_key_ranges) {
-    size_t cost;
-    // TODO: Make the cost function pluggable
-    if ((cost = idx_list_->at(m_entry.first)->approx_count(
-        m_entry.second.first, m_entry.second.second)) < min_cost) {
-      min_cost = cost;
-      min_id = m_entry.first;
+    counts.push_back(std::make_pair(estimate_count(m_entry.first, m_entry.second, num_records), m_entry.first));
+  }
+  std::sort(counts.begin(), counts.end());
+
+  // Intersect the cheapest lookup with each other lookup whose offsets are
+  // cheaper to read than the records it is expected to rule out, assuming
+  // predicates on different indexes are independent
+  std::vector<std::shared_ptr<index_op>> ops;
+  ops.push_back(std::make_shared<index_op>(idx_list_->at(counts[0].second), m_key_ranges[counts[0].second]));
+  double offsets = counts[0].first;
+  double estimate = counts[0].first;
+  for (size_t i = 1; i < counts.size() && num_records > 0; i++) {
+    double remaining = estimate * std::min(1.0, counts[i].first / num_records);
+    if (model.lookup_cost(counts[i].first) < model.fetch_cost(estimate - remaining)) {
+      ops.push_back(std::make_shared<index_op>(idx_list_->at(counts[i].second), m_key_ranges[counts[i].second]));
+      offsets += counts[i].first;
+      estimate = remaining;
     }
   }
 
-  return std::make_shared<index_op>(idx_list_->at(min_id), m_key_ranges[min_id]);
+  cost = model.lookup_cost(offsets) + model.fetch_cost(estimate);
+  if (ops.size() == 1) {
+    return ops[0];
+  }
+  return std::make_shared<intersect_op>(ops, static_cast<uint64_t>(estimate));
 }
 
 }
@@ -0,0 +1,148 @@
+#include "planner/streaming_aggregate.h"
+
+namespace confluo {
+namespace planner {
+
+namespace {
+
+/**
+ * Sum accumulator; values are promoted to double, as with sum_agg
+ */
+template<typename T>
+struct sum_accumulator {
+  void update(T v) {
+    sum_ += static_cast<double>(v);
+  }
+
+  numeric result(const numeric &zero) const {
+    return zero + numeric(sum_);
+  }
+
+  double sum_ = 0.0;
+};
+
+/**
+ * Min accumulator; yields the zero value if no records were added
+ */
+template<typename T>
+struct min_accumulator {
+  void update(T v) {
+    min_ = (valid_ && min_ < v) ? min_ : v;
+    valid_ = true;
+  }
+
+  numeric result(const numeric &zero) const {
+    return valid_ ? numeric(min_) : zero;
+  }
+
+  T min_ = T();
+  bool valid_ = false;
+};
+
+/**
+ * Max accumulator; yields the zero value if no records were added
+ */
+template<typename T>
+struct max_accumulator {
+  void update(T v) {
+    max_ = (valid_ && !(max_ < v)) ? max_ : v;
+    valid_ = true;
+  }
+
+  numeric result(const numeric &zero) const {
+    return valid_ ? numeric(max_) : zero;
+  }
+
+  T max_ = T();
+  bool valid_ = false;
+};
+
+/**
+ * Count accumulator
+ */
+template<typename T>
+struct count_accumulator {
+  void update(T) {
+    count_++;
+  }
+
+  numeric result(const numeric &zero) const {
+    return zero + numeric(count_);
+  }
+
+  uint64_t count_ = 0;
+};
+
+template<typename T, template<typename> class ACCUMULATOR>
+class native_aggregate : public streaming_aggregate {
+ public:
+  native_aggregate(const numeric &zero, size_t field_offset)
+      : zero_(zero),
+        field_offset_(field_offset) {
+  }
+
+  void update(const uint8_t *record) override {
+    acc_.update(field(record + field_offset_));
+  }
+
+  void update_block(const uint8_t *records, size_t record_size, size_t n, const uint8_t *sel) override {
+    const uint8_t *f = records + field_offset_;
+    for (size_t i = 0; i < n; i++, f += record_size) {
+      if (sel[i])
+        acc_.update(field(f));
+    }
+  }
+
+  numeric result() const override {
+    return acc_.result(zero_);
+  }
+
+ private:
+  static T field(const uint8_t *f) {
+    T v;
+    std::memcpy(&v, f, sizeof(T));
+    return v;
+  }
+
+  numeric zero_;
+  size_t field_offset_;
+  ACCUMULATOR<T> acc_;
+};
+
+template<template<typename> class ACCUMULATOR>
+streaming_aggregate *create_native_aggregate(const numeric &zero, const column_t &col) {
+  size_t off = col.offset();
+  switch (col.type().id) {
+    case primitive_type::D_BOOL: return new native_aggregate<bool, ACCUMULATOR>(zero, off);
+    case primitive_type::D_CHAR: return new native_aggregate<int8_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_UCHAR: return new native_aggregate<uint8_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_SHORT: return new native_aggregate<int16_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_USHORT: return new native_aggregate<uint16_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_INT: return new native_aggregate<int32_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_UINT: return new native_aggregate<uint32_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_LONG: return new native_aggregate<int64_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_ULONG: return new native_aggregate<uint64_t, ACCUMULATOR>(zero, off);
+    case primitive_type::D_FLOAT: return new native_aggregate<float, ACCUMULATOR>(zero, off);
+    case primitive_type::D_DOUBLE: return new native_aggregate<double, ACCUMULATOR>(zero, off);
+    default: return nullptr;
+  }
+}
+
+}
+
+std::unique_ptr<streaming_aggregate> streaming_aggregate::create(const aggregator &agg, const column_t &col) {
+  streaming_aggregate *sagg = nullptr;
+  if (agg.seq_op == sum_agg) {
+    sagg = create_native_aggregate<sum_accumulator>(agg.zero, col);
+  } else if (agg.seq_op == min_agg) {
+    sagg = create_native_aggregate<min_accumulator>(agg.zero, col);
+  } else if (agg.seq_op == max_agg) {
+    sagg = create_native_aggregate<max_accumulator>(agg.zero, col);
+  } else if (agg.seq_op == count_agg) {
+    sagg = create_native_aggregate<count_accumulator>(agg.zero, col);
+  }
+  return std::unique_ptr<streaming_aggregate>(sagg);
+}
+
+}
+}
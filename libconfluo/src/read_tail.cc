@@ -3,7 +3,45 @@
 
 namespace confluo {
 
-read_tail::read_tail() {
+const size_t completion_ring::RING_BITS;
+const size_t completion_ring::RING_SIZE;
+const uint64_t completion_ring::EMPTY;
+const uint64_t completion_ring::BUSY;
+
+completion_ring::completion_ring() {
+  for (auto &s : slots_) {
+    atomic::init(&s.start, EMPTY);
+    atomic::init(&s.end, static_cast<uint64_t>(0));
+  }
+}
+
+bool completion_ring::publish(uint64_t start, uint64_t end) {
+  slot &s = slot_for(start);
+  uint64_t expected = EMPTY;
+  if (!atomic::strong::cas(&s.start, &expected, BUSY))
+    return false;
+  atomic::store(&s.end, end);
+  atomic::store(&s.start, start + 1);
+  return true;
+}
+
+bool completion_ring::consume(uint64_t start, uint64_t &end) {
+  slot &s = slot_for(start);
+  uint64_t expected = start + 1;
+  if (atomic::load(&s.start) != expected)
+    return false;
+  end = atomic::load(&s.end);
+  return atomic::strong::cas(&s.start, &expected, EMPTY);
+}
+
+completion_ring::slot &completion_ring::slot_for(uint64_t start) {
+  // Fibonacci hashing spreads consecutive record offsets across the ring
+  return slots_[(start * 11400714819323198485ULL) >> (64 - RING_BITS)];
+}
+
+read_tail::read_tail()
+    : completions_(std::make_shared<completion_ring>()),
+      flushed_tail_(std::make_shared<atomic::type<uint64_t>>(0)) {
   read_tail_ = nullptr;
   mode_ = storage::IN_MEMORY;
 }
@@ -14,6 +52,7 @@ read_tail::read_tail(const std::string &data_path, const storage::storage_mode &
 
 void read_tail::init(const std::string &data_path, const storage::storage_mode &mode, bool load) {
   mode_ = mode;
+  completions_ = std::make_shared<completion_ring>();
   auto path = data_path + "/read_tail";
   uint64_t value = 0;
   if (load) {
@@ -23,6 +62,7 @@ void read_tail::init(const std::string &data_path, const storage::storage_mode &
   auto storage_func = storage::storage_mode_functions::STORAGE_FNS()[mode_];
   read_tail_ = (atomic::type<uint64_t> *) storage_func.allocate(path, sizeof(uint64_t));
   atomic::store(read_tail_, value);
+  flushed_tail_ = std::make_shared<atomic::type<uint64_t>>(value);
 }
 
 uint64_t read_tail::get() const {
@@ -30,12 +70,50 @@ uint64_t read_tail::get() const {
 }
 
 void read_tail::advance(uint64_t old_tail, uint32_t bytes) {
-  uint64_t expected = old_tail;
-  while (!atomic::weak::cas(read_tail_, &expected, old_tail + bytes)) {
-    expected = old_tail;
-    std::this_thread::yield();
+  uint64_t new_tail = old_tail + bytes;
+  if (atomic::load(read_tail_) != old_tail) {
+    if (!completions_->publish(old_tail, new_tail)) {
+      // Slot is held by another pending range; fall back to waiting our turn
+      while (atomic::load(read_tail_) != old_tail)
+        std::this_thread::yield();
+    } else {
+      // The tail may have reached us before our completion was visible; if so,
+      // whoever removes the completion from the ring advances the tail
+      atomic::fence();
+      uint64_t end;
+      if (atomic::load(read_tail_) != old_tail || !completions_->consume(old_tail, end)) {
+        // Another writer commits our range with its group; the record must
+        // be readable and flushed by the time append returns its offset
+        while (atomic::load(flushed_tail_.get()) < new_tail)
+          std::this_thread::yield();
+        return;
+      }
+    }
+  }
+  commit_group(new_tail);
+}
+
+void read_tail::commit_group(uint64_t tail) {
+  uint64_t end;
+  while (true) {
+    while (completions_->consume(tail, end))
+      tail = end;
+    atomic::store(read_tail_, tail);
+    storage::storage_mode_functions::STORAGE_FNS()[mode_].flush(read_tail_, sizeof(uint64_t));
+    publish_flushed(tail);
+
+    // A writer may have published at the new tail after we last checked
+    atomic::fence();
+    if (!completions_->consume(tail, end))
+      return;
+    tail = end;
   }
-  storage::storage_mode_functions::STORAGE_FNS()[mode_].flush(read_tail_, sizeof(uint64_t));
 }
 
-}
\ No newline at end of file
+void read_tail::publish_flushed(uint64_t tail) {
+  // Groups may finish flushing out of order
+  uint64_t cur = atomic::load(flushed_tail_.get());
+  while (cur < tail && !atomic::weak::cas(flushed_tail_.get(), &cur, tail));
+}
+
+}
@@ -55,6 +55,21 @@ double column_t::index_bucket_size() const {
   return idx_state_.bucket_size();
 }
 
+index_type_t column_t::index_type() const {
+  return idx_state_.type();
+}
+
+byte_string column_t::index_key(const immutable_value &value) const {
+  byte_string key = value.to_key(index_bucket_size());
+  return index_type() == HASH_INDEX ? hash_key(key) : key;
+}
+
+std::pair<byte_string, byte_string> column_t::index_key_range() const {
+  if (index_type() == HASH_INDEX)
+    return std::make_pair(byte_string(UINT64_C(0)), byte_string(UINT64_MAX));
+  return std::make_pair(min().to_key(index_bucket_size()), max().to_key(index_bucket_size()));
+}
+
 bool column_t::is_indexed() const {
   return idx_state_.is_indexed();
 }
@@ -63,8 +78,16 @@ bool column_t::set_indexing() {
   return idx_state_.set_indexing();
 }
 
-void column_t::set_indexed(uint16_t index_id, double bucket_size) {
-  idx_state_.set_indexed(index_id, bucket_size);
+void column_t::set_backfilling(uint16_t index_id, double bucket_size, index_type_t type) {
+  idx_state_.set_backfilling(index_id, bucket_size, type);
+}
+
+backfill_handoff &column_t::index_handoff() {
+  return idx_state_.handoff();
+}
+
+void column_t::set_indexed(uint16_t index_id, double bucket_size, index_type_t type) {
+  idx_state_.set_indexed(index_id, bucket_size, type);
 }
 
 void column_t::set_unindexed() {
@@ -82,6 +105,8 @@ field_t column_t::apply(void *data) const {
 }
 
 column_snapshot column_t::snapshot() const {
-  return {type_, offset_, is_indexed(), index_id(), index_bucket_size()};
+  uint8_t state = idx_state_.state();
+  return {type_, offset_, state == index_state_t::INDEXED, state == index_state_t::INDEXING, index_id(),
+          index_bucket_size(), index_type()};
 }
 }
\ No newline at end of file
@@ -9,12 +9,16 @@ const uint8_t index_state_t::INDEXED;
 index_state_t::index_state_t()
     : state_(UNINDEXED),
       id_(UINT16_MAX),
-      bucket_size_(1) {}
+      bucket_size_(1),
+      type_(RADIX_INDEX),
+      handoff_(backfill_handoff::UNPUBLISHED) {}
 
 index_state_t::index_state_t(const index_state_t &other)
     : state_(atomic::load(&other.state_)),
       id_(other.id_),
-      bucket_size_(other.bucket_size_) {}
+      bucket_size_(other.bucket_size_),
+      type_(other.type_),
+      handoff_(other.handoff_) {}
 
 uint16_t index_state_t::id() const {
   return id_;
@@ -24,12 +28,26 @@ double index_state_t::bucket_size() const {
   return bucket_size_;
 }
 
+index_type_t index_state_t::type() const {
+  return type_;
+}
+
 index_state_t &index_state_t::operator=(const index_state_t &other) {
   atomic::init(&state_, atomic::load(&other.state_));
   id_ = other.id_;
+  type_ = other.type_;
+  handoff_ = other.handoff_;
   return *this;
 }
 
+uint8_t index_state_t::state() const {
+  return atomic::load(&state_);
+}
+
+backfill_handoff &index_state_t::handoff() {
+  return handoff_;
+}
+
 bool index_state_t::is_indexed() const {
   return atomic::load(&state_) == INDEXED;
 }
@@ -39,19 +57,31 @@ bool index_state_t::set_indexing() {
   return atomic::strong::cas(&state_, &expected, INDEXING);
 }
 
-void index_state_t::set_indexed(uint16_t index_id, double bucket_size) {
+void index_state_t::set_backfilling(uint16_t index_id, double bucket_size, index_type_t type) {
+  id_ = index_id;
+  bucket_size_ = bucket_size;
+  type_ = type;
+  handoff_.publish();
+}
+
+void index_state_t::set_indexed(uint16_t index_id, double bucket_size, index_type_t type) {
   id_ = index_id;
   bucket_size_ = bucket_size;
+  type_ = type;
   atomic::store(&state_, INDEXED);
 }
 
 void index_state_t::set_unindexed() {
   atomic::store(&state_, UNINDEXED);
+  handoff_.reset();
 }
 
 bool index_state_t::disable_indexing() {
   uint8_t expected = INDEXED;
-  return atomic::strong::cas(&state_, &expected, UNINDEXED);
+  if (!atomic::strong::cas(&state_, &expected, UNINDEXED))
+    return false;
+  handoff_.reset();
+  return true;
 }
 
 }
\ No newline at end of file
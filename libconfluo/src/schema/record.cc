@@ -24,12 +24,27 @@ record_t::record_t(size_t log_offset, storage::read_only_encoded_ptr<uint8_t> da
     : timestamp_(0),
       log_offset_(log_offset),
       data_(nullptr),
-      ptr_(data),
+      ptr_(std::move(data)),
       size_(size),
       version_(log_offset + size) {
-  storage::decoded_ptr<uint8_t> ptr = data.decode();
+  storage::decoded_ptr<uint8_t> ptr = ptr_.decode_ptr(0, size);
   timestamp_ = *reinterpret_cast<int64_t *>(ptr.get());
   data_ = ptr.get();
+  if (ptr_.is_encoded()) {
+    // Keep the decoded copy alive for as long as the record
+    auto deleter = ptr.get_deleter();
+    decoded_ = std::shared_ptr<uint8_t>(ptr.release(), deleter);
+  }
+}
+
+record_t::record_t(size_t log_offset, std::shared_ptr<uint8_t> data, size_t size)
+    : timestamp_(*reinterpret_cast<int64_t *>(data.get())),
+      log_offset_(log_offset),
+      data_(data.get()),
+      ptr_(),
+      decoded_(std::move(data)),
+      size_(size),
+      version_(log_offset + size) {
 }
 
 void record_t::reserve(size_t n) {
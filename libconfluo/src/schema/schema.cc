@@ -60,6 +60,14 @@ record_t schema_t::apply(size_t offset, storage::read_only_encoded_ptr<uint8_t>
   return r;
 }
 
+record_t schema_t::apply(size_t offset, std::shared_ptr<uint8_t> data) const {
+  record_t r(offset, std::move(data), record_size_);
+  r.reserve(columns_.size());
+  for (const auto &column : columns_)
+    r.push_back(column.apply(r.data()));
+  return r;
+}
+
 record_t schema_t::apply_unsafe(size_t offset, void *data) const {
   record_t r(offset, reinterpret_cast<uint8_t *>(data), record_size_);
   r.reserve(columns_.size());
@@ -76,6 +84,13 @@ schema_snapshot schema_t::snapshot() const {
   return snap;
 }
 
+void schema_t::snapshot(schema_snapshot &snap) const {
+  snap.clear();
+  for (const column_t &col : columns_) {
+    snap.add_column(col.snapshot());
+  }
+}
+
 std::vector<column_t> &schema_t::columns() {
   return columns_;
 }
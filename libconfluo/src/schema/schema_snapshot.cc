@@ -10,6 +10,10 @@ void schema_snapshot::add_column(column_snapshot &&snap) {
   snapshot_.push_back(std::move(snap));
 }
 
+void schema_snapshot::clear() {
+  snapshot_.clear();
+}
+
 immutable_value schema_snapshot::get(void *data, uint32_t i) const {
   return immutable_value(snapshot_[i].type, reinterpret_cast<uint8_t *>(data) + snapshot_[i].offset);
 }
@@ -20,9 +24,10 @@ byte_string schema_snapshot::time_key(int64_t time_block) const {
 }
 
 byte_string schema_snapshot::get_key(void *ptr, uint32_t i) const {
-  return snapshot_[i].type.key_transform()(
+  byte_string key = snapshot_[i].type.key_transform()(
       immutable_raw_data(reinterpret_cast<uint8_t *>(ptr) + snapshot_[i].offset, snapshot_[i].type.size),
       snapshot_[i].index_bucket_size);
+  return snapshot_[i].index_type == HASH_INDEX ? hash_key(key) : key;
 }
 
 int64_t schema_snapshot::get_timestamp(void *ptr) const {
@@ -33,6 +38,14 @@ bool schema_snapshot::is_indexed(size_t i) const {
   return snapshot_[i].indexed;
 }
 
+bool schema_snapshot::is_indexing(size_t i) const {
+  return snapshot_[i].indexing;
+}
+
+index_type_t schema_snapshot::index_type(size_t i) const {
+  return snapshot_[i].index_type;
+}
+
 uint32_t schema_snapshot::index_id(size_t i) const {
   return snapshot_[i].index_id;
 }
@@ -0,0 +1,119 @@
+#include "storage/epoch_manager.h"
+
+namespace confluo {
+namespace storage {
+
+const size_t epoch_manager::NUM_SLOTS;
+
+// Nesting depth and entered epoch of the calling thread
+static thread_local size_t epoch_depth = 0;
+static thread_local uint64_t entered_epoch = 0;
+
+epoch_manager::guard::guard() {
+  epoch_manager::instance().enter();
+}
+
+epoch_manager::guard::~guard() {
+  epoch_manager::instance().leave();
+}
+
+epoch_manager &epoch_manager::instance() {
+  static epoch_manager manager;
+  return manager;
+}
+
+epoch_manager::epoch_manager()
+    : epoch_(0) {
+  for (size_t i = 0; i < NUM_SLOTS; i++) {
+    atomic::init(&slots_[i].readers[0], INT64_C(0));
+    atomic::init(&slots_[i].readers[1], INT64_C(0));
+  }
+}
+
+void epoch_manager::enter() {
+  if (epoch_depth++ > 0)
+    return;
+  slot &s = slots_[thread_slot()];
+  while (true) {
+    uint64_t epoch = atomic::load(&epoch_);
+    atomic::faa(&s.readers[epoch & 1], INT64_C(1));
+    atomic::fence();
+    // Only counts if the epoch did not move in between; otherwise the
+    // advance may already have checked this epoch's readers
+    if (atomic::load(&epoch_) == epoch) {
+      entered_epoch = epoch;
+      return;
+    }
+    atomic::fas(&s.readers[epoch & 1], INT64_C(1));
+  }
+}
+
+void epoch_manager::leave() {
+  if (--epoch_depth > 0)
+    return;
+  atomic::fas(&slots_[thread_slot()].readers[entered_epoch & 1], INT64_C(1));
+}
+
+void epoch_manager::retire(void *ptr, deleter_fn deleter) {
+  {
+    std::lock_guard<std::mutex> lock(retired_mtx_);
+    retired_.push_back(retired_ptr{ptr, deleter, atomic::load(&epoch_)});
+  }
+  try_reclaim();
+}
+
+size_t epoch_manager::try_reclaim() {
+  // A pointer retired in epoch e is safe once the epoch reaches e + 2
+  if (try_advance())
+    try_advance();
+  uint64_t epoch = atomic::load(&epoch_);
+
+  std::vector<retired_ptr> ready;
+  {
+    std::lock_guard<std::mutex> lock(retired_mtx_);
+    size_t kept = 0;
+    for (const retired_ptr &r : retired_) {
+      if (r.epoch + 2 <= epoch)
+        ready.push_back(r);
+      else
+        retired_[kept++] = r;
+    }
+    retired_.resize(kept);
+  }
+  for (const retired_ptr &r : ready)
+    r.deleter(r.ptr);
+  return ready.size();
+}
+
+size_t epoch_manager::pending() {
+  std::lock_guard<std::mutex> lock(retired_mtx_);
+  return retired_.size();
+}
+
+uint64_t epoch_manager::epoch() const {
+  return atomic::load(&epoch_);
+}
+
+bool epoch_manager::try_advance() {
+  uint64_t epoch = atomic::load(&epoch_);
+  // Readers of the previous epoch share counters with the next one
+  if (epoch > 0 && readers(epoch - 1) != 0)
+    return false;
+  return atomic::strong::cas(&epoch_, &epoch, epoch + 1);
+}
+
+int64_t epoch_manager::readers(uint64_t epoch) const {
+  int64_t count = 0;
+  for (size_t i = 0; i < NUM_SLOTS; i++)
+    count += atomic::load(&slots_[i].readers[epoch & 1]);
+  return count;
+}
+
+size_t epoch_manager::thread_slot() {
+  static atomic::type<size_t> next_slot(0);
+  static thread_local size_t slot = atomic::faa(&next_slot, static_cast<size_t>(1)) % NUM_SLOTS;
+  return slot;
+}
+
+}
+}
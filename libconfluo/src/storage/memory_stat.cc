@@ -3,21 +3,52 @@
 namespace confluo {
 namespace storage {
 
+const size_t memory_stat::NUM_SLOTS;
+const int64_t memory_stat::SYNC_BYTES;
+
 memory_stat::memory_stat()
-    : memory_used_(0) {
+    : approximate_(0) {
+  for (size_t i = 0; i < NUM_SLOTS; i++) {
+    atomic::init(&slots_[i].used, INT64_C(0));
+    atomic::init(&slots_[i].unsynced, INT64_C(0));
+  }
 }
 
 void memory_stat::increment(size_t size) {
-  atomic::faa(&memory_used_, size);
+  slot &s = slots_[thread_slot()];
+  int64_t delta = static_cast<int64_t>(size);
+  atomic::faa(&s.used, delta);
+  if (atomic::faa(&s.unsynced, delta) + delta >= SYNC_BYTES) {
+    atomic::store(&s.unsynced, INT64_C(0));
+    get();
+  }
 }
 
 void memory_stat::decrement(size_t size) {
-  atomic::fas(&memory_used_, size);
+  atomic::fas(&slots_[thread_slot()].used, static_cast<int64_t>(size));
 }
 
 size_t memory_stat::get() {
-  return atomic::load(&memory_used_);
+  std::lock_guard<std::mutex> lock(sum_mtx_);
+  int64_t used = 0;
+  for (size_t i = 0; i < NUM_SLOTS; i++)
+    used += atomic::load(&slots_[i].used);
+  // Memory freed by a thread other than the one that allocated it may be
+  // summed before the allocation while slots are being read
+  size_t total = used > 0 ? static_cast<size_t>(used) : 0;
+  atomic::store(&approximate_, total);
+  return total;
+}
+
+size_t memory_stat::approximate() const {
+  return atomic::load(&approximate_);
 }
 
+size_t memory_stat::thread_slot() {
+  static atomic::type<size_t> next_slot(0);
+  static thread_local size_t slot = atomic::faa(&next_slot, static_cast<size_t>(1)) % NUM_SLOTS;
+  return slot;
+}
+
+}
 }
-}
\ No newline at end of file
@@ -34,6 +34,24 @@ void reference_counts::increment_both() {
   atomic::faa(&ref_counts_, BOTH_DELTA);
 }
 
+bool reference_counts::increment_first_if_nonzero() {
+  uint32_t counts = atomic::load(&ref_counts_);
+  while ((counts & FIRST_MASK) != 0) {
+    if (atomic::weak::cas(&ref_counts_, &counts, counts + FIRST_DELTA))
+      return true;
+  }
+  return false;
+}
+
+bool reference_counts::increment_second_if_nonzero() {
+  uint32_t counts = atomic::load(&ref_counts_);
+  while ((counts >> SECOND_SHIFT) != 0) {
+    if (atomic::weak::cas(&ref_counts_, &counts, counts + SECOND_DELTA))
+      return true;
+  }
+  return false;
+}
+
 void reference_counts::decrement_first() {
   atomic::fas(&ref_counts_, FIRST_DELTA);
 }
@@ -0,0 +1,131 @@
+#include "storage/size_class_pool.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace confluo {
+namespace storage {
+
+const size_t size_class_pool::MIN_CLASS_SIZE;
+const size_t size_class_pool::MAX_POOLED_SIZE;
+const size_t size_class_pool::NUM_CLASSES;
+const size_t size_class_pool::MAX_CACHED_BYTES;
+const size_t size_class_pool::MIN_CACHED_BLOCKS;
+
+namespace {
+
+const size_t LOG_MIN_CLASS_SIZE = 5;
+
+struct free_block {
+  free_block *next;
+};
+
+struct thread_cache {
+  free_block *heads[size_class_pool::NUM_CLASSES];
+  size_t counts[size_class_pool::NUM_CLASSES];
+};
+
+// Plain thread-locals stay usable after the thread's destructors run, so
+// that blocks freed during static destruction bypass the pool instead of
+// touching a destroyed cache
+thread_local thread_cache *tcache = nullptr;
+thread_local bool tcache_released = false;
+
+void release_cache(thread_cache *cache) {
+  for (size_t c = 0; c < size_class_pool::NUM_CLASSES; c++) {
+    free_block *b = cache->heads[c];
+    while (b != nullptr) {
+      free_block *next = b->next;
+      ::free(b);
+      b = next;
+    }
+  }
+  delete cache;
+}
+
+struct thread_cache_reaper {
+  ~thread_cache_reaper() {
+    if (tcache != nullptr)
+      release_cache(tcache);
+    tcache = nullptr;
+    tcache_released = true;
+  }
+};
+
+thread_cache *get_cache() {
+  if (tcache == nullptr && !tcache_released) {
+    static thread_local thread_cache_reaper reaper;
+    (void) reaper;
+    tcache = new thread_cache();
+  }
+  return tcache;
+}
+
+}
+
+void *size_class_pool::alloc(size_t size) {
+  size_t c = class_of(size);
+  if (c == NUM_CLASSES)
+    return ::malloc(size);
+
+  thread_cache *cache = get_cache();
+  if (cache != nullptr && cache->heads[c] != nullptr) {
+    free_block *b = cache->heads[c];
+    cache->heads[c] = b->next;
+    cache->counts[c]--;
+    return b;
+  }
+  return ::malloc(class_size(c));
+}
+
+void size_class_pool::dealloc(void *ptr, size_t size) {
+  size_t c = class_of(size);
+  if (c == NUM_CLASSES) {
+    ::free(ptr);
+    return;
+  }
+
+  thread_cache *cache = get_cache();
+  size_t max_blocks = MAX_CACHED_BYTES / class_size(c);
+  if (cache == nullptr || cache->counts[c] >= (max_blocks < MIN_CACHED_BLOCKS ? MIN_CACHED_BLOCKS : max_blocks)) {
+    ::free(ptr);
+    return;
+  }
+  free_block *b = new (ptr) free_block;
+  b->next = cache->heads[c];
+  cache->heads[c] = b;
+  cache->counts[c]++;
+}
+
+size_t size_class_pool::class_of(size_t size) {
+  if (size <= MIN_CLASS_SIZE)
+    return 0;
+  if (size > MAX_POOLED_SIZE)
+    return NUM_CLASSES;
+  // 2^k < size <= 2^(k+1), split into four classes
+  size_t k = static_cast<size_t>(63 - __builtin_clzll(static_cast<unsigned long long>(size - 1)));
+  size_t base = static_cast<size_t>(1) << k;
+  size_t sub = (size - 1 - base) / (base / 4);
+  return (k - LOG_MIN_CLASS_SIZE) * 4 + sub + 1;
+}
+
+size_t size_class_pool::class_size(size_t size_class) {
+  if (size_class == 0)
+    return MIN_CLASS_SIZE;
+  size_t k = (size_class - 1) / 4 + LOG_MIN_CLASS_SIZE;
+  size_t base = static_cast<size_t>(1) << k;
+  return base + ((size_class - 1) % 4 + 1) * (base / 4);
+}
+
+size_t size_class_pool::block_size(size_t size) {
+  size_t c = class_of(size);
+  return c == NUM_CLASSES ? size : class_size(c);
+}
+
+size_t size_class_pool::cached_blocks(size_t size_class) {
+  thread_cache *cache = get_cache();
+  return cache == nullptr ? 0 : cache->counts[size_class];
+}
+
+}
+}
@@ -1,4 +1,5 @@
 #include "storage/storage_allocator.h"
+#include "compression/lz4_block_cache.h"
 
 namespace confluo {
 namespace storage {
@@ -17,17 +18,20 @@ void storage_allocator::register_cleanup_callback(storage_allocator::callback_fn
 
 void *storage_allocator::alloc(size_t size, ptr_aux_block aux) {
   int retries = 0;
-  while (mem_stat_.get() >= configuration_params::MAX_MEMORY()) {
+  // The approximate count only lags behind allocations, so it is confirmed
+  // against the exact count before cleaning up
+  while (mem_stat_.approximate() >= configuration_params::MAX_MEMORY()
+      && mem_stat_.get() >= configuration_params::MAX_MEMORY()) {
     mem_cleanup_callback_();
     if (retries > MAX_CLEANUP_RETRIES)
       THROW(memory_exception, "Max memory reached!");
     retries++;
   }
   size_t alloc_size = sizeof(ptr_metadata) + size;
-  mem_stat_.increment(alloc_size);
+  mem_stat_.increment(size_class_pool::block_size(alloc_size));
 
   // allocate contiguous memory for both the ptr and metadata
-  void* ptr = malloc(alloc_size);
+  void* ptr = size_class_pool::alloc(alloc_size);
   ptr_metadata* md = new (ptr) ptr_metadata;
   void* data_ptr = reinterpret_cast<void*>(md + 1);
 
@@ -44,7 +48,7 @@ void *storage_allocator::mmap(std::string path, size_t size, ptr_aux_block aux)
   mmap_stat_.increment(alloc_size);
 
   int fd = utils::file_utils::open_file(path, O_CREAT | O_TRUNC | O_RDWR);
-  utils::file_utils::truncate_file(fd, alloc_size);
+  utils::file_utils::allocate_file(fd, alloc_size);
   void *ptr = utils::mmap_utils::map(fd, nullptr, 0, alloc_size);
   utils::file_utils::close_file(fd);
 
@@ -81,12 +85,16 @@ void *storage_allocator::mmap(std::string path, off_t offset, size_t size, ptr_a
 
 void storage_allocator::dealloc(void *ptr) {
   ptr_metadata *md = ptr_metadata::get(ptr);
+  uint8_t encoding = ptr_aux_block::get(md).encoding_;
+  if (encoding == encoding_type::D_LZ4 || encoding == encoding_type::D_COLUMNAR) {
+    compression::lz4_block_cache::instance().invalidate(static_cast<uint8_t *>(ptr));
+  }
   size_t alloc_size = sizeof(ptr_metadata) + md->data_size_ + md->offset_;
   switch (md->alloc_type_) {
     case alloc_type::D_DEFAULT: {
       md->~ptr_metadata();
-      free(md);
-      mem_stat_.decrement(alloc_size);
+      size_class_pool::dealloc(md, alloc_size);
+      mem_stat_.decrement(size_class_pool::block_size(alloc_size));
       break;
     }
     case alloc_type::D_MMAP: {
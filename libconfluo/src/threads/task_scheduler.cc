@@ -0,0 +1,229 @@
+#include "threads/task_scheduler.h"
+
+#include <algorithm>
+
+#include "conf/configuration_params.h"
+
+const size_t task_scheduler::WHEEL_SLOTS;
+const uint64_t task_scheduler::OVERRUN_LOG_INTERVAL_MS;
+
+task_scheduler::task_scheduler(size_t num_workers, uint64_t tick_ms)
+    : tick_ms_(std::max(tick_ms, UINT64_C(1))),
+      epoch_(std::chrono::steady_clock::now()),
+      tick_(0),
+      wake_tick_(0),
+      next_id_(0),
+      stop_(false),
+      wheel_(WHEEL_SLOTS) {
+  ticker_ = std::thread([this] { tick_loop(); });
+  for (size_t i = 0; i < std::max(num_workers, static_cast<size_t>(1)); i++)
+    workers_.push_back(std::thread([this] { work_loop(); }));
+}
+
+task_scheduler::~task_scheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  tick_cv_.notify_all();
+  ready_cv_.notify_all();
+  ticker_.join();
+  for (std::thread &worker : workers_)
+    worker.join();
+}
+
+task_scheduler &task_scheduler::instance() {
+  static task_scheduler scheduler(static_cast<size_t>(confluo::configuration_params::SCHEDULER_THREADS()));
+  return scheduler;
+}
+
+task_scheduler::task_id task_scheduler::schedule(const std::string &name, std::function<void(void)> task,
+                                                 uint64_t interval_ms) {
+  std::shared_ptr<task_entry> entry = std::make_shared<task_entry>();
+  entry->name = name;
+  entry->fn = std::move(task);
+  entry->interval_ticks = std::max((interval_ms + tick_ms_ - 1) / tick_ms_, UINT64_C(1));
+  entry->queued = false;
+  entry->running = false;
+  entry->notified = false;
+  entry->stats = task_stats{0, 0, 0, 0};
+  entry->unlogged_overruns = 0;
+
+  std::lock_guard<std::mutex> lock(mtx_);
+  task_id id = next_id_++;
+  tasks_[id] = entry;
+  add_to_wheel(id, *entry, now_tick() + entry->interval_ticks);
+  LOG_INFO << name << " task scheduled every " << interval_ms << "ms";
+  return id;
+}
+
+void task_scheduler::notify(task_id id) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = tasks_.find(id);
+  if (it == tasks_.end())
+    return;
+  task_entry &entry = *it->second;
+  if (entry.running)
+    entry.notified = true;
+  else if (!entry.queued)
+    enqueue(id, entry);
+}
+
+bool task_scheduler::cancel(task_id id) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto it = tasks_.find(id);
+  if (it == tasks_.end())
+    return false;
+  // Wheel and ready queue entries of the task are dropped once they are
+  // reached
+  std::shared_ptr<task_entry> entry = it->second;
+  tasks_.erase(it);
+  done_cv_.wait(lock, [&entry] { return !entry->running; });
+  LOG_INFO << entry->name << " task cancelled";
+  return true;
+}
+
+task_scheduler::task_stats task_scheduler::stats(task_id id) const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = tasks_.find(id);
+  if (it == tasks_.end())
+    return task_stats{0, 0, 0, 0};
+  return it->second->stats;
+}
+
+size_t task_scheduler::num_workers() const {
+  return workers_.size();
+}
+
+void task_scheduler::tick_loop() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (!stop_) {
+    // Catch up on the ticks slept through; a full rotation visits every slot
+    uint64_t now = now_tick();
+    uint64_t first = std::max(tick_ + 1, now >= WHEEL_SLOTS ? now - WHEEL_SLOTS + 1 : UINT64_C(0));
+    for (uint64_t t = first; t <= now; t++) {
+      std::vector<wheel_entry> &slot = wheel_[t % WHEEL_SLOTS];
+      size_t kept = 0;
+      for (size_t i = 0; i < slot.size(); i++) {
+        const wheel_entry &w = slot[i];
+        // Entries of cancelled, notified or rescheduled tasks are stale
+        auto it = tasks_.find(w.id);
+        if (it == tasks_.end() || it->second->due_tick != w.due_tick)
+          continue;
+        if (w.due_tick <= now)
+          enqueue(w.id, *it->second);
+        else
+          slot[kept++] = w;
+      }
+      slot.resize(kept);
+    }
+    tick_ = now;
+
+    // Tasks added to the wheel ahead of the wake tick wake the ticker early
+    wake_tick_ = next_due_tick();
+    if (wake_tick_ == UINT64_MAX)
+      tick_cv_.wait(lock);
+    else
+      tick_cv_.wait_until(lock, epoch_ + std::chrono::milliseconds(wake_tick_ * tick_ms_));
+  }
+}
+
+void task_scheduler::work_loop() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (true) {
+    ready_cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+    if (stop_)
+      return;
+
+    task_id id = ready_.front();
+    ready_.pop_front();
+    auto it = tasks_.find(id);
+    if (it == tasks_.end())
+      continue;
+    std::shared_ptr<task_entry> entry = it->second;
+    entry->queued = false;
+    entry->running = true;
+    lock.unlock();
+
+    uint64_t start_tick = now_tick();
+    auto start = std::chrono::steady_clock::now();
+    try {
+      entry->fn();
+    } catch (std::exception &e) {
+      LOG_ERROR << entry->name << ": Could not execute task: " << e.what();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t elapsed_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    lock.lock();
+    entry->running = false;
+    task_stats &stats = entry->stats;
+    stats.runs++;
+    uint64_t interval_us = entry->interval_ticks * tick_ms_ * 1000;
+    if (elapsed_us > interval_us) {
+      stats.overruns++;
+      stats.last_overrun_us = elapsed_us - interval_us;
+      stats.max_overrun_us = std::max(stats.max_overrun_us, stats.last_overrun_us);
+      log_overrun(*entry);
+    }
+
+    if (tasks_.find(id) != tasks_.end()) {
+      // An overrun task is due at the next tick, behind the tasks that
+      // became due while it ran
+      if (entry->notified) {
+        entry->notified = false;
+        enqueue(id, *entry);
+      } else {
+        add_to_wheel(id, *entry, std::max(now_tick() + 1, start_tick + entry->interval_ticks));
+      }
+    }
+    done_cv_.notify_all();
+  }
+}
+
+void task_scheduler::enqueue(task_id id, task_entry &entry) {
+  entry.queued = true;
+  entry.due_tick = UINT64_MAX;
+  ready_.push_back(id);
+  ready_cv_.notify_one();
+}
+
+void task_scheduler::add_to_wheel(task_id id, task_entry &entry, uint64_t due_tick) {
+  // Ticks up to tick_ have been processed
+  due_tick = std::max(due_tick, tick_ + 1);
+  entry.due_tick = due_tick;
+  wheel_[due_tick % WHEEL_SLOTS].push_back(wheel_entry{id, due_tick});
+  if (due_tick < wake_tick_)
+    tick_cv_.notify_one();
+}
+
+void task_scheduler::log_overrun(task_entry &entry) {
+  entry.unlogged_overruns++;
+  auto now = std::chrono::steady_clock::now();
+  if (now - entry.last_overrun_log < std::chrono::milliseconds(OVERRUN_LOG_INTERVAL_MS))
+    return;
+  LOG_WARN << entry.name << ": " << entry.unlogged_overruns << " run(s) overshot the "
+           << entry.interval_ticks * tick_ms_ << "ms interval, the last by " << entry.stats.last_overrun_us
+           << "us (" << entry.stats.overruns << " of " << entry.stats.runs << " runs so far)";
+  entry.unlogged_overruns = 0;
+  entry.last_overrun_log = now;
+}
+
+uint64_t task_scheduler::now_tick() const {
+  auto elapsed = std::chrono::steady_clock::now() - epoch_;
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()) / tick_ms_;
+}
+
+uint64_t task_scheduler::next_due_tick() const {
+  // The first slot ahead holding an entry due within this rotation; entries
+  // due in a later rotation are looked at again a rotation from now
+  bool any = false;
+  for (uint64_t t = tick_ + 1; t <= tick_ + WHEEL_SLOTS; t++) {
+    for (const wheel_entry &w : wheel_[t % WHEEL_SLOTS]) {
+      if (w.due_tick == t)
+        return t;
+      any = true;
+    }
+  }
+  return any ? tick_ + WHEEL_SLOTS : UINT64_MAX;
+}
@@ -1,5 +1,7 @@
 #include "threads/thread_manager.h"
 
+#include <algorithm>
+
 namespace confluo {
 
 int thread_manager::register_thread(thread_id_t thread_id) {
@@ -10,6 +12,26 @@ int thread_manager::register_thread(thread_id_t thread_id) {
   return core_id;
 }
 
+int thread_manager::register_maintenance_thread(thread_id_t thread_id) {
+  deregister_thread(thread_id);
+  bool expected = false;
+  for (int i = MAX_CONCURRENCY(); i < get_num_ids(); i++) {
+    if (atomic::strong::cas(&THREAD_INFO()[i].valid, &expected, true)) {
+      THREAD_INFO()[i].tid = thread_id;
+      return i;
+    }
+    expected = false;
+  }
+  return -2;
+}
+
+int thread_manager::register_reserved_thread(thread_id_t thread_id) {
+  int id;
+  while ((id = register_maintenance_thread(thread_id)) < 0)
+    std::this_thread::yield();
+  return id;
+}
+
 int thread_manager::deregister_thread(thread_id_t thread_id) {
   int core_id;
   if ((core_id = find(thread_id)) != -1)
@@ -25,15 +47,23 @@ int thread_manager::get_max_concurrency() {
   return MAX_CONCURRENCY();
 }
 
+int thread_manager::get_max_maintenance_concurrency() {
+  return MAINTENANCE_CONCURRENCY();
+}
+
+int thread_manager::get_num_ids() {
+  return MAX_CONCURRENCY() + MAINTENANCE_CONCURRENCY();
+}
+
 thread_info *thread_manager::init_thread_info() {
-  auto *tinfo = new thread_info[MAX_CONCURRENCY()];
-  for (int i = 0; i < thread_manager::MAX_CONCURRENCY(); i++)
+  auto *tinfo = new thread_info[get_num_ids()];
+  for (int i = 0; i < get_num_ids(); i++)
     atomic::init(&tinfo[i].valid, false);
   return tinfo;
 }
 
 int thread_manager::find(thread_id_t thread_id ) {
-  for (int i = 0; i < thread_manager::MAX_CONCURRENCY(); i++) {
+  for (int i = 0; i < get_num_ids(); i++) {
     if (atomic::load(&THREAD_INFO()[i].valid) && THREAD_INFO()[i].tid == thread_id) {
       return i;
     }
@@ -63,6 +93,11 @@ int thread_manager::MAX_CONCURRENCY() {
   return concurrency;
 }
 
+int thread_manager::MAINTENANCE_CONCURRENCY() {
+  static int concurrency = std::max(1, configuration_params::MAINTENANCE_THREADS());
+  return concurrency;
+}
+
 thread_info *thread_manager::THREAD_INFO() {
   static thread_info *info = thread_manager::init_thread_info();
   return info;
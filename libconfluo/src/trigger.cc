@@ -12,6 +12,7 @@ monitor::trigger::trigger(const std::string &name,
       op_(op),
       threshold_(threshold),
       periodicity_ms_(periodicity_ms),
+      next_window_ms_(0),
       is_valid_(true) {
 }
 
@@ -39,6 +40,14 @@ uint64_t monitor::trigger::periodicity_ms() const {
   return periodicity_ms_;
 }
 
+uint64_t monitor::trigger::next_window_ms() const {
+  return next_window_ms_;
+}
+
+void monitor::trigger::set_next_window_ms(uint64_t ms) {
+  next_window_ms_ = ms;
+}
+
 bool monitor::trigger::invalidate() {
   bool expected = true;
   return atomic::strong::cas(&is_valid_, &expected, false);
@@ -0,0 +1,65 @@
+#include "version_tracker.h"
+
+namespace confluo {
+
+version_tracker::read_guard::read_guard(version_tracker &tracker)
+    : tracker_(tracker),
+      epoch_(tracker.enter()) {
+}
+
+version_tracker::read_guard::~read_guard() {
+  tracker_.leave(epoch_);
+}
+
+version_tracker::version_tracker()
+    : epoch_(0),
+      readers_(),
+      pending_floor_(0),
+      floor_(0) {
+  readers_.decrement_both();
+}
+
+uint64_t version_tracker::enter() {
+  while (true) {
+    uint64_t epoch = atomic::load(&epoch_);
+    if (epoch & 1)
+      readers_.increment_second();
+    else
+      readers_.increment_first();
+    atomic::fence();
+    // Only counts if the epoch did not flip in between; otherwise the
+    // flip may already have checked this epoch's readers
+    if (atomic::load(&epoch_) == epoch)
+      return epoch;
+    leave(epoch);
+  }
+}
+
+void version_tracker::leave(uint64_t epoch) {
+  if (epoch & 1)
+    readers_.decrement_second();
+  else
+    readers_.decrement_first();
+}
+
+void version_tracker::advance(uint64_t tail) {
+  uint64_t epoch = atomic::load(&epoch_);
+  if (epoch > 0) {
+    if (readers(epoch - 1) != 0)
+      return;
+    atomic::store(&floor_, pending_floor_);
+  }
+  pending_floor_ = tail;
+  atomic::store(&epoch_, epoch + 1);
+  atomic::fence();
+}
+
+uint64_t version_tracker::floor() const {
+  return atomic::load(&floor_);
+}
+
+size_t version_tracker::readers(uint64_t epoch) {
+  return (epoch & 1) ? readers_.get_second() : readers_.get_first();
+}
+
+}
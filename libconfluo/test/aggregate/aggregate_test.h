@@ -98,4 +98,34 @@ TEST_F(AggregateTest, CountTest) {
   }
 }
 
+TEST_F(AggregateTest, ManyVersionsTest) {
+  aggregate_list agg(primitive_types::INT_TYPE(), aggregate_manager::get_aggregator("count"));
+  const uint64_t n = 100000;
+  numeric one(1);
+  for (uint64_t i = 1; i <= n; i++)
+    agg.seq_update(one, i * 2);
+  ASSERT_EQ(n, agg.num_versions());
+
+  for (uint64_t v = 0; v <= 2 * n + 1; v += 7) {
+    ASSERT_TRUE(numeric(v / 2) == agg.get(v));
+  }
+}
+
+TEST_F(AggregateTest, PruneTest) {
+  aggregate_list agg(primitive_types::INT_TYPE(), aggregate_manager::get_aggregator("sum"));
+  const uint64_t n = 10000;
+  const uint64_t lag = 100;
+  numeric one(1);
+  for (uint64_t i = 1; i <= n; i++) {
+    uint64_t floor = i > lag ? (i - lag) * 2 : 0;
+    agg.seq_update(one, i * 2, floor);
+    ASSERT_LE(agg.num_versions(), lag + aggregate_list::PRUNE_THRESHOLD + 1);
+
+    // Versions at or above the floor are still served correctly
+    for (uint64_t v = floor; v <= i * 2 + 1; v += 13)
+      ASSERT_TRUE(numeric(static_cast<double>(v / 2)) == agg.get(v));
+  }
+  ASSERT_TRUE(numeric(static_cast<double>(n)) == agg.get(limits::ulong_max));
+}
+
 #endif /* CONFLUO_TEST_AGGREGATE_TEST_H_ */
@@ -0,0 +1,99 @@
+#ifndef CONFLUO_TEST_APPEND_STAGER_TEST_H_
+#define CONFLUO_TEST_APPEND_STAGER_TEST_H_
+
+#include "append_stager.h"
+#include "filter.h"
+#include "gtest/gtest.h"
+
+using namespace ::confluo;
+
+class AppendStagerTest : public testing::Test {
+ public:
+  struct data_point {
+    int64_t ts;
+    int64_t val;
+  }__attribute__((packed));
+
+  static schema_t schema() {
+    schema_builder builder;
+    builder.add_column(primitive_types::LONG_TYPE(), "value");
+    return schema_t(builder.get_columns());
+  }
+
+  /**
+   * Gets the number of versions a thread has added to a time block's
+   * aggregate
+   */
+  static size_t num_versions(filter &f, size_t aid, uint64_t ts_block, int thread_id) {
+    storage::read_only_ptr<aggregate> aggs;
+    f.lookup_unsafe(ts_block)->aggregates().atomic_copy(aggs);
+    return aggs.get()[aid].num_versions(thread_id);
+  }
+};
+
+TEST_F(AppendStagerTest, StageTest) {
+  schema_t s = schema();
+  schema_snapshot snap = s.snapshot();
+  filter f;
+  size_t aid = f.add_aggregate(new aggregate_info("agg1", aggregate_manager::get_aggregator("sum"), 1));
+  size_t napplied = 0;
+  append_stager stager([&](uint64_t offset, uint8_t *data, size_t nrecords, int64_t time_block, size_t record_size,
+                           int thread_id) {
+    f.update(offset, snap, data, nrecords, time_block, record_size, 0, thread_id);
+    napplied++;
+  });
+
+  int tid = thread_manager::register_thread();
+  ASSERT_NE(-1, tid);
+  const size_t rs = sizeof(data_point);
+  std::vector<data_point> points(append_stager::MAX_STAGED_RECORDS + 3);
+  for (size_t i = 0; i < points.size(); i++)
+    points[i] = {0, static_cast<int64_t>(i)};
+
+  // A full run is applied once, as one aggregate version
+  for (size_t i = 0; i < append_stager::MAX_STAGED_RECORDS; i++) {
+    stager.stage(tid, i * rs, &points[i], 0, rs);
+    if (i + 1 < append_stager::MAX_STAGED_RECORDS) {
+      ASSERT_EQ(static_cast<uint64_t>(0), stager.visible(UINT64_MAX));
+    }
+  }
+  ASSERT_EQ(static_cast<size_t>(1), napplied);
+  ASSERT_EQ(UINT64_MAX, stager.visible(UINT64_MAX));
+  ASSERT_EQ(append_stager::MAX_STAGED_RECORDS, f.lookup(0)->size());
+  ASSERT_EQ(static_cast<size_t>(1), num_versions(f, aid, 0, tid));
+  int64_t sum = append_stager::MAX_STAGED_RECORDS * (append_stager::MAX_STAGED_RECORDS - 1) / 2;
+  ASSERT_TRUE(numeric(sum) == f.lookup(0)->get_aggregate(aid, append_stager::MAX_STAGED_RECORDS * rs));
+
+  // A record that does not extend the run applies the run first
+  uint64_t offset = append_stager::MAX_STAGED_RECORDS * rs;
+  stager.stage(tid, offset, &points[append_stager::MAX_STAGED_RECORDS], 0, rs);
+  stager.stage(tid, offset + rs, &points[append_stager::MAX_STAGED_RECORDS + 1], 0, rs);
+  ASSERT_EQ(offset, stager.visible(UINT64_MAX));
+  ASSERT_EQ(offset - rs, stager.visible(offset - rs));
+  stager.stage(tid, offset + 3 * rs, &points[append_stager::MAX_STAGED_RECORDS + 2], 1, rs);
+  ASSERT_EQ(static_cast<size_t>(2), napplied);
+  ASSERT_EQ(offset + 3 * rs, stager.visible(UINT64_MAX));
+  ASSERT_EQ(append_stager::MAX_STAGED_RECORDS + 2, f.lookup(0)->size());
+  ASSERT_EQ(static_cast<size_t>(2), num_versions(f, aid, 0, tid));
+
+  // Flushing applies partial runs
+  stager.flush_all();
+  ASSERT_EQ(static_cast<size_t>(3), napplied);
+  ASSERT_EQ(UINT64_MAX, stager.visible(UINT64_MAX));
+  ASSERT_EQ(static_cast<size_t>(1), f.lookup(1)->size());
+  stager.flush_all();
+  ASSERT_EQ(static_cast<size_t>(3), napplied);
+
+  // A direct update applies the thread's stage before it
+  stager.stage(tid, offset + 4 * rs, &points[0], 1, rs);
+  stager.direct_update(tid, [&] {
+    ASSERT_EQ(static_cast<size_t>(4), napplied);
+    ASSERT_EQ(UINT64_MAX, stager.visible(UINT64_MAX));
+  });
+  stager.direct_update(tid, [&] {
+    ASSERT_EQ(static_cast<size_t>(4), napplied);
+  });
+  ASSERT_NE(-1, thread_manager::deregister_thread());
+}
+
+#endif /* CONFLUO_TEST_APPEND_STAGER_TEST_H_ */
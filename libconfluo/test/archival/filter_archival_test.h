@@ -30,9 +30,9 @@ class FilterArchivalTest : public testing::Test {
     }
   }__attribute__((packed));
 
-  void fill(filter &f) {
+  void fill(filter &f, uint64_t num_entries = kMaxEntries) {
     ASSERT_TRUE(thread_manager::register_thread() != -1);
-    for (size_t i = 0; i < kMaxEntries / kPerTimeBlock; i++) {
+    for (size_t i = 0; i < num_entries / kPerTimeBlock; i++) {
       for (size_t j = i * kPerTimeBlock; j < (i + 1) * kPerTimeBlock; j++) {
         data_point p(i * kTimeBlock, static_cast<int64_t>(j));
         record_t r(j, reinterpret_cast<uint8_t *>(&p), sizeof(data_point));
@@ -178,4 +178,45 @@ TEST_F(FilterArchivalTest, MultipleReflogsArchivedTest) {
   verify(f);
 }
 
+TEST_F(FilterArchivalTest, RollupsArchivedTest) {
+  file_utils::clear_dir("/tmp/filter_archives/");
+  filter f(filter_none);
+  size_t aid = f.add_aggregate(new aggregate_info("agg1", aggregate_manager::get_aggregator("sum"), 1));
+  // Fewer entries than the other tests, since every entry adds a version to
+  // each rollup level
+  const uint64_t num_entries = kMaxEntries / 10;
+  fill(f, num_entries);
+
+  // Every rollup entry covers all time-blocks; each record added a version
+  auto rollup_aggregate = [&](size_t level) -> const aggregate & {
+    aggregated_reflog *refs = f.rollup_data(level).get_unsafe(byte_string(static_cast<uint64_t>(0)));
+    return refs->aggregates().atomic_load()[aid];
+  };
+  auto num_versions = [&](size_t level) {
+    size_t n = 0;
+    for (int i = 0; i < thread_manager::get_num_ids(); i++)
+      n += rollup_aggregate(level).num_versions(i);
+    return n;
+  };
+  for (size_t l = 0; l < filter::NUM_ROLLUP_LEVELS; l++)
+    ASSERT_EQ(static_cast<size_t>(num_entries), num_versions(l));
+
+  filter_log filters;
+  filters.push_back(&f);
+  filter_log_archiver archiver("/tmp/filter_archives/", &filters);
+
+  // Rollups are only collapsed once all the blocks they cover are archived
+  archiver.archive(32000);
+  ASSERT_EQ(static_cast<size_t>(num_entries), num_versions(0));
+
+  // Collapsed rollups hold a single version with the same aggregate
+  uint64_t version = num_entries + sizeof(data_point);
+  archiver.archive(version);
+  for (size_t l = 0; l < filter::NUM_ROLLUP_LEVELS; l++)
+    ASSERT_EQ(static_cast<size_t>(1), rollup_aggregate(l).num_versions(0));
+  int64_t expected = static_cast<int64_t>(num_entries * (num_entries - 1) / 2);
+  uint64_t day = filter::ROLLUP_BLOCKS[filter::NUM_ROLLUP_LEVELS - 1];
+  ASSERT_TRUE(numeric(expected) == f.get_aggregate(aid, 0, day - 1, version));
+}
+
 #endif /* TEST_FILTER_ARCHIVAL_TEST_H_ */
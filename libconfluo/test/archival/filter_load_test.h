@@ -113,6 +113,36 @@ TEST_F(FilterLoadTest, FilterReplayTest) {
   verify(f);
 }
 
+TEST_F(FilterLoadTest, ParallelFilterReplayTest) {
+  schema_t schema = build_schema();
+  data_log log("data_log", "/tmp", storage::IN_MEMORY);
+
+  // Span two data log buckets, so that the replay is split across workers
+  const uint64_t nrecords = data_log_constants::BUCKET_SIZE / record_size + 1000;
+  const uint64_t per_block = configuration_params::TIME_RESOLUTION_NS() / kTimeBlock;
+  for (uint64_t i = 0; i < nrecords; i++) {
+    data_point p(i * kTimeBlock, static_cast<int64_t>(i));
+    log.append(reinterpret_cast<uint8_t *>(&p), schema.record_size());
+  }
+
+  filter f(filter_none);
+  archival::load_utils::replay(log, schema, {archival::load_utils::filter_replay{&f, 0}}, {}, 4);
+
+  uint64_t nblocks = (nrecords + per_block - 1) / per_block;
+  for (uint64_t t = 0; t < nblocks; t++) {
+    reflog const *s = f.lookup(t);
+    ASSERT_TRUE(s != nullptr);
+    std::vector<uint64_t> offsets;
+    for (size_t i = 0; i < s->size(); i++)
+      offsets.push_back(s->at(i));
+    std::sort(offsets.begin(), offsets.end());
+    uint64_t first = t * per_block;
+    ASSERT_EQ(std::min(per_block, nrecords - first), offsets.size());
+    for (size_t i = 0; i < offsets.size(); i++)
+      ASSERT_EQ((first + i) * record_size, offsets[i]);
+  }
+}
+
 TEST_F(FilterLoadTest, FilterLogLoadReplayTest) {
   std::string path = "/tmp/filter_archives/";
   file_utils::clear_dir(path);
@@ -5,6 +5,7 @@
 
 #include "archival/archival_utils.h"
 #include "archival/index_log_archiver.h"
+#include "archival/load_utils.h"
 #include "index_log.h"
 #include "container/radix_tree.h"
 #include "storage/ptr_aux_block.h"
@@ -103,4 +104,31 @@ TEST_F(IndexLoadTest, IndexLogLoadTest) {
 
 }
 
+TEST_F(IndexLoadTest, IndexReplayStatsTest) {
+  struct rec {
+    int64_t ts;
+    uint32_t a;
+  }__attribute__((packed));
+
+  schema_t s = schema();
+  data_log log("data_log", "/tmp", storage::IN_MEMORY);
+  const uint32_t nrecords = planner::index_stats::SAMPLE_INTERVAL * 200;
+  for (uint32_t i = 0; i < nrecords; i++) {
+    rec r = {0, static_cast<uint32_t>(i / planner::index_stats::SAMPLE_INTERVAL)};
+    log.append(reinterpret_cast<uint8_t *>(&r), sizeof(rec));
+  }
+
+  // Replayed records are sampled as their writers would have sampled them
+  index::radix_index index(sizeof(uint32_t), 256);
+  planner::index_stats stats;
+  archival::load_utils::replay(log, s, {}, {archival::load_utils::index_replay{&index, 1, 0, &stats}}, 1);
+  ASSERT_EQ(static_cast<size_t>(200), stats.num_samples());
+
+  rec lo = {0, 0}, hi = {0, 199};
+  schema_snapshot snap = s.snapshot();
+  ASSERT_TRUE(snap.get_key(&lo, 1) == stats.min());
+  ASSERT_TRUE(snap.get_key(&hi, 1) == stats.max());
+  ASSERT_NEAR(1.0, stats.selectivity(snap.get_key(&lo, 1), snap.get_key(&hi, 1)).value(), 0.01);
+}
+
 #endif /* TEST_ARCHIVAL_INDEX_LOAD_TEST_H_ */
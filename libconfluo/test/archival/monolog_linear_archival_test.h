@@ -89,4 +89,47 @@ TEST_F(MonologLinearArchivalTest, PtrSwapTest) {
   verify_swap(log, 4 * BUCKET_SIZE, 8 * BUCKET_SIZE);
 }
 
+/**
+ * Verifies that buckets encoded in parallel are archived, and load back, in
+ * order.
+ */
+TEST_F(MonologLinearArchivalTest, ParallelArchivalTest) {
+  // Encode several buckets ahead for this test only
+  size_t threads = archival_configuration_params::THREADS();
+  conf::instance().set("archival_threads", "4");
+  struct restore_threads {
+    size_t threads;
+    ~restore_threads() {
+      conf::instance().set("archival_threads", std::to_string(threads));
+    }
+  } restore{threads};
+
+  small_monolog_linear log("log", "/tmp", storage::IN_MEMORY);
+  file_utils::clear_dir("/tmp/data_log/");
+  small_monolog_archiver archiver("/tmp/data_log/", &log);
+
+  // Give each bucket distinct contents, so that out of order buckets show
+  auto expected = [](size_t i) {
+    return static_cast<uint8_t>((i / BUCKET_SIZE * 31 + i) % 256);
+  };
+  uint8_t buf[ARRAY_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE; i++) {
+    buf[i] = expected(i);
+  }
+  log.append(buf, ARRAY_SIZE);
+
+  archiver.archive(8 * BUCKET_SIZE);
+  ASSERT_EQ(8 * BUCKET_SIZE, archiver.tail());
+  verify_swap(log, 0, 8 * BUCKET_SIZE);
+  for (size_t i = 0; i < ARRAY_SIZE; i++) {
+    ASSERT_EQ(expected(i), log.get(i));
+  }
+
+  small_monolog_linear recovered("recovered", "/tmp", storage::IN_MEMORY);
+  archival::monolog_linear_load_utils::load<uint8_t, MAX_BUCKETS, BUCKET_SIZE, 1024>("/tmp/data_log/", recovered);
+  for (size_t i = 0; i < ARRAY_SIZE; i++) {
+    ASSERT_EQ(expected(i), recovered.get(i));
+  }
+}
+
 #endif /* TEST_MONOLOG_LINEAR_ARCHIVAL_TEST_H_ */
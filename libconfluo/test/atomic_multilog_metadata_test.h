@@ -23,7 +23,8 @@ TEST_F(AtomicMultilogMetadataTest, ReadWriteTest) {
   schema_t s(builder.get_columns());
 
   w.write_schema(s);
-  w.write_index_metadata("col1", 0.0);
+  w.write_index_metadata("col1", 0.0, HASH_INDEX);
+  w.write_index_metadata("col2", 1.0, RADIX_INDEX);
   w.write_filter_metadata("filter1", "d>0");
   w.write_aggregate_metadata("agg1", "filter1", "SUM(d)");
   w.write_trigger_metadata("trigger1", "agg1<3", 10);
@@ -43,10 +44,18 @@ TEST_F(AtomicMultilogMetadataTest, ReadWriteTest) {
     }
   }
 
-  ASSERT_EQ(metadata_type::D_INDEX_METADATA, r.next_type());
-  index_metadata iinfo = r.next_index_metadata();
+  ASSERT_EQ(metadata_type::D_TYPED_INDEX_METADATA, r.next_type());
+  index_metadata iinfo = r.next_typed_index_metadata();
   ASSERT_EQ("col1", iinfo.field_name());
   ASSERT_EQ(static_cast<double>(0.0), iinfo.bucket_size());
+  ASSERT_EQ(HASH_INDEX, iinfo.index_type());
+
+  // Radix indexes keep the untyped format of earlier releases
+  ASSERT_EQ(metadata_type::D_INDEX_METADATA, r.next_type());
+  iinfo = r.next_index_metadata();
+  ASSERT_EQ("col2", iinfo.field_name());
+  ASSERT_EQ(static_cast<double>(1.0), iinfo.bucket_size());
+  ASSERT_EQ(RADIX_INDEX, iinfo.index_type());
 
   ASSERT_EQ(metadata_type::D_FILTER_METADATA, r.next_type());
   filter_metadata finfo = r.next_filter_metadata();
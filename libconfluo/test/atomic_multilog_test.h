@@ -39,6 +39,29 @@ class AtomicMultilogTest : public testing::Test {
     ASSERT_EQ(MAX_RECORDS, mlog.num_records());
   }
 
+  void test_execute_aggregate(atomic_multilog &mlog) {
+    mlog.append(record(false, '0', 0, 0, 0, 0.0, 0.01, "abc"));
+    mlog.append(record(true, '1', 10, 2, 1, 0.1, 0.02, "defg"));
+    mlog.append(record(false, '2', 20, 4, 10, 0.2, 0.03, "hijkl"));
+    mlog.append(record(true, '3', 30, 6, 100, 0.3, 0.04, "mnopqr"));
+    mlog.append(record(false, '4', 40, 8, 1000, 0.4, 0.05, "stuvwx"));
+    mlog.append(record(true, '5', 50, 10, 10000, 0.5, 0.06, "yyy"));
+    mlog.append(record(false, '6', 60, 12, 100000, 0.6, 0.07, "zzz"));
+    mlog.append(record(true, '7', 70, 14, 1000000, 0.7, 0.08, "zzz"));
+
+    ASSERT_TRUE(numeric(32.0) == mlog.execute_aggregate("SUM(d)", "a == true"));
+    ASSERT_TRUE(numeric(static_cast<int16_t>(10)) == mlog.execute_aggregate("MIN(c)", "a == true"));
+    ASSERT_TRUE(numeric(INT64_C(1000000)) == mlog.execute_aggregate("MAX(e)", "a == true"));
+    ASSERT_TRUE(numeric(UINT64_C(4)) == mlog.execute_aggregate("COUNT(d)", "a == true"));
+    ASSERT_TRUE(numeric(0.7f) == mlog.execute_aggregate("MAX(f)", "a == true"));
+
+    ASSERT_TRUE(numeric(48.0) == mlog.execute_aggregate("SUM(d)", "b > 4 || c <= 30"));
+    ASSERT_TRUE(numeric(UINT64_C(7)) == mlog.execute_aggregate("COUNT(d)", "b > 4 || c <= 30"));
+
+    ASSERT_TRUE(numeric(0.0) == mlog.execute_aggregate("SUM(d)", "c > 100"));
+    ASSERT_TRUE(numeric(UINT64_C(0)) == mlog.execute_aggregate("COUNT(d)", "c > 100"));
+  }
+
   static std::vector<column_t> s;
 
   struct rec {
@@ -155,6 +178,16 @@ TEST_F(AtomicMultilogTest, AppendAndGetDurableRelaxedTest) {
   test_append_and_get(mlog);
 }
 
+TEST_F(AtomicMultilogTest, TaskStatsTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  for (size_t i = 0; i < 1000 && mlog.task_stats().at("monitor").runs == 0; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  auto stats = mlog.task_stats();
+  ASSERT_GT(stats.at("monitor").runs, 0U);
+  // Archival is off, so its task never runs
+  ASSERT_EQ(0U, stats.at("archival").runs);
+}
+
 TEST_F(AtomicMultilogTest, AppendAndGetRecordTest1) {
   atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
 
@@ -262,6 +295,131 @@ TEST_F(AtomicMultilogTest, LoadTest) {
 
 }
 
+TEST_F(AtomicMultilogTest, ColumnarArchiveLoadTest) {
+  // Archive in the columnar encoding for this test only
+  std::string encoding = conf::instance().get<std::string>("data_log_archival_encoding",
+                                                           archival_defaults::DEFAULT_DATA_LOG_ENCODING_TYPE());
+  conf::instance().set("data_log_archival_encoding", "columnar");
+  struct restore_encoding {
+    std::string encoding;
+    ~restore_encoding() {
+      conf::instance().set("data_log_archival_encoding", encoding);
+    }
+  } restore{encoding};
+
+  // Low-cardinality, frame of reference and LZ4 coded columns
+  auto expected = [](size_t i) {
+    rec e = {static_cast<int64_t>(i), i % 3 == 0, static_cast<int8_t>(i % 7), static_cast<int16_t>(i % 1000),
+             static_cast<int32_t>(i % 100), static_cast<int64_t>(i), static_cast<float>(i) * 0.5f,
+             static_cast<double>(i) / 3.0, {}};
+    memcpy(e.h, i % 2 == 0 ? "even" : "odd", i % 2 == 0 ? 4 : 3);
+    return e;
+  };
+  // Durable multilogs flush once per batch rather than once per record
+  auto append = [&](atomic_multilog &mlog, size_t begin, size_t end) {
+    for (size_t b = begin; b < end; b += 8192) {
+      record_batch_builder builder = mlog.get_batch_builder();
+      for (size_t i = b; i < std::min(end, b + 8192); i++) {
+        rec e = expected(i);
+        builder.add_record(&e);
+      }
+      record_batch batch = builder.get_batch();
+      mlog.append_batch(batch);
+    }
+  };
+  auto encoding_of = [](atomic_multilog &mlog, size_t i) {
+    read_only_data_log_ptr ptr;
+    mlog.read(i * sizeof(rec), ptr);
+    return static_cast<int>(ptr_aux_block::get(ptr_metadata::get(ptr.get().ptr())).encoding_);
+  };
+  auto check = [&](atomic_multilog &mlog, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i += 997) {
+      read_only_data_log_ptr ptr;
+      mlog.read(i * sizeof(rec), ptr);
+      data_ptr dptr = ptr.decode_ptr(0, sizeof(rec));
+      rec e = expected(i);
+      ASSERT_EQ(0, memcmp(&e, dptr.get(), sizeof(rec))) << "record " << i;
+    }
+  };
+
+  // Records that fill the first bucket, and one that crosses into the next
+  const size_t per_bucket = data_log_constants::BUCKET_SIZE / sizeof(rec) + 1;
+  {
+    atomic_multilog mlog("columnar_table", s, "/tmp", storage::DURABLE, archival_mode::OFF, MGMT_POOL);
+    append(mlog, 0, per_bucket + 10);
+    mlog.archive();
+    ASSERT_EQ(static_cast<int>(encoding_type::D_COLUMNAR), encoding_of(mlog, 0));
+    check(mlog, 0, per_bucket + 10);
+    size_t n = 0;
+    for (auto r = mlog.execute_filter("d == 42"); r->has_more(); r->advance()) {
+      ASSERT_EQ(42, r->get().at(4).value().to_data().as<int32_t>());
+      n++;
+    }
+    ASSERT_EQ((per_bucket + 10 + 57) / 100, n);
+  }
+
+  // A loaded multilog reads the archived bucket, and archives the next one
+  // with the layout of its loaded schema
+  {
+    atomic_multilog mlog("columnar_table", "/tmp", MGMT_POOL);
+    ASSERT_EQ(per_bucket + 10, mlog.num_records());
+    check(mlog, 0, per_bucket + 10);
+    append(mlog, per_bucket + 10, 2 * per_bucket + 10);
+    mlog.archive();
+    ASSERT_EQ(static_cast<int>(encoding_type::D_COLUMNAR), encoding_of(mlog, per_bucket));
+    check(mlog, per_bucket, 2 * per_bucket + 10);
+  }
+  {
+    atomic_multilog mlog("columnar_table", "/tmp", MGMT_POOL);
+    ASSERT_EQ(2 * per_bucket + 10, mlog.num_records());
+    check(mlog, 0, 2 * per_bucket + 10);
+  }
+}
+
+TEST_F(AtomicMultilogTest, PartialArchiveLoadTest) {
+  // Records that fill the first bucket and spill into the next
+  const size_t n = data_log_constants::BUCKET_SIZE / sizeof(rec) + 1024;
+  int64_t now_ns = time_utils::cur_ns();
+  uint64_t beg = now_ns / configuration_params::TIME_RESOLUTION_NS();
+  std::string path = "/tmp/partial_table";
+  file_utils::clear_dir(path);
+  {
+    atomic_multilog mlog("partial_table", s, path, storage::DURABLE, archival_mode::OFF, MGMT_POOL);
+    mlog.add_filter("filter1", "d == 3");
+    for (size_t b = 0; b < n; b += 8192) {
+      record_batch_builder builder = mlog.get_batch_builder();
+      for (size_t i = b; i < std::min(n, b + 8192); i++) {
+        rec w = {now_ns, false, '0', 0, static_cast<int32_t>(i % 16), static_cast<int64_t>(i % 32), 0.0, 0.01, {}};
+        builder.add_record(&w);
+      }
+      record_batch batch = builder.get_batch();
+      mlog.append_batch(batch);
+    }
+    // Only the first bucket of the data log can be archived, and the filter
+    // stops where it does; the index is added after, so it has no archive
+    mlog.archive();
+    mlog.add_index("e");
+  }
+
+  // Archived reflogs only point at archived records; the rest are replayed
+  {
+    atomic_multilog mlog("partial_table", path, MGMT_POOL);
+    ASSERT_EQ(n, mlog.num_records());
+    size_t i = 0;
+    for (auto r = mlog.query_filter("filter1", beg, beg); r->has_more(); r->advance()) {
+      ASSERT_EQ(3, r->get().at(4).value().to_data().as<int32_t>());
+      i++;
+    }
+    ASSERT_EQ((n + 12) / 16, i);
+    i = 0;
+    for (auto r = mlog.execute_filter("e == 0"); r->has_more(); r->advance()) {
+      ASSERT_EQ(INT64_C(0), r->get().at(5).value().to_data().as<int64_t>());
+      i++;
+    }
+    ASSERT_EQ((n + 31) / 32, i);
+  }
+}
+
 TEST_F(AtomicMultilogTest, IndexTest) {
   atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
   mlog.add_index("a");
@@ -372,6 +530,117 @@ TEST_F(AtomicMultilogTest, IndexTest) {
   ASSERT_EQ(static_cast<size_t>(3), i);
 }
 
+TEST_F(AtomicMultilogTest, IntersectIndexTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_index("c");
+  mlog.add_index("d");
+
+  // Neither index alone is selective, but their intersection is
+  size_t expected = 0;
+  for (int32_t i = 0; i < 1000; i++) {
+    mlog.append(record(false, '0', static_cast<int16_t>(i % 10), i % 7, i, 0.0, 0.01, "abc"));
+    expected += (i % 10 == 3 && i % 7 == 5);
+  }
+
+  std::string plan = mlog.explain_filter("c == 3 && d == 5");
+  ASSERT_NE(std::string::npos, plan.find("intersect("));
+
+  size_t i = 0;
+  for (auto r = mlog.execute_filter("c == 3 && d == 5"); r->has_more(); r->advance()) {
+    ASSERT_EQ(3, r->get().at(3).value().to_data().as<int16_t>());
+    ASSERT_EQ(5, r->get().at(4).value().to_data().as<int32_t>());
+    i++;
+  }
+  ASSERT_EQ(expected, i);
+
+  // Minterms with and without intersections are combined
+  i = 0;
+  for (auto r = mlog.execute_filter("(c == 3 && d == 5) || c == 4"); r->has_more(); r->advance()) {
+    i++;
+  }
+  ASSERT_EQ(expected + 100, i);
+
+  numeric sum(static_cast<double>(5 * expected));
+  ASSERT_TRUE(sum == mlog.execute_aggregate("SUM(d)", "c == 3 && d == 5"));
+}
+
+TEST_F(AtomicMultilogTest, CostBasedPlanTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_index("c");
+  mlog.add_index("e");
+
+  for (int32_t i = 0; i < 10000; i++)
+    mlog.append(record(false, '0', static_cast<int16_t>(i % 10), 0, i, 0.0, 0.01, "abc"));
+
+  // Fetching most of the log through an index costs more than scanning it
+  ASSERT_NE(std::string::npos, mlog.explain_filter("c <= 5").find("full_scan"));
+  ASSERT_EQ(std::string::npos, mlog.explain_filter("e == 5").find("full_scan"));
+
+  size_t i = 0;
+  for (auto r = mlog.execute_filter("c <= 5"); r->has_more(); r->advance()) {
+    ASSERT_TRUE(r->get().at(3).value().to_data().as<int16_t>() <= 5);
+    i++;
+  }
+  ASSERT_EQ(static_cast<size_t>(6000), i);
+
+  // A cost model that makes random reads prohibitive always scans
+  mlog.set_query_cost_model(std::make_shared<linear_cost_model>(1e9));
+  ASSERT_NE(std::string::npos, mlog.explain_filter("e == 5").find("full_scan"));
+}
+
+TEST_F(AtomicMultilogTest, HashIndexTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_index("h", 1, HASH_INDEX);
+  mlog.add_index("c", 10);
+  ASSERT_TRUE(mlog.is_indexed("h"));
+
+  mlog.append(record(false, '0', 0, 0, 0, 0.0, 0.01, "abc"));
+  mlog.append(record(true, '1', 10, 2, 1, 0.1, 0.02, "defg"));
+  mlog.append(record(false, '2', 20, 4, 10, 0.2, 0.03, "hijkl"));
+  mlog.append(record(true, '3', 30, 6, 100, 0.3, 0.04, "mnopqr"));
+  mlog.append(record(false, '4', 40, 8, 1000, 0.4, 0.05, "stuvwx"));
+  mlog.append(record(true, '5', 50, 10, 10000, 0.5, 0.06, "yyy"));
+  mlog.append(record(false, '6', 60, 12, 100000, 0.6, 0.07, "zzz"));
+  mlog.append(record(true, '7', 70, 14, 1000000, 0.7, 0.08, "zzz"));
+
+  size_t i = 0;
+  for (auto r = mlog.execute_filter("h == zzz"); r->has_more(); r->advance()) {
+    ASSERT_TRUE(r->get().at(8).value().to_data().as<std::string>().substr(0, 3) == "zzz");
+    i++;
+  }
+  ASSERT_EQ(static_cast<size_t>(2), i);
+
+  i = 0;
+  for (auto r = mlog.execute_filter("h == zz"); r->has_more(); r->advance())
+    i++;
+  ASSERT_EQ(static_cast<size_t>(0), i);
+
+  // Ranges cannot use the hash index, and are served by the scan or by
+  // another index
+  i = 0;
+  for (auto r = mlog.execute_filter("h > stuvwx"); r->has_more(); r->advance())
+    i++;
+  ASSERT_EQ(static_cast<size_t>(3), i);
+
+  i = 0;
+  for (auto r = mlog.execute_filter("h > stuvwx && c <= 60"); r->has_more(); r->advance())
+    i++;
+  ASSERT_EQ(static_cast<size_t>(2), i);
+}
+
+TEST_F(AtomicMultilogTest, ExecuteAggregateScanTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  test_execute_aggregate(mlog);
+}
+
+TEST_F(AtomicMultilogTest, ExecuteAggregateIndexTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_index("a");
+  mlog.add_index("b");
+  mlog.add_index("c", 10);
+  test_execute_aggregate(mlog);
+}
+
 TEST_F(AtomicMultilogTest, RemoveIndexTest) {
   atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
 
@@ -400,6 +669,241 @@ TEST_F(AtomicMultilogTest, RemoveIndexTest) {
   ASSERT_EQ(true, mlog.is_indexed("c"));
 }
 
+TEST_F(AtomicMultilogTest, BackfillTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  const size_t n = 8192;
+  int64_t now_ns = time_utils::cur_ns();
+  uint64_t beg = now_ns / configuration_params::TIME_RESOLUTION_NS();
+  for (size_t i = 0; i < n; i++)
+    mlog.append(record(now_ns, i % 2 == 0, '0', 0, static_cast<int32_t>(i % 16), static_cast<int64_t>(i % 32), 0.0,
+                       0.01, "abc"));
+
+  // Keep appending while the index and the filter are added
+  std::thread writer([&] {
+    thread_manager::register_thread();
+    for (size_t i = 0; i < n; i++) {
+      rec w = {now_ns, i % 2 == 0, '0', 0, static_cast<int32_t>(i % 16), static_cast<int64_t>(i % 32), 0.0, 0.01, {}};
+      mlog.append(&w);
+    }
+    thread_manager::deregister_thread();
+  });
+  // Join the writer even if adding the index or the filter throws
+  try {
+    mlog.add_index("e");
+    mlog.add_filter("filter1", "d == 3");
+  } catch (...) {
+    writer.join();
+    throw;
+  }
+  writer.join();
+  ASSERT_TRUE(mlog.is_indexed("e"));
+
+  size_t i = 0;
+  for (auto r = mlog.execute_filter("e == 5"); r->has_more(); r->advance()) {
+    ASSERT_EQ(INT64_C(5), r->get().at(5).value().to_data().as<int64_t>());
+    i++;
+  }
+  ASSERT_EQ(2 * n / 32, i);
+
+  i = 0;
+  for (auto r = mlog.query_filter("filter1", beg, beg); r->has_more(); r->advance()) {
+    ASSERT_EQ(3, r->get().at(4).value().to_data().as<int32_t>());
+    i++;
+  }
+  ASSERT_EQ(2 * n / 16, i);
+}
+
+TEST_F(AtomicMultilogTest, BackfillAllThreadsRegisteredTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  const size_t n = 1024;
+  int64_t now_ns = time_utils::cur_ns();
+  uint64_t beg = now_ns / configuration_params::TIME_RESOLUTION_NS();
+  for (size_t i = 0; i < n; i++)
+    mlog.append(record(now_ns, i % 2 == 0, '0', 0, static_cast<int32_t>(i % 16), static_cast<int64_t>(i % 32), 0.0,
+                       0.01, "abc"));
+
+  // Hold every thread id, as a full quota of writers would
+  atomic::type<bool> done(false);
+  std::vector<std::thread> holders;
+  int id = 0;
+  while (id >= 0) {
+    std::promise<int> registered;
+    std::future<int> result = registered.get_future();
+    holders.push_back(std::thread([&done](std::promise<int> p) {
+      p.set_value(thread_manager::register_thread());
+      while (!atomic::load(&done))
+        std::this_thread::yield();
+      thread_manager::deregister_thread();
+    }, std::move(registered)));
+    id = result.get();
+  }
+  try {
+    mlog.add_index("e");
+    mlog.add_filter("filter1", "d == 3");
+  } catch (...) {
+    atomic::store(&done, true);
+    for (auto &t : holders)
+      t.join();
+    throw;
+  }
+  atomic::store(&done, true);
+  for (auto &t : holders)
+    t.join();
+
+  size_t i = 0;
+  for (auto r = mlog.execute_filter("e == 5"); r->has_more(); r->advance())
+    i++;
+  ASSERT_EQ(n / 32, i);
+
+  i = 0;
+  for (auto r = mlog.query_filter("filter1", beg, beg); r->has_more(); r->advance())
+    i++;
+  ASSERT_EQ(n / 16, i);
+}
+
+TEST_F(AtomicMultilogTest, BackfillWriterRegistersTest) {
+  // As many backfill workers as there are thread ids
+  int recovery_threads = configuration_params::RECOVERY_THREADS();
+  conf::instance().set("recovery_threads", std::to_string(thread_manager::get_num_ids()));
+  struct restore_recovery_threads {
+    int n;
+    ~restore_recovery_threads() {
+      conf::instance().set("recovery_threads", std::to_string(n));
+    }
+  } restore{recovery_threads};
+
+  // Records that fill the first bucket and spill into the next
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  const size_t n = data_log_constants::BUCKET_SIZE / sizeof(rec) + 1024;
+  int64_t now_ns = time_utils::cur_ns();
+  uint64_t beg = now_ns / configuration_params::TIME_RESOLUTION_NS();
+  for (size_t b = 0; b < n; b += 8192) {
+    record_batch_builder builder = mlog.get_batch_builder();
+    for (size_t i = b; i < std::min(n, b + 8192); i++) {
+      rec w = {now_ns, false, '0', 0, static_cast<int32_t>(i % 16), 0, 0.0, 0.01, {}};
+      builder.add_record(&w);
+    }
+    record_batch batch = builder.get_batch();
+    mlog.append_batch(batch);
+  }
+
+  // Hold every writer id but one
+  atomic::type<bool> done(false);
+  std::vector<std::thread> holders;
+  for (int i = 0; i < thread_manager::get_max_concurrency() - 1; i++) {
+    std::promise<int> registered;
+    std::future<int> result = registered.get_future();
+    holders.push_back(std::thread([&done](std::promise<int> p) {
+      p.set_value(thread_manager::register_thread());
+      while (!atomic::load(&done))
+        std::this_thread::yield();
+      thread_manager::deregister_thread();
+    }, std::move(registered)));
+    result.get();
+  }
+
+  // A writer that registers while the filter is backfilled gets the free
+  // id; it leaves the id free most of the time, for backfill to take
+  atomic::type<bool> added(false);
+  std::exception_ptr ex;
+  std::thread backfill([&] {
+    try {
+      mlog.add_filter("filter1", "d == 3");
+    } catch (...) {
+      ex = std::current_exception();
+    }
+    atomic::store(&added, true);
+  });
+  bool all_registered = true;
+  size_t appended = 0;
+  do {
+    if (thread_manager::register_thread() < 0) {
+      all_registered = false;
+      continue;
+    }
+    rec w = {now_ns, false, '0', 0, 3, 0, 0.0, 0.01, {}};
+    mlog.append(&w);
+    appended++;
+    thread_manager::deregister_thread();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  } while (!atomic::load(&added));
+  backfill.join();
+  atomic::store(&done, true);
+  for (auto &t : holders)
+    t.join();
+  if (ex)
+    std::rethrow_exception(ex);
+  ASSERT_TRUE(all_registered);
+
+  size_t i = 0;
+  for (auto r = mlog.query_filter("filter1", beg, beg); r->has_more(); r->advance())
+    i++;
+  ASSERT_EQ((n + 12) / 16 + appended, i);
+}
+
+TEST_F(AtomicMultilogTest, CursorRecordsOutliveCursorTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_index("d");
+  const size_t n = 1000;
+  for (size_t i = 0; i < n; i++)
+    mlog.append(record(i % 2 == 0, '0', 0, static_cast<int32_t>(i % 10), static_cast<int64_t>(i), 0.0, 0.01, "abc"));
+
+  // Records keep their copy of the data once the cursor, and the batch it
+  // was read in, are gone; through the index and through a full scan
+  for (const char *expr : {"d == 3", "e >= 500"}) {
+    std::vector<record_t> recs;
+    {
+      auto r = mlog.execute_filter(expr);
+      for (; r->has_more(); r->advance())
+        recs.push_back(r->get());
+    }
+    ASSERT_FALSE(recs.empty());
+    for (const auto &rec : recs) {
+      int64_t e = rec.at(5).value().to_data().as<int64_t>();
+      ASSERT_EQ(static_cast<int64_t>(rec.log_offset() / mlog.record_size()), e);
+      ASSERT_EQ(static_cast<int32_t>(e % 10), rec.at(4).value().to_data().as<int32_t>());
+    }
+  }
+}
+
+TEST_F(AtomicMultilogTest, StagedAppendsVisibleTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_index("d");
+  mlog.add_filter("filter1", "a == true");
+  mlog.add_aggregate("agg1", "filter1", "SUM(d)");
+
+  // A writer that goes idle with a partial stage: queries still see all of
+  // its records, without waiting for the monitor
+  const size_t n = append_stager::MAX_STAGED_RECORDS + 10;
+  int64_t now_ns = time_utils::cur_ns();
+  uint64_t beg = now_ns / configuration_params::TIME_RESOLUTION_NS();
+  std::promise<void> appended;
+  std::promise<void> finish;
+  std::thread writer([&] {
+    thread_manager::register_thread();
+    for (size_t i = 0; i < n; i++)
+      mlog.append(record(now_ns, true, '0', 0, 1, static_cast<int64_t>(i), 0.0, 0.01, "abc"));
+    appended.set_value();
+    finish.get_future().wait();
+    thread_manager::deregister_thread();
+  });
+  appended.get_future().wait();
+
+  size_t i = 0;
+  for (auto r = mlog.execute_filter("d == 1"); r->has_more(); r->advance())
+    i++;
+  size_t j = 0;
+  for (auto r = mlog.query_filter("filter1", beg, beg); r->has_more(); r->advance())
+    j++;
+  numeric agg = mlog.get_aggregate("agg1", beg, beg);
+  finish.set_value();
+  writer.join();
+
+  ASSERT_EQ(n, i);
+  ASSERT_EQ(n, j);
+  ASSERT_TRUE(numeric(static_cast<int32_t>(n)) == agg);
+}
+
 // TODO: Separate out the tests
 // TODO: Add tests for aggregates only
 TEST_F(AtomicMultilogTest, RemoveFilterTriggerTest) {
@@ -469,6 +973,33 @@ TEST_F(AtomicMultilogTest, RemoveFilterTriggerTest) {
 }
 
 // TODO: Separate out the tests
+TEST_F(AtomicMultilogTest, WindowTriggerTest) {
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_filter("filter1", "a == true");
+  mlog.add_aggregate("agg1", "filter1", "SUM(d)");
+  mlog.install_trigger("trigger1", "agg1 >= 10", 10);
+  mlog.install_trigger("trigger2", "agg1 >= 20", 10);
+
+  // Two records in the same 10ms window, neither of which exceeds the
+  // threshold on its own
+  uint64_t res = configuration_params::TIME_RESOLUTION_NS();
+  uint64_t beg = (static_cast<uint64_t>(time_utils::cur_ns()) / res / 10 + 1) * 10;
+  mlog.append(record(static_cast<int64_t>((beg + 1) * res), true, '1', 10, 6, 1, 0.1, 0.02, "defg"));
+  mlog.append(record(static_cast<int64_t>((beg + 8) * res), true, '3', 30, 6, 100, 0.3, 0.04, "mnopqr"));
+
+  sleep(1);
+
+  auto a1 = mlog.get_alerts(beg, beg + 9, "trigger1");
+  ASSERT_TRUE(a1->has_more());
+  ASSERT_EQ(beg, a1->get().time_bucket);
+  ASSERT_TRUE(numeric(12) == a1->get().value);
+  a1->advance();
+  ASSERT_FALSE(a1->has_more());
+
+  auto a2 = mlog.get_alerts(beg, beg + 9, "trigger2");
+  ASSERT_TRUE(a2->empty());
+}
+
 TEST_F(AtomicMultilogTest, FilterAggregateTriggerTest) {
   atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
   mlog.add_filter("filter1", "a == true");
@@ -776,6 +1307,71 @@ TEST_F(AtomicMultilogTest, BatchIndexTest) {
   ASSERT_EQ(static_cast<size_t>(3), i);
 }
 
+TEST_F(AtomicMultilogTest, AppendBlocksTest) {
+  // Mirrors the layout of a deserialized RPC record block
+  struct block_t {
+    int64_t time_block;
+    std::string data;
+    int64_t nrecords;
+  };
+
+  atomic_multilog mlog("my_table", s, "/tmp", storage::IN_MEMORY, archival_mode::OFF, MGMT_POOL);
+  mlog.add_filter("filter1", "a == true");
+
+  int64_t now_ns = time_utils::cur_ns();
+  int64_t beg = now_ns / configuration_params::TIME_RESOLUTION_NS();
+  record_batch batch = build_batch(mlog, now_ns);
+  ASSERT_EQ(static_cast<size_t>(1), batch.blocks.size());
+  const std::string &pattern = batch.blocks[0].data;
+  size_t record_size = mlog.record_size();
+
+  // Fill the first data log bucket with small blocks of the pattern
+  std::vector<block_t> filler(1);
+  filler[0].time_block = beg;
+  for (size_t i = 0; i < 1024; i++)
+    filler[0].data.append(pattern);
+  filler[0].nrecords = static_cast<int64_t>(1024 * batch.nrecords);
+  size_t filled = 0;
+  while (filled + 2 * filler[0].data.length() < data_log_constants::BUCKET_SIZE)
+    filled = mlog.append_blocks(filler) + filler[0].data.length();
+
+  // Repeat the pattern until the first block straddles the bucket
+  size_t nrepeat = (data_log_constants::BUCKET_SIZE - filled) / pattern.length() + 2;
+  std::vector<block_t> blocks(2);
+  blocks[0].time_block = beg;
+  for (size_t i = 0; i < nrepeat; i++)
+    blocks[0].data.append(pattern);
+  blocks[0].nrecords = static_cast<int64_t>(nrepeat * batch.nrecords);
+  blocks[1].time_block = beg;
+  blocks[1].data = pattern;
+  blocks[1].nrecords = static_cast<int64_t>(batch.nrecords);
+
+  ASSERT_EQ(filled, mlog.append_blocks(blocks));
+  ASSERT_TRUE(filled + blocks[0].data.length() > data_log_constants::BUCKET_SIZE);
+  ASSERT_EQ(filled / record_size + (nrepeat + 1) * batch.nrecords, mlog.num_records());
+
+  size_t nrecords = mlog.num_records();
+  for (size_t i = 0; i < nrecords; i += nrecords / 64 + 1) {
+    read_only_data_log_ptr ptr;
+    mlog.read(i * record_size, ptr);
+    data_ptr dptr = ptr.decode_ptr(0, record_size);
+    ASSERT_EQ(0, memcmp(dptr.get(), &pattern[(i % batch.nrecords) * record_size], record_size));
+  }
+
+  size_t n = 0;
+  for (auto r = mlog.query_filter("filter1", beg, beg); r->has_more(); r->advance()) {
+    // Odd records in the pattern pass the filter
+    ASSERT_EQ(static_cast<size_t>(1), (r->get().log_offset() / record_size) % 2);
+    n++;
+  }
+  ASSERT_EQ(nrecords / 2, n);
+
+  // Blocks with a partial trailing record are rejected whole
+  blocks[1].data.push_back('x');
+  ASSERT_THROW(mlog.append_blocks(blocks), invalid_operation_exception);
+  ASSERT_EQ(nrecords, mlog.num_records());
+}
+
 // TODO: Separate out the tests
 // TODO: Add tests for aggregates only
 TEST_F(AtomicMultilogTest, BatchFilterAggregateTriggerTest) {
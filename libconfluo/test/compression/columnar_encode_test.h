@@ -0,0 +1,123 @@
+#ifndef CONFLUO_TEST_COLUMNAR_ENCODE_TEST_H_
+#define CONFLUO_TEST_COLUMNAR_ENCODE_TEST_H_
+
+#include "compression/columnar_encoder.h"
+#include "compression/columnar_decoder.h"
+#include "gtest/gtest.h"
+
+using namespace confluo;
+using namespace confluo::compression;
+
+class ColumnarEncodeTest : public testing::Test {
+ public:
+  // Timestamp, int, double, low-cardinality string, random bytes; bytes
+  // 44-47 are left out of the layout
+  static const size_t RECORD_SIZE = 48;
+  static const size_t NUM_RECORDS = 3000;
+  // The bucket starts and ends in the middle of a record
+  static const size_t FIRST_RECORD = 13;
+  static const size_t BUCKET_SIZE = FIRST_RECORD + NUM_RECORDS * RECORD_SIZE + 17;
+
+  static columnar_layout layout() {
+    return columnar_layout{RECORD_SIZE, {
+        column_spec{0, 8, column_kind::D_UNSIGNED},
+        column_spec{8, 4, column_kind::D_SIGNED},
+        column_spec{12, 8, column_kind::D_FLOAT},
+        column_spec{20, 8, column_kind::D_BYTES},
+        column_spec{28, 16, column_kind::D_BYTES}
+    }};
+  }
+
+  static std::vector<uint8_t> generate() {
+    std::vector<uint8_t> bucket(BUCKET_SIZE);
+    for (size_t i = 0; i < BUCKET_SIZE; i++)
+      bucket[i] = static_cast<uint8_t>(rand());
+    for (size_t i = 0; i < NUM_RECORDS; i++) {
+      uint8_t *r = &bucket[FIRST_RECORD + i * RECORD_SIZE];
+      uint64_t ts = 1000000 + i * 3;
+      int32_t val = static_cast<int32_t>(i % 100) - 50;
+      double d = i * 0.5;
+      char str[8] = {0};
+      snprintf(str, sizeof(str), "s%d", static_cast<int>(i % 5));
+      memcpy(r, &ts, sizeof(ts));
+      memcpy(r + 8, &val, sizeof(val));
+      memcpy(r + 12, &d, sizeof(d));
+      memcpy(r + 20, str, sizeof(str));
+    }
+    return bucket;
+  }
+};
+
+const size_t ColumnarEncodeTest::RECORD_SIZE;
+const size_t ColumnarEncodeTest::NUM_RECORDS;
+const size_t ColumnarEncodeTest::FIRST_RECORD;
+const size_t ColumnarEncodeTest::BUCKET_SIZE;
+
+TEST_F(ColumnarEncodeTest, EncodeDecodeTest) {
+  std::vector<uint8_t> bucket = generate();
+  auto encoded = columnar_encoder::encode(bucket.data(), BUCKET_SIZE, layout(), FIRST_RECORD);
+  ASSERT_LT(encoded.size(), BUCKET_SIZE);
+
+  ASSERT_EQ(BUCKET_SIZE, columnar_decoder::decoded_size(encoded.get()));
+  ASSERT_EQ(FIRST_RECORD, columnar_decoder::first_record(encoded.get()));
+  ASSERT_EQ(NUM_RECORDS, columnar_decoder::num_records(encoded.get()));
+  ASSERT_EQ(6U, columnar_decoder::num_columns(encoded.get()));
+  ASSERT_EQ(column_codec::D_FOR, columnar_decoder::column(encoded.get(), 0).codec);
+  ASSERT_EQ(column_codec::D_FOR, columnar_decoder::column(encoded.get(), 1).codec);
+  ASSERT_EQ(column_codec::D_LZ4, columnar_decoder::column(encoded.get(), 2).codec);
+  ASSERT_EQ(column_codec::D_DICTIONARY, columnar_decoder::column(encoded.get(), 3).codec);
+
+  // Full and partial decodes, including ranges cut by either end
+  std::vector<uint8_t> decoded(BUCKET_SIZE);
+  columnar_decoder::decode(encoded.get(), decoded.data(), 0, BUCKET_SIZE);
+  ASSERT_TRUE(bucket == decoded);
+  size_t ranges[][2] = {{0, 5}, {5, 100}, {1000, 1}, {RECORD_SIZE * 1500 + 7, RECORD_SIZE * 600},
+                        {BUCKET_SIZE - 40, 40}};
+  for (auto &range : ranges) {
+    std::vector<uint8_t> part(range[1]);
+    columnar_decoder::decode(encoded.get(), part.data(), range[0], range[1]);
+    for (size_t i = 0; i < range[1]; i++)
+      ASSERT_EQ(bucket[range[0] + i], part[i]);
+  }
+  for (size_t i = 0; i < BUCKET_SIZE; i += 997)
+    ASSERT_EQ(bucket[i], columnar_decoder::decode(encoded.get(), i));
+}
+
+TEST_F(ColumnarEncodeTest, ColumnTest) {
+  std::vector<uint8_t> bucket = generate();
+  auto encoded = columnar_encoder::encode(bucket.data(), BUCKET_SIZE, layout(), FIRST_RECORD);
+
+  // Values of one column only, across LZ4 blocks
+  std::vector<int32_t> vals(2000);
+  columnar_decoder::decode_column(encoded.get(), 1, reinterpret_cast<uint8_t *>(vals.data()), 500, vals.size());
+  for (size_t i = 0; i < vals.size(); i++)
+    ASSERT_EQ(static_cast<int32_t>((500 + i) % 100) - 50, vals[i]);
+  std::vector<double> ds(1500);
+  columnar_decoder::decode_column(encoded.get(), 2, reinterpret_cast<uint8_t *>(ds.data()), 900, ds.size());
+  for (size_t i = 0; i < ds.size(); i++)
+    ASSERT_EQ((900 + i) * 0.5, ds[i]);
+
+  uint64_t ts_min, ts_max;
+  memcpy(&ts_min, columnar_decoder::column_min(encoded.get(), 0), sizeof(uint64_t));
+  memcpy(&ts_max, columnar_decoder::column_max(encoded.get(), 0), sizeof(uint64_t));
+  ASSERT_EQ(1000000U, ts_min);
+  ASSERT_EQ(1000000U + (NUM_RECORDS - 1) * 3, ts_max);
+  int32_t val_min, val_max;
+  memcpy(&val_min, columnar_decoder::column_min(encoded.get(), 1), sizeof(int32_t));
+  memcpy(&val_max, columnar_decoder::column_max(encoded.get(), 1), sizeof(int32_t));
+  ASSERT_EQ(-50, val_min);
+  ASSERT_EQ(49, val_max);
+  ASSERT_EQ(0, memcmp("s0", columnar_decoder::column_min(encoded.get(), 3), 3));
+  ASSERT_EQ(0, memcmp("s4", columnar_decoder::column_max(encoded.get(), 3), 3));
+}
+
+TEST_F(ColumnarEncodeTest, NoLayoutTest) {
+  std::vector<uint8_t> bucket = generate();
+  auto encoded = columnar_encoder::encode(bucket.data(), BUCKET_SIZE, columnar_layout{0, {}}, 0);
+  ASSERT_EQ(0U, columnar_decoder::num_records(encoded.get()));
+  std::vector<uint8_t> decoded(BUCKET_SIZE);
+  columnar_decoder::decode(encoded.get(), decoded.data(), 0, BUCKET_SIZE);
+  ASSERT_TRUE(bucket == decoded);
+}
+
+#endif /* CONFLUO_TEST_COLUMNAR_ENCODE_TEST_H_ */
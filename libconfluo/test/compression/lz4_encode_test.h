@@ -3,6 +3,7 @@
 
 #include "compression/lz4_encoder.h"
 #include "compression/lz4_decoder.h"
+#include "compression/lz4_block_cache.h"
 #include "gtest/gtest.h"
 
 using namespace confluo;
@@ -479,4 +480,42 @@ TEST_F(LZ4EncodeTest, EncodeDecodeIdxPtrDivisibleBlockTest) {
   delete[] destination;
 }
 
+TEST_F(LZ4EncodeTest, BlockCacheDecodeTest) {
+  // initialized array size spanning multiple default-sized blocks
+  size_t size = 4 * lz4_block_cache::BLOCK_SIZE;
+  uint8_t *source = new uint8_t[size];
+
+  // populates starting array with indexes modded by 251
+  for (size_t i = 0; i < size; i++) {
+    source[i] = i % 251;
+  }
+
+  auto encoded_buffer = lz4_encoder<>::encode(source, size);
+  auto &cache = lz4_block_cache::instance();
+
+  // decodes a range straddling a block boundary
+  size_t src_index = lz4_block_cache::BLOCK_SIZE - 100;
+  size_t dest_size = 300;
+  uint8_t *destination = new uint8_t[dest_size];
+  cache.decode(encoded_buffer.get(), destination, src_index, dest_size);
+  for (size_t i = 0; i < dest_size; i++) {
+    ASSERT_EQ(source[i + src_index], destination[i]);
+  }
+
+  // repeated reads on a block are served from the cache
+  auto block = cache.get(encoded_buffer.get(), 1);
+  ASSERT_EQ(block, cache.get(encoded_buffer.get(), 1));
+  for (size_t i = 0; i < lz4_block_cache::BLOCK_SIZE; i++) {
+    ASSERT_EQ(source[lz4_block_cache::BLOCK_SIZE + i], block.get()[i]);
+  }
+
+  // invalidation drops all blocks of the buffer
+  cache.invalidate(encoded_buffer.get());
+  ASSERT_NE(block, cache.get(encoded_buffer.get(), 1));
+  cache.invalidate(encoded_buffer.get());
+
+  delete[] source;
+  delete[] destination;
+}
+
 #endif /* CONFLUO_TEST_LZ4_ENCODE_TEST_H_ */
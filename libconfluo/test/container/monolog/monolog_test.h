@@ -171,4 +171,32 @@ TEST_F(MonoLogTest, MonoLogLinearDTest) {
   }
 }
 
+TEST_F(MonoLogTest, MonoLogLinearPreAllocTest) {
+  typedef monolog_linear<uint8_t, 8, 1048576, 1024> linear_type;
+  ASSERT_EQ(0U, linear_type::pre_alloc_bucket(0));
+  ASSERT_EQ(0U, linear_type::pre_alloc_bucket(524287));
+  ASSERT_EQ(1U, linear_type::pre_alloc_bucket(524288));
+  ASSERT_EQ(1U, linear_type::pre_alloc_bucket(1048576));
+  ASSERT_EQ(2U, linear_type::pre_alloc_bucket(1572864));
+
+  for (storage_mode mode : {IN_MEMORY, DURABLE_RELAXED, DURABLE}) {
+    linear_type array("mlog", "/tmp", mode);
+    array.pre_alloc(1, 2);
+    ASSERT_EQ(0U, array.data()[0].storage_size());
+    ASSERT_EQ(array.bucket_size(), array.data()[1].storage_size());
+    ASSERT_EQ(array.bucket_size(), array.data()[2].storage_size());
+    ASSERT_EQ(0U, array.data()[3].storage_size());
+
+    // Runs past the last bucket are cut short
+    array.pre_alloc(7, 4);
+    ASSERT_EQ(array.bucket_size(), array.data()[7].storage_size());
+
+    // Writes land in the pre-allocated buckets
+    for (uint64_t i = 1048576; i < 2 * 1048576; i++)
+      array.set(i, i % 256);
+    for (uint64_t i = 1048576; i < 2 * 1048576; i++)
+      ASSERT_EQ(i % 256, array.get(i));
+  }
+}
+
 #endif // CONFLUO_TEST_MONOLOG_TEST_H_
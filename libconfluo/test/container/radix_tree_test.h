@@ -1,6 +1,8 @@
 #ifndef CONFLUO_TEST_RADIX_TREE_TEST_H_
 #define CONFLUO_TEST_RADIX_TREE_TEST_H_
 
+#include <thread>
+
 #include "container/radix_tree.h"
 #include "gtest/gtest.h"
 
@@ -119,4 +121,54 @@ TEST_F(RadixTreeTest, RangeLookupTest) {
   }
 }
 
+TEST_F(RadixTreeTest, OutOfOrderInsertTest) {
+  // Insert keys in a scrambled order so that nodes grow through every
+  // child block size with children added out of key order
+  radix_index tree(sizeof(int32_t), 256);
+  for (int32_t i = 0; i < 1024; i++)
+    tree.insert(byte_string((i * 331) % 1024), (i * 331) % 1024);
+
+  for (int32_t i = 0; i < 1024; i++) {
+    const reflog *r = tree.get(byte_string(i));
+    ASSERT_TRUE(r != nullptr);
+    ASSERT_EQ(static_cast<size_t>(i), r->at(0));
+  }
+  ASSERT_TRUE(tree.get(byte_string(1024)) == nullptr);
+
+  auto reflogs = tree.range_lookup_reflogs(byte_string(0), byte_string(1023));
+  int32_t i = 0;
+  for (auto it = reflogs.begin(); it != reflogs.end(); ++it) {
+    ASSERT_TRUE(byte_string(i) == it.key());
+    ASSERT_EQ(static_cast<size_t>(i), it->at(0));
+    i++;
+  }
+  ASSERT_EQ(1024, i);
+
+  auto lb = tree.lower_bound(byte_string(2000));
+  ASSERT_EQ(static_cast<size_t>(1023), lb->at(0));
+}
+
+TEST_F(RadixTreeTest, ConcurrentInsertTest) {
+  radix_index tree(sizeof(int32_t), 256);
+  const size_t num_threads = 4;
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < num_threads; t++) {
+    workers.push_back(std::thread([&tree] {
+      for (int32_t i = 0; i < 4096; i++)
+        tree.insert(byte_string(i * 7), i);
+    }));
+  }
+  for (auto &w : workers)
+    w.join();
+
+  size_t count = 0;
+  auto reflogs = tree.range_lookup_reflogs(byte_string(0), byte_string(4096 * 7));
+  for (auto it = reflogs.begin(); it != reflogs.end(); ++it) {
+    ASSERT_TRUE(byte_string(static_cast<int32_t>(count * 7)) == it.key());
+    ASSERT_EQ(num_threads, it->size());
+    count++;
+  }
+  ASSERT_EQ(static_cast<size_t>(4096), count);
+}
+
 #endif /* CONFLUO_TEST_RADIX_TREE_TEST_H_ */
@@ -0,0 +1,203 @@
+#ifndef CONFLUO_TEST_ZONE_MAP_TEST_H_
+#define CONFLUO_TEST_ZONE_MAP_TEST_H_
+
+#include "archival/load_utils.h"
+#include "archival/zone_map_archiver.h"
+#include "atomic_multilog.h"
+#include "container/zone_map.h"
+#include "parser/expression_compiler.h"
+
+#include "gtest/gtest.h"
+
+using namespace ::confluo;
+
+class ZoneMapTest : public testing::Test {
+ public:
+  static const size_t NUM_RECORDS = 5000;
+
+  struct rec {
+    int64_t ts;
+    int32_t a;
+    double b;
+    char s[8];
+  }__attribute__((packed));
+
+  static std::vector<column_t> columns() {
+    return schema_builder()
+        .add_column(primitive_types::INT_TYPE(), "a")
+        .add_column(primitive_types::DOUBLE_TYPE(), "b")
+        .add_column(primitive_types::STRING_TYPE(8), "s")
+        .get_columns();
+  }
+
+  static schema_t schema() {
+    return schema_t(columns());
+  }
+
+  static std::vector<rec> records() {
+    std::vector<rec> recs(NUM_RECORDS);
+    for (size_t i = 0; i < NUM_RECORDS; i++) {
+      recs[i] = {static_cast<int64_t>(i), static_cast<int32_t>(i) - 1000, i * 0.5 - 100.0, {'s', 0}};
+    }
+    return recs;
+  }
+
+  static parser::compiled_expression compile(const std::string &exp, const schema_t &schema) {
+    return parser::compile_expression(parser::parse_expression(exp), schema);
+  }
+
+  template<typename T>
+  static void check_bounds(const zone_map &zones, bool bucket, size_t idx, size_t col, T min, T max) {
+    uint64_t min_key, max_key;
+    if (bucket)
+      ASSERT_TRUE(zones.bucket_bounds(idx, col, min_key, max_key));
+    else
+      ASSERT_TRUE(zones.zone_bounds(idx, col, min_key, max_key));
+    ASSERT_EQ(zones.key(col, &min), min_key);
+    ASSERT_EQ(zones.key(col, &max), max_key);
+  }
+};
+
+const size_t ZoneMapTest::NUM_RECORDS;
+
+TEST_F(ZoneMapTest, UpdateTest) {
+  schema_t s = schema();
+  zone_map zones;
+  zones.init(s);
+  ASSERT_EQ(static_cast<size_t>(3), zones.num_columns());
+  ASSERT_EQ(-1, zones.column_of(3));
+
+  std::vector<rec> recs = records();
+  zones.update(0, recs.data(), 100, sizeof(rec));
+  zones.update(100 * sizeof(rec), &recs[100], NUM_RECORDS - 100, sizeof(rec));
+
+  // Records that start in the first zone, including the one that crosses it
+  size_t last = zone_map::ZONE_SIZE / sizeof(rec);
+  check_bounds<int32_t>(zones, false, 0, 1, -1000, static_cast<int32_t>(last) - 1000);
+  check_bounds<double>(zones, false, 0, 2, -100.0, last * 0.5 - 100.0);
+  check_bounds<int32_t>(zones, false, 1, 1, static_cast<int32_t>(last) - 999, static_cast<int32_t>(2 * last) - 999);
+  check_bounds<int32_t>(zones, true, 0, 1, -1000, static_cast<int32_t>(NUM_RECORDS) - 1001);
+
+  uint64_t min, max;
+  ASSERT_FALSE(zones.zone_bounds(zone_map::ZONES_PER_BUCKET, 1, min, max));
+  ASSERT_FALSE(zones.bucket_bounds(1, 1, min, max));
+
+  // Keys preserve the order of signed and floating point values
+  int32_t i1 = -5, i2 = 3;
+  ASSERT_LT(zones.key(1, &i1), zones.key(1, &i2));
+  double d1 = -2.5, d2 = -0.0, d3 = 0.0, d4 = 1e-300;
+  ASSERT_LT(zones.key(2, &d1), zones.key(2, &d2));
+  ASSERT_EQ(zones.key(2, &d2), zones.key(2, &d3));
+  ASSERT_LT(zones.key(2, &d3), zones.key(2, &d4));
+}
+
+TEST_F(ZoneMapTest, FilterTest) {
+  schema_t s = schema();
+  zone_map zones;
+  zones.init(s);
+  std::vector<rec> recs = records();
+  zones.update(0, recs.data(), NUM_RECORDS, sizeof(rec));
+
+  zone_filter lt(&zones, compile("a < -1000", s));
+  ASSERT_TRUE(lt.is_active());
+  ASSERT_FALSE(lt.may_match_bucket(0));
+  ASSERT_FALSE(lt.may_match_zone(0));
+
+  zone_filter gt(&zones, compile("b > 1200.0", s));
+  ASSERT_TRUE(gt.may_match_bucket(0));
+  ASSERT_FALSE(gt.may_match_zone(0));
+  ASSERT_TRUE(gt.may_match_zone(1));
+  ASSERT_FALSE(gt.may_match(0));
+  ASSERT_TRUE(gt.may_match(zone_map::ZONE_SIZE));
+
+  zone_filter eq(&zones, compile("a == 0 && b > 1200.0", s));
+  ASSERT_FALSE(eq.may_match_zone(0));
+  ASSERT_FALSE(eq.may_match_zone(1));
+  zone_filter disjunction(&zones, compile("a == 0 || b > 2300.0", s));
+  ASSERT_TRUE(disjunction.may_match_zone(0));
+  ASSERT_FALSE(disjunction.may_match_zone(1));
+  ASSERT_TRUE(disjunction.may_match_zone(2));
+
+  // Zones without records may hold anything
+  ASSERT_TRUE(lt.may_match_bucket(1));
+
+  // Inequalities and untracked columns rule nothing out
+  ASSERT_FALSE(zone_filter(&zones, compile("a != 0", s)).is_active());
+  ASSERT_FALSE(zone_filter(&zones, compile("a < -1000 || s == abc", s)).is_active());
+  ASSERT_FALSE(zone_filter(&zones, parser::compiled_expression()).is_active());
+  ASSERT_FALSE(zone_filter(nullptr, compile("a < -1000", s)).is_active());
+}
+
+TEST_F(ZoneMapTest, ArchiveLoadTest) {
+  std::string path = "/tmp/zone_map_archives/";
+  file_utils::clear_dir(path);
+  schema_t s = schema();
+  std::vector<rec> recs = records();
+  zone_map zones;
+  zones.init(s);
+  zones.update(0, recs.data(), 100, sizeof(rec));
+  zones.update(zone_map::BUCKET_SIZE, &recs[100], 100, sizeof(rec));
+
+  archival::zone_map_archiver archiver(path, &zones);
+  archiver.archive(zone_map::BUCKET_SIZE, sizeof(rec));
+  ASSERT_EQ(static_cast<size_t>(0), archiver.tail());
+  archiver.archive(2 * zone_map::BUCKET_SIZE, sizeof(rec));
+  ASSERT_EQ(static_cast<size_t>(zone_map::BUCKET_SIZE), archiver.tail());
+
+  zone_map loaded;
+  loaded.init(s);
+  ASSERT_EQ(static_cast<size_t>(zone_map::BUCKET_SIZE), archival::zone_map_load_utils::load(path, &loaded));
+  check_bounds<int32_t>(loaded, true, 0, 1, -1000, -901);
+  check_bounds<int32_t>(loaded, false, 0, 1, -1000, -901);
+  uint64_t min, max;
+  ASSERT_FALSE(loaded.bucket_bounds(1, 1, min, max));
+}
+
+TEST_F(ZoneMapTest, FullScanTest) {
+  atomic_multilog mlog("my_table", columns(), "/tmp", storage::IN_MEMORY, archival_mode::OFF,
+                       AtomicMultilogTest::MGMT_POOL);
+  std::vector<rec> recs = records();
+  for (size_t i = 0; i < NUM_RECORDS; i++)
+    mlog.append(&recs[i]);
+
+  size_t n = 0;
+  for (auto r = mlog.execute_filter("a >= 3900"); r->has_more(); r->advance()) {
+    ASSERT_TRUE(r->get().at(1).value().to_data().as<int32_t>() >= 3900);
+    n++;
+  }
+  ASSERT_EQ(static_cast<size_t>(100), n);
+
+  n = 0;
+  for (auto r = mlog.execute_filter("a < -1000 || b > 2399.0"); r->has_more(); r->advance())
+    n++;
+  ASSERT_EQ(static_cast<size_t>(1), n);
+  ASSERT_TRUE(numeric(static_cast<int32_t>(3999)) == mlog.execute_aggregate("MAX(a)", "a > 3000"));
+}
+
+TEST_F(ZoneMapTest, ReplayTest) {
+  schema_t s = schema();
+  std::vector<rec> recs = records();
+  data_log log("data_log", "/tmp", storage::IN_MEMORY);
+  for (size_t i = 0; i < NUM_RECORDS; i++)
+    log.append(reinterpret_cast<uint8_t *>(&recs[i]), sizeof(rec));
+
+  zone_map zones;
+  zones.init(s);
+  archival::load_utils::replay(log, s, {}, {}, 2, archival::load_utils::zone_map_replay{&zones, 0});
+  size_t last = zone_map::ZONE_SIZE / sizeof(rec);
+  check_bounds<int32_t>(zones, false, 0, 1, -1000, static_cast<int32_t>(last) - 1000);
+  check_bounds<int32_t>(zones, false, 1, 1, static_cast<int32_t>(last) - 999, static_cast<int32_t>(2 * last) - 999);
+  check_bounds<int32_t>(zones, true, 0, 1, -1000, static_cast<int32_t>(NUM_RECORDS) - 1001);
+
+  // Zones loaded from an archive are not replayed over again
+  zone_map partial;
+  partial.init(s);
+  archival::load_utils::replay(log, s, {}, {}, 2,
+                               archival::load_utils::zone_map_replay{&partial, zone_map::ZONE_SIZE});
+  uint64_t min, max;
+  ASSERT_TRUE(partial.zone_bounds(0, 1, min, max));
+  ASSERT_GT(min, max);
+  check_bounds<int32_t>(partial, false, 1, 1, static_cast<int32_t>(last) - 999, static_cast<int32_t>(2 * last) - 999);
+}
+
+#endif /* CONFLUO_TEST_ZONE_MAP_TEST_H_ */
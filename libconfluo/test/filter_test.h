@@ -198,4 +198,58 @@ TEST_F(FilterTest, MultiThreadedAggregateTest) {
   }
 }
 
+TEST_F(FilterTest, RollupAggregateTest) {
+  filter f;
+  aggregate_info *a = new aggregate_info(
+      "agg1", aggregate_manager::get_aggregator("sum"), 1);
+  size_t aid = f.add_aggregate(a);
+  ASSERT_EQ(0, aid);
+
+  // Spread records over ~2 days so that all rollup levels are populated
+  const uint64_t kNumEntries = 10000;
+  const uint64_t kStepMs = 17333;
+  ASSERT_TRUE(thread_manager::register_thread() != -1);
+  for (size_t i = 0; i < kNumEntries; i++) {
+    data_point p(i * kStepMs * kMillisecs, static_cast<int64_t>(i));
+    record_t r(i * sizeof(data_point), reinterpret_cast<uint8_t *>(&p), sizeof(data_point));
+    r.push_back(field_t(0, primitive_types::LONG_TYPE(), r.data(), false, 0, 0.0));
+    r.push_back(field_t(1,
+                        primitive_types::LONG_TYPE(),
+                        reinterpret_cast<char *>(r.data()) + sizeof(int64_t),
+                        false,
+                        0,
+                        0.0));
+    f.update(r);
+  }
+  ASSERT_TRUE(thread_manager::deregister_thread() != -1);
+
+  auto expected_sum = [&](uint64_t begin_ms, uint64_t end_ms, size_t num_entries) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < num_entries; i++) {
+      uint64_t ts = i * kStepMs;
+      if (ts >= begin_ms && ts <= end_ms)
+        sum += static_cast<int64_t>(i);
+    }
+    return sum;
+  };
+
+  uint64_t version = kNumEntries * sizeof(data_point);
+  uint64_t max_ms = kNumEntries * kStepMs;
+  std::vector<std::pair<uint64_t, uint64_t>> ranges = {
+      {0, 0}, {0, 999}, {1, 998}, {500, 65000}, {59999, 3600001}, {0, max_ms},
+      {1234567, 98765432}, {86399999, 86400000}, {3600000, 7199999}, {max_ms, max_ms + 100000}
+  };
+  for (auto &range : ranges) {
+    int64_t expected = expected_sum(range.first, range.second, kNumEntries);
+    ASSERT_TRUE(numeric(expected) == f.get_aggregate(aid, range.first, range.second, version));
+  }
+
+  // Reads at an older version only see records up to that version
+  uint64_t old_version = (kNumEntries / 2) * sizeof(data_point);
+  for (auto &range : ranges) {
+    int64_t expected = expected_sum(range.first, range.second, kNumEntries / 2);
+    ASSERT_TRUE(numeric(expected) == f.get_aggregate(aid, range.first, range.second, old_version));
+  }
+}
+
 #endif // CONFLUO_TEST_FILTER_TEST_H_
@@ -1,6 +1,7 @@
 #ifndef CONFLUO_TEST_EXPRESSION_COMPILER_TEST_H_
 #define CONFLUO_TEST_EXPRESSION_COMPILER_TEST_H_
 
+#include "parser/batch_expression.h"
 #include "parser/expression_compiler.h"
 #include "gtest/gtest.h"
 #include "schema/schema.h"
@@ -271,4 +272,37 @@ TEST_F(ExpressionCompilerTest, TestPredicateBufferTest) {
   ASSERT_TRUE(predicate("g", reational_op_id::LT, "194.312").test(snap, record_buf(false, 0, 0, 0, 0, 0, 182.3)));
 }
 
+TEST_F(ExpressionCompilerTest, BatchExpressionTest) {
+  const size_t n = 1000;
+  std::vector<rec> recs(n);
+  for (size_t i = 0; i < n; i++) {
+    recs[i] = {static_cast<int64_t>(i), i % 2 == 0, static_cast<int8_t>(i % 128), static_cast<int16_t>(i % 100),
+               static_cast<int32_t>(i), static_cast<int64_t>(i * 10), static_cast<float>(i) / 10,
+               static_cast<double>(i) / 100, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+    recs[i].h[0] = static_cast<char>('a' + i % 3);
+  }
+
+  std::vector<std::string> exprs = {
+      "a==true", "b<5 && c>=5", "d>500 || e<=100", "f!=50.0 && g<5.5", "c==7 || b>9 || a==false",
+      "d>=100 && d<200 && e!=1500", "h==b || d<3"
+  };
+  std::vector<uint8_t> sel(n);
+  for (auto &e : exprs) {
+    compiled_expression cexp;
+    compile(cexp, e, s);
+    batch_expression bexp(cexp, s);
+    bexp.evaluate(reinterpret_cast<const uint8_t *>(recs.data()), sizeof(rec), n, sel.data());
+    for (size_t i = 0; i < n; i++) {
+      ASSERT_EQ(cexp.test(s.apply_unsafe(0, &recs[i])), sel[i] != 0) << e << " @ " << i;
+    }
+  }
+
+  // The empty expression selects every record
+  batch_expression all(compiled_expression(), s);
+  all.evaluate(reinterpret_cast<const uint8_t *>(recs.data()), sizeof(rec), n, sel.data());
+  for (size_t i = 0; i < n; i++) {
+    ASSERT_TRUE(sel[i] != 0);
+  }
+}
+
 #endif /* CONFLUO_TEST_EXPRESSION_COMPILER_TEST_H_ */
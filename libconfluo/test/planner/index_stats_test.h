@@ -0,0 +1,49 @@
+#ifndef CONFLUO_TEST_INDEX_STATS_TEST_H_
+#define CONFLUO_TEST_INDEX_STATS_TEST_H_
+
+#include "gtest/gtest.h"
+
+#include "planner/index_stats.h"
+
+using namespace ::confluo;
+using namespace ::confluo::planner;
+
+class IndexStatsTest : public testing::Test {
+};
+
+TEST_F(IndexStatsTest, SelectivityTest) {
+  index_stats stats;
+  ASSERT_FALSE(stats.selectivity(byte_string(0), byte_string(99)).has_value());
+
+  for (int32_t i = 0; i < 10000; i++)
+    stats.update(byte_string(i % 100));
+  ASSERT_EQ(static_cast<size_t>(10000), stats.num_samples());
+  ASSERT_TRUE(byte_string(0) == stats.min());
+  ASSERT_TRUE(byte_string(99) == stats.max());
+
+  ASSERT_NEAR(1.0, stats.selectivity(byte_string(0), byte_string(99)).value(), 0.01);
+  ASSERT_NEAR(0.5, stats.selectivity(byte_string(0), byte_string(49)).value(), 0.05);
+  ASSERT_NEAR(0.01, stats.selectivity(byte_string(7), byte_string(7)).value(), 0.005);
+  // Keys outside the samples may still occur once in the records sampled
+  double floor = 1.0 / (10000.0 * index_stats::SAMPLE_INTERVAL);
+  ASSERT_DOUBLE_EQ(floor, stats.selectivity(byte_string(100), byte_string(200)).value());
+}
+
+TEST_F(IndexStatsTest, SkewTest) {
+  index_stats stats;
+  for (int32_t i = 0; i < 10000; i++)
+    stats.update(byte_string(i % 2 == 0 ? 42 : i));
+
+  // The frequent key fills whole buckets of the histogram
+  ASSERT_NEAR(0.5, stats.selectivity(byte_string(42), byte_string(42)).value(), 0.05);
+  ASSERT_GT(0.01, stats.selectivity(byte_string(43), byte_string(43)).value());
+}
+
+TEST_F(IndexStatsTest, DistinctCountTest) {
+  index_stats stats;
+  for (int32_t i = 0; i < 20000; i++)
+    stats.update(byte_string(i % 5000));
+  ASSERT_NEAR(5000.0, stats.distinct_count(), 750.0);
+}
+
+#endif /* CONFLUO_TEST_INDEX_STATS_TEST_H_ */
@@ -0,0 +1,99 @@
+#ifndef CONFLUO_TEST_READ_TAIL_TEST_H_
+#define CONFLUO_TEST_READ_TAIL_TEST_H_
+
+#include <thread>
+
+#include "read_tail.h"
+#include "gtest/gtest.h"
+
+using namespace ::confluo;
+
+class ReadTailTest : public testing::Test {
+ public:
+  static const uint64_t kRecordSize = 8;
+  static const uint64_t kRecordsPerThread = 100000;
+
+  /**
+   * Appends records of kRecordSize bytes from multiple writer threads, each
+   * of which reserves its range from a shared write tail.
+   *
+   * @return The number of advances that returned before the read tail
+   * covered their range.
+   */
+  static uint64_t concurrent_advance(read_tail &rt, size_t num_threads, uint64_t records_per_thread,
+                                     std::vector<atomic::type<bool>> &written) {
+    atomic::type<uint64_t> write_tail(0);
+    atomic::type<uint64_t> unreadable(0);
+    std::vector<std::thread> writers;
+    for (size_t i = 0; i < num_threads; i++) {
+      writers.push_back(std::thread([&rt, &write_tail, &unreadable, records_per_thread, &written] {
+        for (uint64_t j = 0; j < records_per_thread; j++) {
+          uint64_t offset = atomic::faa(&write_tail, kRecordSize);
+          atomic::store(&written[offset / kRecordSize], true);
+          rt.advance(offset, static_cast<uint32_t>(kRecordSize));
+          if (rt.get() < offset + kRecordSize)
+            atomic::faa(&unreadable, UINT64_C(1));
+        }
+      }));
+    }
+    for (auto &writer : writers)
+      writer.join();
+    return atomic::load(&unreadable);
+  }
+};
+
+TEST_F(ReadTailTest, InOrderAdvanceTest) {
+  read_tail rt("/tmp", storage::IN_MEMORY);
+  ASSERT_EQ(0, rt.get());
+  for (uint64_t i = 0; i < 100; i++) {
+    rt.advance(i * kRecordSize, kRecordSize);
+    ASSERT_EQ((i + 1) * kRecordSize, rt.get());
+  }
+}
+
+TEST_F(ReadTailTest, OutOfOrderAdvanceTest) {
+  read_tail rt("/tmp", storage::IN_MEMORY);
+  // Writers past the read tail return once an earlier writer commits them
+  std::thread w1([&rt] { rt.advance(10, 10); });
+  std::thread w2([&rt] { rt.advance(30, 5); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(0, rt.get());
+  rt.advance(0, 10);
+  w1.join();
+  EXPECT_EQ(20, rt.get());
+  rt.advance(20, 10);
+  w2.join();
+  ASSERT_EQ(35, rt.get());
+}
+
+TEST_F(ReadTailTest, ConcurrentAdvanceTest) {
+  for (size_t num_threads = 1; num_threads <= 4; num_threads++) {
+    read_tail rt("/tmp", storage::IN_MEMORY);
+    uint64_t num_records = num_threads * kRecordsPerThread;
+    std::vector<atomic::type<bool>> written(num_records);
+    for (auto &w : written)
+      atomic::init(&w, false);
+
+    // The read tail must never expose an unwritten record, or move backwards
+    atomic::type<bool> done(false);
+    std::thread reader([&rt, &written, &done] {
+      uint64_t last_tail = 0;
+      while (!atomic::load(&done)) {
+        uint64_t tail = rt.get();
+        ASSERT_GE(tail, last_tail);
+        for (uint64_t i = last_tail / kRecordSize; i < tail / kRecordSize; i++)
+          ASSERT_TRUE(atomic::load(&written[i]));
+        last_tail = tail;
+      }
+    });
+
+    uint64_t unreadable = concurrent_advance(rt, num_threads, kRecordsPerThread, written);
+    atomic::store(&done, true);
+    reader.join();
+    // Writers must be able to read their own records once advance returns
+    ASSERT_EQ(0U, unreadable);
+    ASSERT_EQ(num_records * kRecordSize, rt.get());
+  }
+}
+
+#endif /* CONFLUO_TEST_READ_TAIL_TEST_H_ */
@@ -0,0 +1,100 @@
+#ifndef CONFLUO_TEST_EPOCH_MANAGER_TEST_H_
+#define CONFLUO_TEST_EPOCH_MANAGER_TEST_H_
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "storage/allocator.h"
+#include "storage/epoch_manager.h"
+#include "storage/swappable_encoded_ptr.h"
+
+using namespace ::confluo;
+using namespace ::confluo::storage;
+
+class EpochManagerTest : public testing::Test {
+ public:
+  static const size_t ARRAY_SIZE = 1024;
+};
+
+TEST_F(EpochManagerTest, RetireTest) {
+  epoch_manager &manager = epoch_manager::instance();
+  manager.try_reclaim();
+  ASSERT_EQ(0, manager.pending());
+
+  ptr_aux_block aux(state_type::D_IN_MEMORY, encoding_type::D_UNENCODED);
+  void *data = allocator::instance().alloc(sizeof(uint64_t) * ARRAY_SIZE, aux);
+  {
+    epoch_manager::guard guard;
+    // Nested guards share the outer epoch
+    epoch_manager::guard nested;
+    manager.retire(data, destroy_and_dealloc<uint64_t>);
+    ASSERT_EQ(1, manager.pending());
+  }
+  ASSERT_EQ(1, manager.try_reclaim());
+  ASSERT_EQ(0, manager.pending());
+}
+
+TEST_F(EpochManagerTest, SwapTest) {
+  size_t initial_mem_usage = allocator::instance().memory_utilization();
+  epoch_manager &manager = epoch_manager::instance();
+
+  {
+    ptr_aux_block aux_unarchived(state_type::D_IN_MEMORY, encoding_type::D_UNENCODED);
+    ptr_aux_block aux_archived(state_type::D_ARCHIVED, encoding_type::D_UNENCODED);
+    auto *data = static_cast<uint64_t *>(allocator::instance().alloc(sizeof(uint64_t) * ARRAY_SIZE,
+                                                                     aux_unarchived));
+    void *data_swapped = allocator::instance().alloc(sizeof(uint64_t) * ARRAY_SIZE, aux_archived);
+    for (size_t i = 0; i < ARRAY_SIZE; i++)
+      data[i] = i;
+
+    swappable_encoded_ptr<uint64_t> ptr((encoded_ptr<uint64_t>(data)));
+    size_t swapped_mem_usage = allocator::instance().memory_utilization();
+
+    // A swap from another thread retires the pointer a reader has loaded
+    // within its epoch, without deallocating it
+    {
+      epoch_manager::guard guard;
+      encoded_ptr<uint64_t> loaded = ptr.atomic_load();
+      std::thread swapper([&] {
+        ptr.swap_ptr(encoded_ptr<uint64_t>(data_swapped));
+      });
+      swapper.join();
+      ASSERT_EQ(data_swapped, ptr.atomic_load().ptr());
+      ASSERT_EQ(1, manager.pending());
+      ASSERT_EQ(swapped_mem_usage, allocator::instance().memory_utilization());
+      for (size_t i = 0; i < ARRAY_SIZE; i++)
+        ASSERT_EQ(i, loaded.decode_at(i));
+    }
+
+    manager.try_reclaim();
+    ASSERT_EQ(0, manager.pending());
+    ASSERT_GT(swapped_mem_usage, allocator::instance().memory_utilization());
+  }
+
+  ASSERT_EQ(initial_mem_usage, allocator::instance().memory_utilization());
+}
+
+TEST_F(EpochManagerTest, ConcurrentReadersTest) {
+  epoch_manager &manager = epoch_manager::instance();
+  uint64_t epoch = manager.epoch();
+
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < 8; i++) {
+    readers.push_back(std::thread([&] {
+      for (size_t j = 0; j < 10000; j++) {
+        epoch_manager::guard guard;
+      }
+    }));
+  }
+  for (size_t i = 0; i < 100; i++)
+    manager.try_reclaim();
+  for (auto &reader : readers)
+    reader.join();
+
+  // With every reader gone, the epoch is free to advance
+  manager.try_reclaim();
+  ASSERT_LT(epoch, manager.epoch());
+}
+
+#endif /* CONFLUO_TEST_EPOCH_MANAGER_TEST_H_ */
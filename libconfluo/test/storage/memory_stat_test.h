@@ -1,6 +1,10 @@
 #ifndef CONFLUO_TEST_MEMORY_STAT_TEST_H_
 #define CONFLUO_TEST_MEMORY_STAT_TEST_H_
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include "storage/memory_stat.h"
 #include "gtest/gtest.h"
 
@@ -32,4 +36,65 @@ TEST_F(MemoryStatTest, DecrementGetTest) {
 
 }
 
+TEST_F(MemoryStatTest, ConcurrentTest) {
+
+  storage::memory_stat stat;
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < 8; i++) {
+    workers.push_back(std::thread([&stat] {
+      for (size_t j = 0; j < 10000; j++) {
+        stat.increment(1024);
+        stat.decrement(1000);
+      }
+    }));
+  }
+  for (auto &w : workers)
+    w.join();
+
+  ASSERT_EQ(stat.get(), 8 * 10000 * 24);
+
+}
+
+TEST_F(MemoryStatTest, ApproximateLagTest) {
+
+  const size_t num_workers = 8;
+  const size_t num_increments = 4096;
+  const size_t increment = 1024;
+  storage::memory_stat stat;
+  atomic::type<size_t> done(0);
+  atomic::type<size_t> running(num_workers);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_workers; i++) {
+    workers.push_back(std::thread([&] {
+      for (size_t j = 0; j < num_increments; j++) {
+        stat.increment(increment);
+        atomic::faa(&done, increment);
+      }
+      atomic::faa(&running, static_cast<size_t>(-1));
+    }));
+  }
+
+  // Each worker's slot lags by less than SYNC_BYTES, plus the increment
+  // that triggers a refresh still in progress
+  size_t max_lag = num_workers * (storage::memory_stat::SYNC_BYTES + increment);
+  size_t total = num_workers * num_increments * increment;
+  size_t max_seen_lag = 0;
+  size_t max_approximate = 0;
+  do {
+    size_t lower = atomic::load(&done);
+    size_t approximate = stat.approximate();
+    max_approximate = std::max(max_approximate, approximate);
+    if (lower > approximate)
+      max_seen_lag = std::max(max_seen_lag, lower - approximate);
+  } while (atomic::load(&running) > 0);
+  for (auto &w : workers)
+    w.join();
+
+  ASSERT_LE(max_seen_lag, max_lag);
+  ASSERT_LE(max_approximate, total);
+  ASSERT_GE(stat.approximate() + max_lag, total);
+  ASSERT_EQ(total, stat.get());
+
+}
+
 #endif /* CONFLUO_TEST_MEMORY_STAT_TEST_H_ */
@@ -7,6 +7,7 @@
 #include "storage/allocator.h"
 #include "storage/encoded_ptr.h"
 #include "storage/ptr_metadata.h"
+#include "storage/size_class_pool.h"
 
 using namespace ::confluo;
 using namespace ::confluo::storage;
@@ -15,7 +16,8 @@ class PtrTest : public testing::Test {
 
  public:
   static const size_t ARRAY_SIZE = 1024;
-  const size_t ALLOC_SIZE = sizeof(ptr_metadata) + 1024 * sizeof(ARRAY_SIZE);
+  // Allocations count the size class block that serves them
+  const size_t ALLOC_SIZE = size_class_pool::block_size(sizeof(ptr_metadata) + 1024 * sizeof(ARRAY_SIZE));
 
 };
 
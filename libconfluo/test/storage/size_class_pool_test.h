@@ -0,0 +1,54 @@
+#ifndef CONFLUO_TEST_SIZE_CLASS_POOL_TEST_H_
+#define CONFLUO_TEST_SIZE_CLASS_POOL_TEST_H_
+
+#include <thread>
+
+#include "storage/size_class_pool.h"
+#include "gtest/gtest.h"
+
+using namespace ::confluo::storage;
+
+class SizeClassPoolTest : public testing::Test {
+};
+
+TEST_F(SizeClassPoolTest, SizeClassTest) {
+  ASSERT_EQ(size_class_pool::MIN_CLASS_SIZE, size_class_pool::class_size(0));
+  ASSERT_EQ(size_class_pool::MAX_POOLED_SIZE, size_class_pool::class_size(size_class_pool::NUM_CLASSES - 1));
+  ASSERT_EQ(size_class_pool::NUM_CLASSES, size_class_pool::class_of(size_class_pool::MAX_POOLED_SIZE + 1));
+
+  size_t prev = 0;
+  for (size_t c = 0; c < size_class_pool::NUM_CLASSES; c++) {
+    size_t size = size_class_pool::class_size(c);
+    ASSERT_GT(size, prev);
+    ASSERT_EQ(c, size_class_pool::class_of(size));
+    ASSERT_EQ(c, size_class_pool::class_of(prev + 1));
+    // Classes are at most 25% larger than the requests they serve
+    ASSERT_LE(size, (prev + 1) + (prev + 1) / 4 + size_class_pool::MIN_CLASS_SIZE);
+    prev = size;
+  }
+}
+
+TEST_F(SizeClassPoolTest, RecycleTest) {
+  size_t size = 8 * 1024 + 8;
+  size_t c = size_class_pool::class_of(size);
+  size_t cached = size_class_pool::cached_blocks(c);
+
+  void *ptr = size_class_pool::alloc(size);
+  memset(ptr, 0xff, size_class_pool::class_size(c));
+  size_class_pool::dealloc(ptr, size);
+  ASSERT_EQ(cached + 1, size_class_pool::cached_blocks(c));
+
+  // Requests of the same class reuse the block
+  void *ptr2 = size_class_pool::alloc(size - 4);
+  ASSERT_EQ(ptr, ptr2);
+  ASSERT_EQ(cached, size_class_pool::cached_blocks(c));
+
+  // Blocks freed on another thread go to that thread's pool
+  std::thread([ptr2, size, c] {
+    size_class_pool::dealloc(ptr2, size);
+    ASSERT_EQ(static_cast<size_t>(1), size_class_pool::cached_blocks(c));
+  }).join();
+  ASSERT_EQ(cached, size_class_pool::cached_blocks(c));
+}
+
+#endif /* CONFLUO_TEST_SIZE_CLASS_POOL_TEST_H_ */
@@ -4,6 +4,7 @@
 #include "storage/storage_allocator.h"
 #include "storage/memory_stat.h"
 #include "storage/ptr_aux_block.h"
+#include "storage/size_class_pool.h"
 #include "gtest/gtest.h"
 
 using namespace ::confluo::storage;
@@ -38,7 +39,8 @@ TEST_F(StorageAllocatorTest, DeallocTest) {
   size_t used_memory = allocator.memory_utilization();
 
   uint64_t *ptr = static_cast<uint64_t *>(allocator.alloc(sizeof(uint64_t) * ARRAY_SIZE, ptr_aux_block()));
-  size_t expected_used = ARRAY_SIZE * sizeof(uint64_t) + sizeof(ptr_metadata);
+  // The allocation counts the size class block that serves it
+  size_t expected_used = size_class_pool::block_size(ARRAY_SIZE * sizeof(uint64_t) + sizeof(ptr_metadata));
   ASSERT_EQ(allocator.memory_utilization() - used_memory, expected_used);
 
   allocator.dealloc(ptr);
@@ -15,9 +15,13 @@
 #include "types/data_types_test.h"
 #include "compression/lz4_encode_test.h"
 #include "compression/delta_encode_test.h"
+#include "compression/columnar_encode_test.h"
 #include "container/bitmap/delta_encoded_array_test.h"
 #include "confluo_store_test.h"
 #include "atomic_multilog_test.h"
+#include "read_tail_test.h"
+#include "append_stager_test.h"
+#include "version_tracker_test.h"
 #include "parser/expression_compiler_test.h"
 #include "parser/expression_parser_test.h"
 #include "filter_test.h"
@@ -29,18 +33,23 @@
 #include "schema/index_state_test.h"
 #include "storage/storage_allocator_test.h"
 #include "storage/memory_stat_test.h"
+#include "storage/size_class_pool_test.h"
 #include "container/monolog/monolog_test.h"
 #include "archival/monolog_linear_archival_test.h"
 #include "archival/monolog_linear_load_test.h"
 #include "types/mutable_value_test.h"
 #include "threads/periodic_task_test.h"
+#include "threads/task_scheduler_test.h"
 #include "storage/ptr_test.h"
+#include "storage/epoch_manager_test.h"
+#include "planner/index_stats_test.h"
 #include "container/radix_tree_test.h"
 #include "schema/record_batch_test.h"
 #include "parser/schema_parser_test.h"
 #include "schema/schema_test.h"
 #include "container/stream_test.h"
 #include "container/string_map_test.h"
+#include "container/zone_map_test.h"
 #include "atomic_multilog_metadata_test.h"
 #include "threads/task_test.h"
 #include "threads/thread_manager_test.h"
@@ -0,0 +1,89 @@
+#ifndef CONFLUO_TEST_TASK_SCHEDULER_TEST_H_
+#define CONFLUO_TEST_TASK_SCHEDULER_TEST_H_
+
+#include "threads/task_scheduler.h"
+
+#include "gtest/gtest.h"
+
+class TaskSchedulerTest : public testing::Test {
+};
+
+TEST_F(TaskSchedulerTest, ManyTasksTest) {
+  // Many more tasks than workers all get to run
+  task_scheduler scheduler(2);
+  std::vector<atomic::type<uint64_t>> runs(64);
+  std::vector<task_scheduler::task_id> ids;
+  for (size_t i = 0; i < runs.size(); i++) {
+    atomic::init(&runs[i], UINT64_C(0));
+    ids.push_back(scheduler.schedule("task" + std::to_string(i), [&runs, i] {
+      atomic::faa(&runs[i], UINT64_C(1));
+    }, 5));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  for (task_scheduler::task_id id : ids)
+    ASSERT_TRUE(scheduler.cancel(id));
+  ASSERT_FALSE(scheduler.cancel(ids[0]));
+
+  for (size_t i = 0; i < runs.size(); i++) {
+    uint64_t n = atomic::load(&runs[i]);
+    ASSERT_GT(n, 0U);
+    // No more runs once cancelled
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(n, atomic::load(&runs[i]));
+  }
+}
+
+TEST_F(TaskSchedulerTest, OverrunTest) {
+  task_scheduler scheduler(1);
+  task_scheduler::task_id slow = scheduler.schedule("slow", [] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }, 1);
+  task_scheduler::task_id fast = scheduler.schedule("fast", [] {}, 10);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  // The slow task overruns every time, without starving the fast one
+  task_scheduler::task_stats slow_stats = scheduler.stats(slow);
+  ASSERT_GT(slow_stats.runs, 0U);
+  ASSERT_EQ(slow_stats.runs, slow_stats.overruns);
+  ASSERT_GE(slow_stats.max_overrun_us, 15000U);
+  task_scheduler::task_stats fast_stats = scheduler.stats(fast);
+  ASSERT_GT(fast_stats.runs, 2U);
+  ASSERT_EQ(0U, fast_stats.overruns);
+
+  scheduler.cancel(slow);
+  scheduler.cancel(fast);
+}
+
+TEST_F(TaskSchedulerTest, NotifyTest) {
+  task_scheduler scheduler(1);
+  atomic::type<uint64_t> runs(0);
+  task_scheduler::task_id id = scheduler.schedule("notified", [&runs] {
+    atomic::faa(&runs, UINT64_C(1));
+  }, 60000);
+  scheduler.notify(id);
+  for (size_t i = 0; i < 1000 && atomic::load(&runs) == 0; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_EQ(1U, atomic::load(&runs));
+  ASSERT_EQ(1U, scheduler.stats(id).runs);
+  scheduler.cancel(id);
+}
+
+TEST_F(TaskSchedulerTest, WakeOnScheduleTest) {
+  // With only a task far in the future the ticker sleeps a rotation, and
+  // is woken by a task due sooner
+  task_scheduler scheduler(1);
+  task_scheduler::task_id idle = scheduler.schedule("idle", [] {}, 60000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  atomic::type<uint64_t> runs(0);
+  task_scheduler::task_id id = scheduler.schedule("soon", [&runs] {
+    atomic::faa(&runs, UINT64_C(1));
+  }, 5);
+  for (size_t i = 0; i < 200 && atomic::load(&runs) < 2; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_GE(atomic::load(&runs), 2U);
+  ASSERT_EQ(0U, scheduler.stats(idle).runs);
+  scheduler.cancel(id);
+  scheduler.cancel(idle);
+}
+
+#endif /* CONFLUO_TEST_TASK_SCHEDULER_TEST_H_ */
@@ -1,6 +1,8 @@
 #ifndef CONFLUO_TEST_THREAD_MANAGER_TEST_H_
 #define CONFLUO_TEST_THREAD_MANAGER_TEST_H_
 
+#include <future>
+
 #include "threads/thread_manager.h"
 #include "gtest/gtest.h"
 
@@ -36,4 +38,48 @@ TEST_F(ThreadManagerTest, MultiThreadedRegisterDeregisterTest) {
 
 }
 
+TEST_F(ThreadManagerTest, RegisterReservedTest) {
+  int id = thread_manager::register_reserved_thread();
+  ASSERT_EQ(thread_manager::get_max_concurrency(), id);
+  ASSERT_EQ(thread_manager::get_num_ids(),
+            thread_manager::get_max_concurrency() + thread_manager::get_max_maintenance_concurrency());
+  ASSERT_EQ(id, thread_manager::get_id());
+
+  // Registering again moves the thread off the reserved id
+  int other = thread_manager::register_thread();
+  ASSERT_TRUE(other >= 0 && other < thread_manager::get_max_concurrency());
+  ASSERT_EQ(other, thread_manager::deregister_thread());
+  ASSERT_EQ(-1, thread_manager::get_id());
+}
+
+TEST_F(ThreadManagerTest, RegisterMaintenanceTest) {
+  // Take every reserved id; writers can still register
+  int nreserved = thread_manager::get_max_maintenance_concurrency();
+  atomic::type<bool> done(false);
+  std::vector<std::thread> holders;
+  std::vector<std::future<int>> ids;
+  for (int i = 0; i < nreserved; i++) {
+    std::promise<int> registered;
+    ids.push_back(registered.get_future());
+    holders.push_back(std::thread([&done](std::promise<int> p) {
+      p.set_value(thread_manager::register_maintenance_thread());
+      while (!atomic::load(&done))
+        std::this_thread::yield();
+      thread_manager::deregister_thread();
+    }, std::move(registered)));
+  }
+  for (auto &id : ids) {
+    int i = id.get();
+    ASSERT_TRUE(i >= thread_manager::get_max_concurrency() && i < thread_manager::get_num_ids());
+  }
+  ASSERT_EQ(-2, thread_manager::register_maintenance_thread());
+  int id = thread_manager::register_thread();
+  ASSERT_TRUE(id >= 0 && id < thread_manager::get_max_concurrency());
+  ASSERT_EQ(id, thread_manager::deregister_thread());
+
+  atomic::store(&done, true);
+  for (auto &t : holders)
+    t.join();
+}
+
 #endif /* CONFLUO_TEST_THREAD_MANAGER_TEST_H_ */
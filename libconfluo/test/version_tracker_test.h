@@ -0,0 +1,73 @@
+#ifndef CONFLUO_TEST_VERSION_TRACKER_TEST_H_
+#define CONFLUO_TEST_VERSION_TRACKER_TEST_H_
+
+#include <thread>
+
+#include "version_tracker.h"
+#include "gtest/gtest.h"
+
+using namespace ::confluo;
+
+class VersionTrackerTest : public testing::Test {
+};
+
+TEST_F(VersionTrackerTest, AdvanceTest) {
+  version_tracker tracker;
+  ASSERT_EQ(0U, tracker.floor());
+
+  // The tail observed at a flip becomes the floor at the next one
+  tracker.advance(10);
+  ASSERT_EQ(0U, tracker.floor());
+  tracker.advance(20);
+  ASSERT_EQ(10U, tracker.floor());
+
+  {
+    // Readers of the current epoch hold the floor back one more flip
+    version_tracker::read_guard guard(tracker);
+    tracker.advance(30);
+    ASSERT_EQ(20U, tracker.floor());
+    tracker.advance(40);
+    ASSERT_EQ(20U, tracker.floor());
+    tracker.advance(50);
+    ASSERT_EQ(20U, tracker.floor());
+  }
+
+  tracker.advance(60);
+  ASSERT_EQ(30U, tracker.floor());
+  tracker.advance(70);
+  ASSERT_EQ(60U, tracker.floor());
+}
+
+TEST_F(VersionTrackerTest, ConcurrentReadersTest) {
+  version_tracker tracker;
+  atomic::type<uint64_t> tail(0);
+  atomic::type<bool> done(false);
+  atomic::type<bool> violated(false);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.push_back(std::thread([&] {
+      while (!atomic::load(&done)) {
+        version_tracker::read_guard guard(tracker);
+        uint64_t version = atomic::load(&tail);
+        for (int j = 0; j < 100; j++) {
+          if (tracker.floor() > version)
+            atomic::store(&violated, true);
+        }
+      }
+    }));
+  }
+
+  for (uint64_t i = 1; i <= 100000; i++) {
+    atomic::store(&tail, i);
+    tracker.advance(atomic::load(&tail));
+  }
+  atomic::store(&done, true);
+  for (auto &t : readers)
+    t.join();
+
+  ASSERT_FALSE(atomic::load(&violated));
+  ASSERT_LT(0U, tracker.floor());
+}
+
+#endif /* CONFLUO_TEST_VERSION_TRACKER_TEST_H_ */
@@ -45,8 +45,10 @@ class rpc_client {
    *
    * @param host The host for the rpc client
    * @param port The port for the rpc client
+   * @param framed Whether to use framed transport, as required by servers
+   * in NONBLOCKING mode
    */
-  rpc_client(const std::string &host, int port);
+  rpc_client(const std::string &host, int port, bool framed = false);
 
   /**
    * Destructs the rpc client
@@ -63,8 +65,10 @@ class rpc_client {
    *
    * @param host The host to connect to 
    * @param port The port to use
+   * @param framed Whether to use framed transport, as required by servers
+   * in NONBLOCKING mode
    */
-  void connect(const std::string &host, int port);
+  void connect(const std::string &host, int port, bool framed = false);
 
   /**
    * Creates an atomic multilog with the given name, schema, and storage
@@ -17,6 +17,33 @@ class rpc_configuration_params {
   static size_t ITERATOR_BATCH_SIZE() {
     return conf::instance().get<size_t>("iterator_batch_size", rpc_defaults::DEFAULT_ITERATOR_BATCH_SIZE());
   }
+
+  /** Time an iterator may stay unread before it is evicted, in milliseconds */
+  static size_t ITERATOR_TTL_MS() {
+    return conf::instance().get<size_t>("iterator_ttl_ms", rpc_defaults::DEFAULT_ITERATOR_TTL_MS());
+  }
+
+  /** Maximum number of iterators open on a single connection */
+  static size_t MAX_ITERATORS_PER_HANDLER() {
+    return conf::instance().get<size_t>("max_iterators_per_handler",
+                                        rpc_defaults::DEFAULT_MAX_ITERATORS_PER_HANDLER());
+  }
+
+  /** Maximum memory pinned by iterators on a single connection, in bytes */
+  static size_t MAX_ITERATOR_BYTES_PER_HANDLER() {
+    return conf::instance().get<size_t>("max_iterator_bytes_per_handler",
+                                        rpc_defaults::DEFAULT_MAX_ITERATOR_BYTES_PER_HANDLER());
+  }
+
+  /** Maximum number of iterators open across all connections */
+  static size_t MAX_ITERATORS() {
+    return conf::instance().get<size_t>("max_iterators", rpc_defaults::DEFAULT_MAX_ITERATORS());
+  }
+
+  /** Maximum memory pinned by iterators across all connections, in bytes */
+  static size_t MAX_ITERATOR_BYTES() {
+    return conf::instance().get<size_t>("max_iterator_bytes", rpc_defaults::DEFAULT_MAX_ITERATOR_BYTES());
+  }
 };
 
 }
@@ -16,6 +16,31 @@ class rpc_defaults {
   static inline size_t DEFAULT_ITERATOR_BATCH_SIZE() {
     return 20;
   }
+
+  /** Default time an iterator may stay unread before it is evicted, in milliseconds */
+  static inline size_t DEFAULT_ITERATOR_TTL_MS() {
+    return 300000;
+  }
+
+  /** Default maximum number of iterators open on a single connection */
+  static inline size_t DEFAULT_MAX_ITERATORS_PER_HANDLER() {
+    return 1024;
+  }
+
+  /** Default maximum memory pinned by iterators on a single connection */
+  static inline size_t DEFAULT_MAX_ITERATOR_BYTES_PER_HANDLER() {
+    return 64ULL * 1024ULL * 1024ULL;
+  }
+
+  /** Default maximum number of iterators open across all connections */
+  static inline size_t DEFAULT_MAX_ITERATORS() {
+    return 65536;
+  }
+
+  /** Default maximum memory pinned by iterators across all connections */
+  static inline size_t DEFAULT_MAX_ITERATOR_BYTES() {
+    return 1024ULL * 1024ULL * 1024ULL;
+  }
 };
 
 }
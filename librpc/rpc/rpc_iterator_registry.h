@@ -0,0 +1,132 @@
+#ifndef CONFLUO_RPC_ITERATOR_REGISTRY_H
+#define CONFLUO_RPC_ITERATOR_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace confluo {
+namespace rpc {
+
+/**
+ * The reason a server-side iterator was released
+ */
+enum rpc_iterator_release {
+  /** The client read the iterator to the end */
+  ITERATOR_EXHAUSTED = 0,
+  /** The iterator was not read from for longer than its TTL */
+  ITERATOR_IDLE = 1,
+  /** The connection that opened the iterator was closed */
+  ITERATOR_CLOSED = 2
+};
+
+/**
+ * An iterator held open by a handler between get_more calls, along with
+ * the bookkeeping used to evict it
+ *
+ * @tparam CURSOR The cursor type
+ */
+template<typename CURSOR>
+struct rpc_iterator_entry {
+  /**
+   * Constructs an iterator entry
+   *
+   * @param cursor The cursor backing the iterator
+   * @param bytes The estimated memory pinned by the cursor
+   * @param last_access_ms The time the iterator was last read from
+   */
+  rpc_iterator_entry(std::unique_ptr<CURSOR> cursor, size_t bytes, uint64_t last_access_ms)
+      : cursor(std::move(cursor)),
+        bytes(bytes),
+        last_access_ms(last_access_ms) {
+  }
+
+  /** The cursor backing the iterator */
+  std::unique_ptr<CURSOR> cursor;
+  /** The estimated memory pinned by the cursor */
+  size_t bytes;
+  /** The time the iterator was last read from, in milliseconds */
+  uint64_t last_access_ms;
+};
+
+/**
+ * Accounts for the iterators held open across all handlers, enforcing the
+ * global caps on their number and the memory they pin
+ */
+class rpc_iterator_registry {
+ public:
+  /**
+   * Accounts for a new iterator, unless it would exceed a global cap
+   *
+   * @param bytes The estimated memory pinned by the iterator
+   *
+   * @return True if the iterator may be opened, false otherwise
+   */
+  static bool acquire(size_t bytes);
+
+  /**
+   * Releases an iterator accounted for by acquire
+   *
+   * @param bytes The estimated memory pinned by the iterator
+   * @param reason The reason the iterator was released
+   */
+  static void release(size_t bytes, rpc_iterator_release reason);
+
+  /**
+   * Records an iterator rejected by a per-handler cap
+   */
+  static void reject();
+
+  /**
+   * Gets the number of live iterators
+   *
+   * @return The number of live iterators
+   */
+  static size_t live_iterators();
+
+  /**
+   * Gets the estimated memory pinned by live iterators
+   *
+   * @return The estimated memory pinned by live iterators, in bytes
+   */
+  static size_t live_bytes();
+
+  /**
+   * Gets the number of iterators released for a reason
+   *
+   * @param reason The reason the iterators were released
+   *
+   * @return The number of iterators released for the reason
+   */
+  static size_t released(rpc_iterator_release reason);
+
+  /**
+   * Gets the number of iterators rejected by a cap
+   *
+   * @return The number of rejected iterators
+   */
+  static size_t rejected();
+
+  /**
+   * Describes the live, released and rejected iterators, for logging
+   *
+   * @return A description of the iterator counters
+   */
+  static std::string summary();
+
+ private:
+  /** Number of live iterators **/
+  static std::atomic<size_t> live_iterators_;
+  /** Estimated memory pinned by live iterators **/
+  static std::atomic<size_t> live_bytes_;
+  /** Number of released iterators, by reason **/
+  static std::atomic<size_t> released_[3];
+  /** Number of rejected iterators **/
+  static std::atomic<size_t> rejected_;
+};
+
+}
+}
+
+#endif //CONFLUO_RPC_ITERATOR_REGISTRY_H
@@ -7,18 +7,25 @@
 #include <thrift/server/TThreadPoolServer.h>
 #include <thrift/transport/TSocket.h>
 #include <thrift/transport/TServerSocket.h>
+#ifdef CONFLUO_NONBLOCKING_SERVER
+#include <thrift/server/TNonblockingServer.h>
+#include <thrift/transport/TNonblockingServerSocket.h>
+#endif
 #include <thrift/transport/TBufferTransports.h>
 #include <thrift/concurrency/ThreadManager.h>
 #include <thrift/concurrency/PlatformThreadFactory.h>
 #include <thrift/transport/TTransportUtils.h>
 #include <thrift/TToString.h>
 
+#include <mutex>
 #include <thread>
 
 #include "atomic_multilog.h"
 #include "confluo_store.h"
 #include "rpc_type_conversions.h"
 #include "rpc_configuration_params.h"
+#include "rpc_iterator_registry.h"
+#include "threads/periodic_task.h"
 #include "logger.h"
 
 /**
@@ -45,27 +52,27 @@ namespace rpc {
 class rpc_service_handler : virtual public rpc_serviceIf {
  public:
   /** The adhoc_map type */
-  typedef std::map<rpc_iterator_id, std::unique_ptr<record_cursor>> adhoc_map;
+  typedef std::map<rpc_iterator_id, rpc_iterator_entry<record_cursor>> adhoc_map;
   /** The adhoc entry type */
-  typedef std::pair<rpc_iterator_id, std::unique_ptr<record_cursor>> adhoc_entry;
+  typedef std::pair<rpc_iterator_id, rpc_iterator_entry<record_cursor>> adhoc_entry;
   /** The adhoc status type */
   typedef std::pair<adhoc_map::iterator, bool> adhoc_status;
   /** The map type */
-  typedef std::map<rpc_iterator_id, std::unique_ptr<record_cursor>> predef_map;
+  typedef std::map<rpc_iterator_id, rpc_iterator_entry<record_cursor>> predef_map;
   /** The entry type */
-  typedef std::pair<rpc_iterator_id, std::unique_ptr<record_cursor>> predef_entry;
+  typedef std::pair<rpc_iterator_id, rpc_iterator_entry<record_cursor>> predef_entry;
   /** The status type */
   typedef std::pair<predef_map::iterator, bool> predef_status;
   /** The combined map type */
-  typedef std::map<rpc_iterator_id, std::unique_ptr<record_cursor>> combined_map;
+  typedef std::map<rpc_iterator_id, rpc_iterator_entry<record_cursor>> combined_map;
   /** The combined map entry type */
-  typedef std::pair<rpc_iterator_id, std::unique_ptr<record_cursor>> combined_entry;
+  typedef std::pair<rpc_iterator_id, rpc_iterator_entry<record_cursor>> combined_entry;
   /** The combined status type */
   typedef std::pair<combined_map::iterator, bool> combined_status;
   /** The alerts map type */
-  typedef std::map<rpc_iterator_id, std::unique_ptr<alert_cursor>> alerts_map;
+  typedef std::map<rpc_iterator_id, rpc_iterator_entry<alert_cursor>> alerts_map;
   /** The alerts entry type */
-  typedef std::pair<rpc_iterator_id, std::unique_ptr<alert_cursor>> alerts_entry;
+  typedef std::pair<rpc_iterator_id, rpc_iterator_entry<alert_cursor>> alerts_entry;
   /** The alerts status type */
   typedef std::pair<alerts_map::iterator, bool> alerts_status;
 
@@ -77,6 +84,12 @@ class rpc_service_handler : virtual public rpc_serviceIf {
    */
   explicit rpc_service_handler(confluo_store *store);
 
+  /**
+   * Stops evicting idle iterators and releases the iterators still held
+   * open by the connection
+   */
+  ~rpc_service_handler() override;
+
   /**
    * Registers this service handler on a new thread
    * @throw management_expcetion If this service handler could not
@@ -372,11 +385,21 @@ class rpc_service_handler : virtual public rpc_serviceIf {
  private:
   rpc_iterator_id new_iterator_id();
 
-  void adhoc_more(rpc_iterator_handle &_return, size_t record_size, rpc_iterator_id it_id);
+  template<typename MAP, typename CURSOR>
+  void add_iterator(MAP &map, rpc_iterator_id it_id, std::unique_ptr<CURSOR> cursor, size_t bytes);
+
+  template<typename MAP>
+  void remove_iterator(MAP &map, typename MAP::iterator it, rpc_iterator_release reason);
+
+  template<typename MAP>
+  size_t evict_idle(MAP &map, uint64_t now_ms);
 
-  void predef_more(rpc_iterator_handle &_return, size_t record_size, rpc_iterator_id it_id);
+  size_t evict_idle_iterators();
 
-  void combined_more(rpc_iterator_handle &_return, size_t record_size, rpc_iterator_id it_id);
+  size_t num_iterators() const;
+
+  void records_more(rpc_iterator_handle &_return, adhoc_map &map, rpc_iterator_type type, size_t record_size,
+                    rpc_iterator_id it_id);
 
   void alerts_more(rpc_iterator_handle &_return, rpc_iterator_id it_id);
 
@@ -389,6 +412,10 @@ class rpc_service_handler : virtual public rpc_serviceIf {
   predef_map predef_;
   combined_map combined_;
   alerts_map alerts_;
+  size_t iterator_bytes_;
+  // Guards the iterators against the periodic eviction of idle iterators
+  std::mutex iterators_mtx_;
+  periodic_task eviction_task_;
 };
 
 /**
@@ -428,6 +455,18 @@ class rpc_clone_factory : public rpc_serviceIfFactory {
   confluo_store *store_;
 };
 
+/**
+ * Describes how the rpc server handles client connections.
+ */
+enum rpc_server_mode {
+  /** Pins a pooled worker thread to each connection; buffered transport */
+  THREAD_POOL = 0,
+  /** Multiplexes connections over event-driven I/O threads and dispatches
+   requests onto a bounded worker pool; framed transport. Only available
+   when built with libevent */
+  NONBLOCKING = 1
+};
+
 /**
  * The rpc server the client connects to
  */
@@ -439,11 +478,19 @@ class rpc_server {
    * @param store The confluo store 
    * @param address The address of the server
    * @param port The port the server is on
+   * @param num_workers The number of worker threads serving requests
+   * @param mode The connection handling mode of the server
+   * @param num_io_threads The number of I/O threads multiplexing client
+   * connections; only used in NONBLOCKING mode
    *
+   * @throw std::invalid_argument If NONBLOCKING mode is requested in a build
+   * without libevent
    * @return A pointer to the server
    */
   static std::shared_ptr<TServer> create(confluo_store *store, const std::string &address,
-                                         int port, int num_workers = configuration_params::MAX_CONCURRENCY());
+                                         int port, int num_workers = configuration_params::MAX_CONCURRENCY(),
+                                         rpc_server_mode mode = rpc_server_mode::THREAD_POOL,
+                                         int num_io_threads = 1);
 };
 
 }
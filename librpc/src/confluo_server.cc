@@ -21,6 +21,13 @@ int main(int argc, char **argv) {
   opts.add(cmd_option("port", 'p', false).set_default("9090").set_description("Port that server listens on"));
   opts.add(cmd_option("address", 'a', false).set_default("127.0.0.1").set_description("Address server binds to"));
   opts.add(cmd_option("data-path", 'd', false).set_default(".").set_description("Data path for Confluo"));
+  opts.add(cmd_option("server-mode", 'm', false).set_default("thread-pool").set_description(
+      "Connection handling mode: thread-pool (one worker per connection, buffered transport) or nonblocking "
+      "(multiplexed connections, framed transport)"));
+  opts.add(cmd_option("num-workers", 'w', false).set_default(std::to_string(configuration_params::MAX_CONCURRENCY()))
+               .set_description("Number of worker threads serving requests"));
+  opts.add(cmd_option("num-io-threads", 'i', false).set_default("1").set_description(
+      "Number of I/O threads multiplexing connections in nonblocking mode"));
 
   cmd_parser parser(argc, argv, opts);
   if (parser.get_flag("help")) {
@@ -31,11 +38,24 @@ int main(int argc, char **argv) {
   int port;
   std::string address;
   std::string data_path;
+  rpc_server_mode mode;
+  int num_workers;
+  int num_io_threads;
 
   try {
     port = parser.get_int("port");
     address = parser.get("address");
     data_path = parser.get("data-path");
+    std::string mode_str = parser.get("server-mode");
+    if (mode_str == "thread-pool") {
+      mode = rpc_server_mode::THREAD_POOL;
+    } else if (mode_str == "nonblocking") {
+      mode = rpc_server_mode::NONBLOCKING;
+    } else {
+      throw std::invalid_argument("unknown server mode " + mode_str);
+    }
+    num_workers = parser.get_int("num-workers");
+    num_io_threads = parser.get_int("num-io-threads");
   } catch (std::exception &e) {
     fprintf(stderr, "could not parse cmdline args: %s\n", e.what());
     fprintf(stderr, "%s\n", parser.help_msg().c_str());
@@ -47,7 +67,7 @@ int main(int argc, char **argv) {
   confluo_store *store = new confluo_store(data_path);
 
   try {
-    auto server = rpc_server::create(store, address, port);
+    auto server = rpc_server::create(store, address, port, num_workers, mode, num_io_threads);
     server->serve();
   } catch (std::exception &e) {
     LOG_ERROR << "Could not start server listening on " << address << ":" << port << ": " << e.what();
@@ -7,9 +7,9 @@ rpc_client::rpc_client()
     : cur_multilog_id_(-1) {
 }
 
-rpc_client::rpc_client(const std::string &host, int port)
+rpc_client::rpc_client(const std::string &host, int port, bool framed)
     : cur_multilog_id_(-1) {
-  connect(host, port);
+  connect(host, port, framed);
 }
 
 rpc_client::~rpc_client() {
@@ -26,10 +26,13 @@ void rpc_client::disconnect() {
   }
 }
 
-void rpc_client::connect(const std::string &host, int port) {
+void rpc_client::connect(const std::string &host, int port, bool framed) {
   LOG_INFO << "Connecting to " << host << ":" << port;
   socket_ = std::shared_ptr<TSocket>(new TSocket(host, port));
-  transport_ = std::shared_ptr<TTransport>(new TBufferedTransport(socket_));
+  if (framed)
+    transport_ = std::shared_ptr<TTransport>(new TFramedTransport(socket_));
+  else
+    transport_ = std::shared_ptr<TTransport>(new TBufferedTransport(socket_));
   protocol_ = std::shared_ptr<TProtocol>(new TBinaryProtocol(transport_));
   client_ = std::shared_ptr<thrift_client>(new thrift_client(protocol_));
   transport_->open();
@@ -0,0 +1,58 @@
+#include "rpc_iterator_registry.h"
+
+#include "rpc_configuration_params.h"
+
+namespace confluo {
+namespace rpc {
+
+std::atomic<size_t> rpc_iterator_registry::live_iterators_{0};
+std::atomic<size_t> rpc_iterator_registry::live_bytes_{0};
+std::atomic<size_t> rpc_iterator_registry::released_[3];
+std::atomic<size_t> rpc_iterator_registry::rejected_{0};
+
+bool rpc_iterator_registry::acquire(size_t bytes) {
+  size_t n = live_iterators_.fetch_add(1) + 1;
+  size_t b = live_bytes_.fetch_add(bytes) + bytes;
+  if (n > rpc_configuration_params::MAX_ITERATORS() || b > rpc_configuration_params::MAX_ITERATOR_BYTES()) {
+    live_iterators_.fetch_sub(1);
+    live_bytes_.fetch_sub(bytes);
+    rejected_.fetch_add(1);
+    return false;
+  }
+  return true;
+}
+
+void rpc_iterator_registry::release(size_t bytes, rpc_iterator_release reason) {
+  live_iterators_.fetch_sub(1);
+  live_bytes_.fetch_sub(bytes);
+  released_[reason].fetch_add(1);
+}
+
+void rpc_iterator_registry::reject() {
+  rejected_.fetch_add(1);
+}
+
+size_t rpc_iterator_registry::live_iterators() {
+  return live_iterators_.load();
+}
+
+size_t rpc_iterator_registry::live_bytes() {
+  return live_bytes_.load();
+}
+
+size_t rpc_iterator_registry::released(rpc_iterator_release reason) {
+  return released_[reason].load();
+}
+
+size_t rpc_iterator_registry::rejected() {
+  return rejected_.load();
+}
+
+std::string rpc_iterator_registry::summary() {
+  return "live=" + std::to_string(live_iterators()) + " live_bytes=" + std::to_string(live_bytes())
+      + " exhausted=" + std::to_string(released(ITERATOR_EXHAUSTED)) + " idle=" + std::to_string(released(ITERATOR_IDLE))
+      + " closed=" + std::to_string(released(ITERATOR_CLOSED)) + " rejected=" + std::to_string(rejected());
+}
+
+}
+}
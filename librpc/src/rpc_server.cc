@@ -20,7 +20,27 @@ namespace rpc {
 rpc_service_handler::rpc_service_handler(confluo_store *store)
     : handler_id_(-1),
       store_(store),
-      iterator_id_(0) {
+      iterator_id_(0),
+      iterator_bytes_(0),
+      eviction_task_("iterator_eviction", store->scheduler()) {
+  // Idle iterators live at most one and a half TTLs
+  eviction_task_.start([this] {
+    size_t evicted = evict_idle_iterators();
+    if (evicted > 0)
+      LOG_INFO << "Evicted " << evicted << " idle iterator(s); " << rpc_iterator_registry::summary();
+  }, std::max(rpc_configuration_params::ITERATOR_TTL_MS() / 2, static_cast<size_t>(1)));
+}
+
+rpc_service_handler::~rpc_service_handler() {
+  eviction_task_.stop();
+  for (auto &e : adhoc_)
+    rpc_iterator_registry::release(e.second.bytes, rpc_iterator_release::ITERATOR_CLOSED);
+  for (auto &e : predef_)
+    rpc_iterator_registry::release(e.second.bytes, rpc_iterator_release::ITERATOR_CLOSED);
+  for (auto &e : combined_)
+    rpc_iterator_registry::release(e.second.bytes, rpc_iterator_release::ITERATOR_CLOSED);
+  for (auto &e : alerts_)
+    rpc_iterator_registry::release(e.second.bytes, rpc_iterator_release::ITERATOR_CLOSED);
 }
 
 void rpc_service_handler::register_handler() {
@@ -185,13 +205,15 @@ void rpc_service_handler::archive(int64_t id, int64_t offset) {
 }
 
 int64_t rpc_service_handler::append(int64_t id, const std::string &data) {
-  void *buf = (char *) &data[0];  // XXX: Fix
+  // The record is only read, straight out of the deserialized request
+  void *buf = const_cast<char *>(data.data());
   return static_cast<int64_t>(store_->get_atomic_multilog(id)->append(buf));
 }
 
 int64_t rpc_service_handler::append_batch(int64_t id, const rpc_record_batch &batch) {
-  record_batch rbatch = rpc_type_conversions::convert_batch(batch);
-  return static_cast<int64_t>(store_->get_atomic_multilog(id)->append_batch(rbatch));
+  // Write the blocks of the deserialized request straight into the data log,
+  // rather than first copying them into a record_batch
+  return static_cast<int64_t>(store_->get_atomic_multilog(id)->append_blocks(batch.blocks));
 }
 
 void rpc_service_handler::read(std::string &_return, int64_t id, const int64_t offset, const int64_t nrecords) {
@@ -199,10 +221,10 @@ void rpc_service_handler::read(std::string &_return, int64_t id, const int64_t o
   uint64_t limit;
   read_only_data_log_ptr ptr;
   mlog->read((uint64_t) offset, limit, ptr);
-  data_ptr dptr = ptr.decode();
-  char *data = reinterpret_cast<char *>(dptr.get());
   size_t size = std::min(static_cast<size_t>(limit - offset),
                          static_cast<size_t>(nrecords * mlog->record_size()));
+  data_ptr dptr = ptr.decode_ptr(0, size);
+  char *data = reinterpret_cast<char *>(dptr.get());
   _return.assign(data, size);
 }
 
@@ -224,26 +246,19 @@ void rpc_service_handler::adhoc_aggregate(std::string &_return,
 }
 
 void rpc_service_handler::adhoc_filter(rpc_iterator_handle &_return, int64_t id, const std::string &filter_expr) {
-  bool success;
   rpc_iterator_id it_id = new_iterator_id();
   atomic_multilog *mlog = store_->get_atomic_multilog(id);
+  std::unique_ptr<record_cursor> cursor;
   try {
-    adhoc_entry entry(it_id, mlog->execute_filter(filter_expr));
-    adhoc_status ret = adhoc_.insert(std::move(entry));
-    success = ret.second;
+    cursor = mlog->execute_filter(filter_expr);
   } catch (parse_exception &ex) {
     rpc_invalid_operation e;
     e.msg = ex.what();
     throw e;
   }
-
-  if (!success) {
-    rpc_invalid_operation e;
-    e.msg = "Duplicate rpc_iterator_id assigned";
-    throw e;
-  }
-
-  adhoc_more(_return, mlog->record_size(), it_id);
+  size_t bytes = cursor->batch_capacity() * (sizeof(record_t) + mlog->record_size());
+  add_iterator(adhoc_, it_id, std::move(cursor), bytes);
+  records_more(_return, adhoc_, rpc_iterator_type::RPC_ADHOC, mlog->record_size(), it_id);
 }
 
 void rpc_service_handler::predef_filter(rpc_iterator_handle &_return,
@@ -253,15 +268,10 @@ void rpc_service_handler::predef_filter(rpc_iterator_handle &_return,
                                         const int64_t end_ms) {
   rpc_iterator_id it_id = new_iterator_id();
   atomic_multilog *mlog = store_->get_atomic_multilog(id);
-  predef_entry entry(it_id, mlog->query_filter(filter_name, (uint64_t) begin_ms, (uint64_t) end_ms));
-  predef_status ret = predef_.insert(std::move(entry));
-  if (!ret.second) {
-    rpc_invalid_operation e;
-    e.msg = "Duplicate rpc_iterator_id assigned";
-    throw e;
-  }
-
-  predef_more(_return, mlog->record_size(), it_id);
+  std::unique_ptr<record_cursor> cursor = mlog->query_filter(filter_name, (uint64_t) begin_ms, (uint64_t) end_ms);
+  size_t bytes = cursor->batch_capacity() * (sizeof(record_t) + mlog->record_size());
+  add_iterator(predef_, it_id, std::move(cursor), bytes);
+  records_more(_return, predef_, rpc_iterator_type::RPC_PREDEF, mlog->record_size(), it_id);
 }
 
 void rpc_service_handler::combined_filter(rpc_iterator_handle &_return,
@@ -270,25 +280,19 @@ void rpc_service_handler::combined_filter(rpc_iterator_handle &_return,
                                           const std::string &filter_expr,
                                           const int64_t begin_ms,
                                           const int64_t end_ms) {
-  bool success;
   rpc_iterator_id it_id = new_iterator_id();
   atomic_multilog *mlog = store_->get_atomic_multilog(id);
+  std::unique_ptr<record_cursor> cursor;
   try {
-    combined_entry entry(it_id, mlog->query_filter(filter_name, (uint64_t) begin_ms, (uint64_t) end_ms, filter_expr));
-    combined_status ret = combined_.insert(std::move(entry));
-    success = ret.second;
+    cursor = mlog->query_filter(filter_name, (uint64_t) begin_ms, (uint64_t) end_ms, filter_expr);
   } catch (parse_exception &ex) {
     rpc_invalid_operation e;
     e.msg = ex.what();
     throw e;
   }
-  if (!success) {
-    rpc_invalid_operation e;
-    e.msg = "Duplicate rpc_iterator_id assigned";
-    throw e;
-  }
-
-  combined_more(_return, mlog->record_size(), it_id);
+  size_t bytes = cursor->batch_capacity() * (sizeof(record_t) + mlog->record_size());
+  add_iterator(combined_, it_id, std::move(cursor), bytes);
+  records_more(_return, combined_, rpc_iterator_type::RPC_COMBINED, mlog->record_size(), it_id);
 }
 
 void rpc_service_handler::alerts_by_time(rpc_iterator_handle &_return,
@@ -297,14 +301,9 @@ void rpc_service_handler::alerts_by_time(rpc_iterator_handle &_return,
                                          const int64_t end_ms) {
   rpc_iterator_id it_id = new_iterator_id();
   atomic_multilog *mlog = store_->get_atomic_multilog(id);
-  alerts_entry entry(it_id, mlog->get_alerts((uint64_t) begin_ms, (uint64_t) end_ms));
-  alerts_status ret = alerts_.insert(std::move(entry));
-  if (!ret.second) {
-    rpc_invalid_operation e;
-    e.msg = "Duplicate rpc_iterator_id assigned";
-    throw e;
-  }
-
+  std::unique_ptr<alert_cursor> cursor = mlog->get_alerts((uint64_t) begin_ms, (uint64_t) end_ms);
+  size_t bytes = cursor->batch_capacity() * sizeof(alert);
+  add_iterator(alerts_, it_id, std::move(cursor), bytes);
   alerts_more(_return, it_id);
 }
 
@@ -315,14 +314,9 @@ void rpc_service_handler::alerts_by_trigger_and_time(rpc_iterator_handle &_retur
                                                      const int64_t end_ms) {
   rpc_iterator_id it_id = new_iterator_id();
   atomic_multilog *mlog = store_->get_atomic_multilog(id);
-  alerts_entry entry(it_id, mlog->get_alerts((uint64_t) begin_ms, (uint64_t) end_ms, trigger_name));
-  alerts_status ret = alerts_.insert(std::move(entry));
-  if (!ret.second) {
-    rpc_invalid_operation e;
-    e.msg = "Duplicate rpc_iterator_id assigned";
-    throw e;
-  }
-
+  std::unique_ptr<alert_cursor> cursor = mlog->get_alerts((uint64_t) begin_ms, (uint64_t) end_ms, trigger_name);
+  size_t bytes = cursor->batch_capacity() * sizeof(alert);
+  add_iterator(alerts_, it_id, std::move(cursor), bytes);
   alerts_more(_return, it_id);
 }
 
@@ -337,15 +331,15 @@ void rpc_service_handler::get_more(rpc_iterator_handle &_return, int64_t id, con
 
   switch (desc.type) {
     case rpc_iterator_type::RPC_ADHOC: {
-      adhoc_more(_return, record_size, desc.id);
+      records_more(_return, adhoc_, desc.type, record_size, desc.id);
       break;
     }
     case rpc_iterator_type::RPC_PREDEF: {
-      predef_more(_return, record_size, desc.id);
+      records_more(_return, predef_, desc.type, record_size, desc.id);
       break;
     }
     case rpc_iterator_type::RPC_COMBINED: {
-      combined_more(_return, record_size, desc.id);
+      records_more(_return, combined_, desc.type, record_size, desc.id);
       break;
     }
     case rpc_iterator_type::RPC_ALERTS: {
@@ -363,82 +357,97 @@ rpc_iterator_id rpc_service_handler::new_iterator_id() {
   return iterator_id_++;
 }
 
-void rpc_service_handler::adhoc_more(rpc_iterator_handle &_return, size_t record_size, rpc_iterator_id it_id) {
-  // Initialize iterator descriptor
-  _return.desc.data_type = rpc_data_type::RPC_RECORD;
-  _return.desc.handler_id = handler_id_;
-  _return.desc.id = it_id;
-  _return.desc.type = rpc_iterator_type::RPC_ADHOC;
+template<typename MAP, typename CURSOR>
+void rpc_service_handler::add_iterator(MAP &map, rpc_iterator_id it_id, std::unique_ptr<CURSOR> cursor,
+                                       size_t bytes) {
+  evict_idle_iterators();
 
-  // Read data from iterator
-  try {
-    auto &res = adhoc_.at(it_id);
-    size_t to_read = rpc_configuration_params::ITERATOR_BATCH_SIZE();
-    _return.data.reserve(record_size * to_read);
-    size_t i = 0;
-    for (; res->has_more() && i < to_read; ++i, res->advance()) {
-      record_t rec = res->get();
-      _return.data.append(reinterpret_cast<const char *>(rec.data()), rec.length());
-    }
-    _return.num_entries = static_cast<int32_t>(i);
-    _return.has_more = res->has_more();
-  } catch (std::out_of_range &ex) {
+  std::lock_guard<std::mutex> lock(iterators_mtx_);
+  bool handler_full = num_iterators() >= rpc_configuration_params::MAX_ITERATORS_PER_HANDLER()
+      || iterator_bytes_ + bytes > rpc_configuration_params::MAX_ITERATOR_BYTES_PER_HANDLER();
+  if (handler_full)
+    rpc_iterator_registry::reject();
+  if (handler_full || !rpc_iterator_registry::acquire(bytes)) {
     rpc_invalid_operation e;
-    e.msg = "No such iterator";
+    e.msg = "Too many open iterators";
     throw e;
   }
+
+  typename MAP::mapped_type entry(std::move(cursor), bytes, time_utils::cur_ms());
+  if (!map.insert(std::make_pair(it_id, std::move(entry))).second) {
+    rpc_iterator_registry::release(bytes, rpc_iterator_release::ITERATOR_CLOSED);
+    rpc_invalid_operation e;
+    e.msg = "Duplicate rpc_iterator_id assigned";
+    throw e;
+  }
+  iterator_bytes_ += bytes;
 }
 
-void rpc_service_handler::predef_more(rpc_iterator_handle &_return, size_t record_size, rpc_iterator_id it_id) {
-  // Initialize iterator descriptor
-  _return.desc.data_type = rpc_data_type::RPC_RECORD;
-  _return.desc.handler_id = handler_id_;
-  _return.desc.id = it_id;
-  _return.desc.type = rpc_iterator_type::RPC_PREDEF;
+template<typename MAP>
+void rpc_service_handler::remove_iterator(MAP &map, typename MAP::iterator it, rpc_iterator_release reason) {
+  iterator_bytes_ -= it->second.bytes;
+  rpc_iterator_registry::release(it->second.bytes, reason);
+  map.erase(it);
+}
 
-  // Read data from iterator
-  try {
-    auto &res = predef_.at(it_id);
-    size_t to_read = rpc_configuration_params::ITERATOR_BATCH_SIZE();
-    _return.data.reserve(record_size * to_read);
-    size_t i = 0;
-    for (; res->has_more() && i < to_read; ++i, res->advance()) {
-      record_t rec = res->get();
-      _return.data.append(reinterpret_cast<const char *>(rec.data()), rec.length());
+template<typename MAP>
+size_t rpc_service_handler::evict_idle(MAP &map, uint64_t now_ms) {
+  uint64_t ttl_ms = rpc_configuration_params::ITERATOR_TTL_MS();
+  size_t evicted = 0;
+  for (auto it = map.begin(); it != map.end();) {
+    auto cur = it++;
+    if (now_ms - cur->second.last_access_ms > ttl_ms) {
+      remove_iterator(map, cur, rpc_iterator_release::ITERATOR_IDLE);
+      evicted++;
     }
-    _return.num_entries = static_cast<int32_t>(i);
-    _return.has_more = res->has_more();
-  } catch (std::out_of_range &ex) {
-    rpc_invalid_operation e;
-    e.msg = "No such iterator";
-    throw e;
   }
+  return evicted;
+}
+
+size_t rpc_service_handler::evict_idle_iterators() {
+  std::lock_guard<std::mutex> lock(iterators_mtx_);
+  uint64_t now_ms = time_utils::cur_ms();
+  return evict_idle(adhoc_, now_ms) + evict_idle(predef_, now_ms) + evict_idle(combined_, now_ms)
+      + evict_idle(alerts_, now_ms);
 }
 
-void rpc_service_handler::combined_more(rpc_iterator_handle &_return, size_t record_size, rpc_iterator_id it_id) {
+size_t rpc_service_handler::num_iterators() const {
+  return adhoc_.size() + predef_.size() + combined_.size() + alerts_.size();
+}
+
+void rpc_service_handler::records_more(rpc_iterator_handle &_return, adhoc_map &map, rpc_iterator_type type,
+                                       size_t record_size, rpc_iterator_id it_id) {
   // Initialize iterator descriptor
   _return.desc.data_type = rpc_data_type::RPC_RECORD;
   _return.desc.handler_id = handler_id_;
   _return.desc.id = it_id;
-  _return.desc.type = rpc_iterator_type::RPC_COMBINED;
+  _return.desc.type = type;
 
   // Read data from iterator
-  try {
-    auto &res = combined_.at(it_id);
-    size_t to_read = rpc_configuration_params::ITERATOR_BATCH_SIZE();
-    _return.data.reserve(record_size * to_read);
-    size_t i = 0;
-    for (; res->has_more() && i < to_read; ++i, res->advance()) {
-      record_t rec = res->get();
-      _return.data.append(reinterpret_cast<const char *>(rec.data()), rec.length());
-    }
-    _return.num_entries = static_cast<int32_t>(i);
-    _return.has_more = res->has_more();
-  } catch (std::out_of_range &ex) {
+  std::lock_guard<std::mutex> lock(iterators_mtx_);
+  auto it = map.find(it_id);
+  if (it == map.end()) {
     rpc_invalid_operation e;
     e.msg = "No such iterator";
     throw e;
   }
+
+  auto &res = it->second.cursor;
+  size_t to_read = rpc_configuration_params::ITERATOR_BATCH_SIZE();
+  _return.data.reserve(record_size * to_read);
+  size_t i = 0;
+  for (; res->has_more() && i < to_read; ++i, res->advance()) {
+    record_t rec = res->get();
+    _return.data.append(reinterpret_cast<const char *>(rec.data()), rec.length());
+  }
+  _return.num_entries = static_cast<int32_t>(i);
+  _return.has_more = res->has_more();
+
+  // Clients stop asking for more once the iterator is exhausted
+  if (_return.has_more)
+    it->second.last_access_ms = time_utils::cur_ms();
+  else
+    remove_iterator(map, it, rpc_iterator_release::ITERATOR_EXHAUSTED);
 }
 
 void rpc_service_handler::alerts_more(rpc_iterator_handle &_return, rpc_iterator_id it_id) {
@@ -449,22 +458,29 @@ void rpc_service_handler::alerts_more(rpc_iterator_handle &_return, rpc_iterator
   _return.desc.type = rpc_iterator_type::RPC_ALERTS;
 
   // Read data from iterator
-  try {
-    auto &res = alerts_.at(it_id);
-    size_t to_read = rpc_configuration_params::ITERATOR_BATCH_SIZE();
-    size_t i = 0;
-    for (; res->has_more() && i < to_read; ++i, res->advance()) {
-      alert a = res->get();
-      _return.data.append(a.to_string());
-      _return.data.push_back('\n');
-    }
-    _return.num_entries = static_cast<int32_t>(i);
-    _return.has_more = res->has_more();
-  } catch (std::out_of_range &ex) {
+  std::lock_guard<std::mutex> lock(iterators_mtx_);
+  auto it = alerts_.find(it_id);
+  if (it == alerts_.end()) {
     rpc_invalid_operation e;
     e.msg = "No such iterator";
     throw e;
   }
+
+  auto &res = it->second.cursor;
+  size_t to_read = rpc_configuration_params::ITERATOR_BATCH_SIZE();
+  size_t i = 0;
+  for (; res->has_more() && i < to_read; ++i, res->advance()) {
+    alert a = res->get();
+    _return.data.append(a.to_string());
+    _return.data.push_back('\n');
+  }
+  _return.num_entries = static_cast<int32_t>(i);
+  _return.has_more = res->has_more();
+
+  if (_return.has_more)
+    it->second.last_access_ms = time_utils::cur_ms();
+  else
+    remove_iterator(alerts_, it, rpc_iterator_release::ITERATOR_EXHAUSTED);
 }
 
 rpc_clone_factory::rpc_clone_factory(confluo_store *store)
@@ -476,6 +492,11 @@ rpc_clone_factory::~rpc_clone_factory() = default;
 rpc_serviceIf *rpc_clone_factory::getHandler(const TConnectionInfo &conn_info) {
   std::shared_ptr<TSocket> sock = std::dynamic_pointer_cast<TSocket>(
       conn_info.transport);
+  // The nonblocking server hands out its own connection transport, not a TSocket
+  if (sock == nullptr) {
+    LOG_INFO << "Incoming connection";
+    return new rpc_service_handler(store_);
+  }
   LOG_INFO << "Incoming connection\n"
            << "\t\t\tSocketInfo: " << sock->getSocketInfo() << "\n"
            << "\t\t\tPeerHost: " << sock->getPeerHost() << "\n"
@@ -486,10 +507,12 @@ rpc_serviceIf *rpc_clone_factory::getHandler(const TConnectionInfo &conn_info) {
 
 void rpc_clone_factory::releaseHandler(rpc_serviceIf *handler) {
   delete handler;
+  LOG_INFO << "Connection closed; iterators: " << rpc_iterator_registry::summary();
 }
 
 std::shared_ptr<TServer> rpc_server::create(confluo_store *store, const std::string &address,
-                                            int port, int num_workers) {
+                                            int port, int num_workers, rpc_server_mode mode,
+                                            int num_io_threads) {
   LOG_INFO << "Creating rpc server with a thread pool of size = " << num_workers;
   std::shared_ptr<ThreadManager> thread_manager =
       ThreadManager::newSimpleThreadManager(num_workers);
@@ -498,9 +521,21 @@ std::shared_ptr<TServer> rpc_server::create(confluo_store *store, const std::str
 
   auto clone_factory = std::make_shared<rpc_clone_factory>(store);
   auto proc_factory = std::make_shared<rpc_serviceProcessorFactory>(clone_factory);
+  auto p_factory = std::make_shared<TBinaryProtocolFactory>();
+  if (mode == rpc_server_mode::NONBLOCKING) {
+#ifdef CONFLUO_NONBLOCKING_SERVER
+    LOG_INFO << "Using nonblocking server with " << num_io_threads << " I/O thread(s)";
+    auto sock = std::make_shared<TNonblockingServerSocket>(address, port);
+    auto server = std::make_shared<TNonblockingServer>(proc_factory, p_factory, sock, thread_manager);
+    server->setNumIOThreads(static_cast<size_t>(num_io_threads));
+    return server;
+#else
+    throw std::invalid_argument("nonblocking server mode requires a build with libevent");
+#endif
+  }
+
   auto sock = std::make_shared<TServerSocket>(address, port);
   auto t_factory = std::make_shared<TBufferedTransportFactory>();
-  auto p_factory = std::make_shared<TBinaryProtocolFactory>();
   return std::make_shared<TThreadPoolServer>(proc_factory, sock, t_factory, p_factory, thread_manager);
 }
 
@@ -43,4 +43,43 @@ TEST_F(ClientConnectionTest, ConcurrentConnectionsTest) {
   }
 }
 
+#ifdef CONFLUO_NONBLOCKING_SERVER
+TEST_F(ClientConnectionTest, NonblockingConcurrentConnectionsTest) {
+  auto store = new confluo_store("/tmp");
+  auto server = rpc_server::create(store, SERVER_ADDRESS, SERVER_PORT, 2, rpc_server_mode::NONBLOCKING, 2);
+  std::thread serve_thread([&server] {
+    server->serve();
+  });
+
+  rpc_test_utils::wait_till_server_ready(SERVER_ADDRESS, SERVER_PORT, true);
+  std::vector<rpc_client> clients(16);
+  for (auto &client : clients) {
+    client.connect(SERVER_ADDRESS, SERVER_PORT, true);
+  }
+
+  // More open connections than worker threads must all be served
+  schema_t schema(schema_builder().add_column(primitive_types::LONG_TYPE(), "value").get_columns());
+  clients[0].create_atomic_multilog("nonblocking_multilog", schema, storage::IN_MEMORY);
+  for (size_t i = 1; i < clients.size(); i++) {
+    clients[i].set_current_atomic_multilog("nonblocking_multilog");
+  }
+  for (auto &client : clients) {
+    client.append(std::vector<std::string>{"1"});
+  }
+  for (auto &client : clients) {
+    ASSERT_EQ(static_cast<int64_t>(clients.size()), client.num_records());
+  }
+
+  for (auto &client : clients) {
+    client.disconnect();
+  }
+
+  server->stop();
+
+  if (serve_thread.joinable()) {
+    serve_thread.join();
+  }
+}
+#endif
+
 #endif /* RPC_TEST_SERVER_CLIENT_TEST_H_ */
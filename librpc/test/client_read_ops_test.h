@@ -359,6 +359,94 @@ TEST_F(ClientReadOpsTest, AdHocFilterTest) {
   }
 }
 
+TEST_F(ClientReadOpsTest, IteratorEvictionTest) {
+  std::string multilog_name = "my_multilog";
+  auto store = new confluo_store("/tmp");
+  store->create_atomic_multilog(multilog_name, schema(), storage::IN_MEMORY);
+  auto mlog = store->get_atomic_multilog(multilog_name);
+
+  size_t batch_size = rpc_configuration_params::ITERATOR_BATCH_SIZE();
+  for (size_t i = 0; i < 2 * batch_size; i++)
+    mlog->append(record(true, '1', 10, 2, 1, 0.1, 0.02, "defg"));
+
+  auto server = create_server(store);
+  std::thread serve_thread([&server] {
+    server->serve();
+  });
+
+  rpc_test_utils::wait_till_server_ready(SERVER_ADDRESS, SERVER_PORT);
+
+  rpc_client client(SERVER_ADDRESS, SERVER_PORT);
+  client.set_current_atomic_multilog(multilog_name);
+
+  size_t live = rpc_iterator_registry::live_iterators();
+  size_t exhausted = rpc_iterator_registry::released(rpc_iterator_release::ITERATOR_EXHAUSTED);
+
+  size_t i = 0;
+  auto r = client.execute_filter("a == true");
+  ASSERT_TRUE(r.has_more());
+  ASSERT_EQ(live + 1, rpc_iterator_registry::live_iterators());
+  for (; r.has_more(); ++r)
+    i++;
+  ASSERT_EQ(2 * batch_size, i);
+
+  // The server drops the iterator as soon as it hands out the last batch
+  ASSERT_EQ(live, rpc_iterator_registry::live_iterators());
+  ASSERT_EQ(exhausted + 1, rpc_iterator_registry::released(rpc_iterator_release::ITERATOR_EXHAUSTED));
+
+  client.disconnect();
+  server->stop();
+  if (serve_thread.joinable()) {
+    serve_thread.join();
+  }
+}
+
+TEST_F(ClientReadOpsTest, IdleIteratorEvictionTest) {
+  struct restore_ttl {
+    std::string ttl_ms;
+    ~restore_ttl() {
+      conf::instance().set("iterator_ttl_ms", ttl_ms);
+    }
+  } restore{std::to_string(rpc_configuration_params::ITERATOR_TTL_MS())};
+  conf::instance().set("iterator_ttl_ms", 20);
+  std::string multilog_name = "my_multilog";
+  auto store = new confluo_store("/tmp");
+  store->create_atomic_multilog(multilog_name, schema(), storage::IN_MEMORY);
+  auto mlog = store->get_atomic_multilog(multilog_name);
+
+  size_t batch_size = rpc_configuration_params::ITERATOR_BATCH_SIZE();
+  for (size_t i = 0; i < 2 * batch_size; i++)
+    mlog->append(record(true, '1', 10, 2, 1, 0.1, 0.02, "defg"));
+
+  auto server = create_server(store);
+  std::thread serve_thread([&server] {
+    server->serve();
+  });
+
+  rpc_test_utils::wait_till_server_ready(SERVER_ADDRESS, SERVER_PORT);
+
+  rpc_client client(SERVER_ADDRESS, SERVER_PORT);
+  client.set_current_atomic_multilog(multilog_name);
+
+  size_t live = rpc_iterator_registry::live_iterators();
+  size_t idle = rpc_iterator_registry::released(rpc_iterator_release::ITERATOR_IDLE);
+  auto r = client.execute_filter("a == true");
+  ASSERT_TRUE(r.has_more());
+  ASSERT_EQ(live + 1, rpc_iterator_registry::live_iterators());
+
+  // An unread iterator is evicted without the connection opening another
+  for (size_t i = 0; i < 1000 && rpc_iterator_registry::live_iterators() > live; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_EQ(live, rpc_iterator_registry::live_iterators());
+  ASSERT_EQ(idle + 1, rpc_iterator_registry::released(rpc_iterator_release::ITERATOR_IDLE));
+
+  client.disconnect();
+  server->stop();
+  if (serve_thread.joinable()) {
+    serve_thread.join();
+  }
+}
+
 TEST_F(ClientReadOpsTest, FilterAggregateTriggerTest) {
   if (configuration_params::MAX_CONCURRENCY() < 2) {
     LOG_WARN << "Need at least 2 cores to run this test, skipping...";
@@ -5,11 +5,11 @@
 
 class rpc_test_utils {
  public:
-  static void wait_till_server_ready(const std::string &host, int port) {
+  static void wait_till_server_ready(const std::string &host, int port, bool framed = false) {
     bool check = true;
     while (check) {
       try {
-        confluo::rpc::rpc_client(host, port);
+        confluo::rpc::rpc_client(host, port, framed);
         check = false;
       } catch (TTransportException &e) {
         usleep(100000);
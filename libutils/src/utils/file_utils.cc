@@ -62,6 +62,18 @@ void file_utils::truncate_file(int fd, size_t size) {
       ret != -1,
       "ftruncate(" << fd << ", " << size << "): " << strerror(errno));
 }
+void file_utils::allocate_file(int fd, size_t size) {
+  // Reserves the file's blocks up front, so that faulting its pages in does
+  // not have to; a file system that cannot reserve them gets a sparse file
+  int ret = posix_fallocate(fd, 0, static_cast<off_t>(size));
+  if (ret == EOPNOTSUPP || ret == EINVAL) {
+    truncate_file(fd, size);
+    return;
+  }
+  assert_throw(
+      ret == 0,
+      "posix_fallocate(" << fd << ", " << size << "): " << strerror(ret));
+}
 void file_utils::close_file(int fd) {
   int ret = close(fd);
   assert_throw(ret != -1, "close(" << fd << "): " << strerror(errno));
@@ -118,6 +118,15 @@ static inline void init(type<T> *obj, const T &arg) {
 #endif
 }
 
+// Full memory barrier
+static inline void fence() {
+#ifdef CPP11_ATOMICS
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+#else
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
 namespace c11 {
 
 namespace weak {
@@ -53,6 +53,17 @@ class configuration_map {
     return as<T>(it->second);
   }
 
+  /**
+   * Overrides a configuration value; must not race with reads of the map,
+   * so is only meant for startup and tests
+   */
+  template<typename T>
+  void set(const std::string &key, const T &val) {
+    std::ostringstream ostr;
+    ostr << val;
+    conf_map_[key] = ostr.str();
+  }
+
  private:
   template<typename T>
   static T as(std::string const &val) {
@@ -39,6 +39,8 @@ class file_utils {
 
   static void truncate_file(int fd, size_t size);
 
+  static void allocate_file(int fd, size_t size);
+
   static void close_file(int fd);
 
   static std::string full_path(const std::string &path);